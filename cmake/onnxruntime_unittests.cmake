@@ -1162,10 +1162,17 @@ if (NOT onnxruntime_ENABLE_TRAINING_TORCH_INTEROP)
       ${BENCHMARK_DIR}/eigen.cc
       ${BENCHMARK_DIR}/copy.cc
       ${BENCHMARK_DIR}/gelu.cc
+      ${BENCHMARK_DIR}/elementwise_fusion.cc
       ${BENCHMARK_DIR}/activation.cc
       ${BENCHMARK_DIR}/quantize.cc
       ${BENCHMARK_DIR}/reduceminmax.cc
-      ${BENCHMARK_DIR}/layer_normalization.cc)
+      ${BENCHMARK_DIR}/layer_normalization.cc
+      ${BENCHMARK_DIR}/string_ops.cc
+      ${BENCHMARK_DIR}/lookup.cc
+      ${BENCHMARK_DIR}/rnn.cc
+      ${BENCHMARK_DIR}/sampling.cc
+      ${BENCHMARK_DIR}/svm.cc
+      ${BENCHMARK_DIR}/gqa.cc)
     target_include_directories(onnxruntime_benchmark PRIVATE ${ONNXRUNTIME_ROOT} ${onnxruntime_graph_header} ${ONNXRUNTIME_ROOT}/core/mlas/inc)
     target_compile_definitions(onnxruntime_benchmark PRIVATE BENCHMARK_STATIC_DEFINE)
     if(WIN32)
@@ -5902,6 +5902,35 @@ struct OrtApi {
    */
   ORT_API2_STATUS(Node_GetParentGraph, _In_ const OrtNode* node,
                   _Outptr_result_maybenull_ const OrtGraph** parent_graph);
+
+  /** \brief Feed an output back to an input on the next run with the binding.
+   *
+   * After each successful OrtApi::RunWithBinding, the value of output `output_name` becomes the value of input
+   * `input_name` for the next run, without a copy. This carries state between runs of models with explicit state
+   * inputs and outputs, such as streaming audio models, and keeps the state on the device of the output.
+   *
+   * The state is double buffered: once the input holds a value produced by a run, its buffer is reused as the output
+   * of the next run if the shape of the state didn't change. The initial value of the input is never written to.
+   * As a consequence the output values returned by OrtApi::GetBoundOutputValues after a run are overwritten two runs
+   * later. Copy them before then to keep them.
+   *
+   * Binding the input again with OrtApi::BindInput resets the state: the next run uses the new value instead of the
+   * output of the previous run.
+   *
+   * Both names must already be bound: the input with its initial value by OrtApi::BindInput, the output by
+   * OrtApi::BindOutput or OrtApi::BindOutputToDevice. OrtApi::ClearBoundInputs and OrtApi::ClearBoundOutputs remove
+   * the state bindings.
+   *
+   * \param[in] binding_ptr
+   * \param[in] output_name Name of the state output
+   * \param[in] input_name Name of the state input
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.23.
+   */
+  ORT_API2_STATUS(BindOutputToInput, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* output_name,
+                  _In_ const char* input_name);
 };
 
 /*
@@ -2205,6 +2205,7 @@ struct IoBindingImpl : ConstIoBindingImpl<T> {
   void BindInput(const char* name, const Value&);
   void BindOutput(const char* name, const Value&);
   void BindOutput(const char* name, const OrtMemoryInfo*);
+  void BindOutputToInput(const char* output_name, const char* input_name);  ///< Wraps OrtApi::BindOutputToInput
   void ClearBoundInputs();
   void ClearBoundOutputs();
   void SynchronizeInputs();
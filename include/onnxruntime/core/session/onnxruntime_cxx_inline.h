@@ -354,6 +354,11 @@ inline void IoBindingImpl<T>::BindOutput(const char* name, const OrtMemoryInfo*
   ThrowOnError(GetApi().BindOutputToDevice(this->p_, name, mem_info));
 }
 
+template <typename T>
+inline void IoBindingImpl<T>::BindOutputToInput(const char* output_name, const char* input_name) {
+  ThrowOnError(GetApi().BindOutputToInput(this->p_, output_name, input_name));
+}
+
 template <typename T>
 inline void IoBindingImpl<T>::ClearBoundInputs() {
   GetApi().ClearBoundInputs(this->p_);
@@ -71,6 +71,11 @@ static const char* const kOrtSessionOptionsEnableGeluApproximation = "optimizati
 // CastElimination with chain elimination has side effects which may change the inference results. It is disabled by default due to this.
 static const char* const kOrtSessionOptionsEnableCastChainElimination = "optimization.enable_cast_chain_elimination";
 
+// Enable or disable ElementwiseFusion in graph optimization for the CPU EP. "0": disable; "1": enable. The default is
+// "0". ElementwiseFusion replaces the chains of elementwise nodes that remain after the level 3 fusions with a
+// FusedElementwise node. It is disabled by default until it is measured on a wider range of models.
+static const char* const kOrtSessionOptionsEnableElementwiseFusion = "optimization.enable_elementwise_fusion";
+
 // This setting controls whether to enable AheadOfTime function inlining.
 // AOT function inlining examines the graph and attempts to inline as many locally defined functions in the model
 // as possible with the help of enabled execution providers.
@@ -372,11 +377,31 @@ static const char* const kOrtSessionOptionsEpContextModelExternalInitializersFil
 // - "1": Gemm FastMath mode is enabled.
 static const char* const kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16 = "mlas.enable_gemm_fastmath_arm64_bfloat16";
 
+// The CPU Conv kernel transforms constant 3x3 stride 1 filters for the MLAS Winograd F(4x4,3x3) algorithm when the
+// channel counts are large enough. The Winograd transforms reassociate the products, so the outputs can differ from
+// the direct algorithm in the last few bits.
+// Option values:
+// - "0": Winograd convolution is enabled. [DEFAULT]
+// - "1": Winograd convolution is disabled.
+static const char* const kOrtSessionOptionsMlasConvWinogradDisable = "mlas.disable_conv_winograd";
+
 // When converting DQ + MatMul -> MatMulNBits, the accuracy level of the MatMulNBits is controlled by this option.
 // Refer to MatMulNBits op schema for more details.
 // If not provided, default is 4.
 static const char* const kOrtSessionOptionsQDQMatMulNBitsAccuracyLevel = "session.qdq_matmulnbits_accuracy_level";
 
+// Size in bytes of the cache of past state that the CPU GreedySearch and Sampling contrib ops keep for recent prompts.
+// A prompt that starts with the same tokens as a cached one (e.g. a shared system prompt) only runs the decoder
+// subgraph on the rest of its tokens. Entries are evicted least recently used first.
+// Each GreedySearch or Sampling node of the session has its own cache of this size, which lives as long as the session.
+// Caches are not shared between nodes or sessions, as the past state is only valid for the decoder that computed it.
+// Only used for GPT models when batch_size is 1.
+// Option values:
+// - "0": The cache is disabled. [DEFAULT]
+// - "<size>": The cache keeps up to <size> bytes of past state.
+static const char* const kOrtSessionOptionsGenerationPrefixCacheSizeInBytes =
+    "session.generation_prefix_cache_size_in_bytes";
+
 // THIS OPTION IS NOT A REGULAR SESSION OPTION SINCE IT CAN BE MODIFIED AT ANY TIME
 // Meant to be used with SetEpDynamicOptions
 // Specify the type of workload for this session.
@@ -399,3 +424,24 @@ static const char* const kOrtEpDynamicOptionsWorkloadType = "ep.dynamic.workload
 // - "0": EP compile is not disabled. [DEFAULT]
 // - "1": EP compile is disabled.
 static const char* const kOrtSessionOptionsDisableModelCompile = "session.disable_model_compile";
+
+// Enables TunableOp for the CPU execution provider. Tunable kernels, currently the float Gemm and MatMul, run with the
+// MLAS thread partition recorded for their shape in the tuning results of the session. The results can be read and
+// loaded with the session's GetTuningResults/SetTuningResults or stored in the model metadata.
+// Option values:
+// - "0": TunableOp is disabled. [DEFAULT]
+// - "1": TunableOp is enabled.
+static const char* const kOrtSessionOptionsCpuTunableOpEnable = "session.cpu_tunable_op_enable";
+
+// Enables tuning for the CPU TunableOp. A tunable kernel whose shape has no tuning result yet benchmarks the
+// candidate thread partitions on its first run and records the fastest. Has no effect unless
+// "session.cpu_tunable_op_enable" is "1".
+// Option values:
+// - "0": Tuning is disabled, kernels without a tuning result use the default partition. [DEFAULT]
+// - "1": Tuning is enabled.
+static const char* const kOrtSessionOptionsCpuTunableOpTuningEnable = "session.cpu_tunable_op_tuning_enable";
+
+// The maximum time in milliseconds spent benchmarking each candidate of a CPU TunableOp. The default of "0" sets no
+// limit and each candidate runs the maximum number of tuning iterations.
+static const char* const kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs =
+    "session.cpu_tunable_op_max_tuning_duration_ms";
@@ -253,84 +253,63 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
     const auto* weights_data = weights ? weights->Data<T>() : nullptr;
     const auto* bias_data = bias->Data<T>();
 
-    // We use Q/K head size to estimate the cost, this is not accurate when Q/K and V head sizes are different.
-    const double cost = static_cast<double>(sequence_length) *
-                        static_cast<double>(parameters.head_size) * static_cast<double>(input_hidden_size);
-
-    ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
-      for (std::ptrdiff_t i = begin; i != end; ++i) {
-        const int batch_index = static_cast<int>((i / 3) / num_heads_);
-        const int head_index = static_cast<int>((i / 3) % num_heads_);
-        const int qkv_index = static_cast<int>(i % 3);
-
-        int input_offset = batch_index * sequence_length * input_hidden_size;
-
-        T* qkv_dest = QKV[qkv_index];
-        int head_size = qkv_head_size[qkv_index];
-        int weights_offset = 0;
-        int bias_offset = qkv_index * parameters.hidden_size + head_index * head_size;
-
-        if (!is_prepack_) {
-          weights_offset = bias_offset;
-        } else {
-          weights_offset = head_index * head_size;
-        }
-
-        int qkv_offset = (batch_index * num_heads_ + head_index) * (sequence_length * head_size);
-
-        // TODO!! memcpy here makes it not worthwhile to use Gemm batch. Possible to post process?
-        // broadcast NH -> (B.N.S.H) for each of Q, K, V
-        const T* broadcast_data_src = bias_data + bias_offset;
-        T* broadcast_data_dest = QKV[qkv_index] + qkv_offset;
-
-        for (int seq_index = 0; seq_index < sequence_length; seq_index++) {
-          memcpy(broadcast_data_dest, broadcast_data_src, head_size * sizeof(T));
-          broadcast_data_dest += head_size;
-        }
-
-        //                   original           transposed            iteration
-        // A: input          (BxSxD_i)          (B.)S x D_i           S x D_i
-        // B: weights        (D_ixNxH_t)        D_i x (N.)H_t         D_i x H_t
-        // C: QKV[qkv_index] (BxNxSxH_t)        (B.N.)S x H_t         S x H_t
-        // Here H_t = H + H + H_v is size of one head of Q, K and V
-        if (is_prepack_) {
-          uint8_t* packed_weight;
-          packed_weight = static_cast<uint8_t*>(packed_weights_[qkv_index].get()) +
-                          packed_weights_size_[qkv_index] * (weights_offset / head_size);
-
-          MlasGemm(
-              CblasNoTrans,               // TransA = no
-              sequence_length,            // M      = S
-              head_size,                  // N      = H
-              input_hidden_size,          // K      = D
-              1.0f,                       // alpha
-              input_data + input_offset,  // A
-              input_hidden_size,          // lda    = D
-              packed_weight,              // B
-              1.0f,                       // beta
-              qkv_dest + qkv_offset,      // C
-              head_size,                  // ldc
-              nullptr);                   // use single-thread
-        } else {
-          math::GemmEx<float, ThreadPool>(
-              CblasNoTrans,                   // TransA = no
-              CblasNoTrans,                   // TransB = no
-              sequence_length,                // M      = S
-              head_size,                      // N      = H
-              input_hidden_size,              // K      = D
-              1.0f,                           // alpha
-              input_data + input_offset,      // A
-              input_hidden_size,              // lda    = D
-              weights_data + weights_offset,  // B
-              qkv_hidden_size,                // ldb    = D + D + D_v
-              1.0f,                           // beta
-              qkv_dest + qkv_offset,          // C
-              head_size,                      // ldc
-              nullptr                         // use single-thread
-          );
-        }
+    // The bias of each head is added by the GEMM epilogue, which is shared by all batches.
+    std::vector<MLAS_SGEMM_EPILOGUE> epilogues(3 * static_cast<size_t>(num_heads_));
+    std::vector<MLAS_SGEMM_GROUPED_PARAMS> gemm_params(static_cast<size_t>(loop_len));
+
+    for (int i = 0; i < loop_len; i++) {
+      const int batch_index = (i / 3) / num_heads_;
+      const int head_index = (i / 3) % num_heads_;
+      const int qkv_index = i % 3;
+
+      int input_offset = batch_index * sequence_length * input_hidden_size;
+
+      T* qkv_dest = QKV[qkv_index];
+      int head_size = qkv_head_size[qkv_index];
+      int weights_offset = 0;
+      int bias_offset = qkv_index * parameters.hidden_size + head_index * head_size;
+
+      if (!is_prepack_) {
+        weights_offset = bias_offset;
+      } else {
+        weights_offset = head_index * head_size;
       }
-    });
+
+      int qkv_offset = (batch_index * num_heads_ + head_index) * (sequence_length * head_size);
+
+      // broadcast NH -> (B.N.S.H) for each of Q, K, V
+      MLAS_SGEMM_EPILOGUE& epilogue = epilogues[qkv_index * num_heads_ + head_index];
+      epilogue.Bias = bias_data + bias_offset;
+
+      //                   original           transposed            iteration
+      // A: input          (BxSxD_i)          (B.)S x D_i           S x D_i
+      // B: weights        (D_ixNxH_t)        D_i x (N.)H_t         D_i x H_t
+      // C: QKV[qkv_index] (BxNxSxH_t)        (B.N.)S x H_t         S x H_t
+      // Here H_t = H + H + H_v is size of one head of Q, K and V
+      MLAS_SGEMM_GROUPED_PARAMS& gemm = gemm_params[i];
+      gemm.M = sequence_length;                             // M      = S
+      gemm.N = head_size;                                   // N      = H
+      gemm.K = input_hidden_size;                           // K      = D
+      gemm.Data.A = input_data + input_offset;              // A
+      gemm.Data.lda = input_hidden_size;                    // lda    = D
+      gemm.Data.C = qkv_dest + qkv_offset;                  // C
+      gemm.Data.ldc = head_size;                            // ldc
+      gemm.Data.Epilogue = &epilogue;
+
+      if (is_prepack_) {
+        const uint8_t* packed_weight = static_cast<const uint8_t*>(packed_weights_[qkv_index].get()) +
+                                       packed_weights_size_[qkv_index] * (weights_offset / head_size);
+        gemm.Data.B = reinterpret_cast<const float*>(packed_weight);
+        gemm.Data.BIsPacked = true;
+      } else {
+        gemm.Data.B = weights_data + weights_offset;        // B
+        gemm.Data.ldb = qkv_hidden_size;                    // ldb    = D + D + D_v
+      }
+    }
+
+    // The Q and K heads have a different shape from the V heads when their head sizes differ, so the
+    // multiplications are issued as a group and partitioned across the thread pool by their complexity.
+    MlasGemmGrouped(gemm_params.data(), gemm_params.size(), tp);
   }
 
   // Compute the attention score and apply the score to V
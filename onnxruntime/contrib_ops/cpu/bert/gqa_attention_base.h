@@ -12,6 +12,11 @@
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
 namespace onnxruntime {
 namespace contrib {
 
@@ -76,14 +81,6 @@ class GQAAttentionBase {
     }
     int seqlen_present_kv_cache = static_cast<int>(present_key->Shape().GetDims()[2]);
 
-    // Compute the attention score.
-    bool gqa_mlas_supported = MlasGQASupported<T>(CblasNoTrans, CblasTrans) &&
-                              MlasGQASupported<T>(CblasNoTrans, CblasNoTrans);
-    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache *
-                   (gqa_mlas_supported ? sizeof(T) : sizeof(float));
-    auto attention_probs = allocator->Alloc(bytes);
-    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
-
     const T* past_key_data = past_key != nullptr ? past_key->Data<T>() : nullptr;
     T* present_key_data = present_key != nullptr ? present_key->MutableData<T>() : nullptr;
     const T* past_value_data = past_value != nullptr ? past_value->Data<T>() : nullptr;
@@ -96,6 +93,28 @@ class GQAAttentionBase {
 
     const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
 
+    // Token generation with fewer heads than threads: split the sequence across threads as well.
+    if (sequence_length == 1 && !is_prompt) {
+      const size_t num_splits = DecodeSplitCount(batch_size, static_cast<size_t>(parameters.total_sequence_length), tp);
+      if (num_splits > 1) {
+        const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * head_size : V;
+        ComputeDecodeAttentionSplitKV(output->MutableData<T>(), Q, k, v, seqlens_k->Data<int32_t>(),
+                                      attention_bias_data, attention_bias_shape, batch_size, num_splits,
+                                      seqlen_past_kv_cache, seqlen_present_kv_cache, head_size, past_key_data,
+                                      present_key_data, past_value_data, present_value_data,
+                                      past_present_share_buffer, packed_qkv, tp, allocator);
+        return Status::OK();
+      }
+    }
+
+    // Compute the attention score.
+    bool gqa_mlas_supported = MlasGQASupported<T>(CblasNoTrans, CblasTrans) &&
+                              MlasGQASupported<T>(CblasNoTrans, CblasNoTrans);
+    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache *
+                   (gqa_mlas_supported ? sizeof(T) : sizeof(float));
+    auto attention_probs = allocator->Alloc(bytes);
+    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+
     if (gqa_mlas_supported) {
       ComputeAttentionProbs(static_cast<T*>(attention_probs), Q, k, seqlens_k->Data<int32_t>(), attention_bias_data,
                             batch_size, sequence_length, attention_bias_shape, seqlen_past_kv_cache, seqlen_present_kv_cache,
@@ -127,7 +146,220 @@ class GQAAttentionBase {
     return Status::OK();
   }
 
- private:
+  // Same as ApplyAttention, with past and present key/value stored as int8. A cached key is key / k_scale[head]
+  // rounded to int8, likewise for values. The new key/value rows are quantized into the present cache and the
+  // attention is computed one query row at a time with the int8 dot products of MLAS, so the cache is never
+  // dequantized to a buffer. Scores and probabilities are kept in float for both float and float16 inputs.
+  template <typename T>
+  Status ApplyQuantizedKVAttention(const T* Q,                                 // Q data with shape BxNxSxH
+                                   const T* K,                                 // K data with shape BxN_kvxSxH
+                                   const T* V,                                 // V data with shape BxN_kvxSxH
+                                   const Tensor* attention_bias,               // Attention bias to add to QxK'
+                                   const Tensor* past_key,                     // past K input tensor with int8 data
+                                   const Tensor* past_value,                   // past V input tensor with int8 data
+                                   const Tensor* k_scale,                      // scale of K with shape N_kv or 1
+                                   const Tensor* v_scale,                      // scale of V with shape N_kv or 1
+                                   Tensor* output,                             // output tensor
+                                   Tensor* present_key,                        // present K output tensor with int8 data
+                                   Tensor* present_value,                      // present V output tensor with int8 data
+                                   const Tensor* seqlens_k,                    // past sequence lengths tensor
+                                   GroupQueryAttentionParameters& parameters,  // attention parameters
+                                   OpKernelContext* context) const {
+    const bool is_prompt = parameters.is_first_prompt;
+    const size_t batch_size = static_cast<size_t>(parameters.batch_size);
+    const size_t sequence_length = static_cast<size_t>(parameters.sequence_length);
+    const size_t head_size = static_cast<size_t>(parameters.head_size);
+    const bool packed_qkv = parameters.is_packed_qkv;
+    const int32_t* seqlens = seqlens_k->Data<int32_t>();
+
+    auto* tp = context->GetOperatorThreadPool();
+
+    const size_t past_buffer_sequence_length = past_key != nullptr ? static_cast<size_t>(past_key->Shape()[2]) : 0;
+    const size_t present_buffer_sequence_length = static_cast<size_t>(present_key->Shape()[2]);
+
+    const int8_t* past_key_data = past_key != nullptr ? past_key->Data<int8_t>() : nullptr;
+    const int8_t* past_value_data = past_value != nullptr ? past_value->Data<int8_t>() : nullptr;
+    int8_t* present_key_data = present_key->MutableData<int8_t>();
+    int8_t* present_value_data = present_value->MutableData<int8_t>();
+    const bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
+
+    const float* k_scale_data = k_scale->Data<float>();
+    const float* v_scale_data = v_scale->Data<float>();
+    const bool k_scale_per_head = k_scale->Shape().Size() != 1;
+    const bool v_scale_per_head = v_scale->Shape().Size() != 1;
+
+    const T* attention_bias_data = attention_bias != nullptr ? attention_bias->Data<T>() : nullptr;
+    auto attention_bias_shape = attention_bias != nullptr ? attention_bias->Shape().GetDims() : gsl::span<const int64_t>{};
+
+    const size_t kv_num_heads_factor = num_heads_ / kv_num_heads_;
+    const size_t chunk_length = sequence_length * head_size;                              // S x H
+    const size_t past_buff_chunk_length = past_buffer_sequence_length * head_size;        // L x H
+    const size_t present_buff_chunk_length = present_buffer_sequence_length * head_size;  // T x H
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * chunk_length : SafeInt<ptrdiff_t>(0);
+
+    const T* k = packed_qkv ? Q + num_heads_ * chunk_length : K;
+    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * chunk_length : V;
+
+    // Quantize the new keys and values into the present cache, once per kv head.
+    TensorOpCost quantize_cost;
+    quantize_cost.bytes_loaded = static_cast<double>(2 * chunk_length * sizeof(T));
+    quantize_cost.bytes_stored = static_cast<double>(2 * present_buff_chunk_length);
+    quantize_cost.compute_cycles = static_cast<double>(2 * chunk_length * 4);
+
+    const size_t kv_loop_len = batch_size * kv_num_heads_;
+    ThreadPool::TryParallelFor(tp, kv_loop_len, quantize_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      std::vector<float> new_rows;
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const size_t batch_index = i / kv_num_heads_;
+        const size_t kv_head_index = i % kv_num_heads_;
+        const size_t total_seqlen = static_cast<size_t>(seqlens[batch_index]) + 1;
+        const size_t past_seqlen = is_prompt ? 0 : total_seqlen - sequence_length;  // Assume no padding sequence length
+        const size_t input_offset = packed_qkv ? packed_batch_stride * batch_index + chunk_length * kv_head_index
+                                               : chunk_length * i;
+
+        const float scales[2] = {k_scale_data[k_scale_per_head ? kv_head_index : 0],
+                                 v_scale_data[v_scale_per_head ? kv_head_index : 0]};
+        const int8_t* pasts[2] = {past_key_data, past_value_data};
+        int8_t* presents[2] = {present_key_data, present_value_data};
+        const T* inputs[2] = {k + input_offset, v + input_offset};
+
+        for (size_t kv = 0; kv < 2; kv++) {
+          int8_t* present = presents[kv] + i * present_buff_chunk_length;
+          if (!past_present_share_buffer) {
+            if (past_seqlen > 0) {
+              memcpy(present, pasts[kv] + i * past_buff_chunk_length, past_seqlen * head_size);
+            }
+            if (past_seqlen + sequence_length < present_buffer_sequence_length) {
+              memset(present + (past_seqlen + sequence_length) * head_size, 0,
+                     (present_buffer_sequence_length - past_seqlen - sequence_length) * head_size);
+            }
+          }
+
+          const float* input;
+          if constexpr (std::is_same<T, float>::value) {
+            input = inputs[kv];
+          } else {
+            new_rows.resize(chunk_length);
+            MlasConvertHalfToFloatBuffer(inputs[kv], new_rows.data(), chunk_length);
+            input = new_rows.data();
+          }
+          MlasQuantizeLinear<int8_t>(input, present + past_seqlen * head_size, chunk_length, scales[kv], 0);
+        }
+      }
+    });
+
+    // Compute softmax(Q x K') x V one query row at a time on the int8 cache.
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    T* output_data = output->MutableData<T>();
+
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles =
+        static_cast<double>(SafeInt<ptrdiff_t>(4) * sequence_length * head_size * present_buffer_sequence_length);
+    unit_cost.bytes_loaded = static_cast<double>(2 * present_buff_chunk_length + chunk_length * sizeof(T));
+    unit_cost.bytes_stored = static_cast<double>(chunk_length * sizeof(T));
+
+    const size_t loop_len = batch_size * num_heads_;
+    ThreadPool::TryParallelFor(tp, loop_len, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      std::vector<float> probs(present_buffer_sequence_length);
+      std::vector<float> q_fp32;
+      std::vector<float> bias_fp32;
+      std::vector<float> output_fp32;
+      if constexpr (!std::is_same<T, float>::value) {
+        q_fp32.resize(head_size);
+        output_fp32.resize(head_size);
+      }
+
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const size_t batch_index = i / num_heads_;
+        const size_t head_index = i % num_heads_;
+        const size_t kv_head_index = head_index / kv_num_heads_factor;
+        const size_t total_seqlen = static_cast<size_t>(seqlens[batch_index]) + 1;
+        const size_t past_seqlen = is_prompt ? 0 : total_seqlen - sequence_length;  // Assume no padding sequence length
+
+        const T* q = Q + (packed_qkv ? packed_batch_stride * batch_index + chunk_length * head_index
+                                     : chunk_length * i);
+        const size_t cache_offset = (batch_index * kv_num_heads_ + kv_head_index) * present_buff_chunk_length;
+        const int8_t* key_cache = present_key_data + cache_offset;
+        const int8_t* value_cache = present_value_data + cache_offset;
+        const float key_scale = alpha * k_scale_data[k_scale_per_head ? kv_head_index : 0];
+        const float value_scale = v_scale_data[v_scale_per_head ? kv_head_index : 0];
+
+        // Attention bias is of shape (B or 1, H or 1, S, T) so handle broadcasting
+        const T* attention_bias_thread = nullptr;
+        ptrdiff_t attention_total_seqlen = 0;
+        if (attention_bias_data != nullptr) {
+          attention_total_seqlen = static_cast<ptrdiff_t>(attention_bias_shape[3]);
+          const ptrdiff_t attention_matrix_size = sequence_length * attention_total_seqlen;
+          ptrdiff_t attention_bias_offset = 0;
+          if (attention_bias_shape[0] != 1) {
+            attention_bias_offset += SafeInt<ptrdiff_t>(batch_index) * attention_bias_shape[1] * attention_matrix_size;
+          }
+          if (attention_bias_shape[1] != 1) {
+            attention_bias_offset += SafeInt<ptrdiff_t>(head_index) * attention_matrix_size;
+          }
+          attention_bias_thread = attention_bias_data + attention_bias_offset;
+        }
+
+        for (size_t seq = 0; seq < sequence_length; seq++) {
+          const size_t seq_causal_length = past_seqlen + seq + 1;
+
+          // local_window_size does not include the current query token, while window_size includes it.
+          const bool should_apply_local_window = local_window_size_ >= 0 &&
+                                                 seq_causal_length > static_cast<size_t>(local_window_size_) + 1;
+          const size_t start_offset = should_apply_local_window ? seq_causal_length - local_window_size_ - 1 : 0;
+          const size_t window_size = should_apply_local_window ? local_window_size_ + 1 : seq_causal_length;
+
+          const float* q_row;
+          if constexpr (std::is_same<T, float>::value) {
+            q_row = q + seq * head_size;
+          } else {
+            MlasConvertHalfToFloatBuffer(q + seq * head_size, q_fp32.data(), head_size);
+            q_row = q_fp32.data();
+          }
+
+          MlasAttentionScoresS8(q_row, key_cache + start_offset * head_size, probs.data(), window_size, head_size,
+                                key_scale);
+
+          if (softcap_ > 0.f) {
+            ComputeAttentionSoftcapInplace(probs.data(), static_cast<int>(window_size), softcap_);
+          }
+
+          if (attention_bias_thread != nullptr) {
+            const T* bias_row = attention_bias_thread + seq * attention_total_seqlen + start_offset;
+            if constexpr (std::is_same<T, float>::value) {
+              ApplyAttentionBias(probs.data(), bias_row, static_cast<int>(window_size));
+            } else {
+              bias_fp32.resize(window_size);
+              MlasConvertHalfToFloatBuffer(bias_row, bias_fp32.data(), window_size);
+              ApplyAttentionBias(probs.data(), bias_fp32.data(), static_cast<int>(window_size));
+            }
+          }
+
+          if (use_smooth_softmax_) {
+            ComputeSmoothSoftmaxInplace(probs.data(), 1, static_cast<int>(window_size), nullptr);
+          } else {
+            ComputeAttentionSoftmaxInplace(probs.data(), 1, static_cast<int>(window_size), nullptr);
+          }
+
+          // output is BxSxNxH
+          T* output_row = output_data + ((batch_index * sequence_length + seq) * num_heads_ + head_index) * head_size;
+          if constexpr (std::is_same<T, float>::value) {
+            MlasAttentionValuesS8(probs.data(), value_cache + start_offset * head_size, output_row, window_size,
+                                  head_size, value_scale);
+          } else {
+            MlasAttentionValuesS8(probs.data(), value_cache + start_offset * head_size, output_fp32.data(),
+                                  window_size, head_size, value_scale);
+            MlasConvertFloatToHalfBuffer(output_fp32.data(), output_row, head_size);
+          }
+        }
+      }
+    });
+
+    return Status::OK();
+  }
+
+ protected:
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T)
   //  attention_probs(B, N, S, T) = Softmax(attention_probs)
@@ -455,6 +687,224 @@ class GQAAttentionBase {
                                    SafeInt<size_t>(sequence_length) * batch_size * num_heads_ * head_size);
     }
   }
+
+  // Minimum number of past tokens per split of the decoding attention. Shorter splits don't amortize the merge.
+  static constexpr size_t kMinDecodeSplitLength = 256;
+
+  // Number of splits of the sequence for the decoding attention of each head, so that all threads get work when
+  // batch_size x num_heads is smaller than the number of threads. Returns 1 when splitting is not worth it.
+  size_t DecodeSplitCount(size_t batch_size, size_t total_sequence_length, ThreadPool* tp) const {
+    const size_t loop_len = batch_size * num_heads_;
+    const size_t num_threads = static_cast<size_t>(ThreadPool::DegreeOfParallelism(tp));
+    if (loop_len >= num_threads) {
+      return 1;
+    }
+
+    const size_t max_splits = total_sequence_length / kMinDecodeSplitLength;
+    return std::max<size_t>(1, std::min((num_threads + loop_len - 1) / loop_len, max_splits));
+  }
+
+  // Attention of one new token per batch entry, with the sequence of each head split into num_splits parts that run
+  // in parallel (flash decoding). Each part computes the maximum score, the sum of exp(score - maximum) and the
+  // unnormalized output of its tokens, then the parts of a head are rescaled to the common maximum and added up.
+  // The present key and value are concatenated first, once per kv head.
+  template <typename T>
+  void ComputeDecodeAttentionSplitKV(T* output,                                            // output with size BxNxH
+                                     const T* Q,                                           // Q data with size BxNxH
+                                     const T* K,                                           // new K with size BxN_kvxH
+                                     const T* V,                                           // new V with size BxN_kvxH
+                                     const int32_t* seqlens_k,                             // total - 1 sequence lengths
+                                     const T* attention_bias,                              // optional attention bias
+                                     const gsl::span<const int64_t> attention_bias_shape,  // shape of attention bias
+                                     const size_t batch_size,                              // batch size
+                                     const size_t num_splits,                              // number of splits per head
+                                     const size_t past_buffer_sequence_length,             // sequence length of past
+                                     const size_t present_buffer_sequence_length,          // sequence length of present
+                                     const size_t head_size,                               // head size
+                                     const T* past_key,                                    // past key only
+                                     T* present_key,                                       // present key only
+                                     const T* past_value,                                  // past value only
+                                     T* present_value,                                     // present value only
+                                     const bool past_present_share_buffer,                 // present shares past buffer
+                                     const bool packed_qkv,                                // whether Q, K, V are packed
+                                     ThreadPool* tp,                                       // thread pool
+                                     AllocatorPtr allocator) const {                       // allocator for scratch
+    const size_t kv_num_heads_factor = num_heads_ / kv_num_heads_;
+    const size_t packed_batch_stride = packed_qkv ? (num_heads_ + 2 * kv_num_heads_) * head_size : 0;
+    const size_t past_buff_chunk_length = past_buffer_sequence_length * head_size;
+    const size_t present_buff_chunk_length = present_buffer_sequence_length * head_size;
+
+    if (!past_present_share_buffer) {
+      memset((void*)present_key, 0, batch_size * kv_num_heads_ * present_buff_chunk_length * sizeof(T));
+      memset((void*)present_value, 0, batch_size * kv_num_heads_ * present_buff_chunk_length * sizeof(T));
+    }
+
+    TensorOpCost concat_cost;
+    concat_cost.bytes_loaded = static_cast<double>(2 * present_buff_chunk_length * sizeof(T));
+    concat_cost.bytes_stored = concat_cost.bytes_loaded;
+    concat_cost.compute_cycles = 0;
+
+    const size_t kv_loop_len = batch_size * kv_num_heads_;
+    ThreadPool::TryParallelFor(tp, kv_loop_len, concat_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const size_t batch_index = i / kv_num_heads_;
+        const size_t kv_head_index = i % kv_num_heads_;
+        const size_t past_chunk_length = static_cast<size_t>(seqlens_k[batch_index]) * head_size;
+        const size_t input_offset = packed_qkv ? packed_batch_stride * batch_index + kv_head_index * head_size
+                                               : i * head_size;
+        ConcatStateChunkGQA(past_key, K + input_offset, present_key, present_buff_chunk_length,
+                            past_buff_chunk_length, past_chunk_length, head_size, past_present_share_buffer, i);
+        ConcatStateChunkGQA(past_value, V + input_offset, present_value, present_buff_chunk_length,
+                            past_buff_chunk_length, past_chunk_length, head_size, past_present_share_buffer, i);
+      }
+    });
+
+    // Each split stores its maximum score, its sum of exponentials and its unnormalized output.
+    const size_t loop_len = batch_size * num_heads_;
+    const size_t partial_length = head_size + 2;
+    const size_t partial_bytes = SafeInt<size_t>(loop_len) * num_splits * partial_length * sizeof(float);
+    auto partials_buffer = allocator->Alloc(partial_bytes);
+    BufferUniquePtr partials_deleter(partials_buffer, BufferDeleter(allocator));
+    float* partials = static_cast<float*>(partials_buffer);
+
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    const size_t split_length_hint = (present_buffer_sequence_length + num_splits - 1) / num_splits;
+
+    TensorOpCost unit_cost;
+    unit_cost.bytes_loaded = static_cast<double>(2 * split_length_hint * head_size * sizeof(T));
+    unit_cost.bytes_stored = static_cast<double>(partial_length * sizeof(float));
+    unit_cost.compute_cycles = static_cast<double>(4 * split_length_hint * head_size);
+
+    ThreadPool::TryParallelFor(tp, loop_len * num_splits, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      std::vector<float> scores;
+      std::vector<float> q_fp32;
+      std::vector<float> kv_fp32;
+      std::vector<float> bias_fp32;
+
+      for (std::ptrdiff_t task = begin; task != end; ++task) {
+        const size_t i = task / num_splits;
+        const size_t split = task % num_splits;
+        const size_t batch_index = i / num_heads_;
+        const size_t head_index = i % num_heads_;
+        const size_t kv_index = batch_index * kv_num_heads_ + head_index / kv_num_heads_factor;
+        const size_t total_seqlen = static_cast<size_t>(seqlens_k[batch_index]) + 1;
+
+        // local_window_size does not include the current query token, while window_size includes it.
+        const bool should_apply_local_window = local_window_size_ >= 0 &&
+                                               total_seqlen > static_cast<size_t>(local_window_size_) + 1;
+        const size_t window_start = should_apply_local_window ? total_seqlen - local_window_size_ - 1 : 0;
+        const size_t window_size = total_seqlen - window_start;
+        const size_t split_length = (window_size + num_splits - 1) / num_splits;
+        const size_t start = window_start + std::min(window_size, split * split_length);
+        const size_t length = std::min(split_length, total_seqlen - start);
+
+        float* partial = partials + task * partial_length;
+        float* partial_output = partial + 2;
+        if (length == 0) {
+          partial[0] = std::numeric_limits<float>::lowest();
+          partial[1] = 0.0f;
+          continue;
+        }
+
+        const T* q = packed_qkv ? Q + packed_batch_stride * batch_index + head_index * head_size
+                                : Q + i * head_size;
+        const T* k = present_key + kv_index * present_buff_chunk_length + start * head_size;
+        const T* v = present_value + kv_index * present_buff_chunk_length + start * head_size;
+
+        const float* q_float;
+        const float* k_float;
+        if constexpr (std::is_same<T, float>::value) {
+          q_float = q;
+          k_float = k;
+        } else {
+          q_fp32.resize(head_size);
+          kv_fp32.resize(length * head_size);
+          MlasConvertHalfToFloatBuffer(q, q_fp32.data(), head_size);
+          MlasConvertHalfToFloatBuffer(k, kv_fp32.data(), length * head_size);
+          q_float = q_fp32.data();
+          k_float = kv_fp32.data();
+        }
+
+        scores.resize(length);
+        math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasTrans, 1, length, head_size, alpha, q_float,
+                                        static_cast<int>(head_size), k_float, static_cast<int>(head_size),
+                                        0.0f /*beta*/, scores.data(), static_cast<int>(length), nullptr);
+
+        if (softcap_ > 0.f) {
+          ComputeAttentionSoftcapInplace(scores.data(), static_cast<int>(length), softcap_);
+        }
+
+        // Attention bias is of shape (B or 1, H or 1, 1, T) so handle broadcasting
+        if (attention_bias != nullptr) {
+          ptrdiff_t attention_bias_offset = static_cast<ptrdiff_t>(start);
+          if (attention_bias_shape[0] != 1) {
+            attention_bias_offset +=
+                SafeInt<ptrdiff_t>(batch_index) * attention_bias_shape[1] * attention_bias_shape[3];
+          }
+          if (attention_bias_shape[1] != 1) {
+            attention_bias_offset += SafeInt<ptrdiff_t>(head_index) * attention_bias_shape[3];
+          }
+          if constexpr (std::is_same<T, float>::value) {
+            ApplyAttentionBias(scores.data(), attention_bias + attention_bias_offset, static_cast<int>(length));
+          } else {
+            bias_fp32.resize(length);
+            MlasConvertHalfToFloatBuffer(attention_bias + attention_bias_offset, bias_fp32.data(), length);
+            ApplyAttentionBias(scores.data(), bias_fp32.data(), static_cast<int>(length));
+          }
+        }
+
+        const float maximum = *std::max_element(scores.begin(), scores.end());
+        float sum = 0.0f;
+        for (float& score : scores) {
+          score = std::exp(score - maximum);
+          sum += score;
+        }
+        partial[0] = maximum;
+        partial[1] = sum;
+
+        const float* v_float;
+        if constexpr (std::is_same<T, float>::value) {
+          v_float = v;
+        } else {
+          MlasConvertHalfToFloatBuffer(v, kv_fp32.data(), length * head_size);
+          v_float = kv_fp32.data();
+        }
+        math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasNoTrans, 1, head_size, length, 1.0f, scores.data(),
+                                        static_cast<int>(length), v_float, static_cast<int>(head_size),
+                                        0.0f /*beta*/, partial_output, static_cast<int>(head_size), nullptr);
+      }
+    });
+
+    // Merge the splits of each head. Smooth softmax adds exp(0 - maximum) to the sum, with a maximum of at least 0.
+    std::vector<float> merged(head_size);
+    for (size_t i = 0; i < loop_len; i++) {
+      const float* head_partials = partials + i * num_splits * partial_length;
+      float maximum = use_smooth_softmax_ ? 0.0f : std::numeric_limits<float>::lowest();
+      for (size_t split = 0; split < num_splits; split++) {
+        maximum = std::max(maximum, head_partials[split * partial_length]);
+      }
+
+      float sum = use_smooth_softmax_ ? std::exp(-maximum) : 0.0f;
+      std::fill(merged.begin(), merged.end(), 0.0f);
+      for (size_t split = 0; split < num_splits; split++) {
+        const float* partial = head_partials + split * partial_length;
+        if (partial[1] == 0.0f) {
+          continue;
+        }
+        const float rescale = std::exp(partial[0] - maximum);
+        sum += partial[1] * rescale;
+        for (size_t h = 0; h < head_size; h++) {
+          merged[h] += partial[2 + h] * rescale;
+        }
+      }
+
+      // output is BxSxNxH with S = 1
+      T* output_current = output + i * head_size;
+      for (size_t h = 0; h < head_size; h++) {
+        output_current[h] = static_cast<T>(merged[h] / sum);
+      }
+    }
+  }
 };
 
 }  // namespace contrib
@@ -22,16 +22,17 @@ namespace onnxruntime {
 namespace contrib {
 
 // These ops are internal-only, so register outside of onnx
-#define REGISTER_KERNEL_TYPED(T)                                        \
-  ONNX_OPERATOR_TYPED_KERNEL_EX(                                        \
-      GroupQueryAttention,                                              \
-      kMSDomain,                                                        \
-      1,                                                                \
-      T,                                                                \
-      kCpuExecutionProvider,                                            \
-      KernelDefBuilder()                                                \
-          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())        \
-          .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()), \
+#define REGISTER_KERNEL_TYPED(T)                                                                                \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                                                \
+      GroupQueryAttention,                                                                                      \
+      kMSDomain,                                                                                                \
+      1,                                                                                                        \
+      T,                                                                                                        \
+      kCpuExecutionProvider,                                                                                    \
+      KernelDefBuilder()                                                                                        \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())                                                \
+          .TypeConstraint("T_CACHE", {DataTypeImpl::GetTensorType<T>(), DataTypeImpl::GetTensorType<int8_t>()}) \
+          .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()),                                         \
       GroupQueryAttention<T>);
 
 REGISTER_KERNEL_TYPED(float)
@@ -54,6 +55,8 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   const Tensor* sin_cache = context->Input<Tensor>(8);
   const Tensor* position_ids = context->Input<Tensor>(9);
   const Tensor* attention_bias = context->Input<Tensor>(10);
+  const Tensor* k_scale = context->Input<Tensor>(11);
+  const Tensor* v_scale = context->Input<Tensor>(12);
 
   GroupQueryAttentionParameters parameters = {};
   ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckInputs(query,
@@ -92,6 +95,7 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   std::vector<int64_t> present_v_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
   Tensor* present_k = context->Output(1, present_k_shape);
   Tensor* present_v = context->Output(2, present_v_shape);
+  ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckQuantizedKVCache(present_k, k_scale, v_scale, kv_num_heads_));
 
   AllocatorPtr allocator;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
@@ -204,6 +208,13 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
 
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
 
+  if (present_k->IsDataType<int8_t>()) {
+    return ApplyQuantizedKVAttention(q_rotary, packed_qkv ? nullptr : k_rotary,
+                                     packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(), attention_bias, past_key,
+                                     past_value, k_scale, v_scale, output, present_k, present_v, seqlens_k, parameters,
+                                     context);
+  }
+
   // Compute the attention score and apply the score to V
   return ApplyAttention(q_rotary, packed_qkv ? nullptr : k_rotary, packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(),
                         attention_bias, past_key, past_value, output, present_k, present_v,
@@ -380,6 +380,34 @@ Status CheckCustomAttentionInputs(const T* position_ids,
   return Status::OK();
 }
 
+// The kv cache is quantized when present_key is int8. Past and present key/value share the type constraint, so only
+// the scales need checking: both are required and have shape (kv_num_heads) or (1).
+template <typename T = Tensor>
+Status CheckQuantizedKVCache(const T* present_key,
+                             const T* k_scale,
+                             const T* v_scale,
+                             int kv_num_heads) {
+  if (!present_key->template IsDataType<int8_t>()) {
+    return Status::OK();
+  }
+
+  if (k_scale == nullptr || v_scale == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Inputs 'k_scale' and 'v_scale' are required when the kv cache is int8.");
+  }
+
+  for (const T* scale : {k_scale, v_scale}) {
+    const auto& scale_shape = scale->Shape();
+    if (scale_shape.NumDimensions() != 1 || (scale_shape[0] != kv_num_heads && scale_shape[0] != 1)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Inputs 'k_scale' and 'v_scale' shall have shape (kv_num_heads) or (1), got ",
+                             scale_shape);
+    }
+  }
+
+  return Status::OK();
+}
+
 }  // namespace group_query_attention_helper
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -0,0 +1,558 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/narrow.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/common.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+namespace {
+
+// Number of elements that an expression is evaluated on at a time, so that the inputs and the intermediate results
+// of a tile stay in the L1 cache while the instructions run.
+constexpr size_t kTileSize = 1024;
+
+enum class ElementwiseOp {
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Neg,
+  Relu,
+  Sigmoid,
+  Tanh,
+  Erf,
+  Exp,
+  Sqrt,
+  Gelu,
+};
+
+struct ElementwiseOpInfo {
+  const char* name;
+  ElementwiseOp op;
+  bool is_binary;
+  // Estimated compute cycles per element.
+  float cost;
+};
+
+constexpr ElementwiseOpInfo kElementwiseOps[] = {
+    {"Add", ElementwiseOp::Add, true, 1.0f},
+    {"Sub", ElementwiseOp::Sub, true, 1.0f},
+    {"Mul", ElementwiseOp::Mul, true, 1.0f},
+    {"Div", ElementwiseOp::Div, true, 2.0f},
+    {"Neg", ElementwiseOp::Neg, false, 1.0f},
+    {"Relu", ElementwiseOp::Relu, false, 1.0f},
+    {"Sigmoid", ElementwiseOp::Sigmoid, false, 2.0f},
+    {"Tanh", ElementwiseOp::Tanh, false, 2.0f},
+    {"Erf", ElementwiseOp::Erf, false, 4.0f},
+    {"Exp", ElementwiseOp::Exp, false, 2.0f},
+    {"Sqrt", ElementwiseOp::Sqrt, false, 2.0f},
+    {"Gelu", ElementwiseOp::Gelu, false, 6.0f},
+};
+
+const ElementwiseOpInfo* GetElementwiseOpInfo(const std::string& name) {
+  for (const auto& info : kElementwiseOps) {
+    if (name == info.name) {
+      return &info;
+    }
+  }
+  return nullptr;
+}
+
+// Computes y = op(a, b) for n elements. y may be the same buffer as a or b, except for Gelu, which reads a after
+// writing y.
+void EvaluateElementwiseOp(ElementwiseOp op, const float* a, const float* b, float* y, size_t n) {
+  const auto len = static_cast<std::ptrdiff_t>(n);
+  ConstEigenVectorArrayMap<float> am(a, len);
+  EigenVectorArrayMap<float> ym(y, len);
+
+  switch (op) {
+    case ElementwiseOp::Add:
+      ym = am + ConstEigenVectorArrayMap<float>(b, len);
+      break;
+    case ElementwiseOp::Sub:
+      ym = am - ConstEigenVectorArrayMap<float>(b, len);
+      break;
+    case ElementwiseOp::Mul:
+      ym = am * ConstEigenVectorArrayMap<float>(b, len);
+      break;
+    case ElementwiseOp::Div:
+      ym = am / ConstEigenVectorArrayMap<float>(b, len);
+      break;
+    case ElementwiseOp::Neg:
+      ym = -am;
+      break;
+    case ElementwiseOp::Relu:
+      ym = am.cwiseMax(0.0f);
+      break;
+    case ElementwiseOp::Sigmoid:
+      MlasComputeLogistic(a, y, n);
+      break;
+    case ElementwiseOp::Tanh:
+      MlasComputeTanh(a, y, n);
+      break;
+    case ElementwiseOp::Erf:
+      MlasComputeErf(a, y, n);
+      break;
+    case ElementwiseOp::Exp:
+      // Same as the Exp kernel, which uses Eigen rather than MlasComputeExp.
+      ym = am.exp();
+      break;
+    case ElementwiseOp::Sqrt:
+      ym = am.sqrt();
+      break;
+    case ElementwiseOp::Gelu:
+      // Same as the Gelu kernel: 0.5 * x * (1 + erf(x / sqrt(2))).
+      for (size_t i = 0; i < n; i++) {
+        y[i] = a[i] * static_cast<float>(M_SQRT1_2);
+      }
+      MlasComputeErf(y, y, n);
+      for (size_t i = 0; i < n; i++) {
+        y[i] = 0.5f * a[i] * (y[i] + 1.0f);
+      }
+      break;
+  }
+}
+
+// Describes how an input, or a value computed on the elements of an input, is read for a range of the output.
+struct BroadcastInput {
+  const float* data;
+  // The input has as many elements as the output, so a range of the output reads the same range of the input.
+  bool is_full;
+  // The input has a single element.
+  bool is_scalar;
+  // Strides of the input for the collapsed output dimensions, 0 for the dimensions that the input is broadcast on.
+  TensorShapeVector strides;
+};
+
+// Copies the input values for the output elements [start, start + count) to dst.
+void GatherBroadcastInput(const BroadcastInput& input, gsl::span<const int64_t> dims,
+                          size_t start, size_t count, float* dst) {
+  const size_t rank = dims.size();
+  const size_t inner_size = narrow<size_t>(dims[rank - 1]);
+  const bool inner_is_broadcast = input.strides[rank - 1] == 0;
+
+  size_t position = start;
+  while (count > 0) {
+    size_t offset = 0;
+    size_t index = position;
+    for (size_t d = rank; d-- > 0;) {
+      const auto dim = static_cast<size_t>(dims[d]);
+      offset += (index % dim) * static_cast<size_t>(input.strides[d]);
+      index /= dim;
+    }
+
+    const size_t run = std::min(inner_size - position % inner_size, count);
+    if (inner_is_broadcast) {
+      std::fill_n(dst, run, input.data[offset]);
+    } else {
+      std::copy_n(input.data + offset, run, dst);
+    }
+
+    dst += run;
+    position += run;
+    count -= run;
+  }
+}
+
+}  // namespace
+
+// Evaluates an expression of elementwise operators created by the ElementwiseFusion transformer.
+//
+// The output is split into tiles of kTileSize elements that are evaluated in parallel. Within a tile, each
+// instruction runs over the whole tile, with the intermediate results kept in tile buffers that are reused once
+// their value is no longer read. Inputs of the output shape are read in place, broadcast inputs are gathered into a
+// tile buffer.
+//
+// Instructions that only read a single broadcast input and constants are evaluated once on the elements of that
+// input before the tiles, and their results are then gathered like the input. Instructions that only read constants
+// are evaluated on a single element.
+class FusedElementwise final : public OpKernel {
+ public:
+  explicit FusedElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  struct Instruction {
+    ElementwiseOp op;
+    int operand0;
+    int operand1;
+    // Tile buffer of the result, or -1 for the last instruction, which writes the output.
+    int buffer;
+    // Estimated compute cycles per element.
+    float cost;
+  };
+
+  size_t num_inputs_;
+  std::vector<float> constants_;
+  std::vector<Instruction> program_;
+  int num_buffers_ = 0;
+};
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+  num_inputs_ = info.GetInputCount();
+  constants_ = info.GetAttrsOrDefault<float>("constants");
+  const auto ops = info.GetAttrsOrDefault<std::string>("ops");
+  const auto operands = info.GetAttrsOrDefault<int64_t>("operands");
+  ORT_ENFORCE(!ops.empty() && operands.size() == 2 * ops.size(),
+              "FusedElementwise needs two operands for each of its ops.");
+
+  const size_t num_leaves = num_inputs_ + constants_.size();
+  const size_t num_values = num_leaves + ops.size();
+
+  // Index of the last instruction that reads each value. A result that is never read is released by the
+  // instruction that computes it.
+  std::vector<size_t> last_use(num_values, 0);
+  program_.reserve(ops.size());
+  for (size_t i = 0; i < ops.size(); i++) {
+    const ElementwiseOpInfo* op_info = GetElementwiseOpInfo(ops[i]);
+    ORT_ENFORCE(op_info != nullptr, "FusedElementwise does not support the ", ops[i], " operator.");
+
+    const int64_t operand0 = operands[2 * i];
+    const int64_t operand1 = operands[2 * i + 1];
+    const auto is_valid_operand = [&](int64_t operand) {
+      return operand >= 0 && operand < static_cast<int64_t>(num_leaves + i);
+    };
+    ORT_ENFORCE(is_valid_operand(operand0) && (op_info->is_binary ? is_valid_operand(operand1) : operand1 == -1),
+                "FusedElementwise instruction ", i, " has invalid operands.");
+
+    program_.push_back({op_info->op, narrow<int>(operand0), narrow<int>(operand1), -1, op_info->cost});
+
+    last_use[num_leaves + i] = i;
+    last_use[narrow<size_t>(operand0)] = i;
+    if (operand1 >= 0) {
+      last_use[narrow<size_t>(operand1)] = i;
+    }
+  }
+
+  // Assign the tile buffers of the intermediate results.
+  std::vector<int> value_buffer(num_values, -1);
+  std::vector<int> free_buffers;
+  for (size_t i = 0; i < program_.size(); i++) {
+    Instruction& instruction = program_[i];
+
+    InlinedVector<int, 2> released;
+    for (int operand : {instruction.operand0, instruction.operand1}) {
+      if (operand >= 0 && last_use[operand] == i && value_buffer[operand] >= 0 &&
+          std::find(released.begin(), released.end(), value_buffer[operand]) == released.end()) {
+        released.push_back(value_buffer[operand]);
+      }
+    }
+
+    const bool can_overwrite_operand = instruction.op != ElementwiseOp::Gelu;
+    if (can_overwrite_operand) {
+      free_buffers.insert(free_buffers.end(), released.begin(), released.end());
+    }
+
+    if (i + 1 < program_.size()) {
+      if (free_buffers.empty()) {
+        free_buffers.push_back(num_buffers_++);
+      }
+      instruction.buffer = free_buffers.back();
+      free_buffers.pop_back();
+      value_buffer[num_leaves + i] = instruction.buffer;
+      if (last_use[num_leaves + i] == i) {
+        free_buffers.push_back(instruction.buffer);
+      }
+    }
+
+    if (!can_overwrite_operand) {
+      free_buffers.insert(free_buffers.end(), released.begin(), released.end());
+    }
+  }
+}
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  const size_t num_leaves = num_inputs_ + constants_.size();
+  const size_t num_values = num_leaves + program_.size();
+
+  InlinedVector<const Tensor*> inputs(num_inputs_);
+  TensorShape output_shape;
+  for (size_t i = 0; i < num_inputs_; i++) {
+    inputs[i] = context->Input<Tensor>(static_cast<int>(i));
+    ORT_RETURN_IF(inputs[i] == nullptr, "FusedElementwise input ", i, " is missing.");
+    if (i == 0) {
+      output_shape = inputs[i]->Shape();
+    } else {
+      ORT_RETURN_IF_ERROR(ComputeBroadcastOutputShape(Node().Name(), output_shape, inputs[i]->Shape(),
+                                                      output_shape));
+    }
+  }
+
+  Tensor* output = context->Output(0, output_shape);
+  const size_t output_size = narrow<size_t>(output_shape.Size());
+  if (output_size == 0) {
+    return Status::OK();
+  }
+
+  // How each value is read for a range of the output. The inputs and the constants are set here, the results of the
+  // instructions that are evaluated before the tiles further down.
+  InlinedVector<BroadcastInput> broadcast_values(num_values);
+  for (size_t i = 0; i < num_inputs_; i++) {
+    const size_t input_size = narrow<size_t>(inputs[i]->Shape().Size());
+    broadcast_values[i].data = inputs[i]->Data<float>();
+    broadcast_values[i].is_full = input_size == output_size;
+    broadcast_values[i].is_scalar = input_size == 1;
+  }
+  for (size_t i = num_inputs_; i < num_leaves; i++) {
+    broadcast_values[i].data = constants_.data() + (i - num_inputs_);
+    broadcast_values[i].is_scalar = true;
+  }
+
+  // Collapse the output dimensions: dimensions of size 1 are dropped, and adjacent dimensions are merged when each
+  // input is broadcast on both or on neither of them.
+  const size_t rank = output_shape.NumDimensions();
+  TensorShapeVector dims;
+  InlinedVector<bool> is_broadcast(num_inputs_);
+  InlinedVector<bool> previous_is_broadcast(num_inputs_);
+  for (size_t d = 0; d < rank; d++) {
+    if (output_shape[d] == 1) {
+      continue;
+    }
+
+    for (size_t i = 0; i < num_inputs_; i++) {
+      const auto& input_shape = inputs[i]->Shape();
+      const size_t input_rank = input_shape.NumDimensions();
+      is_broadcast[i] = d + input_rank < rank || input_shape[d + input_rank - rank] == 1;
+    }
+
+    const bool merge = !dims.empty() && is_broadcast == previous_is_broadcast;
+    if (merge) {
+      dims.back() *= output_shape[d];
+    } else {
+      dims.push_back(output_shape[d]);
+    }
+
+    for (size_t i = 0; i < num_inputs_; i++) {
+      const auto& input_shape = inputs[i]->Shape();
+      const size_t input_rank = input_shape.NumDimensions();
+      const int64_t stride = is_broadcast[i] ? 0 : input_shape.SizeFromDimension(d + input_rank - rank + 1);
+      if (merge) {
+        broadcast_values[i].strides.back() = stride;
+      } else {
+        broadcast_values[i].strides.push_back(stride);
+      }
+    }
+    previous_is_broadcast = is_broadcast;
+  }
+
+  // The input whose elements each value is computed on, kOutputShape for the values computed on the tiles and
+  // kConstantValue for the values that don't read any input. An instruction that reads a single broadcast input has
+  // the elements of that input, and the last instruction always writes the output.
+  constexpr int kOutputShape = -1;
+  constexpr int kConstantValue = -2;
+  InlinedVector<int> value_source(num_values, kConstantValue);
+  for (size_t i = 0; i < num_inputs_; i++) {
+    value_source[i] = broadcast_values[i].is_full ? kOutputShape : static_cast<int>(i);
+  }
+
+  InlinedVector<size_t> hoisted_offset(program_.size(), 0);
+  size_t hoisted_size = 0;
+  float tile_cost = 0.0f;
+  for (size_t j = 0; j < program_.size(); j++) {
+    const Instruction& instruction = program_[j];
+    int source = value_source[instruction.operand0];
+    if (instruction.operand1 >= 0) {
+      const int source1 = value_source[instruction.operand1];
+      if (source == kConstantValue) {
+        source = source1;
+      } else if (source1 != kConstantValue && source1 != source) {
+        source = kOutputShape;
+      }
+    }
+    if (j + 1 == program_.size()) {
+      source = kOutputShape;
+    }
+
+    value_source[num_leaves + j] = source;
+    if (source == kOutputShape) {
+      tile_cost += instruction.cost;
+      continue;
+    }
+
+    BroadcastInput& result = broadcast_values[num_leaves + j];
+    result.is_scalar = source == kConstantValue || broadcast_values[source].is_scalar;
+    if (source != kConstantValue) {
+      result.strides = broadcast_values[source].strides;
+    }
+    hoisted_offset[j] = hoisted_size;
+    hoisted_size += source == kConstantValue ? 1 : narrow<size_t>(inputs[source]->Shape().Size());
+  }
+
+  std::vector<float> hoisted(hoisted_size);
+  for (size_t j = 0; j < program_.size(); j++) {
+    if (value_source[num_leaves + j] != kOutputShape) {
+      broadcast_values[num_leaves + j].data = hoisted.data() + hoisted_offset[j];
+    }
+  }
+
+  // The instructions that only read constants are evaluated on a single element.
+  for (size_t j = 0; j < program_.size(); j++) {
+    const Instruction& instruction = program_[j];
+    if (value_source[num_leaves + j] == kConstantValue) {
+      EvaluateElementwiseOp(instruction.op, broadcast_values[instruction.operand0].data,
+                            instruction.operand1 >= 0 ? broadcast_values[instruction.operand1].data : nullptr,
+                            hoisted.data() + hoisted_offset[j], 1);
+    }
+  }
+
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+  const double bytes_per_tile = static_cast<double>(sizeof(float) * kTileSize);
+
+  // The instructions that read a broadcast input are evaluated on the elements of the input, with the constants that
+  // they read filled into tile buffers.
+  for (size_t i = 0; i < num_inputs_; i++) {
+    InlinedVector<size_t> instructions;
+    InlinedVector<int> constant_operands;
+    float cost = 0.0f;
+    for (size_t j = 0; j < program_.size(); j++) {
+      if (value_source[num_leaves + j] != static_cast<int>(i)) {
+        continue;
+      }
+      instructions.push_back(j);
+      cost += program_[j].cost;
+      for (int operand : {program_[j].operand0, program_[j].operand1}) {
+        if (operand >= 0 && value_source[operand] == kConstantValue &&
+            std::find(constant_operands.begin(), constant_operands.end(), operand) == constant_operands.end()) {
+          constant_operands.push_back(operand);
+        }
+      }
+    }
+    if (instructions.empty()) {
+      continue;
+    }
+
+    const size_t input_size = narrow<size_t>(inputs[i]->Shape().Size());
+    concurrency::ThreadPool::TryParallelFor(
+        thread_pool, static_cast<std::ptrdiff_t>((input_size + kTileSize - 1) / kTileSize),
+        TensorOpCost{bytes_per_tile, bytes_per_tile * static_cast<double>(instructions.size()),
+                     static_cast<double>(cost) * kTileSize},
+        [&](std::ptrdiff_t first_tile, std::ptrdiff_t last_tile) {
+          std::vector<float> scratch(constant_operands.size() * kTileSize);
+          InlinedVector<const float*> filled(num_values, nullptr);
+          for (size_t k = 0; k < constant_operands.size(); k++) {
+            std::fill_n(scratch.data() + k * kTileSize, kTileSize, *broadcast_values[constant_operands[k]].data);
+            filled[constant_operands[k]] = scratch.data() + k * kTileSize;
+          }
+
+          for (std::ptrdiff_t tile = first_tile; tile < last_tile; tile++) {
+            const size_t start = static_cast<size_t>(tile) * kTileSize;
+            const size_t count = std::min(kTileSize, input_size - start);
+            const auto operand_data = [&](int operand) -> const float* {
+              if (operand < 0) {
+                return nullptr;
+              }
+              return filled[operand] != nullptr ? filled[operand] : broadcast_values[operand].data + start;
+            };
+
+            for (size_t j : instructions) {
+              const Instruction& instruction = program_[j];
+              EvaluateElementwiseOp(instruction.op, operand_data(instruction.operand0),
+                                    operand_data(instruction.operand1), hoisted.data() + hoisted_offset[j] + start,
+                                    count);
+            }
+          }
+        });
+  }
+
+  // The tile buffers of a task: the intermediate results, then the broadcast values that the tiles read. The scalars
+  // among them are filled once for all the tiles of the task, the others are gathered for each tile.
+  InlinedVector<bool> is_read_on_tiles(num_values, false);
+  for (size_t j = 0; j < program_.size(); j++) {
+    if (value_source[num_leaves + j] == kOutputShape) {
+      for (int operand : {program_[j].operand0, program_[j].operand1}) {
+        if (operand >= 0) {
+          is_read_on_tiles[operand] = true;
+        }
+      }
+    }
+  }
+  size_t num_broadcast = 0;
+  for (size_t v = 0; v < num_values; v++) {
+    if (is_read_on_tiles[v] && value_source[v] != kOutputShape) {
+      num_broadcast++;
+    }
+  }
+  const size_t scratch_size = (num_buffers_ + num_broadcast) * kTileSize;
+
+  float* output_data = output->MutableData<float>();
+  const auto num_tiles = static_cast<std::ptrdiff_t>((output_size + kTileSize - 1) / kTileSize);
+
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, num_tiles,
+      TensorOpCost{bytes_per_tile * static_cast<double>(num_inputs_), bytes_per_tile,
+                   static_cast<double>(tile_cost) * kTileSize},
+      [&](std::ptrdiff_t first_tile, std::ptrdiff_t last_tile) {
+        std::vector<float> scratch(scratch_size);
+        float* next_buffer = scratch.data() + num_buffers_ * kTileSize;
+
+        InlinedVector<const float*> values(num_values, nullptr);
+        InlinedVector<float*> gathered(num_values, nullptr);
+        for (size_t v = 0; v < num_values; v++) {
+          if (!is_read_on_tiles[v] || value_source[v] == kOutputShape) {
+            continue;
+          }
+          if (broadcast_values[v].is_scalar) {
+            std::fill_n(next_buffer, kTileSize, *broadcast_values[v].data);
+          } else {
+            gathered[v] = next_buffer;
+          }
+          values[v] = next_buffer;
+          next_buffer += kTileSize;
+        }
+
+        for (std::ptrdiff_t tile = first_tile; tile < last_tile; tile++) {
+          const size_t start = static_cast<size_t>(tile) * kTileSize;
+          const size_t count = std::min(kTileSize, output_size - start);
+
+          for (size_t i = 0; i < num_inputs_; i++) {
+            if (broadcast_values[i].is_full) {
+              values[i] = broadcast_values[i].data + start;
+            }
+          }
+          for (size_t v = 0; v < num_values; v++) {
+            if (gathered[v] != nullptr) {
+              GatherBroadcastInput(broadcast_values[v], dims, start, count, gathered[v]);
+            }
+          }
+
+          for (size_t j = 0; j < program_.size(); j++) {
+            if (value_source[num_leaves + j] != kOutputShape) {
+              continue;
+            }
+            const Instruction& instruction = program_[j];
+            float* result = instruction.buffer >= 0 ? scratch.data() + instruction.buffer * kTileSize
+                                                    : output_data + start;
+            EvaluateElementwiseOp(instruction.op, values[instruction.operand0],
+                                  instruction.operand1 >= 0 ? values[instruction.operand1] : nullptr,
+                                  result, count);
+            values[num_leaves + j] = result;
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
+    FusedElementwise,
+    1,
+    float,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -9,18 +9,52 @@ namespace contrib {
 constexpr const char* ACTIVATION_NAME_PREFIX = "activation_";
 constexpr size_t ACTIVATION_NAME_PREFIX_LEN = 11;
 
+// Returns the MLAS_ACTIVATION for the activations that the MLAS gemm epilogue can apply.
+static std::optional<MLAS_ACTIVATION> GetMlasActivation(const OpKernelInfo& info, const std::string& activation) {
+  MLAS_ACTIVATION mlas_activation;
+  if (activation == "Relu") {
+    mlas_activation.ActivationKind = MlasReluActivation;
+  } else if (activation == "Sigmoid") {
+    mlas_activation.ActivationKind = MlasLogisticActivation;
+  } else if (activation == "Tanh") {
+    mlas_activation.ActivationKind = MlasTanhActivation;
+  } else if (activation == "LeakyRelu") {
+    mlas_activation.ActivationKind = MlasLeakyReluActivation;
+    if (!info.GetAttr<float>("activation_alpha", &mlas_activation.Parameters.LeakyRelu.alpha).IsOK()) {
+      return std::nullopt;
+    }
+  } else if (activation == "HardSigmoid") {
+    mlas_activation.ActivationKind = MlasHardSigmoidActivation;
+    if (!info.GetAttr<float>("activation_alpha", &mlas_activation.Parameters.HardSigmoid.alpha).IsOK() ||
+        !info.GetAttr<float>("activation_beta", &mlas_activation.Parameters.HardSigmoid.beta).IsOK()) {
+      return std::nullopt;
+    }
+  } else {
+    return std::nullopt;
+  }
+  return mlas_activation;
+}
+
 template <typename T>
 class FusedGemm final : public Gemm<T> {
  public:
   FusedGemm(const OpKernelInfo& info) : Gemm<T>(info) {
     std::string activation = info.GetAttrOrDefault<std::string>("activation", "");
-    NodeAttributes attrs;
-    for (const auto& p : info.node().GetAttributes()) {
-      if (p.first.size() > ACTIVATION_NAME_PREFIX_LEN && p.first.compare(0, ACTIVATION_NAME_PREFIX_LEN, ACTIVATION_NAME_PREFIX) == 0) {
-        attrs[p.first.substr(ACTIVATION_NAME_PREFIX_LEN)] = p.second;
+
+    // The activations supported by MLAS are applied in the gemm epilogue, the others in a pass over the output.
+    if constexpr (std::is_same_v<T, float>) {
+      this->mlas_activation_ = GetMlasActivation(info, activation);
+    }
+
+    if (!this->mlas_activation_) {
+      NodeAttributes attrs;
+      for (const auto& p : info.node().GetAttributes()) {
+        if (p.first.size() > ACTIVATION_NAME_PREFIX_LEN && p.first.compare(0, ACTIVATION_NAME_PREFIX_LEN, ACTIVATION_NAME_PREFIX) == 0) {
+          attrs[p.first.substr(ACTIVATION_NAME_PREFIX_LEN)] = p.second;
+        }
       }
+      ORT_THROW_IF_ERROR(functors::ElementWiseRangedTransform<T>::Create(activation, attrs, this->activation_));
     }
-    ORT_THROW_IF_ERROR(functors::ElementWiseRangedTransform<T>::Create(activation, attrs, this->activation_));
   }
 };
 
@@ -0,0 +1,453 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/moe/moe_base_cpu.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+using concurrency::ThreadPool;
+
+namespace {
+
+// Each row of a sparse mixer masks the experts whose logits are too far below the selected expert.
+constexpr float kSparseMixerJitterEps = 0.01f;
+
+// Selects the top k experts from the softmax of the logits. Ties go to the expert with the lower index.
+void SelectTopK(const float* logits, int64_t num_experts, int64_t k, bool normalize_routing_weights,
+                float* probs, int* experts, float* weights) {
+  const float max_logit = *std::max_element(logits, logits + num_experts);
+  float sum = 0.0f;
+  for (int64_t e = 0; e < num_experts; e++) {
+    probs[e] = std::exp(logits[e] - max_logit);
+    sum += probs[e];
+  }
+
+  float selected_sum = 0.0f;
+  for (int64_t k_idx = 0; k_idx < k; k_idx++) {
+    int64_t best = 0;
+    for (int64_t e = 1; e < num_experts; e++) {
+      if (probs[e] > probs[best]) {
+        best = e;
+      }
+    }
+    experts[k_idx] = static_cast<int>(best);
+    weights[k_idx] = probs[best] / sum;
+    selected_sum += weights[k_idx];
+    probs[best] = -1.0f;
+  }
+
+  if (normalize_routing_weights) {
+    for (int64_t k_idx = 0; k_idx < k; k_idx++) {
+      weights[k_idx] /= selected_sum;
+    }
+  }
+}
+
+// Selects the top 2 experts with the sparse mixer of https://arxiv.org/abs/2409.12136. The softmax of each
+// selection only includes the experts whose logits are close to the selected expert.
+void SelectSparseMixerTop2(const float* logits, int64_t num_experts, int* experts, float* weights) {
+  for (int k_idx = 0; k_idx < 2; k_idx++) {
+    int64_t best = -1;
+    for (int64_t e = 0; e < num_experts; e++) {
+      if ((k_idx == 0 || e != experts[0]) && (best < 0 || logits[e] > logits[best])) {
+        best = e;
+      }
+    }
+
+    const float max_logit = logits[best];
+    float sum = 0.0f;
+    for (int64_t e = 0; e < num_experts; e++) {
+      const float factor = std::max(std::abs(logits[e]), max_logit);
+      const bool masked = (max_logit - logits[e]) > (2 * kSparseMixerJitterEps * factor) ||
+                          (k_idx == 1 && e == experts[0]);
+      if (!masked) {
+        sum += std::exp(logits[e] - max_logit);
+      }
+    }
+
+    experts[k_idx] = static_cast<int>(best);
+    weights[k_idx] = 1.0f / sum;
+  }
+}
+
+}  // namespace
+
+void MoEExpertGemms::Add(const MoERouting& routing, int64_t num_experts, const float* a, float* c, size_t n,
+                         size_t k, CBLAS_TRANSPOSE trans_b, const float* const* expert_weights, bool weights_packed,
+                         const float* bias) {
+  const int64_t* expert_offsets = routing.expert_offsets.get();
+
+  for (int64_t e = 0; e < num_experts; e++) {
+    const size_t rows = narrow<size_t>(expert_offsets[e + 1] - expert_offsets[e]);
+    if (rows == 0 || expert_weights[e] == nullptr) {
+      continue;
+    }
+
+    const size_t first_row = narrow<size_t>(expert_offsets[e]);
+
+    MLAS_SGEMM_GROUPED_PARAMS gemm;
+    gemm.TransB = trans_b;
+    gemm.M = rows;
+    gemm.N = n;
+    gemm.K = k;
+    gemm.Data.A = a + first_row * k;
+    gemm.Data.lda = k;
+    gemm.Data.B = expert_weights[e];
+    gemm.Data.ldb = weights_packed ? 0 : (trans_b == CblasTrans ? k : n);
+    gemm.Data.BIsPacked = weights_packed;
+    gemm.Data.C = c + first_row * n;
+    gemm.Data.ldc = n;
+
+    MLAS_SGEMM_EPILOGUE epilogue;
+    epilogue.Bias = bias != nullptr ? bias + e * n : nullptr;
+
+    gemms_.push_back(gemm);
+    epilogues_.push_back(epilogue);
+  }
+}
+
+void MoEExpertGemms::Run(ThreadPool* tp) {
+  // The epilogues are linked here, once the vector no longer grows.
+  for (size_t i = 0; i < gemms_.size(); i++) {
+    if (epilogues_[i].Bias != nullptr) {
+      gemms_[i].Data.Epilogue = &epilogues_[i];
+    }
+  }
+
+  MlasGemmGrouped(gemms_.data(), gemms_.size(), tp);
+
+  gemms_.clear();
+  epilogues_.clear();
+}
+
+MoEBaseCPU::MoEBaseCPU(const OpKernelInfo& op_kernel_info) {
+  ORT_ENFORCE(op_kernel_info.GetAttr<int64_t>("k", &k_).IsOK());
+
+  std::string activation_type_str;
+  ORT_ENFORCE(op_kernel_info.GetAttr<std::string>("activation_type", &activation_type_str).IsOK());
+  if (activation_type_str == "relu") {
+    activation_type_ = MoEActivationType::Relu;
+  } else if (activation_type_str == "gelu") {
+    activation_type_ = MoEActivationType::Gelu;
+  } else if (activation_type_str == "silu") {
+    activation_type_ = MoEActivationType::Silu;
+  } else if (activation_type_str == "identity") {
+    activation_type_ = MoEActivationType::Identity;
+  } else {
+    ORT_THROW("Unsupported MoE activation type: ", activation_type_str);
+  }
+
+  normalize_routing_weights_ = op_kernel_info.GetAttrOrDefault<int64_t>("normalize_routing_weights", 0) == 1;
+
+  use_sparse_mixer_ = op_kernel_info.GetAttrOrDefault<int64_t>("use_sparse_mixer", 0) == 1;
+  if (use_sparse_mixer_) {
+    ORT_ENFORCE(k_ == 2, "Sparse mixer only supports k=2");
+  }
+}
+
+Status MoEBaseCPU::CheckInputs(MoEParameters& parameters, MoEQuantType quant_type, const Tensor* input,
+                               const Tensor* router_probs, const TensorShape& fc1_experts_weights_shape,
+                               const Tensor* fc1_experts_bias_optional, const TensorShape& fc2_experts_weights_shape,
+                               const Tensor* fc2_experts_bias_optional,
+                               const TensorShape* fc3_experts_weights_shape_optional,
+                               const Tensor* fc3_experts_bias_optional) const {
+  const auto& input_dims = input->Shape().GetDims();
+  const auto& router_probs_dims = router_probs->Shape().GetDims();
+  const auto& fc1_experts_weights_dims = fc1_experts_weights_shape.GetDims();
+  const auto& fc2_experts_weights_dims = fc2_experts_weights_shape.GetDims();
+
+  if (input_dims.size() != 2 && input_dims.size() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "input must be 2D or 3D, got ", input_dims.size());
+  }
+  if (fc1_experts_weights_dims.size() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "fc1_experts_weights_dims must be 3D, got ",
+                           fc1_experts_weights_dims.size());
+  }
+  if (fc2_experts_weights_dims.size() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "fc2_experts_weights_dims must be 3D, got ",
+                           fc2_experts_weights_dims.size());
+  }
+  if (router_probs_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "router_probs_dims must be 2D, got ",
+                           router_probs_dims.size());
+  }
+
+  int64_t num_rows = input_dims.size() == 2 ? input_dims[0] : input_dims[0] * input_dims[1];
+  int64_t hidden_size = input_dims[input_dims.size() - 1];
+  int64_t num_experts = router_probs_dims[1];
+  int64_t inter_size = fc2_experts_weights_dims[1];
+
+  // The CPU kernels hold all of the experts, so the expert parallel sharding of the CUDA kernels is not supported.
+  if (fc1_experts_weights_dims[0] != num_experts || fc2_experts_weights_dims[0] != num_experts) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "experts weights must have num_experts experts, got ", fc1_experts_weights_dims[0],
+                           " and ", fc2_experts_weights_dims[0], " for ", num_experts, " experts");
+  }
+  if (k_ <= 0 || k_ > num_experts) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "k must be in the range [1, num_experts], got ", k_,
+                           " and ", num_experts);
+  }
+  if (fc1_experts_weights_dims[1] != hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "fc1_experts_weights_dims[1] must be equal to hidden_size, got ",
+                           fc1_experts_weights_dims[1], " and ", hidden_size);
+  }
+
+  // 4 bit weights pack two values of the last dimension in a byte.
+  const int64_t coe = quant_type == MoEQuantType::UINT4 ? 2 : 1;
+  if (fc1_experts_weights_dims[2] * coe != inter_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "fc1_experts_weights_dims[2] must be equal to inter_size, got ",
+                           fc1_experts_weights_dims[2], " and ", inter_size);
+  }
+  if (fc2_experts_weights_dims[2] * coe != hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "fc2_experts_weights_dims[2] must be equal to hidden_size, got ",
+                           fc2_experts_weights_dims[2], " and ", hidden_size);
+  }
+  if (router_probs_dims[0] != num_rows) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "router_probs_dims[0] must be equal to num_rows, got ",
+                           router_probs_dims[0], " and ", num_rows);
+  }
+
+  const auto check_bias = [num_experts](const Tensor* bias, const char* name, int64_t size) -> Status {
+    if (bias != nullptr) {
+      const auto& bias_dims = bias->Shape().GetDims();
+      if (bias_dims.size() != 2 || bias_dims[0] != num_experts || bias_dims[1] != size) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, name, " must have shape (", num_experts, ", ",
+                               size, "), got ", bias->Shape());
+      }
+    }
+    return Status::OK();
+  };
+
+  ORT_RETURN_IF_ERROR(check_bias(fc1_experts_bias_optional, "fc1_experts_bias", inter_size));
+  ORT_RETURN_IF_ERROR(check_bias(fc2_experts_bias_optional, "fc2_experts_bias", hidden_size));
+  ORT_RETURN_IF_ERROR(check_bias(fc3_experts_bias_optional, "fc3_experts_bias", inter_size));
+
+  if (fc3_experts_weights_shape_optional != nullptr &&
+      fc3_experts_weights_shape_optional->GetDims() != fc1_experts_weights_dims) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "fc3_experts_weights_dims must be equal to fc1_experts_weights_dims, got ",
+                           *fc3_experts_weights_shape_optional, " and ", fc1_experts_weights_shape);
+  }
+  if (fc3_experts_weights_shape_optional == nullptr && fc3_experts_bias_optional != nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "fc3_experts_bias requires fc3_experts_weights");
+  }
+
+  parameters.num_rows = num_rows;
+  parameters.num_experts = num_experts;
+  parameters.hidden_size = hidden_size;
+  parameters.inter_size = inter_size;
+
+  return Status::OK();
+}
+
+Status MoEBaseCPU::CheckInputScales(const Tensor* fc1_experts_scales, const Tensor* fc2_experts_scales,
+                                    const Tensor* fc3_experts_scales, int64_t num_experts, int64_t hidden_size,
+                                    int64_t inter_size) const {
+  const auto& fc1_experts_scales_dims = fc1_experts_scales->Shape().GetDims();
+  const auto& fc2_experts_scales_dims = fc2_experts_scales->Shape().GetDims();
+
+  if (fc1_experts_scales_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "fc1_experts_scales must be 2D, got ",
+                           fc1_experts_scales_dims.size());
+  }
+  if (fc1_experts_scales_dims[0] != num_experts) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "fc1_experts_scales[0] must be equal to num_experts, got ",
+                           fc1_experts_scales_dims[0], " and ", num_experts);
+  }
+  if (fc1_experts_scales_dims[1] != inter_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "fc1_experts_scales[1] must be equal to inter_size, got ",
+                           fc1_experts_scales_dims[1], " and ", inter_size);
+  }
+  if (fc2_experts_scales_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "fc2_experts_scales must be 2D, got ",
+                           fc2_experts_scales_dims.size());
+  }
+  if (fc2_experts_scales_dims[0] != num_experts) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "fc2_experts_scales[0] must be equal to num_experts, got ",
+                           fc2_experts_scales_dims[0], " and ", num_experts);
+  }
+  if (fc2_experts_scales_dims[1] != hidden_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "fc2_experts_scales[1] must be equal to hidden_size, got ",
+                           fc2_experts_scales_dims[1], " and ", hidden_size);
+  }
+  if (fc3_experts_scales != nullptr && fc1_experts_scales_dims != fc3_experts_scales->Shape().GetDims()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "fc3_experts_scales must be equal to fc1_experts_scales, got ",
+                           fc3_experts_scales->Shape(), " and ", TensorShape(fc1_experts_scales_dims));
+  }
+
+  return Status::OK();
+}
+
+Status MoEBaseCPU::RouteRows(const MoEParameters& parameters, const float* router_probs, AllocatorPtr allocator,
+                             ThreadPool* tp, MoERouting& routing) const {
+  const int64_t num_rows = parameters.num_rows;
+  const int64_t num_experts = parameters.num_experts;
+  const size_t expanded_rows = SafeInt<size_t>(num_rows) * k_;
+
+  // The sorted rows are indexed with int, as are the rows of the CUDA kernels.
+  ORT_RETURN_IF_NOT(expanded_rows <= static_cast<size_t>(std::numeric_limits<int>::max()),
+                    "MoE supports up to ", std::numeric_limits<int>::max(), " expanded rows, got ", expanded_rows);
+
+  routing.expert_for_row = IAllocator::MakeUniquePtr<int>(allocator, expanded_rows);
+  routing.weight_for_row = IAllocator::MakeUniquePtr<float>(allocator, expanded_rows);
+  routing.dest_for_row = IAllocator::MakeUniquePtr<int>(allocator, expanded_rows);
+  routing.source_for_dest = IAllocator::MakeUniquePtr<int>(allocator, expanded_rows);
+  routing.expert_offsets = IAllocator::MakeUniquePtr<int64_t>(allocator, narrow<size_t>(num_experts) + 1);
+
+  int* expert_for_row = routing.expert_for_row.get();
+  float* weight_for_row = routing.weight_for_row.get();
+  int* dest_for_row = routing.dest_for_row.get();
+  int* source_for_dest = routing.source_for_dest.get();
+  int64_t* expert_offsets = routing.expert_offsets.get();
+
+  // Select the experts of each row.
+  const int64_t k = k_;
+  const bool normalize_routing_weights = normalize_routing_weights_;
+  const bool use_sparse_mixer = use_sparse_mixer_;
+  const double cost = static_cast<double>(num_experts) * (k + 4);
+
+  auto probs_buffer = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(num_rows) * num_experts);
+  float* probs = probs_buffer.get();
+
+  ThreadPool::TryParallelFor(tp, narrow<std::ptrdiff_t>(num_rows), cost,
+                             [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+                               for (std::ptrdiff_t row = begin; row != end; ++row) {
+                                 const float* logits = router_probs + row * num_experts;
+                                 int* experts = expert_for_row + row * k;
+                                 float* weights = weight_for_row + row * k;
+                                 if (use_sparse_mixer) {
+                                   SelectSparseMixerTop2(logits, num_experts, experts, weights);
+                                 } else {
+                                   SelectTopK(logits, num_experts, k, normalize_routing_weights,
+                                              probs + row * num_experts, experts, weights);
+                                 }
+                               }
+                             });
+
+  // Sort the expanded rows by expert with a counting sort. The rows of an expert keep their input order.
+  std::fill_n(expert_offsets, num_experts + 1, int64_t{0});
+  for (size_t i = 0; i < expanded_rows; i++) {
+    expert_offsets[expert_for_row[i] + 1]++;
+  }
+  for (int64_t e = 0; e < num_experts; e++) {
+    expert_offsets[e + 1] += expert_offsets[e];
+  }
+
+  std::vector<int64_t> next_dest(expert_offsets, expert_offsets + num_experts);
+  for (size_t i = 0; i < expanded_rows; i++) {
+    const int dest = static_cast<int>(next_dest[expert_for_row[i]]++);
+    dest_for_row[i] = dest;
+    source_for_dest[dest] = static_cast<int>(i / narrow<size_t>(k));
+  }
+
+  return Status::OK();
+}
+
+void MoEBaseCPU::GatherRows(const MoEParameters& parameters, const MoERouting& routing, const float* input,
+                            float* sorted_input, ThreadPool* tp) const {
+  const int64_t hidden_size = parameters.hidden_size;
+  const int* source_for_dest = routing.source_for_dest.get();
+
+  ThreadPool::TryParallelFor(tp, narrow<std::ptrdiff_t>(parameters.num_rows * k_),
+                             static_cast<double>(hidden_size),
+                             [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+                               for (std::ptrdiff_t dest = begin; dest != end; ++dest) {
+                                 std::memcpy(sorted_input + dest * hidden_size,
+                                             input + source_for_dest[dest] * hidden_size,
+                                             narrow<size_t>(hidden_size) * sizeof(float));
+                               }
+                             });
+}
+
+void MoEBaseCPU::ApplyActivation(float* fc1_output, const float* fc3_output, int64_t count, ThreadPool* tp) const {
+  // As with FastGelu, the elements are split into chunks that each use a buffer on the stack.
+  static constexpr int64_t length_per_task = 4096;
+  const int64_t task_count = (count + length_per_task - 1) / length_per_task;
+  const MoEActivationType activation_type = activation_type_;
+
+  ThreadPool::TryBatchParallelFor(
+      tp, narrow<std::ptrdiff_t>(task_count),
+      [&](std::ptrdiff_t task_idx) {
+        const int64_t start = task_idx * length_per_task;
+        const size_t length = narrow<size_t>(std::min(length_per_task, count - start));
+        float* x = fc1_output + start;
+
+        float buffer[length_per_task];
+
+        switch (activation_type) {
+          case MoEActivationType::Relu:
+            for (size_t i = 0; i < length; i++) {
+              x[i] = std::max(x[i], 0.0f);
+            }
+            break;
+          case MoEActivationType::Gelu:
+            // The tanh approximation, which is the GELU of the CUDA kernels.
+            for (size_t i = 0; i < length; i++) {
+              buffer[i] = x[i] * (0.0356774081f * x[i] * x[i] + 0.7978845608f);
+            }
+            MlasComputeTanh(buffer, buffer, length);
+            for (size_t i = 0; i < length; i++) {
+              x[i] = 0.5f * x[i] * (buffer[i] + 1.0f);
+            }
+            break;
+          case MoEActivationType::Silu:
+            MlasComputeLogistic(x, buffer, length);
+            for (size_t i = 0; i < length; i++) {
+              x[i] *= buffer[i];
+            }
+            break;
+          case MoEActivationType::Identity:
+            break;
+        }
+
+        if (fc3_output != nullptr) {
+          const float* gate = fc3_output + start;
+          for (size_t i = 0; i < length; i++) {
+            x[i] *= gate[i];
+          }
+        }
+      },
+      0);
+}
+
+void MoEBaseCPU::CombineRows(const MoEParameters& parameters, const MoERouting& routing, const float* fc2_output,
+                             float* output, ThreadPool* tp) const {
+  const int64_t hidden_size = parameters.hidden_size;
+  const int64_t k = k_;
+  const float* weight_for_row = routing.weight_for_row.get();
+  const int* dest_for_row = routing.dest_for_row.get();
+
+  ThreadPool::TryParallelFor(tp, narrow<std::ptrdiff_t>(parameters.num_rows),
+                             static_cast<double>(hidden_size * k),
+                             [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+                               for (std::ptrdiff_t row = begin; row != end; ++row) {
+                                 float* y = output + row * hidden_size;
+                                 std::fill_n(y, hidden_size, 0.0f);
+                                 for (int64_t k_idx = 0; k_idx < k; k_idx++) {
+                                   const float weight = weight_for_row[row * k + k_idx];
+                                   const float* x = fc2_output + int64_t{dest_for_row[row * k + k_idx]} * hidden_size;
+                                   for (int64_t i = 0; i < hidden_size; i++) {
+                                     y[i] += weight * x[i];
+                                   }
+                                 }
+                               }
+                             });
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
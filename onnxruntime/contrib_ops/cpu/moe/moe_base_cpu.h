@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/framework/op_kernel.h"
+#include "core/framework/tensor_shape.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+enum class MoEActivationType {
+  Relu,
+  Gelu,
+  Silu,
+  Identity,
+};
+
+enum class MoEQuantType {
+  None = 0,
+  UINT4 = 1,
+  UINT8 = 2,
+};
+
+struct MoEParameters {
+  int64_t num_rows;
+  int64_t num_experts;
+  int64_t hidden_size;
+  int64_t inter_size;
+};
+
+// Rows of the input routed to the experts. Each row is expanded to k rows, one per selected expert, and the
+// expanded rows are sorted by expert so that the rows of an expert are contiguous.
+struct MoERouting {
+  IAllocatorUniquePtr<int> expert_for_row;        // (num_rows, k) selected experts of each row
+  IAllocatorUniquePtr<float> weight_for_row;      // (num_rows, k) routing weights of the selected experts
+  IAllocatorUniquePtr<int> dest_for_row;          // (num_rows, k) position of the expanded row in the sorted rows
+  IAllocatorUniquePtr<int> source_for_dest;       // (num_rows * k) input row of each sorted row
+  IAllocatorUniquePtr<int64_t> expert_offsets;    // (num_experts + 1) first sorted row of each expert
+};
+
+// Multiplications of the FC layers of the experts, run as a single grouped SGEMM.
+class MoEExpertGemms {
+ public:
+  // Adds a multiplication for each expert that has rows. expert_weights holds the (K, N) weights of each expert,
+  // transposed as given by trans_b, or its weights packed by MlasGemmPackB when weights_packed is set. Experts
+  // without weights are skipped. bias is optional.
+  void Add(const MoERouting& routing, int64_t num_experts, const float* a, float* c, size_t n, size_t k,
+           CBLAS_TRANSPOSE trans_b, const float* const* expert_weights, bool weights_packed, const float* bias);
+
+  void Run(concurrency::ThreadPool* tp);
+
+ private:
+  std::vector<MLAS_SGEMM_GROUPED_PARAMS> gemms_;
+  std::vector<MLAS_SGEMM_EPILOGUE> epilogues_;
+};
+
+class MoEBaseCPU {
+ public:
+  Status CheckInputs(MoEParameters& parameters, MoEQuantType quant_type, const Tensor* input,
+                     const Tensor* router_probs, const TensorShape& fc1_experts_weights_shape,
+                     const Tensor* fc1_experts_bias_optional, const TensorShape& fc2_experts_weights_shape,
+                     const Tensor* fc2_experts_bias_optional, const TensorShape* fc3_experts_weights_shape_optional,
+                     const Tensor* fc3_experts_bias_optional) const;
+
+  Status CheckInputScales(const Tensor* fc1_experts_scales, const Tensor* fc2_experts_scales,
+                          const Tensor* fc3_experts_scales, int64_t num_experts, int64_t hidden_size,
+                          int64_t inter_size) const;
+
+ protected:
+  explicit MoEBaseCPU(const OpKernelInfo& op_kernel_info);
+
+  // Selects the top k experts of each row from the router logits and sorts the expanded rows by expert.
+  Status RouteRows(const MoEParameters& parameters, const float* router_probs, AllocatorPtr allocator,
+                   concurrency::ThreadPool* tp, MoERouting& routing) const;
+
+  // Copies the input rows to the sorted rows, so that the rows of an expert are a single matrix.
+  void GatherRows(const MoEParameters& parameters, const MoERouting& routing, const float* input,
+                  float* sorted_input, concurrency::ThreadPool* tp) const;
+
+  // Applies the activation to the output of the first FC layer. When the experts have a third FC layer, the
+  // activation is gated by its output, as in SwiGLU.
+  void ApplyActivation(float* fc1_output, const float* fc3_output, int64_t count,
+                       concurrency::ThreadPool* tp) const;
+
+  // Sums the output rows of the selected experts of each input row, scaled by the routing weights.
+  void CombineRows(const MoEParameters& parameters, const MoERouting& routing, const float* fc2_output,
+                   float* output, concurrency::ThreadPool* tp) const;
+
+  bool normalize_routing_weights_;
+  bool use_sparse_mixer_;
+  int64_t k_;
+  MoEActivationType activation_type_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,198 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/moe/moe_cpu.h"
+
+#include <cstring>
+#include <vector>
+
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+namespace {
+
+// MoE op input indices of the experts weights of fc1, fc2 and fc3.
+constexpr int kWeightsInputIndex[3] = {2, 4, 6};
+
+int GetFcIndex(int input_idx) {
+  for (int fc = 0; fc < 3; fc++) {
+    if (kWeightsInputIndex[fc] == input_idx) {
+      return fc;
+    }
+  }
+  return -1;
+}
+
+}  // namespace
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    MoE,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    MoE);
+
+MoE::MoE(const OpKernelInfo& op_kernel_info) : OpKernel(op_kernel_info), MoEBaseCPU(op_kernel_info) {
+}
+
+Status MoE::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                    /*out*/ bool& is_packed,
+                    /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  const int fc = GetFcIndex(input_idx);
+  if (fc < 0) {
+    return Status::OK();
+  }
+
+  const auto& weights_dims = tensor.Shape().GetDims();
+  if (weights_dims.size() != 3) {
+    return Status::OK();
+  }
+
+  const size_t num_experts = narrow<size_t>(weights_dims[0]);
+  // The weights of an expert are stored as (N, K), as with the CUDA kernels, although the shape is (K, N).
+  const size_t k = narrow<size_t>(weights_dims[1]);
+  const size_t n = narrow<size_t>(weights_dims[2]);
+
+  const size_t packb_size = MlasGemmPackBSize(n, k);
+  if (packb_size == 0) {
+    return Status::OK();
+  }
+
+  const size_t packed_weights_data_size = SafeInt<size_t>(packb_size) * num_experts;
+  packed_weights_[fc] = IAllocator::MakeUniquePtr<void>(alloc, packed_weights_data_size, true);
+  packed_weights_size_[fc] = packb_size;
+  weights_shape_[fc] = tensor.Shape();
+
+  std::byte* packed_weights_data = static_cast<std::byte*>(packed_weights_[fc].get());
+  // Initialize memory to 0 as there could be some padding associated with pre-packed
+  // buffer memory and we do not want it uninitialized and generate different hashes
+  // if and when we try to cache this pre-packed buffer for sharing between sessions.
+  memset(packed_weights_data, 0, packed_weights_data_size);
+
+  const float* weights_data = tensor.Data<float>();
+  for (size_t e = 0; e < num_experts; e++) {
+    MlasGemmPackB(CblasTrans, n, k, weights_data + e * k * n, k, packed_weights_data + e * packb_size);
+  }
+
+  if (prepacked_weights != nullptr) {
+    prepacked_weights->buffers_.push_back(std::move(packed_weights_[fc]));
+    prepacked_weights->buffer_sizes_.push_back(packed_weights_data_size);
+  }
+
+  is_packed = true;
+  return Status::OK();
+}
+
+Status MoE::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                      int input_idx,
+                                      /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  const int fc = GetFcIndex(input_idx);
+  if (fc >= 0) {
+    used_shared_buffers = true;
+    packed_weights_[fc] = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
+Status MoE::Compute(OpKernelContext* context) const {
+  const Tensor* weights[3];
+  TensorShape weights_shape[3];
+  for (int fc = 0; fc < 3; fc++) {
+    weights[fc] = packed_weights_[fc] ? nullptr : context->Input<Tensor>(kWeightsInputIndex[fc]);
+    weights_shape[fc] = weights[fc] != nullptr ? weights[fc]->Shape() : weights_shape_[fc];
+  }
+
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* router_probs = context->Input<Tensor>(1);
+  const Tensor* fc1_experts_bias_optional = context->Input<Tensor>(3);
+  const Tensor* fc2_experts_bias_optional = context->Input<Tensor>(5);
+  const Tensor* fc3_experts_bias_optional = context->Input<Tensor>(7);
+
+  const bool has_fc3 = packed_weights_[2] != nullptr || weights[2] != nullptr;
+
+  MoEParameters parameters;
+  ORT_RETURN_IF_ERROR(CheckInputs(parameters, MoEQuantType::None, input, router_probs, weights_shape[0],
+                                  fc1_experts_bias_optional, weights_shape[1], fc2_experts_bias_optional,
+                                  has_fc3 ? &weights_shape[2] : nullptr, fc3_experts_bias_optional));
+
+  Tensor* output = context->Output(0, input->Shape());
+  if (parameters.num_rows == 0) {
+    return Status::OK();
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  auto* tp = context->GetOperatorThreadPool();
+
+  MoERouting routing;
+  ORT_RETURN_IF_ERROR(RouteRows(parameters, router_probs->Data<float>(), allocator, tp, routing));
+
+  const size_t expanded_rows = SafeInt<size_t>(parameters.num_rows) * k_;
+  const size_t hidden_size = narrow<size_t>(parameters.hidden_size);
+  const size_t inter_size = narrow<size_t>(parameters.inter_size);
+
+  // The sorted input is reused for the output of fc2.
+  auto sorted_rows = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(expanded_rows) * hidden_size);
+  GatherRows(parameters, routing, input->Data<float>(), sorted_rows.get(), tp);
+
+  auto fc1_output_buffer = IAllocator::MakeUniquePtr<float>(
+      allocator, SafeInt<size_t>(expanded_rows) * inter_size * (has_fc3 ? 2 : 1));
+  float* fc1_output = fc1_output_buffer.get();
+  float* fc3_output = has_fc3 ? fc1_output + expanded_rows * inter_size : nullptr;
+
+  // The weights of each expert, either in the input tensor or packed by PrePack.
+  std::vector<const float*> expert_weights[3];
+  for (int fc = 0; fc < 3; fc++) {
+    if (packed_weights_[fc] != nullptr) {
+      const auto* packed_weights_data = static_cast<const std::byte*>(packed_weights_[fc].get());
+      for (int64_t e = 0; e < parameters.num_experts; e++) {
+        expert_weights[fc].push_back(
+            reinterpret_cast<const float*>(packed_weights_data + e * packed_weights_size_[fc]));
+      }
+    } else if (weights[fc] != nullptr) {
+      const size_t expert_size = narrow<size_t>(weights_shape[fc].SizeFromDimension(1));
+      for (int64_t e = 0; e < parameters.num_experts; e++) {
+        expert_weights[fc].push_back(weights[fc]->Data<float>() + e * expert_size);
+      }
+    }
+  }
+
+  const auto bias_data = [](const Tensor* bias) { return bias != nullptr ? bias->Data<float>() : nullptr; };
+
+  MoEExpertGemms gemms;
+
+  // fc1 and fc3 read the same rows, so their multiplications share a single group.
+  gemms.Add(routing, parameters.num_experts, sorted_rows.get(), fc1_output, inter_size, hidden_size, CblasTrans,
+            expert_weights[0].data(), packed_weights_[0] != nullptr, bias_data(fc1_experts_bias_optional));
+  if (has_fc3) {
+    gemms.Add(routing, parameters.num_experts, sorted_rows.get(), fc3_output, inter_size, hidden_size, CblasTrans,
+              expert_weights[2].data(), packed_weights_[2] != nullptr, bias_data(fc3_experts_bias_optional));
+  }
+  gemms.Run(tp);
+
+  ApplyActivation(fc1_output, fc3_output, SafeInt<int64_t>(expanded_rows) * parameters.inter_size, tp);
+
+  gemms.Add(routing, parameters.num_experts, fc1_output, sorted_rows.get(), hidden_size, inter_size, CblasTrans,
+            expert_weights[1].data(), packed_weights_[1] != nullptr, bias_data(fc2_experts_bias_optional));
+  gemms.Run(tp);
+
+  CombineRows(parameters, routing, sorted_rows.get(), output->MutableData<float>(), tp);
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "contrib_ops/cpu/moe/moe_base_cpu.h"
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Mixture of experts with fp32 experts. The rows of the input are sorted by expert, and the FC layers of the
+// experts run as grouped SGEMMs that share the thread pool according to the number of rows of each expert.
+//
+// As with the CUDA kernels, the weights of an FC layer with shape (num_experts, K, N) hold the transposed (N, K)
+// matrix of each expert, which is the layout of the weight of torch.nn.Linear.
+class MoE final : public OpKernel, public MoEBaseCPU {
+ public:
+  explicit MoE(const OpKernelInfo& op_kernel_info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+ private:
+  // Experts weights of fc1, fc2 and fc3 packed by MlasGemmPackB, one packed matrix per expert.
+  IAllocatorUniquePtr<void> packed_weights_[3];
+  size_t packed_weights_size_[3] = {0, 0, 0};
+  TensorShape weights_shape_[3];
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,462 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/moe/moe_quantization_cpu.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/mlas/inc/mlas_qnbit.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+using concurrency::ThreadPool;
+
+namespace {
+
+// QMoE op input indices of the experts weights, scales and bias of fc1, fc2 and fc3.
+constexpr int kWeightsInputIndex[3] = {2, 5, 8};
+constexpr int kScalesInputIndex[3] = {3, 6, 9};
+constexpr int kBiasInputIndex[3] = {4, 7, 10};
+
+// Implicit zero points of the unsigned quantized weights.
+constexpr int kZeroPointUInt4 = 8;
+constexpr int kZeroPointUInt8 = 128;
+
+// The weights dequantized at once for the experts that have rows, in floats. Larger multiplications are split
+// into batches of experts, so that the buffer stays small next to the quantized weights.
+constexpr size_t kMaxDequantizedWeightsSize = size_t{16} * 1024 * 1024;
+
+size_t DivRoundUp(size_t a, size_t b) {
+  return (a + b - 1) / b;
+}
+
+int GetFcIndex(int input_idx) {
+  for (int fc = 0; fc < 3; fc++) {
+    if (kWeightsInputIndex[fc] == input_idx) {
+      return fc;
+    }
+  }
+  return -1;
+}
+
+// Block length of the packed 4 bit weights. The scale of a column is repeated for each block of the column, so
+// the longest block length that divides K is used.
+size_t GetBlockSize(size_t k) {
+  for (size_t block_size : {128, 64, 32, 16}) {
+    if (k % block_size == 0) {
+      return block_size;
+    }
+  }
+  return 32;
+}
+
+bool IsPackingAvailable(MoEQuantType quant_type, size_t k) {
+  return quant_type == MoEQuantType::UINT4 && MlasIsQNBitGemmAvailable(4, GetBlockSize(k), SQNBIT_CompFp32);
+}
+
+// Transposes the (K, N) 4 bit weights of an expert to the (N, K) blocks of MatMulNBits. The padding of the last
+// block holds the zero point.
+void TransposeUInt4Weights(const uint8_t* weights, size_t n, size_t k, size_t block_size, uint8_t* transposed) {
+  const size_t ldb = DivRoundUp(k, block_size) * block_size / 2;
+  std::memset(transposed, kZeroPointUInt4 * 0x11, n * ldb);
+
+  for (size_t kk = 0; kk < k; kk++) {
+    const uint8_t* src = weights + kk * (n / 2);
+    const int shift = (kk & 1) * 4;
+    const uint8_t keep = static_cast<uint8_t>(0xF0 >> shift);
+    for (size_t nn = 0; nn < n; nn++) {
+      const uint8_t value = (src[nn / 2] >> ((nn & 1) * 4)) & 0x0F;
+      uint8_t& dst = transposed[nn * ldb + kk / 2];
+      dst = static_cast<uint8_t>((dst & keep) | (value << shift));
+    }
+  }
+}
+
+// A multiplication of an FC layer of the experts with quantized weights.
+struct QuantizedExpertGemm {
+  const float* a;
+  float* c;
+  size_t n;
+  size_t k;
+  // Weights packed by MlasQNBitGemmPackQuantBData, or nullptr for the quantized (K, N) weights.
+  const std::byte* packed_weights;
+  size_t packed_weights_size;
+  const uint8_t* weights;
+  const float* scales;
+  const float* bias;
+};
+
+// Runs the multiplications with packed 4 bit weights. The multiplication of each expert is split into column
+// ranges in proportion to its rows, so that experts with few rows still spread over the thread pool.
+void RunPackedGemms(const MoERouting& routing, int64_t num_experts, const std::vector<QuantizedExpertGemm>& gemms,
+                    AllocatorPtr allocator, ThreadPool* tp) {
+  struct Segment {
+    size_t m;
+    size_t n;
+    size_t k;
+    size_t block_size;
+    MLAS_QNBIT_GEMM_DATA_PARAMS<float> data;
+  };
+
+  const int64_t* expert_offsets = routing.expert_offsets.get();
+  const size_t total_rows = narrow<size_t>(expert_offsets[num_experts]);
+  const size_t target_segments = 2 * static_cast<size_t>(ThreadPool::DegreeOfParallelism(tp));
+
+  std::vector<int64_t> routed_experts;
+  for (int64_t e = 0; e < num_experts; e++) {
+    if (expert_offsets[e + 1] > expert_offsets[e]) {
+      routed_experts.push_back(e);
+    }
+  }
+
+  // The kernels take a scale per block, so the scales of the columns are repeated for the blocks of each column.
+  std::vector<IAllocatorUniquePtr<float>> block_scales(gemms.size());
+  for (size_t g = 0; g < gemms.size(); g++) {
+    const QuantizedExpertGemm& gemm = gemms[g];
+    const size_t block_count = DivRoundUp(gemm.k, GetBlockSize(gemm.k));
+    block_scales[g] = IAllocator::MakeUniquePtr<float>(
+        allocator, SafeInt<size_t>(routed_experts.size()) * gemm.n * block_count);
+  }
+
+  ThreadPool::TrySimpleParallelFor(
+      tp, narrow<std::ptrdiff_t>(gemms.size() * routed_experts.size()), [&](std::ptrdiff_t i) {
+        const size_t g = static_cast<size_t>(i) / routed_experts.size();
+        const size_t slot = static_cast<size_t>(i) % routed_experts.size();
+        const QuantizedExpertGemm& gemm = gemms[g];
+        const size_t block_count = DivRoundUp(gemm.k, GetBlockSize(gemm.k));
+        const float* scales = gemm.scales + routed_experts[slot] * gemm.n;
+        float* dst = block_scales[g].get() + slot * gemm.n * block_count;
+        for (size_t nn = 0; nn < gemm.n; nn++) {
+          std::fill_n(dst + nn * block_count, block_count, scales[nn]);
+        }
+      });
+
+  std::vector<Segment> segments;
+  for (size_t g = 0; g < gemms.size(); g++) {
+    const QuantizedExpertGemm& gemm = gemms[g];
+    const size_t block_size = GetBlockSize(gemm.k);
+    const size_t block_count = DivRoundUp(gemm.k, block_size);
+    const size_t ldb = block_count * block_size / 2;
+
+    for (size_t slot = 0; slot < routed_experts.size(); slot++) {
+      const int64_t e = routed_experts[slot];
+      const size_t first_row = narrow<size_t>(expert_offsets[e]);
+      const size_t rows = narrow<size_t>(expert_offsets[e + 1]) - first_row;
+
+      const size_t range_count = DivRoundUp(target_segments * rows, total_rows);
+      const size_t range_n = DivRoundUp(DivRoundUp(gemm.n, range_count), size_t{16}) * 16;
+
+      for (size_t n_start = 0; n_start < gemm.n; n_start += range_n) {
+        Segment segment;
+        segment.m = rows;
+        segment.n = std::min(range_n, gemm.n - n_start);
+        segment.k = gemm.k;
+        segment.block_size = block_size;
+        segment.data.A = gemm.a + first_row * gemm.k;
+        segment.data.lda = gemm.k;
+        segment.data.QuantBDataWorkspace = nullptr;
+        segment.data.PackedQuantBData = gemm.packed_weights + e * gemm.packed_weights_size + n_start * ldb;
+        segment.data.QuantBScale = block_scales[g].get() + (slot * gemm.n + n_start) * block_count;
+        segment.data.Bias = gemm.bias != nullptr ? gemm.bias + e * gemm.n + n_start : nullptr;
+        segment.data.C = gemm.c + first_row * gemm.n + n_start;
+        segment.data.ldc = gemm.n;
+        segments.push_back(segment);
+      }
+    }
+  }
+
+  // The fp32 compute type needs no workspace.
+  ThreadPool::TrySimpleParallelFor(tp, narrow<std::ptrdiff_t>(segments.size()), [&](std::ptrdiff_t i) {
+    const Segment& segment = segments[i];
+    MlasQNBitGemmBatch(segment.m, segment.n, segment.k, 1, 4, segment.block_size, SQNBIT_CompFp32, &segment.data,
+                       nullptr, nullptr);
+  });
+}
+
+// Runs the multiplications with quantized (K, N) weights. The weights of the experts that have rows are
+// dequantized in batches and multiplied by a grouped SGEMM.
+void RunDequantizedGemms(const MoERouting& routing, int64_t num_experts, MoEQuantType quant_type,
+                         const std::vector<QuantizedExpertGemm>& gemms, AllocatorPtr allocator, ThreadPool* tp) {
+  struct Item {
+    size_t gemm;
+    int64_t expert;
+    size_t weights_offset;
+  };
+
+  const int64_t* expert_offsets = routing.expert_offsets.get();
+
+  std::vector<Item> items;
+  size_t max_expert_size = 0;
+  size_t total_size = 0;
+  for (size_t g = 0; g < gemms.size(); g++) {
+    for (int64_t e = 0; e < num_experts; e++) {
+      if (expert_offsets[e + 1] > expert_offsets[e]) {
+        items.push_back({g, e, 0});
+        max_expert_size = std::max(max_expert_size, gemms[g].k * gemms[g].n);
+        total_size += gemms[g].k * gemms[g].n;
+      }
+    }
+  }
+
+  auto dequantized_weights = IAllocator::MakeUniquePtr<float>(
+      allocator, std::min(total_size, std::max(max_expert_size, kMaxDequantizedWeightsSize)));
+
+  MoEExpertGemms expert_gemms;
+  std::vector<std::vector<const float*>> expert_weights(gemms.size(),
+                                                        std::vector<const float*>(narrow<size_t>(num_experts)));
+
+  for (size_t begin = 0; begin < items.size();) {
+    // Fill the buffer with the weights of as many experts as fit.
+    size_t end = begin;
+    size_t size = 0;
+    std::vector<size_t> row_offsets{0};
+    while (end < items.size()) {
+      const QuantizedExpertGemm& gemm = gemms[items[end].gemm];
+      if (end > begin && size + gemm.k * gemm.n > kMaxDequantizedWeightsSize) {
+        break;
+      }
+      items[end].weights_offset = size;
+      size += gemm.k * gemm.n;
+      row_offsets.push_back(row_offsets.back() + gemm.k);
+      end++;
+    }
+
+    // Dequantize the rows of the weights, (q - zero_point) * scale.
+    ThreadPool::TryParallelFor(
+        tp, narrow<std::ptrdiff_t>(row_offsets.back()), static_cast<double>(gemms[items[begin].gemm].n) * 2,
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t row = first; row != last; ++row) {
+            const size_t i = std::upper_bound(row_offsets.begin(), row_offsets.end(), static_cast<size_t>(row)) -
+                             row_offsets.begin() - 1;
+            const Item& item = items[begin + i];
+            const QuantizedExpertGemm& gemm = gemms[item.gemm];
+            const size_t kk = static_cast<size_t>(row) - row_offsets[i];
+            const float* scales = gemm.scales + item.expert * gemm.n;
+            float* dst = dequantized_weights.get() + item.weights_offset + kk * gemm.n;
+
+            if (quant_type == MoEQuantType::UINT4) {
+              const uint8_t* src = gemm.weights + (item.expert * gemm.k + kk) * (gemm.n / 2);
+              for (size_t nn = 0; nn < gemm.n; nn += 2) {
+                const uint8_t packed = src[nn / 2];
+                dst[nn] = static_cast<float>((packed & 0x0F) - kZeroPointUInt4) * scales[nn];
+                dst[nn + 1] = static_cast<float>((packed >> 4) - kZeroPointUInt4) * scales[nn + 1];
+              }
+            } else {
+              const uint8_t* src = gemm.weights + (item.expert * gemm.k + kk) * gemm.n;
+              for (size_t nn = 0; nn < gemm.n; nn++) {
+                dst[nn] = static_cast<float>(src[nn] - kZeroPointUInt8) * scales[nn];
+              }
+            }
+          }
+        });
+
+    for (size_t g = 0; g < gemms.size(); g++) {
+      std::fill(expert_weights[g].begin(), expert_weights[g].end(), nullptr);
+    }
+    for (size_t i = begin; i < end; i++) {
+      expert_weights[items[i].gemm][narrow<size_t>(items[i].expert)] =
+          dequantized_weights.get() + items[i].weights_offset;
+    }
+    for (size_t g = 0; g < gemms.size(); g++) {
+      const QuantizedExpertGemm& gemm = gemms[g];
+      expert_gemms.Add(routing, num_experts, gemm.a, gemm.c, gemm.n, gemm.k, CblasNoTrans,
+                       expert_weights[g].data(), false, gemm.bias);
+    }
+    expert_gemms.Run(tp);
+
+    begin = end;
+  }
+}
+
+void RunQuantizedGemms(const MoERouting& routing, int64_t num_experts, MoEQuantType quant_type,
+                       const std::vector<QuantizedExpertGemm>& gemms, AllocatorPtr allocator, ThreadPool* tp) {
+  std::vector<QuantizedExpertGemm> packed_gemms;
+  std::vector<QuantizedExpertGemm> dequantized_gemms;
+  for (const auto& gemm : gemms) {
+    (gemm.packed_weights != nullptr ? packed_gemms : dequantized_gemms).push_back(gemm);
+  }
+
+  if (!packed_gemms.empty()) {
+    RunPackedGemms(routing, num_experts, packed_gemms, allocator, tp);
+  }
+  if (!dequantized_gemms.empty()) {
+    RunDequantizedGemms(routing, num_experts, quant_type, dequantized_gemms, allocator, tp);
+  }
+}
+
+}  // namespace
+
+ONNX_OPERATOR_KERNEL_EX(
+    QMoE,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>()),
+    QMoE);
+
+QMoE::QMoE(const OpKernelInfo& op_kernel_info) : OpKernel(op_kernel_info), MoEBaseCPU(op_kernel_info) {
+  int64_t expert_weight_bits;
+  ORT_ENFORCE(op_kernel_info.GetAttr<int64_t>("expert_weight_bits", &expert_weight_bits).IsOK());
+  ORT_ENFORCE(expert_weight_bits == 8 || expert_weight_bits == 4,
+              "expert_weight_bits must be 4 or 8, but got ", expert_weight_bits);
+  quant_type_ = expert_weight_bits == 4 ? MoEQuantType::UINT4 : MoEQuantType::UINT8;
+}
+
+Status QMoE::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                     /*out*/ bool& is_packed,
+                     /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  const int fc = GetFcIndex(input_idx);
+  if (fc < 0) {
+    return Status::OK();
+  }
+
+  const auto& weights_dims = tensor.Shape().GetDims();
+  if (weights_dims.size() != 3) {
+    return Status::OK();
+  }
+
+  const size_t num_experts = narrow<size_t>(weights_dims[0]);
+  const size_t k = narrow<size_t>(weights_dims[1]);
+  const size_t n = narrow<size_t>(weights_dims[2]) * 2;
+  if (k == 0 || n == 0 || !IsPackingAvailable(quant_type_, k)) {
+    return Status::OK();
+  }
+
+  const size_t block_size = GetBlockSize(k);
+  const size_t packed_size = MlasQNBitGemmPackQuantBDataSize(n, k, 4, block_size, false, SQNBIT_CompFp32);
+  const size_t packed_weights_data_size = SafeInt<size_t>(packed_size) * num_experts;
+  packed_weights_[fc] = IAllocator::MakeUniquePtr<void>(alloc, packed_weights_data_size, true);
+  packed_weights_size_[fc] = packed_size;
+  weights_shape_[fc] = tensor.Shape();
+
+  std::byte* packed_weights_data = static_cast<std::byte*>(packed_weights_[fc].get());
+  memset(packed_weights_data, 0, packed_weights_data_size);
+
+  std::vector<uint8_t> transposed(n * DivRoundUp(k, block_size) * block_size / 2);
+  const uint8_t* weights_data = tensor.Data<uint8_t>();
+  for (size_t e = 0; e < num_experts; e++) {
+    TransposeUInt4Weights(weights_data + e * k * (n / 2), n, k, block_size, transposed.data());
+    MlasQNBitGemmPackQuantBData(n, k, 4, block_size, SQNBIT_CompFp32, transposed.data(),
+                                packed_weights_data + e * packed_size, nullptr, false, nullptr, nullptr);
+  }
+
+  if (prepacked_weights != nullptr) {
+    prepacked_weights->buffers_.push_back(std::move(packed_weights_[fc]));
+    prepacked_weights->buffer_sizes_.push_back(packed_weights_data_size);
+  }
+
+  is_packed = true;
+  return Status::OK();
+}
+
+Status QMoE::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                       int input_idx,
+                                       /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  const int fc = GetFcIndex(input_idx);
+  if (fc >= 0) {
+    used_shared_buffers = true;
+    packed_weights_[fc] = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
+Status QMoE::Compute(OpKernelContext* context) const {
+  const Tensor* weights[3];
+  TensorShape weights_shape[3];
+  const Tensor* scales[3];
+  const Tensor* bias[3];
+  for (int fc = 0; fc < 3; fc++) {
+    weights[fc] = packed_weights_[fc] ? nullptr : context->Input<Tensor>(kWeightsInputIndex[fc]);
+    weights_shape[fc] = weights[fc] != nullptr ? weights[fc]->Shape() : weights_shape_[fc];
+    scales[fc] = context->Input<Tensor>(kScalesInputIndex[fc]);
+    bias[fc] = context->Input<Tensor>(kBiasInputIndex[fc]);
+  }
+
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* router_probs = context->Input<Tensor>(1);
+
+  const bool has_fc3 = packed_weights_[2] != nullptr || weights[2] != nullptr;
+  if (has_fc3 && scales[2] == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "fc3_experts_weights requires fc3_scales");
+  }
+
+  MoEParameters parameters;
+  ORT_RETURN_IF_ERROR(CheckInputs(parameters, quant_type_, input, router_probs, weights_shape[0], bias[0],
+                                  weights_shape[1], bias[1], has_fc3 ? &weights_shape[2] : nullptr, bias[2]));
+  ORT_RETURN_IF_ERROR(CheckInputScales(scales[0], scales[1], has_fc3 ? scales[2] : nullptr, parameters.num_experts,
+                                       parameters.hidden_size, parameters.inter_size));
+
+  Tensor* output = context->Output(0, input->Shape());
+  if (parameters.num_rows == 0) {
+    return Status::OK();
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  auto* tp = context->GetOperatorThreadPool();
+
+  MoERouting routing;
+  ORT_RETURN_IF_ERROR(RouteRows(parameters, router_probs->Data<float>(), allocator, tp, routing));
+
+  const size_t expanded_rows = SafeInt<size_t>(parameters.num_rows) * k_;
+  const size_t hidden_size = narrow<size_t>(parameters.hidden_size);
+  const size_t inter_size = narrow<size_t>(parameters.inter_size);
+
+  // The sorted input is reused for the output of fc2.
+  auto sorted_rows = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(expanded_rows) * hidden_size);
+  GatherRows(parameters, routing, input->Data<float>(), sorted_rows.get(), tp);
+
+  auto fc1_output_buffer = IAllocator::MakeUniquePtr<float>(
+      allocator, SafeInt<size_t>(expanded_rows) * inter_size * (has_fc3 ? 2 : 1));
+  float* fc1_output = fc1_output_buffer.get();
+  float* fc3_output = has_fc3 ? fc1_output + expanded_rows * inter_size : nullptr;
+
+  const auto make_gemm = [&](int fc, const float* a, float* c, size_t n, size_t k) {
+    QuantizedExpertGemm gemm;
+    gemm.a = a;
+    gemm.c = c;
+    gemm.n = n;
+    gemm.k = k;
+    gemm.packed_weights = static_cast<const std::byte*>(packed_weights_[fc].get());
+    gemm.packed_weights_size = packed_weights_size_[fc];
+    gemm.weights = weights[fc] != nullptr ? weights[fc]->Data<uint8_t>() : nullptr;
+    gemm.scales = scales[fc]->Data<float>();
+    gemm.bias = bias[fc] != nullptr ? bias[fc]->Data<float>() : nullptr;
+    return gemm;
+  };
+
+  // fc1 and fc3 read the same rows, so their multiplications run together.
+  std::vector<QuantizedExpertGemm> gemms;
+  gemms.push_back(make_gemm(0, sorted_rows.get(), fc1_output, inter_size, hidden_size));
+  if (has_fc3) {
+    gemms.push_back(make_gemm(2, sorted_rows.get(), fc3_output, inter_size, hidden_size));
+  }
+  RunQuantizedGemms(routing, parameters.num_experts, quant_type_, gemms, allocator, tp);
+
+  ApplyActivation(fc1_output, fc3_output, SafeInt<int64_t>(expanded_rows) * parameters.inter_size, tp);
+
+  gemms.clear();
+  gemms.push_back(make_gemm(1, fc1_output, sorted_rows.get(), hidden_size, inter_size));
+  RunQuantizedGemms(routing, parameters.num_experts, quant_type_, gemms, allocator, tp);
+
+  CombineRows(parameters, routing, sorted_rows.get(), output->MutableData<float>(), tp);
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "contrib_ops/cpu/moe/moe_base_cpu.h"
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Mixture of experts with experts weights quantized to 4 or 8 bits.
+//
+// The CPU kernel takes the weights of each expert as a row major (K, N) matrix of unsigned values with one scale
+// per output column, not the layout preprocessed for the CUDA kernels. A 4 bit weight holds two columns in a byte,
+// the even column in the low nibble. The zero point is implicit: 8 for 4 bit weights and 128 for 8 bit weights.
+//
+// 4 bit weights are packed for MlasQNBitGemmBatch, and each multiplication is split into column ranges that run
+// on the thread pool together with the multiplications of the other experts. Other weights are dequantized for
+// the experts that have rows and multiplied by a grouped SGEMM.
+class QMoE final : public OpKernel, public MoEBaseCPU {
+ public:
+  explicit QMoE(const OpKernelInfo& op_kernel_info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+ private:
+  MoEQuantType quant_type_;
+
+  // Experts weights of fc1, fc2 and fc3 packed by MlasQNBitGemmPackQuantBData, one packed matrix per expert.
+  IAllocatorUniquePtr<void> packed_weights_[3];
+  size_t packed_weights_size_[3] = {0, 0, 0};
+  TensorShape weights_shape_[3];
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -137,24 +137,19 @@ Status CheckPotentiallyPrepackedInputs(const T* input,
                                        const T* bias,
                                        int hidden_size_check,
                                        size_t input_dims_size_check,
-                                       bool prepacked_skip,
                                        bool prepacked_gamma) {
   if (input_dims_size_check != 3 && input_dims_size_check != 2) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                            "input is expected to have 3 or 2 dimensions, got ", input_dims_size_check);
   }
 
-  if (nullptr != skip) {
-    auto status = CheckSkip<T>(input, skip, input_dims_size_check);
-    if (status != Status::OK()) {
-      return status;
-    }
-  } else if (!prepacked_skip) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "skip is expected but not provided");
+  auto status = CheckSkip<T>(input, skip, input_dims_size_check);
+  if (status != Status::OK()) {
+    return status;
   }
 
   if (nullptr != gamma) {
-    auto status = CheckGamma<T>(gamma, hidden_size_check);
+    status = CheckGamma<T>(gamma, hidden_size_check);
     if (status != Status::OK()) {
       return status;
     }
@@ -162,7 +157,7 @@ Status CheckPotentiallyPrepackedInputs(const T* input,
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "gamma is expected but not provided");
   }
 
-  auto status = CheckBeta<T>(beta, hidden_size_check);
+  status = CheckBeta<T>(beta, hidden_size_check);
   if (status != Status::OK()) {
     return status;
   }
@@ -187,6 +187,15 @@ class BeamSearchBase : public GenerateBase {
                        AllocatorPtr& allocator,
                        int counter);
 
+  // Logs the bytes moved in this step to reorder the past state for the selected beams: all of the present state when
+  // it is gathered by beam, or the cache indirection table when decoder masked attention reads the past state through
+  // it. presents are the present outputs of the decoder that are fed back as past state.
+  void LogPastStateReorder(int counter,
+                           gsl::span<const OrtValue> presents,
+                           bool past_present_share_buffer,
+                           bool use_cache_indirection,
+                           int current_length) const;
+
   BeamSearchParameters* parameters_;
 
   std::unique_ptr<IBeamScorer> beam_scorer_;
@@ -252,6 +261,32 @@ Status BeamSearchBase<T>::ProcessLogits(
                               parameters_, counter, ort_stream_, GetConsoleDumper());
 }
 
+template <typename T>
+void BeamSearchBase<T>::LogPastStateReorder(int counter,
+                                            gsl::span<const OrtValue> presents,
+                                            bool past_present_share_buffer,
+                                            bool use_cache_indirection,
+                                            int current_length) const {
+  const logging::Logger& logger = this->context_.Logger();
+  if (!logger.OutputIsEnabled(logging::Severity::kVERBOSE, logging::DataType::SYSTEM)) {
+    return;
+  }
+
+  size_t bytes_moved = 0;
+  if (parameters_->num_beams > 1) {
+    if (!past_present_share_buffer) {
+      for (const OrtValue& present : presents) {
+        bytes_moved += present.Get<Tensor>().SizeInBytes();
+      }
+    } else if (use_cache_indirection) {
+      bytes_moved = SafeInt<size_t>(parameters_->BatchBeamSize()) * current_length * sizeof(int32_t);
+    }
+  }
+
+  LOGS(logger, VERBOSE) << "Beam search step " << counter << ": reordering past state moved " << bytes_moved
+                        << " bytes" << (past_present_share_buffer && use_cache_indirection ? " (cache indirection)" : "");
+}
+
 template <typename T>
 Status BeamSearchBase<T>::GenerateNextToken(
     const OrtValue& logits,
@@ -366,7 +366,7 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
       ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
                                       position_ids, increase_position,
                                       ReinterpretAsSpan<const int32_t>(beam_next_tokens),
-                                      gpt_subgraph_.has_decoder_masked_attention_
+                                      gpt_subgraph_.has_decoder_masked_attention_ && this->IsCuda()
                                           ? place_holder
                                           : ReinterpretAsSpan<const int32_t>(this->beam_scorer_->GetNextIndicesCPU()),
                                       gpt_subgraph_.has_decoder_masked_attention_
@@ -375,6 +375,11 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
                                       current_length - 1,
                                       parameters->sequence_length,
                                       gpt_subgraph_.has_decoder_masked_attention_));
+      this->LogPastStateReorder(iteration_counter,
+                                gsl::make_span(fetches).subspan(static_cast<size_t>(gpt_subgraph_.GetFirstPresentOutputIndex())),
+                                gpt_subgraph_.past_present_share_buffer_,
+                                gpt_subgraph_.has_decoder_masked_attention_,
+                                current_length);
     }
 
     if (this->beam_scorer_->IsDoneLater())
@@ -301,16 +301,24 @@ Status BeamSearchT5<T>::Execute(const FeedsFetchesManager& encoder_feeds_fetches
       auto cross_attention_past_key_sz = first_cross_attention_key->Shape().Size();
       beam_state.EnsurePastStateReorderStagingBuffer(this->temp_space_allocator_, cross_attention_past_key_sz);
 
+      size_t cache_indir_input_offset = static_cast<size_t>(decoder_subgraph_.GetFirstPastInputIndex()) + 4 * static_cast<size_t>(decoder_subgraph_.num_layers) + 2;
+      if (!this->IsCuda()) {
+        // CPU decoder masked attention reads the past state in its original layout, so only the cache indirection
+        // needs to be initialized.
+        ORT_RETURN_IF_ERROR(GenerationCpuDeviceHelper::InitCacheIndir(
+            *decoder_feeds[cache_indir_input_offset].GetMutable<Tensor>(), this->ort_stream_));
+      }
 #ifdef USE_CUDA
-      // Here we only need to reorder the past key for self-attention and cross-attention.
-      for (size_t i = 0; i < 2 * static_cast<size_t>(decoder_subgraph_.num_layers); ++i) {
-        ORT_RETURN_IF_ERROR(reorder_past_state_func_(cuda_device_prop_,
-                                                     *decoder_feeds[offset + 2 * i].GetMutable<Tensor>(),
-                                                     beam_state.staging_for_past_state_reorder,
-                                                     this->ort_stream_));
+      else {
+        // Here we only need to reorder the past key for self-attention and cross-attention.
+        for (size_t i = 0; i < 2 * static_cast<size_t>(decoder_subgraph_.num_layers); ++i) {
+          ORT_RETURN_IF_ERROR(reorder_past_state_func_(cuda_device_prop_,
+                                                       *decoder_feeds[offset + 2 * i].GetMutable<Tensor>(),
+                                                       beam_state.staging_for_past_state_reorder,
+                                                       this->ort_stream_));
+        }
+        ORT_RETURN_IF_ERROR(init_cache_indir_func_(*decoder_feeds[cache_indir_input_offset].GetMutable<Tensor>(), this->ort_stream_));
       }
-      size_t cache_indir_input_offset = static_cast<size_t>(decoder_subgraph_.GetFirstPastInputIndex()) + 4 * static_cast<size_t>(decoder_subgraph_.num_layers) + 2;
-      ORT_RETURN_IF_ERROR(init_cache_indir_func_(*decoder_feeds[cache_indir_input_offset].GetMutable<Tensor>(), this->ort_stream_));
 #endif
     }
   }
@@ -400,7 +408,7 @@ Status BeamSearchT5<T>::Execute(const FeedsFetchesManager& encoder_feeds_fetches
           decoder_feeds,
           num_present_outputs,
           ReinterpretAsSpan<const int32_t>(beam_next_tokens),
-          decoder_subgraph_.has_decoder_masked_attention_
+          decoder_subgraph_.has_decoder_masked_attention_ && this->IsCuda()
               ? place_holder
               : ReinterpretAsSpan<const int32_t>(this->beam_scorer_->GetNextIndicesCPU()),
           decoder_subgraph_.has_decoder_masked_attention_
@@ -416,6 +424,13 @@ Status BeamSearchT5<T>::Execute(const FeedsFetchesManager& encoder_feeds_fetches
           decoder_subgraph_.has_decoder_masked_attention_,
           cpu_state.sequences,
           this->GetConsoleDumper()));
+      this->LogPastStateReorder(iteration_counter,
+                                gsl::make_span(decoder_fetches)
+                                    .subspan(static_cast<size_t>(decoder_subgraph_.GetFirstPresentOutputIndex()),
+                                             static_cast<size_t>(num_present_outputs)),
+                                decoder_subgraph_.past_present_share_buffer_,
+                                decoder_subgraph_.has_decoder_masked_attention_,
+                                current_length);
     }
 
     if (decoder_subgraph_.past_present_share_buffer_) {
@@ -555,6 +555,37 @@ Status DeviceCopy(gsl::span<T> target, gsl::span<const T> source, Stream* /*stre
   return Status::OK();
 }
 
+Status InitCacheIndir(Tensor& cache_indir, Stream* /*stream*/) {
+  // All beams start from the same sequence, so every time step comes from beam 0.
+  memset(cache_indir.MutableDataRaw(), 0, cache_indir.SizeInBytes());
+  return Status::OK();
+}
+
+void UpdateCacheIndirection(gsl::span<int32_t> target,
+                            gsl::span<const int32_t> source,
+                            gsl::span<const int32_t> beam_indices,
+                            int batch_size,
+                            int num_beams,
+                            int input_sequence_length,
+                            int max_sequence_length,
+                            int current_length) {
+  for (int batch = 0; batch < batch_size; batch++) {
+    for (int beam = 0; beam < num_beams; beam++) {
+      const int src_beam = beam_indices[SafeInt<size_t>(batch) * num_beams + beam] % num_beams;
+      const size_t target_offset = (SafeInt<size_t>(batch) * num_beams + beam) * max_sequence_length;
+      const size_t source_offset = (SafeInt<size_t>(batch) * num_beams + src_beam) * max_sequence_length;
+
+      // Time steps of the input sequence come from beam 0, the new time step from the beam itself, and the others
+      // from wherever the beam it continues took them from.
+      std::fill_n(target.begin() + target_offset, input_sequence_length, 0);
+      std::copy(source.begin() + source_offset + input_sequence_length,
+                source.begin() + source_offset + current_length - 1,
+                target.begin() + target_offset + input_sequence_length);
+      target[target_offset + current_length - 1] = beam;
+    }
+  }
+}
+
 // Copy present state to past state for GPT model
 template <typename T>
 void PickGptPastState(const std::vector<OrtValue>& last_outputs,
@@ -619,8 +650,6 @@ Status UpdateGptFeeds(
   // next_inputs: input_ids, position_id, attention_mask, past_0, past_1
   ORT_UNUSED_PARAMETER(stream);
   ORT_UNUSED_PARAMETER(beam_indices_gpu);
-  ORT_UNUSED_PARAMETER(input_sequence_len);
-  ORT_UNUSED_PARAMETER(need_cache_indir);
 
   // The following updates inputs for subgraph
 
@@ -664,8 +693,32 @@ Status UpdateGptFeeds(
   next_inputs[2] = attention_mask;
 
   if (past_present_share_buffer) {
-    int32_t* past_seq_len_data = const_cast<int32_t*>(next_inputs.back().Get<Tensor>().Data<int32_t>());
-    *past_seq_len_data = past_sequence_len;
+    const ptrdiff_t past_sequence_length_idx = (static_cast<ptrdiff_t>(last_outputs.size()) -
+                                                gpt_subgraph_first_present_output_idx) +
+                                               gpt_subgraph_first_past_input_idx;
+    *(next_inputs[past_sequence_length_idx].GetMutable<Tensor>()->MutableData<int32_t>()) = past_sequence_len;
+
+    // Instead of gathering the past state of the selected beams, update the cache indirection table that decoder
+    // masked attention uses to find the past state of each time step. It comes 2 feeds after past_sequence_length.
+    if (need_cache_indir && num_beams > 1) {
+      const OrtValue& old_cache_indirection = next_inputs[past_sequence_length_idx + 2];
+      OrtValue cache_indirection;
+      Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(), old_cache_indirection.Get<Tensor>().Shape(), allocator,
+                           cache_indirection);
+
+      // The fourth dimension of the past/present tensor is the max_sequence_length
+      const int max_sequence_length =
+          static_cast<int>(last_outputs[gpt_subgraph_first_present_output_idx].Get<Tensor>().Shape()[3]);
+      UpdateCacheIndirection(cache_indirection.GetMutable<Tensor>()->MutableDataAsSpan<int32_t>(),
+                             old_cache_indirection.Get<Tensor>().DataAsSpan<int32_t>(),
+                             beam_indices_cpu,
+                             batch_beam_size / num_beams,
+                             num_beams,
+                             input_sequence_len,
+                             max_sequence_length,
+                             current_length);
+      next_inputs[past_sequence_length_idx + 2] = cache_indirection;
+    }
     return Status::OK();
   }
 
@@ -813,9 +866,6 @@ Status UpdateDecoderFeeds(
     const IConsoleDumper* dumper) {
   ORT_UNUSED_PARAMETER(stream);
   ORT_UNUSED_PARAMETER(beam_indices_gpu);
-  ORT_UNUSED_PARAMETER(input_sequence_len);
-  ORT_UNUSED_PARAMETER(past_present_share_buffer);
-  ORT_UNUSED_PARAMETER(need_cache_indir);
   // last_outputs: logits, present_key_self_0, present_value_self_0, ...
   // next_inputs: input_ids,
   //              encoder_attention_mask, encoder_hidden_states(optional),
@@ -856,6 +906,37 @@ Status UpdateDecoderFeeds(
 
   // Update past state
   ORT_ENFORCE(last_outputs.size() >= static_cast<size_t>(1) + num_present_tensors);
+
+  if (past_present_share_buffer) {
+    // Presents were written to the past buffers in place. Only the past sequence length input needs an update.
+    const ptrdiff_t past_sequence_length_idx = 2 * num_present_tensors + t5_decoder_first_past_input_idx;
+    *(next_inputs[past_sequence_length_idx].GetMutable<Tensor>()->MutableData<int32_t>()) = current_length - 1;
+
+    // Instead of gathering the self attention past state of the selected beams, update the cache indirection table
+    // that decoder masked attention uses to find the past state of each time step. It comes 2 feeds after
+    // past_sequence_length.
+    if (need_cache_indir && num_beams > 1) {
+      const OrtValue& old_cache_indirection = next_inputs[past_sequence_length_idx + 2];
+      OrtValue cache_indirection;
+      Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(), old_cache_indirection.Get<Tensor>().Shape(), allocator,
+                           cache_indirection);
+
+      // The third dimension of the past/present tensor is the max_sequence_length
+      const int max_sequence_length =
+          static_cast<int>(last_outputs[t5_decoder_first_present_output_idx].Get<Tensor>().Shape()[2]);
+      UpdateCacheIndirection(cache_indirection.GetMutable<Tensor>()->MutableDataAsSpan<int32_t>(),
+                             old_cache_indirection.Get<Tensor>().DataAsSpan<int32_t>(),
+                             beam_indices,
+                             batch_beam_size / num_beams,
+                             num_beams,
+                             input_sequence_len,
+                             max_sequence_length,
+                             current_length);
+      next_inputs[past_sequence_length_idx + 2] = cache_indirection;
+    }
+    return Status::OK();
+  }
+
   // TODO(tianleiwu): remove num_beams==1 once GreedySearch operator is available.
   if (num_beams == 1) {
     // feed present_* output to past_* inputs one by one
@@ -397,6 +397,21 @@ Status ExpandBuffer(
     bool only_copy_shape,
     int max_sequence_length);
 
+Status InitCacheIndir(Tensor& cache_indir, Stream* stream);
+
+// Updates the cache indirection table of shape (batch_size, num_beams, max_sequence_length) for the beams selected in
+// this step. Entry t of a beam is the beam whose past state holds time step t of its sequence, so decoder masked
+// attention reads the past state through it and the past state itself never has to be reordered.
+// beam_indices has the index of the beam that each selected beam continues, within batch_size * num_beams.
+void UpdateCacheIndirection(gsl::span<int32_t> target,
+                            gsl::span<const int32_t> source,
+                            gsl::span<const int32_t> beam_indices,
+                            int batch_size,
+                            int num_beams,
+                            int input_sequence_length,
+                            int max_sequence_length,
+                            int current_length);
+
 Status UpdateDecoderCrossQK(
     int iteration_number,
     Stream* stream,
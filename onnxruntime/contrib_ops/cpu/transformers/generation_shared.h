@@ -148,6 +148,7 @@ struct IGenerationParameters {
   int decoder_start_token_id;
   int no_repeat_ngram_size;
   bool early_stopping;
+  int prompt_lookup_num_tokens = 0;  // max number of draft tokens verified per decoder run, 0 to disable
 
   // Parameters from inputs
   int min_length;
@@ -98,6 +98,8 @@ void GreedySearch::Init(const OpKernelInfo& info) {
 
   // Make sure the decoder sub-graph attribute is present for all model types.
   ORT_ENFORCE(info.GetAttr<ONNX_NAMESPACE::GraphProto>("decoder", &proto).IsOK());
+
+  prefix_cache_ = PrefixCache::Create(info.GetConfigOptions());
 }
 
 Status GreedySearch::SetupSubgraphExecutionInfo(const SessionState& session_state,
@@ -206,6 +208,7 @@ Status GreedySearch::Compute(OpKernelContext* ctx) const {
 #ifdef USE_CUDA
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, cuda_device_prop_, cuda_device_arch_));
 #endif
+      impl.SetPrefixCache(prefix_cache_.get());
       ORT_RETURN_IF_ERROR(impl.Initialize());
 
       return impl.Execute(init_run_decoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
@@ -230,6 +233,7 @@ Status GreedySearch::Compute(OpKernelContext* ctx) const {
 #ifdef USE_CUDA
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, cuda_device_prop_, cuda_device_arch_));
 #endif
+      impl.SetPrefixCache(prefix_cache_.get());
       ORT_RETURN_IF_ERROR(impl.Initialize());
 
       return impl.Execute(init_run_decoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
@@ -12,6 +12,7 @@
 #include "contrib_ops/cpu/transformers/subgraph_t5_encoder.h"
 #include "contrib_ops/cpu/transformers/subgraph_t5_decoder.h"
 #include "contrib_ops/cpu/transformers/generation_device_helper.h"
+#include "contrib_ops/cpu/transformers/prefix_cache.h"
 
 namespace onnxruntime {
 class FeedsFetchesManager;
@@ -129,6 +130,9 @@ class GreedySearch : public IControlFlowKernel {
   GreedySearchParameters parameters_;
 
   bool has_init_decoder_ = false;
+
+  // Past state of recent prompts, shared by the runs of this node. Null unless enabled in the session options.
+  std::unique_ptr<PrefixCache> prefix_cache_;
 };
 
 }  // namespace transformers
@@ -48,8 +48,7 @@ struct SamplingState : public ISamplingState<T> {
         this->h_sampled_all[i] = distribution(this->generator);
       }
     } else {
-      // TODO: Some buffer can be reused for CPU
-      this->sorted_scores = AllocateBuffer<T>(cpu_allocator, sorted_scores_buffer_, SafeInt<size_t>(total_count), stream);
+      // top-p filtering on CPU only needs the probabilities. it doesn't sort the scores.
       this->cumulative_probs = AllocateBuffer<T>(cpu_allocator, cumulative_probs_buffer_, SafeInt<size_t>(total_count), stream);
     }
   }
@@ -66,7 +65,6 @@ struct SamplingState : public ISamplingState<T> {
   IAllocatorUniquePtr<void> h_sampled_all_buffer_;
   IAllocatorUniquePtr<void> d_indices_buffer_;
   IAllocatorUniquePtr<void> d_presence_mask_buffer_;
-  IAllocatorUniquePtr<void> sorted_scores_buffer_;
   IAllocatorUniquePtr<void> cumulative_probs_buffer_;
 };
 
@@ -3,10 +3,13 @@
 
 #pragma once
 #include <algorithm>
+#include <numeric>
 #include <vector>
 
+#include "core/common/inlined_containers.h"
 #include "core/common/span_utils.h"
 #include "contrib_ops/cpu/transformers/greedy_search_impl_base.h"
+#include "contrib_ops/cpu/transformers/prefix_cache.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -23,6 +26,58 @@ std::pair<Status, std::unique_ptr<GptSubgraph>> CreateGptSubgraphAndUpdateParame
     /*out*/ BeamSearchParameters& parameters);
 }  // namespace gpt_details
 
+// Copies the slices of `input` at the given indices along batch_axis to a new tensor.
+inline void GatherBatchRows(const Tensor& input,
+                            size_t batch_axis,
+                            gsl::span<const int32_t> rows,
+                            AllocatorPtr allocator,
+                            OrtValue& output) {
+  const TensorShape& shape = input.Shape();
+  const auto outer_size = static_cast<size_t>(shape.SizeToDimension(batch_axis));
+  const auto batch_size = static_cast<size_t>(shape[batch_axis]);
+  const size_t row_bytes = static_cast<size_t>(shape.SizeFromDimension(batch_axis + 1)) * input.DataType()->Size();
+
+  TensorShapeVector dims = shape.AsShapeVector();
+  dims[batch_axis] = static_cast<int64_t>(rows.size());
+  Tensor::InitOrtValue(input.DataType(), TensorShape(dims), std::move(allocator), output);
+
+  const auto* source = static_cast<const char*>(input.DataRaw());
+  auto* target = static_cast<char*>(output.GetMutable<Tensor>()->MutableDataRaw());
+  for (size_t outer = 0; outer < outer_size; ++outer) {
+    for (int32_t row : rows) {
+      memcpy(target, source + (outer * batch_size + static_cast<size_t>(row)) * row_bytes, row_bytes);
+      target += row_bytes;
+    }
+  }
+}
+
+// Longest n-gram at the end of the sequence that prompt lookup decoding tries to find earlier in the sequence.
+constexpr size_t kPromptLookupMaxNgramSize = 3;
+
+// Proposes draft tokens for prompt lookup decoding: finds the most recent earlier occurrence of the last n tokens of
+// the sequence, trying shorter n-grams when there is none, and copies up to max_tokens tokens that followed it.
+inline void ProposePromptLookupTokens(gsl::span<const int32_t> sequence,
+                                      size_t max_tokens,
+                                      InlinedVector<int32_t>& draft_tokens) {
+  draft_tokens.clear();
+  const size_t length = sequence.size();
+  if (max_tokens == 0 || length < 2) {
+    return;
+  }
+
+  for (size_t ngram_size = std::min(kPromptLookupMaxNgramSize, length - 1); ngram_size > 0; --ngram_size) {
+    const auto suffix = sequence.subspan(length - ngram_size);
+    for (size_t start = length - ngram_size; start-- > 0;) {
+      if (std::equal(suffix.begin(), suffix.end(), sequence.begin() + start)) {
+        const size_t follow = start + ngram_size;
+        const size_t count = std::min(max_tokens, length - follow);
+        draft_tokens.assign(sequence.begin() + follow, sequence.begin() + follow + count);
+        return;
+      }
+    }
+  }
+}
+
 // Greedy search implementation for GPT-2 model.
 template <typename T, typename ParametersT>
 class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
@@ -79,6 +134,11 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
   }
 #endif
 
+  // Reuse the past state of earlier prompts sharing a prefix with this one. Only used on CPU when batch_size is 1.
+  void SetPrefixCache(PrefixCache* prefix_cache) {
+    prefix_cache_ = prefix_cache;
+  }
+
   // Execute beam search in iterations util stopping criteria is reached.
   // In each iteration, GPT subgraph is called, and next token for each sequence is generated.
   Status Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
@@ -101,6 +161,38 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
       gsl::span<const int32_t> next_tokens,
       int past_sequence_length);
 
+  // Drops the rows of sequences that met EOS from the decoder inputs, so that the remaining steps only run the
+  // unfinished sequences. active_rows maps the rows of the decoder batch to the batch of the op and is updated.
+  Status CompactFinishedRows(gsl::span<const bool> eos_meet,
+                             InlinedVector<int32_t>& active_rows,
+                             std::vector<OrtValue>& feeds,
+                             std::vector<OrtValue>& fetches,
+                             gsl::span<int32_t> next_positions,
+                             OrtValue& position_ids);
+
+  // Generates the next tokens from the logits of a decoder run whose input was the last token followed by
+  // draft_tokens, with the logits for each input in turn, until a generated token differs from the draft token.
+  // This gives the same tokens as one run per token. Returns the number of tokens appended to the sequence.
+  Status VerifyDraftTokens(const OrtValue& logits,
+                           gsl::span<const int32_t> draft_tokens,
+                           GreedySearchState<T>& greedy_state,
+                           ISamplingState<T>& sampling_state,
+                           int counter,
+                           int& num_generated);
+
+  // Replaces the initial feeds so that the decoder only runs on the prompt tokens after a cached prefix, and returns
+  // the length of the prefix, or 0 if no cached prefix matches.
+  size_t ApplyCachedPrefix(gsl::span<const int32_t> prompt, std::vector<OrtValue>& feeds);
+
+  // Prepares the inputs of the next decoder run for prompt lookup decoding: last_token followed by draft_tokens at
+  // `position`. The past state is the present state of the last run without the num_rejected tokens at its end.
+  Status UpdateFeedsWithDraftTokens(const std::vector<OrtValue>& last_outputs,
+                                    std::vector<OrtValue>& next_inputs,
+                                    int32_t last_token,
+                                    gsl::span<const int32_t> draft_tokens,
+                                    int position,
+                                    int num_rejected);
+
   const SessionState* init_run_decoder_session_state_ = nullptr;
   GptSubgraph* init_run_gpt_subgraph_ = nullptr;
   GptSubgraph& gpt_subgraph_;
@@ -116,6 +208,8 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
 
   const void* cuda_device_prop_ = nullptr;
   int cuda_device_arch_ = 0;
+
+  PrefixCache* prefix_cache_ = nullptr;
 };
 
 template <typename T, typename ParametersT>
@@ -187,6 +281,207 @@ Status GreedySearchGpt<T, ParametersT>::UpdateFeeds(
                             false);
 }
 
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::CompactFinishedRows(gsl::span<const bool> eos_meet,
+                                                            InlinedVector<int32_t>& active_rows,
+                                                            std::vector<OrtValue>& feeds,
+                                                            std::vector<OrtValue>& fetches,
+                                                            gsl::span<int32_t> next_positions,
+                                                            OrtValue& position_ids) {
+  // rows of the current decoder batch to keep
+  InlinedVector<int32_t> keep;
+  keep.reserve(active_rows.size());
+  for (size_t i = 0; i < active_rows.size(); ++i) {
+    if (!eos_meet[active_rows[i]]) {
+      keep.push_back(static_cast<int32_t>(i));
+    }
+  }
+
+  if (keep.size() == active_rows.size()) {
+    return Status::OK();
+  }
+
+  // present state has shape (2, batch_size, num_heads, past_seq_len, head_size)
+  for (int layer = 0; layer < gpt_subgraph_.num_layers; layer++) {
+    OrtValue& present = fetches[static_cast<size_t>(gpt_subgraph_.GetFirstPresentOutputIndex()) + layer];
+    OrtValue compacted;
+    GatherBatchRows(present.Get<Tensor>(), 1, keep, this->temp_space_allocator_, compacted);
+    present = std::move(compacted);
+  }
+
+  // attention mask has shape (batch_size, current_length - 1) until UpdateFeeds appends the new token
+  OrtValue attention_mask;
+  GatherBatchRows(feeds[2].Get<Tensor>(), 0, keep, this->temp_space_allocator_, attention_mask);
+  feeds[2] = std::move(attention_mask);
+
+  // keep[i] >= i, so the positions and the row mapping can be compacted in place
+  for (size_t i = 0; i < keep.size(); ++i) {
+    next_positions[i] = next_positions[keep[i]];
+    active_rows[i] = active_rows[keep[i]];
+  }
+  active_rows.resize(keep.size());
+
+  int64_t dims[] = {static_cast<int64_t>(keep.size()), 1};
+  Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(),
+                       TensorShape(&dims[0], 2),
+                       next_positions.data(),
+                       this->temp_space_allocator_->Info(),
+                       position_ids);
+
+  return Status::OK();
+}
+
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::VerifyDraftTokens(const OrtValue& logits,
+                                                          gsl::span<const int32_t> draft_tokens,
+                                                          GreedySearchState<T>& greedy_state,
+                                                          ISamplingState<T>& sampling_state,
+                                                          int counter,
+                                                          int& num_generated) {
+  // logits has shape (1, 1 + num_draft_tokens, vocab_size)
+  const Tensor& logits_tensor = logits.Get<Tensor>();
+  const int64_t vocab_size = logits_tensor.Shape()[2];
+  int64_t dims[] = {1, 1, vocab_size};
+  const TensorShape token_logits_shape(&dims[0], 3);
+
+  num_generated = 0;
+  for (size_t i = 0; i <= draft_tokens.size(); ++i) {
+    OrtValue token_logits;
+    Tensor::InitOrtValue(logits_tensor.DataType(),
+                         token_logits_shape,
+                         const_cast<T*>(logits_tensor.Data<T>()) + i * static_cast<size_t>(vocab_size),
+                         logits_tensor.Location(),
+                         token_logits);
+
+    gsl::span<int32_t> next_tokens;
+    ORT_RETURN_IF_ERROR(this->GenerateNextToken(token_logits,
+                                                next_tokens,
+                                                greedy_state,
+                                                sampling_state,
+                                                counter,
+                                                this->parameters_->eos_token_id));
+    ++num_generated;
+
+    if (greedy_state.eos_meet[0] || i == draft_tokens.size() || next_tokens[0] != draft_tokens[i]) {
+      break;
+    }
+  }
+
+  return Status::OK();
+}
+
+template <typename T, typename ParametersT>
+size_t GreedySearchGpt<T, ParametersT>::ApplyCachedPrefix(gsl::span<const int32_t> prompt,
+                                                          std::vector<OrtValue>& feeds) {
+  // cached past state is only valid when every prompt token is attended to at positions 0, 1, ...
+  gsl::span<const int32_t> attention_mask = feeds[2].Get<Tensor>().DataAsSpan<int32_t>();
+  if (std::any_of(attention_mask.begin(), attention_mask.end(), [](int32_t mask) { return mask != 1; })) {
+    return 0;
+  }
+
+  // at least the last prompt token runs through the decoder to produce the logits
+  std::vector<OrtValue> past;
+  const size_t prefix_length = prefix_cache_->Lookup(prompt, prompt.size() - 1, this->temp_space_allocator_, past);
+  if (prefix_length == 0) {
+    return 0;
+  }
+
+  const auto suffix_length = static_cast<int64_t>(prompt.size() - prefix_length);
+  int64_t dims[] = {1, suffix_length};
+  TensorShape input_shape(&dims[0], 2);
+  auto int32_type = DataTypeImpl::GetType<int32_t>();
+
+  OrtValue input_ids;
+  Tensor::InitOrtValue(int32_type, input_shape, this->temp_space_allocator_, input_ids);
+  int32_t* input_ids_data = input_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+  OrtValue position_ids;
+  Tensor::InitOrtValue(int32_type, input_shape, this->temp_space_allocator_, position_ids);
+  int32_t* position_data = position_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+  for (int64_t i = 0; i < suffix_length; i++) {
+    input_ids_data[i] = prompt[prefix_length + static_cast<size_t>(i)];
+    position_data[i] = static_cast<int32_t>(prefix_length + static_cast<size_t>(i));
+  }
+
+  feeds[0] = input_ids;
+  feeds[1] = position_ids;
+  // the attention mask of the whole prompt stays as it is
+  for (int layer = 0; layer < gpt_subgraph_.num_layers; layer++) {
+    feeds[static_cast<size_t>(gpt_subgraph_.GetFirstPastInputIndex()) + layer] = std::move(past[layer]);
+  }
+
+  return prefix_length;
+}
+
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::UpdateFeedsWithDraftTokens(const std::vector<OrtValue>& last_outputs,
+                                                                   std::vector<OrtValue>& next_inputs,
+                                                                   int32_t last_token,
+                                                                   gsl::span<const int32_t> draft_tokens,
+                                                                   int position,
+                                                                   int num_rejected) {
+  const auto num_inputs = static_cast<int64_t>(draft_tokens.size()) + 1;
+  int64_t dims[] = {1, num_inputs};
+  TensorShape input_shape(&dims[0], 2);
+  auto int32_type = DataTypeImpl::GetType<int32_t>();
+
+  OrtValue input_ids;
+  Tensor::InitOrtValue(int32_type, input_shape, this->temp_space_allocator_, input_ids);
+  int32_t* input_ids_data = input_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+  OrtValue position_ids;
+  Tensor::InitOrtValue(int32_type, input_shape, this->temp_space_allocator_, position_ids);
+  int32_t* position_data = position_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+  for (int64_t i = 0; i < num_inputs; i++) {
+    input_ids_data[i] = i == 0 ? last_token : draft_tokens[static_cast<size_t>(i) - 1];
+    position_data[i] = position + static_cast<int32_t>(i);
+  }
+  next_inputs[0] = input_ids;
+  next_inputs[1] = position_ids;
+
+  // present state has shape (2, 1, num_heads, total_length, head_size). drop the entries of rejected draft tokens.
+  int64_t past_length = 0;
+  const int first_past_index = gpt_subgraph_.GetFirstPastInputIndex();
+  const int first_present_index = gpt_subgraph_.GetFirstPresentOutputIndex();
+  for (int layer = 0; layer < gpt_subgraph_.num_layers; layer++) {
+    const OrtValue& present_value = last_outputs[static_cast<size_t>(first_present_index) + layer];
+    const Tensor& present = present_value.Get<Tensor>();
+    const TensorShape& present_shape = present.Shape();
+    past_length = present_shape[3] - num_rejected;
+    if (num_rejected == 0) {
+      next_inputs[static_cast<size_t>(first_past_index) + layer] = present_value;
+      continue;
+    }
+
+    TensorShapeVector past_dims = present_shape.AsShapeVector();
+    past_dims[3] = past_length;
+    OrtValue past;
+    Tensor::InitOrtValue(present.DataType(), TensorShape(past_dims), this->temp_space_allocator_, past);
+
+    const size_t outer_size = static_cast<size_t>(present_shape.SizeToDimension(3));
+    const size_t token_bytes = static_cast<size_t>(present_shape[4]) * present.DataType()->Size();
+    const auto* source = static_cast<const char*>(present.DataRaw());
+    auto* target = static_cast<char*>(past.GetMutable<Tensor>()->MutableDataRaw());
+    for (size_t i = 0; i < outer_size; ++i) {
+      memcpy(target + i * static_cast<size_t>(past_length) * token_bytes,
+             source + i * static_cast<size_t>(present_shape[3]) * token_bytes,
+             static_cast<size_t>(past_length) * token_bytes);
+    }
+    next_inputs[static_cast<size_t>(first_past_index) + layer] = past;
+  }
+
+  // the attention mask of the last run covers its total length. keep the part for the past and attend to the inputs.
+  const Tensor& old_mask = next_inputs[2].Get<Tensor>();
+  const int32_t* old_mask_data = old_mask.Data<int32_t>();
+  int64_t mask_dims[] = {1, past_length + num_inputs};
+  OrtValue attention_mask;
+  Tensor::InitOrtValue(int32_type, TensorShape(&mask_dims[0], 2), this->temp_space_allocator_, attention_mask);
+  int32_t* mask_data = attention_mask.GetMutable<Tensor>()->MutableData<int32_t>();
+  std::copy(old_mask_data, old_mask_data + past_length, mask_data);
+  std::fill(mask_data + past_length, mask_data + past_length + num_inputs, 1);
+  next_inputs[2] = attention_mask;
+
+  return Status::OK();
+}
+
 template <typename T, typename ParametersT>
 Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
                                                 const FeedsFetchesManager& feeds_fetches_manager) {
@@ -268,6 +563,32 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
                        this->temp_space_allocator_->Info(),
                        position_ids);
 
+  // On CPU, sequences that met EOS are removed from the decoder batch between steps instead of being decoded as padding
+  // until the longest sequence finishes. The logits of the remaining rows are scattered back to the full batch so
+  // the logits processors and the sequences keep working on the batch of the op.
+  const bool compact_finished_rows = !this->IsCuda() && !gpt_subgraph_.past_present_share_buffer_;
+  const auto batch_beam_size = static_cast<size_t>(parameters->BatchBeamSize());
+  InlinedVector<int32_t> active_rows(batch_beam_size);
+  std::iota(active_rows.begin(), active_rows.end(), 0);
+  InlinedVector<int32_t> active_next_tokens;
+  OrtValue full_logits;
+
+  // Prompt lookup decoding verifies draft tokens copied from earlier in the sequence in the same decoder run as the
+  // last token, so repetitive output (code, quotes of the prompt) takes fewer runs. Sampling isn't supported since
+  // the generated tokens would not match the draft tokens with the same probability. A draft model subgraph would
+  // reuse the verification below but needs its own past state and subgraph attribute, so it isn't supported.
+  const bool use_prompt_lookup = parameters->prompt_lookup_num_tokens > 0 && batch_beam_size == 1 &&
+                                 !this->IsCuda() && !gpt_subgraph_.past_present_share_buffer_ &&
+                                 std::is_same<ParametersT, GreedySearchParameters>::value;
+  InlinedVector<int32_t> draft_tokens;  // draft tokens in the inputs of the last decoder run
+  int next_position = use_prompt_lookup ? greedy_state.next_positions[0] : 0;
+
+  // With a cached prefix, the first run uses the decoder subgraph on the remaining prompt tokens instead of the
+  // init decoder on the whole prompt. The past state of the whole prompt is added to the cache after the first run.
+  const bool use_prefix_cache = prefix_cache_ != nullptr && batch_beam_size == 1 && !this->IsCuda() &&
+                                !gpt_subgraph_.past_present_share_buffer_;
+  const size_t cached_prefix_length = use_prefix_cache ? ApplyCachedPrefix(input_ids, feeds) : 0;
+
   int current_length = parameters->sequence_length;
   int iteration_counter = 0;
   while (current_length < parameters->max_length) {
@@ -282,7 +603,7 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
 
     // For the first iteration use the init_run_decoder subgraph (if present)
     if (iteration_counter++ == 0 &&
-        init_run_decoder_session_state_ != nullptr) {
+        init_run_decoder_session_state_ != nullptr && cached_prefix_length == 0) {
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
       const_cast<SessionState*>(this->init_run_decoder_session_state_)->IncrementGraphExecutionCounter();
 #endif
@@ -312,15 +633,54 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
 
     ORT_RETURN_IF_ERROR(status);
 
-    const OrtValue& logits = fetches[0];
-    gsl::span<int32_t> next_tokens;
+    if (use_prefix_cache && iteration_counter == 1) {
+      const auto first_present = fetches.begin() + gpt_subgraph_.GetFirstPresentOutputIndex();
+      prefix_cache_->Insert(input_ids,
+                            gsl::make_span(&*first_present, static_cast<size_t>(gpt_subgraph_.num_layers)),
+                            this->cpu_allocator_);
+    }
 
-    ORT_RETURN_IF_ERROR(this->GenerateNextToken(logits,
-                                                next_tokens,
-                                                greedy_state,
-                                                sampling_state,
-                                                iteration_counter,
-                                                parameters->eos_token_id));
+    const OrtValue* logits = &fetches[0];
+    if (active_rows.size() < batch_beam_size) {
+      // Logits has shape (active_rows, 1, vocab_size) once rows were dropped, which only happens after the first run.
+      const Tensor& active_logits = fetches[0].Get<Tensor>();
+      const auto vocab_size = static_cast<size_t>(active_logits.Shape()[2]);
+      if (!full_logits.IsAllocated()) {
+        int64_t dims[] = {static_cast<int64_t>(batch_beam_size), 1, static_cast<int64_t>(vocab_size)};
+        Tensor::InitOrtValue(active_logits.DataType(), TensorShape(&dims[0], 3), this->temp_space_allocator_,
+                             full_logits);
+        // rows of finished sequences are never written. zero them so the logits processors see valid numbers.
+        memset(full_logits.GetMutable<Tensor>()->MutableDataRaw(), 0, full_logits.Get<Tensor>().SizeInBytes());
+      }
+
+      gsl::span<const T> source = active_logits.DataAsSpan<T>();
+      gsl::span<T> target = full_logits.GetMutable<Tensor>()->MutableDataAsSpan<T>();
+      for (size_t i = 0; i < active_rows.size(); ++i) {
+        gsl::copy(source.subspan(i * vocab_size, vocab_size),
+                  target.subspan(static_cast<size_t>(active_rows[i]) * vocab_size, vocab_size));
+      }
+      logits = &full_logits;
+    }
+
+    gsl::span<int32_t> next_tokens;
+    int num_generated = 1;
+
+    if (!draft_tokens.empty()) {
+      ORT_RETURN_IF_ERROR(VerifyDraftTokens(*logits,
+                                            draft_tokens,
+                                            greedy_state,
+                                            sampling_state,
+                                            iteration_counter,
+                                            num_generated));
+      next_tokens = greedy_state.next_tokens;
+    } else {
+      ORT_RETURN_IF_ERROR(this->GenerateNextToken(*logits,
+                                                  next_tokens,
+                                                  greedy_state,
+                                                  sampling_state,
+                                                  iteration_counter,
+                                                  parameters->eos_token_id));
+    }
 
     // When all batches are finished, stop earlier to avoid wasting computation.
     gsl::span<bool>& eos_meet = greedy_state.eos_meet;
@@ -335,8 +695,8 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
       break;
     }
 
-    // Increase sequence length after a new token is generated.
-    ++current_length;
+    // Increase sequence length after new tokens are generated.
+    current_length += num_generated;
 
 #ifdef USE_CUDA
     // Reorder past state after first run if the GPT subgraph (the one used after the first iteration)
@@ -358,12 +718,38 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
 #endif
 
     // Prepare inputs for next round of subgraph call.
-    if (current_length < parameters->max_length) {
+    if (current_length < parameters->max_length && use_prompt_lookup) {
+      // inputs of the last run after the accepted draft tokens are dropped from the past state
+      const int num_rejected = static_cast<int>(draft_tokens.size()) + 1 - num_generated;
+      if (iteration_counter > 1) {
+        next_position += num_generated;
+      }
+
+      // the run verifies up to 1 + draft tokens, which must fit in max_length
+      const auto max_draft_tokens = static_cast<size_t>(std::min(parameters->prompt_lookup_num_tokens,
+                                                                 parameters->max_length - current_length - 1));
+      ProposePromptLookupTokens(greedy_state.sequences.GetSequence(0), max_draft_tokens, draft_tokens);
+      ORT_RETURN_IF_ERROR(UpdateFeedsWithDraftTokens(fetches, feeds, next_tokens[0], draft_tokens, next_position,
+                                                     num_rejected));
+    } else if (current_length < parameters->max_length) {
       bool increase_position = (iteration_counter > 1);
 
+      gsl::span<const int32_t> decoder_next_tokens = next_tokens;
+      if (compact_finished_rows) {
+        ORT_RETURN_IF_ERROR(CompactFinishedRows(eos_meet, active_rows, feeds, fetches,
+                                                greedy_state.next_positions, position_ids));
+        if (active_rows.size() < batch_beam_size) {
+          active_next_tokens.resize(active_rows.size());
+          for (size_t i = 0; i < active_rows.size(); ++i) {
+            active_next_tokens[i] = next_tokens[active_rows[i]];
+          }
+          decoder_next_tokens = active_next_tokens;
+        }
+      }
+
       ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
                                       position_ids, increase_position,
-                                      ReinterpretAsSpan<const int32_t>(next_tokens),
+                                      decoder_next_tokens,
                                       current_length - 1));
     }
     if (gpt_subgraph_.past_present_share_buffer_) {
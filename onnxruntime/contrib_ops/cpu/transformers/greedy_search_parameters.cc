@@ -15,6 +15,9 @@ void GreedySearchParameters::ParseFromAttributes(const OpKernelInfo& info) {
   decoder_start_token_id = static_cast<int>(info.GetAttrOrDefault<int64_t>("decoder_start_token_id", -1));
   no_repeat_ngram_size = static_cast<int>(info.GetAttrOrDefault<int64_t>("no_repeat_ngram_size", 0));
   vocab_size = static_cast<int>(info.GetAttrOrDefault<int64_t>("vocab_size", -1));
+  prompt_lookup_num_tokens = static_cast<int>(info.GetAttrOrDefault<int64_t>("prompt_lookup_num_tokens", 0));
+  ORT_ENFORCE(prompt_lookup_num_tokens >= 0, "prompt_lookup_num_tokens shall be non-negative, got ",
+              prompt_lookup_num_tokens);
 }
 
 void GreedySearchParameters::ParseFromInputs(OpKernelContext* context) {
@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/transformers/prefix_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "core/common/parse_string.h"
+#include "core/framework/config_options.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+namespace {
+
+// Copies the first `length` entries along the sequence axis (axis 3) of a past state tensor with shape
+// (2, batch_size, num_heads, sequence_length, head_size).
+void CopySequencePrefix(const Tensor& source, int64_t length, Tensor& target) {
+  const TensorShape& shape = source.Shape();
+  const auto outer_size = static_cast<size_t>(shape.SizeToDimension(3));
+  const size_t token_bytes = static_cast<size_t>(shape[4]) * source.DataType()->Size();
+  const size_t source_bytes = static_cast<size_t>(shape[3]) * token_bytes;
+  const size_t target_bytes = static_cast<size_t>(length) * token_bytes;
+
+  const auto* source_data = static_cast<const char*>(source.DataRaw());
+  auto* target_data = static_cast<char*>(target.MutableDataRaw());
+  for (size_t i = 0; i < outer_size; ++i) {
+    memcpy(target_data + i * target_bytes, source_data + i * source_bytes, target_bytes);
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<PrefixCache> PrefixCache::Create(const ConfigOptions& config_options) {
+  const std::string size = config_options.GetConfigOrDefault(kOrtSessionOptionsGenerationPrefixCacheSizeInBytes, "0");
+  size_t max_bytes = 0;
+  ORT_ENFORCE(TryParseStringWithClassicLocale(size, max_bytes),
+              "Invalid value for ", kOrtSessionOptionsGenerationPrefixCacheSizeInBytes, ": ", size);
+  return max_bytes > 0 ? std::make_unique<PrefixCache>(max_bytes) : nullptr;
+}
+
+uint64_t PrefixCache::HashPrefix(gsl::span<const int32_t> tokens) {
+  // FNV-1a
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < kMinPrefixLength; ++i) {
+    hash ^= static_cast<uint32_t>(tokens[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+size_t PrefixCache::Lookup(gsl::span<const int32_t> tokens,
+                           size_t max_length,
+                           AllocatorPtr allocator,
+                           std::vector<OrtValue>& past) {
+  max_length = std::min(max_length, tokens.size());
+  if (max_length < kMinPrefixLength) {
+    return 0;
+  }
+
+  const uint64_t prefix_hash = HashPrefix(tokens);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto best = entries_.end();
+  size_t best_length = 0;
+  for (auto entry = entries_.begin(); entry != entries_.end(); ++entry) {
+    if (entry->prefix_hash != prefix_hash) {
+      continue;
+    }
+
+    const size_t length = std::min(max_length, entry->tokens.size());
+    const auto mismatch = std::mismatch(tokens.begin(), tokens.begin() + length, entry->tokens.begin());
+    const auto common_length = static_cast<size_t>(mismatch.first - tokens.begin());
+    if (common_length > best_length) {
+      best = entry;
+      best_length = common_length;
+    }
+  }
+
+  if (best_length < kMinPrefixLength) {
+    return 0;
+  }
+
+  past.clear();
+  past.reserve(best->present.size());
+  for (const Tensor& present : best->present) {
+    TensorShapeVector dims = present.Shape().AsShapeVector();
+    dims[3] = static_cast<int64_t>(best_length);
+    OrtValue past_value;
+    Tensor::InitOrtValue(present.DataType(), TensorShape(dims), allocator, past_value);
+    CopySequencePrefix(present, static_cast<int64_t>(best_length), *past_value.GetMutable<Tensor>());
+    past.push_back(std::move(past_value));
+  }
+
+  entries_.splice(entries_.begin(), entries_, best);
+  return best_length;
+}
+
+void PrefixCache::Insert(gsl::span<const int32_t> tokens,
+                         gsl::span<const OrtValue> present,
+                         AllocatorPtr allocator) {
+  if (tokens.size() < kMinPrefixLength) {
+    return;
+  }
+
+  size_t bytes = tokens.size() * sizeof(int32_t);
+  for (const OrtValue& value : present) {
+    bytes += value.Get<Tensor>().SizeInBytes();
+  }
+  if (bytes > max_bytes_) {
+    return;
+  }
+
+  const uint64_t prefix_hash = HashPrefix(tokens);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto entry = entries_.begin(); entry != entries_.end(); ++entry) {
+      if (entry->prefix_hash == prefix_hash && entry->tokens.size() >= tokens.size() &&
+          std::equal(tokens.begin(), tokens.end(), entry->tokens.begin())) {
+        entries_.splice(entries_.begin(), entries_, entry);
+        return;
+      }
+    }
+  }
+
+  // copy outside of the lock. another thread may insert the same tokens meanwhile, which only wastes some space.
+  Entry entry{prefix_hash, std::vector<int32_t>(tokens.begin(), tokens.end()), {}, bytes};
+  entry.present.reserve(present.size());
+  for (const OrtValue& value : present) {
+    const Tensor& source = value.Get<Tensor>();
+    Tensor copy(source.DataType(), source.Shape(), allocator);
+    memcpy(copy.MutableDataRaw(), source.DataRaw(), source.SizeInBytes());
+    entry.present.push_back(std::move(copy));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (!entries_.empty() && total_bytes_ + bytes > max_bytes_) {
+    total_bytes_ -= entries_.back().bytes;
+    entries_.pop_back();
+  }
+  total_bytes_ += bytes;
+  entries_.push_front(std::move(entry));
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <gsl/gsl>
+
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+struct ConfigOptions;
+
+namespace contrib {
+namespace transformers {
+
+// Keeps the past state that the GPT decoder computed for recent prompts, so that a prompt starting with the same
+// tokens as one of them (e.g. a shared system prompt) only runs the decoder on the rest of its tokens.
+//
+// The past state of the first n tokens only depends on those tokens, so any entry sharing a prefix with a prompt can
+// seed it. Entries are bounded by a total size in bytes and evicted least recently used first. Thread safe, since
+// the kernel that owns it can run concurrently.
+//
+// Each GreedySearch and Sampling kernel owns its cache, so it is shared by all runs of the node in a session but not
+// across nodes or sessions: the entries don't record which decoder computed them.
+class PrefixCache {
+ public:
+  // Prefixes shorter than this are not worth the lookup and the copies.
+  static constexpr size_t kMinPrefixLength = 16;
+
+  explicit PrefixCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+  // Creates the cache sized by the session option kOrtSessionOptionsGenerationPrefixCacheSizeInBytes, or returns
+  // nullptr when the option is 0 or not set. Throws if the option is not a number.
+  static std::unique_ptr<PrefixCache> Create(const ConfigOptions& config_options);
+
+  // Finds the entry sharing the longest prefix with `tokens`, limited to max_length tokens. On a hit the past state for
+  // the prefix is copied to `past`, one tensor per layer with shape (2, 1, num_heads, prefix_length, head_size), and
+  // the prefix length is returned. Returns 0 if there is no prefix of at least kMinPrefixLength tokens.
+  size_t Lookup(gsl::span<const int32_t> tokens,
+                size_t max_length,
+                AllocatorPtr allocator,
+                std::vector<OrtValue>& past);
+
+  // Adds the present state of the decoder run on `tokens`, one tensor per layer with shape
+  // (2, 1, num_heads, tokens.size(), head_size). Does nothing if an entry already covers the tokens.
+  void Insert(gsl::span<const int32_t> tokens,
+              gsl::span<const OrtValue> present,
+              AllocatorPtr allocator);
+
+  size_t SizeInBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_bytes_;
+  }
+
+ private:
+  struct Entry {
+    uint64_t prefix_hash;  // hash of the first kMinPrefixLength tokens, to skip entries that can't match
+    std::vector<int32_t> tokens;
+    std::vector<Tensor> present;
+    size_t bytes;
+  };
+
+  static uint64_t HashPrefix(gsl::span<const int32_t> tokens);
+
+  const size_t max_bytes_;
+  mutable std::mutex mutex_;
+  std::list<Entry> entries_;  // most recently used first
+  size_t total_bytes_ = 0;
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -60,6 +60,8 @@ void Sampling::Init(const OpKernelInfo& info) {
 
   // Make sure the decoder sub-graph attribute is present for all model types.
   ORT_ENFORCE(info.GetAttr<ONNX_NAMESPACE::GraphProto>("decoder", &proto).IsOK());
+
+  prefix_cache_ = PrefixCache::Create(info.GetConfigOptions());
 }
 
 Status Sampling::SetupSubgraphExecutionInfo(const SessionState& session_state,
@@ -142,6 +144,7 @@ Status Sampling::Compute(OpKernelContext* ctx) const {
 #ifdef USE_CUDA
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, gpu_device_prop_, gpu_device_arch_));
 #endif
+      impl.SetPrefixCache(prefix_cache_.get());
       ORT_RETURN_IF_ERROR(impl.Initialize());
 
       return impl.Execute(init_run_decoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
@@ -166,6 +169,7 @@ Status Sampling::Compute(OpKernelContext* ctx) const {
 #ifdef USE_CUDA
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, gpu_device_prop_, gpu_device_arch_));
 #endif
+      impl.SetPrefixCache(prefix_cache_.get());
       ORT_RETURN_IF_ERROR(impl.Initialize());
 
       return impl.Execute(init_run_decoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
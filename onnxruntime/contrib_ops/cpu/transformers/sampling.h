@@ -9,6 +9,7 @@
 #include "core/providers/cpu/controlflow/utils.h"
 #include "contrib_ops/cpu/transformers/subgraph_gpt.h"
 #include "contrib_ops/cpu/transformers/generation_device_helper.h"
+#include "contrib_ops/cpu/transformers/prefix_cache.h"
 #include "contrib_ops/cpu/transformers/sampling_parameters.h"
 
 namespace onnxruntime {
@@ -111,6 +112,9 @@ class Sampling : public IControlFlowKernel {
   SamplingParameters parameters_;
 
   bool has_init_decoder_ = false;
+
+  // Past state of recent prompts, shared by the runs of this node. Null unless enabled in the session options.
+  std::unique_ptr<PrefixCache> prefix_cache_;
 };
 
 }  // namespace transformers
@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+#include <gsl/gsl>
+
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace SamplingCpuHelper {
+
+// Number of highest probability tokens selected before the candidate set is grown. Top-p usually keeps a few tens of
+// tokens, so one partial selection over the vocabulary followed by sorting this many candidates is the common case.
+constexpr size_t kTopPInitialCandidates = 256;
+
+// Keeps the smallest set of highest probability tokens of one row whose probability mass reaches top_p and sets the
+// scores of all other tokens to filter_value.
+//
+// Only the candidate prefix is sorted: std::nth_element moves the highest probabilities to the front of `indices`, that
+// prefix is sorted and accumulated, and the prefix is grown 4x at a time until it covers top_p. This replaces sorting
+// the whole vocabulary, which dominates for large vocabularies since the kept set is typically tiny.
+//
+// The default mode matches the HuggingFace top-p warper: a token is kept while the mass of the tokens ranked above it is
+// below top_p, and at least min_tokens_to_keep tokens are kept. Tokens whose probability underflows to 0 are filtered
+// too, as the warper removes tokens whose mass together with all lower ranked tokens is at most 1 - top_p, which
+// matters for top_p = 1. With custom_sampling a token is kept while that mass doesn't exceed top_p, and at least one
+// token is kept.
+//
+// probs and indices are scratch buffers with the same size as scores.
+inline void TopPFilter(gsl::span<float> scores,
+                       float top_p,
+                       float filter_value,
+                       size_t min_tokens_to_keep,
+                       bool custom_sampling,
+                       gsl::span<float> probs,
+                       gsl::span<int32_t> indices) {
+  const size_t vocab_size = scores.size();
+  if (vocab_size == 0) {
+    return;
+  }
+
+  MlasComputeSoftmax(scores.data(), probs.data(), 1, vocab_size, false, false, nullptr);
+  std::iota(indices.begin(), indices.end(), 0);
+
+  const float* probs_data = probs.data();
+  auto by_prob = [probs_data](int32_t lhs, int32_t rhs) { return probs_data[lhs] > probs_data[rhs]; };
+
+  const size_t min_keep = custom_sampling ? 1 : std::min(min_tokens_to_keep, vocab_size - 1);
+  size_t candidates = std::min(vocab_size, std::max(kTopPInitialCandidates, min_keep));
+  size_t sorted = 0;  // indices[0, sorted) hold the highest probabilities in descending order
+  size_t keep = vocab_size;
+  float cumulative = 0.0f;
+
+  while (keep == vocab_size) {
+    auto begin = indices.begin() + sorted;
+    auto middle = indices.begin() + candidates;
+    if (middle != indices.end()) {
+      std::nth_element(begin, middle, indices.end(), by_prob);
+    }
+    std::sort(begin, middle, by_prob);
+
+    for (; sorted < candidates; ++sorted) {
+      const bool covered = custom_sampling ? cumulative > top_p
+                                           : cumulative >= top_p || probs_data[indices[sorted]] == 0.0f;
+      if (covered && sorted >= min_keep) {
+        keep = sorted;
+        break;
+      }
+      cumulative += probs_data[indices[sorted]];
+    }
+
+    if (candidates == vocab_size) {
+      break;
+    }
+    candidates = std::min(vocab_size, candidates * 4);
+  }
+
+  for (size_t i = keep; i < vocab_size; ++i) {
+    scores[indices[i]] = filter_value;
+  }
+}
+
+// Applies TopPFilter to each row of a [batch_size, vocab_size] buffer of scores, in parallel over the rows.
+inline void TopPFilter(gsl::span<float> scores,
+                       size_t batch_size,
+                       float top_p,
+                       float filter_value,
+                       size_t min_tokens_to_keep,
+                       bool custom_sampling,
+                       gsl::span<float> probs,
+                       gsl::span<int32_t> indices,
+                       concurrency::ThreadPool* thread_pool) {
+  if (batch_size == 0) {
+    return;
+  }
+
+  const size_t vocab_size = scores.size() / batch_size;
+  // softmax plus a partial selection pass over the row, with a few compares per element
+  const TensorOpCost cost{static_cast<double>(vocab_size * sizeof(float)), 0.0, static_cast<double>(vocab_size) * 8.0};
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(batch_size), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (auto row = static_cast<size_t>(first); row < static_cast<size_t>(last); ++row) {
+          const size_t offset = row * vocab_size;
+          TopPFilter(scores.subspan(offset, vocab_size), top_p, filter_value, min_tokens_to_keep, custom_sampling,
+                     probs.subspan(offset, vocab_size), indices.subspan(offset, vocab_size));
+        }
+      });
+}
+
+}  // namespace SamplingCpuHelper
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -40,6 +40,7 @@ class MatMulNBits final : public CudaKernel {
     ORT_ENFORCE(Status::OK() == info.GetAttr<int64_t>("N", &N_));
     ORT_ENFORCE(Status::OK() == info.GetAttr<int64_t>("block_size", &block_size_));
     ORT_ENFORCE(Status::OK() == info.GetAttr<int64_t>("bits", &nbits_));
+    ORT_ENFORCE(nbits_ == 4 || nbits_ == 8, "Only 4b and 8b quantization is supported for MatMulNBits op in CUDA.");
 
     constexpr size_t kInputIndexScale = 2;
     constexpr size_t kInputIndexZeroPoints = 3;
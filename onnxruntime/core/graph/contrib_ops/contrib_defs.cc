@@ -1325,6 +1325,13 @@ ONNX_MS_OPERATOR_SET_SCHEMA(GreedySearch, 1,
                                       "Size of the vocabulary. "
                                       "If not provided, it will be inferred from the decoder subgraph's output shape",
                                       AttributeProto::INT, static_cast<int64_t>(-1))
+                                .Attr("prompt_lookup_num_tokens",
+                                      "Maximum number of draft tokens to verify in each `decoder` run with prompt lookup decoding. "
+                                      "Draft tokens are copied from the tokens that followed the last n-gram where it occurred earlier in the sequence. "
+                                      "The output is the same as without it. 0 disables it. "
+                                      "Draft tokens come from the sequence itself, not from a separate draft model, so no second subgraph or past state is needed. "
+                                      "Only used for the GPT2 model on CPU when batch_size is 1",
+                                      AttributeProto::INT, static_cast<int64_t>(0))
                                 .Input(0, "input_ids", "The sequence used as a prompt for the generation. Shape is (batch_size, sequence_length)", "I")
                                 .Input(1, "max_length", "The maximum length of the sequence to be generated. Shape is (1)", "I")
                                 .Input(2, "min_length", "The minimum length below which the score of eos_token_id is set to -Inf. Shape is (1)", "I", OpSchema::Optional)
@@ -1408,10 +1415,21 @@ ONNX_MS_OPERATOR_SET_SCHEMA(MoE, 1,
                                 .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float or float16 tensors.")
                                 .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput));
 
+constexpr const char* QMoE_ver1_doc = R"DOC(
+      Quantized MoE. The weights of each expert are quantized with one scale per output column, given by the scales
+      inputs: the dequantized weight is (q - zero_point) * scale. The layout of the quantized weights depends on the
+      execution provider, so a model is not portable between them:
+      - CUDA takes signed weights preprocessed for its mixed precision GEMM, as produced by the symmetric quantization
+        of TensorRT-LLM, with a zero point of 0.
+      - CPU takes each expert as a row major (K, N) matrix of unsigned values, for example (hidden_size, inter_size)
+        for fc1. The zero point is implicit: 8 for 4 bit weights and 128 for 8 bit weights. 4 bit weights hold two
+        columns in a byte, the even column in the low nibble.
+      )DOC";
+
 ONNX_MS_OPERATOR_SET_SCHEMA(
     QMoE, 1,
     OpSchema()
-        .SetDoc("Quantized MoE")
+        .SetDoc(QMoE_ver1_doc)
         .Attr("activation_type",
               "Activation function to use. Choose from relu, gelu, silu and identity. Default is relu",
               AttributeProto::STRING,
@@ -1476,7 +1494,8 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                 "2D input tensor with shape (num_rows, hidden_size) or 3D input tensor with shape "
                 "(batch_size, sequence_length, hidden_size)",
                 "T")
-        .TypeConstraint("T", {"tensor(float16)"}, "Constrain input and output types to float or float16 tensors.")
+        .TypeConstraint("T", {"tensor(float)", "tensor(float16)"},
+                        "Constrain input and output types to float or float16 tensors.")
         .TypeConstraint("T1", {"tensor(uint8)"}, "Constrain weights type to uint8 tensors.")
         .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput));
 
@@ -1798,6 +1817,44 @@ activation and leaky_relu_alpha.)DOC")
                                   }
                                 }));
 
+constexpr const char* FusedElementwise_ver1_doc = R"DOC(
+Evaluates an expression of elementwise operators on the inputs with multidirectional (Numpy-style) broadcasting,
+without materializing the intermediate results. It is created by the ElementwiseFusion graph transformer, which
+is enabled with the session option optimization.enable_elementwise_fusion.
+
+The expression is a list of instructions. The operator of instruction i is ops[i], and its operands are
+operands[2 * i] and operands[2 * i + 1]; the second operand is -1 for unary operators. An operand refers to
+the inputs first, then to the scalar values in constants, then to the results of the preceding instructions.
+The output is the result of the last instruction.
+
+The supported operators are Add, Sub, Mul, Div, Neg, Relu, Sigmoid, Tanh, Erf, Exp, Sqrt and Gelu.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    FusedElementwise, 1,
+    OpSchema()
+        .SetDoc(FusedElementwise_ver1_doc)
+        .Attr("ops", "The operator of each instruction.", AttributeProto::STRINGS)
+        .Attr("operands", "The two operands of each instruction.", AttributeProto::INTS)
+        .Attr("constants", "Scalar values referred to by the instructions.", AttributeProto::FLOATS,
+              OPTIONAL_VALUE)
+        .Input(0, "inputs", "The inputs of the expression.", "T", OpSchema::Variadic)
+        .Output(0, "Y", "The result of the expression, of the broadcast shape of the inputs.", "T")
+        .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          propagateElemTypeFromInputToOutput(ctx, 0, 0);
+          const size_t num_inputs = ctx.getNumInputs();
+          std::vector<const ONNX_NAMESPACE::TensorShapeProto*> shapes;
+          for (size_t i = 0; i < num_inputs; ++i) {
+            if (!hasInputShape(ctx, i)) {
+              return;
+            }
+            shapes.push_back(&ctx.getInputType(i)->tensor_type().shape());
+          }
+          multidirectionalBroadcastShapeInference(shapes,
+                                                  *ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape());
+        }));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(ExpandDims, 1,
                             OpSchema()
                                 .Input(0, "X", "input", "T")
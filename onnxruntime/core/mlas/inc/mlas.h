@@ -203,6 +203,21 @@ MlasActivation(
 // op(X) = X or op(X) = transpose(X) or op(X) = conjg(transpose(X))
 //
 
+/**
+ * @brief Supply the operations applied to the output of a single precision
+ *        gemm while the output block is still in the cache:
+ *
+ *        C := Activation(alpha * op(A) * op(B) + beta * C + Bias + Residual)
+ *
+ *        Bias is broadcast along the rows of C.
+ */
+struct MLAS_SGEMM_EPILOGUE {
+    const float* Bias = nullptr;                 /**< Supplies the optional bias vector of N elements */
+    const float* Residual = nullptr;             /**< Supplies the optional M x N matrix added to the output */
+    size_t ldr = 0;                              /**< Supplies the first dimension of matrix Residual */
+    const MLAS_ACTIVATION* Activation = nullptr; /**< Supplies the optional activation, nullptr for identity */
+};
+
 /**
  * @brief Supply matrices data information to single precision gemm functions
  */
@@ -216,6 +231,21 @@ struct MLAS_SGEMM_DATA_PARAMS {
     float alpha = 1.0f;       /**< Supplies the scalar alpha multiplier (see SGEMM definition) */
     float beta = 0.0f;        /**< Supplies the scalar beta multiplier (see SGEMM definition) */
     bool BIsPacked = false;   /**< Whether B is pre-packed */
+    bool BIsBlockSparse = false; /**< Whether B is packed by MlasGemmBlockSparsePackB */
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr; /**< Supplies the optional output epilogue */
+};
+
+/**
+ * @brief Supply the thread partition of a single precision gemm, overriding
+ *        the partition MLAS derives from the complexity of the operation.
+ *
+ *        Each multiplication of a batch is split into a grid of ThreadCountM
+ *        by ThreadCountN segments. A count of zero selects the default for
+ *        that dimension.
+ */
+struct MLAS_SGEMM_THREADING {
+    size_t ThreadCountM = 0; /**< Supplies the number of segments along the M dimension */
+    size_t ThreadCountN = 0; /**< Supplies the number of segments along the N dimension */
 };
 
 /**
@@ -231,6 +261,8 @@ struct MLAS_SGEMM_DATA_PARAMS {
  * @param BatchSize  Supplies number of multiplications in this batch
  * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
                      base library threading support should be used.
+ * @param Threading  Supplies the optional thread partition of each multiplication,
+                     else nullptr to derive it from the complexity of the operation.
  */
 void
 MLASCALL
@@ -242,7 +274,8 @@ MlasGemmBatch(
     size_t K,
     const MLAS_SGEMM_DATA_PARAMS* Data,
     size_t BatchSize,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    const MLAS_SGEMM_THREADING* Threading = nullptr
     );
 
 /**
@@ -257,6 +290,8 @@ MlasGemmBatch(
  * @param Data    Supplies the matrices data parameters
  * @param ThreadPool  Supplies the thread pool object to use, else nullptr if the
                       base library threading support should be used.
+ * @param Threading   Supplies the optional thread partition, else nullptr to
+                      derive it from the complexity of the operation.
  */
 inline
 void
@@ -267,12 +302,47 @@ MlasGemm(
     size_t N,
     size_t K,
     const MLAS_SGEMM_DATA_PARAMS& Data,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    const MLAS_SGEMM_THREADING* Threading = nullptr
     )
 {
-    MlasGemmBatch(TransA, TransB, M, N, K, &Data, 1, ThreadPool);
+    MlasGemmBatch(TransA, TransB, M, N, K, &Data, 1, ThreadPool, Threading);
 }
 
+/**
+ * @brief Supply the shape and the data of one multiplication of a grouped
+ *        single precision gemm.
+ */
+struct MLAS_SGEMM_GROUPED_PARAMS {
+    CBLAS_TRANSPOSE TransA = CblasNoTrans; /**< Supplies the transpose operation for matrix A */
+    CBLAS_TRANSPOSE TransB = CblasNoTrans; /**< Supplies the transpose operation for matrix B */
+    size_t M = 0;                          /**< Supplies the number of rows of matrix A and matrix C */
+    size_t N = 0;                          /**< Supplies the number of columns of matrix B and matrix C */
+    size_t K = 0;                          /**< Supplies the number of columns of matrix A and rows of matrix B */
+    MLAS_SGEMM_DATA_PARAMS Data;           /**< Supplies the matrices data parameters */
+};
+
+/**
+ * @brief  Grouped single precision matrix/matrix multiply operation (SGEMM)
+ *
+ *         Unlike MlasGemmBatch, every multiplication has its own shape. The
+ *         segments of all the multiplications are scheduled on the thread pool
+ *         at once, with a number of segments per multiplication proportional
+ *         to its share of the total work.
+ *
+ * @param Problems      Supplies the array of multiplications
+ * @param ProblemCount  Supplies the number of multiplications
+ * @param ThreadPool    Supplies the thread pool object to use, else nullptr if the
+                        base library threading support should be used.
+ */
+void
+MLASCALL
+MlasGemmGrouped(
+    const MLAS_SGEMM_GROUPED_PARAMS* Problems,
+    size_t ProblemCount,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 /**
  * @brief  Single precision matrix/matrix multiply operation (SGEMM)
  *
@@ -700,6 +770,44 @@ MlasGemmPackB(
     void* PackedB
     );
 
+//
+// Block sparse packing routines for a matrix B with blocks of zeros, such as
+// a pruned weight matrix. Only the non-zero blocks of 16 rows by 16 columns
+// are packed and multiplied. The packed buffer is passed as B with
+// BIsBlockSparse set in MLAS_SGEMM_DATA_PARAMS.
+//
+
+float
+MLASCALL
+MlasGemmBlockSparsity(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+size_t
+MLASCALL
+MlasGemmBlockSparsePackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+void
+MLASCALL
+MlasGemmBlockSparsePackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
 size_t
 MLASCALL
 MlasGemmPackBSize(
@@ -758,6 +866,7 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
 #if defined(MLAS_TARGET_WASM_SCALAR)
     MlasConvAlgorithmDepthwise,
 #endif
@@ -790,6 +899,11 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t TilesH;
+            size_t TilesW;
+            size_t TileBlock;
+        } Winograd;
     } u;
 };
 
@@ -809,7 +923,8 @@ MlasConvPrepare(MLAS_CONV_PARAMETERS* Parameters,
                 const MLAS_ACTIVATION* Activation,
                 size_t* WorkingBufferSize,
                 float Beta,
-                MLAS_THREADPOOL* ThreadPool);
+                MLAS_THREADPOOL* ThreadPool,
+                bool FilterIsWinogradPacked = false);
 
 void
 MLASCALL
@@ -823,6 +938,43 @@ MlasConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Winograd F(4x4,3x3) convolution routines.
+//
+// A convolution supported by MlasConvWinogradIsSupported runs with the
+// Winograd algorithm when its filter has been transformed by
+// MlasConvWinogradPackFilter and MlasConvPrepare is told so. MlasConv then
+// takes the packed filter in place of the filter tensor.
+//
+
+bool
+MLASCALL
+MlasConvWinogradIsSupported(
+    size_t Dimensions,
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* StrideShape
+    );
+
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t InputChannels,
+    size_t FilterCount
+    );
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    void* PackedFilter
+    );
+
 void
 MLASCALL
 MlasConvDepthwise(
@@ -1461,6 +1613,61 @@ MlasRotaryEmbedOneRow(
     T* output
 );
 
+/**
+ * @brief Layer normalization of one row of N elements:
+ *        Output = (X - mean(X)) / sqrt(var(X) + Epsilon) * Scale + Bias,
+ *        where X = Input + Skip + SkipBias. The statistics are computed in fp32.
+ *
+ * @tparam T            float or MLAS_FP16
+ * @param Input         the row to normalize
+ * @param Skip          optional row added to Input, as in SkipLayerNormalization. May be nullptr.
+ * @param SkipBias      optional N elements added to Input. May be nullptr.
+ * @param Scale         N elements
+ * @param Bias          optional N elements. May be nullptr.
+ * @param Output        the normalized row
+ * @param SkipOutput    optional, receives X. May be nullptr.
+ * @param N             number of elements in the row
+ * @param Epsilon       added to the variance
+ * @param Mean          optional, receives mean(X). May be nullptr.
+ * @param InvStdDev     optional, receives 1 / sqrt(var(X) + Epsilon). May be nullptr.
+ */
+template <typename T>
+void
+MLASCALL
+MlasLayerNorm(
+    const T* Input,
+    const T* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    T* Output,
+    T* SkipOutput,
+    size_t N,
+    float Epsilon,
+    float* Mean,
+    float* InvStdDev
+);
+
+/**
+ * @brief RMS normalization of one row of N elements:
+ *        Output = X / sqrt(mean(X * X) + Epsilon) * Scale, where X = Input + Skip + SkipBias.
+ *        The parameters are the same as for MlasLayerNorm.
+ */
+template <typename T>
+void
+MLASCALL
+MlasRmsNorm(
+    const T* Input,
+    const T* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    T* Output,
+    T* SkipOutput,
+    size_t N,
+    float Epsilon,
+    float* InvStdDev
+);
+
 /**
  * @brief Supply matrices data information to half precision gemm functions
  */
@@ -2008,3 +2215,54 @@ MlasFlashAttention(
     MlasFlashAttentionThreadedArgs* args,
     MLAS_THREADPOOL* ThreadPool
 );
+
+/**
+ * @brief Computes the attention scores of one query row against keys stored
+ *        as symmetric int8 with one scale per head. The keys are dequantized
+ *        inside the dot products, so the key cache is read as int8.
+ *
+ *        Scores[t] = Scale * sum_h(Query[h] * Key[t * HeadSize + h])
+ *
+ * @param Query             Query row with HeadSize elements
+ * @param Key               Keys with shape (SequenceLength, HeadSize)
+ * @param Scores            Output with SequenceLength elements
+ * @param SequenceLength    Number of keys
+ * @param HeadSize          Size of each head
+ * @param Scale             Scale of the keys times the scale of the scores
+ */
+void
+MLASCALL
+MlasAttentionScoresS8(
+    const float* Query,
+    const int8_t* Key,
+    float* Scores,
+    size_t SequenceLength,
+    size_t HeadSize,
+    float Scale
+);
+
+/**
+ * @brief Computes the attention output of one query row from values stored
+ *        as symmetric int8 with one scale per head. The values are
+ *        dequantized inside the accumulation, so the value cache is read as
+ *        int8.
+ *
+ *        Output[h] = Scale * sum_t(Probs[t] * Value[t * HeadSize + h])
+ *
+ * @param Probs             Attention probabilities with SequenceLength elements
+ * @param Value             Values with shape (SequenceLength, HeadSize)
+ * @param Output            Output row with HeadSize elements
+ * @param SequenceLength    Number of values
+ * @param HeadSize          Size of each head
+ * @param Scale             Scale of the values
+ */
+void
+MLASCALL
+MlasAttentionValuesS8(
+    const float* Probs,
+    const int8_t* Value,
+    float* Output,
+    size_t SequenceLength,
+    size_t HeadSize,
+    float Scale
+);
@@ -70,6 +70,8 @@ struct MLAS_QNBIT_GEMM_DATA_PARAMS {
  *        Call MlasQNBitGemmBatchWorkspaceSize() with the same parameters to determine whether `Workspace` should
  *          point to an intermediate workspace buffer.
  *
+ *        2-bit and 3-bit B (BlkBitWidth 2 or 3) are only supported with SQNBIT_CompFp32.
+ *
  * @tparam          T               data type of input A
  * @param[in]       M               row size of matrix A and C
  * @param[in]       N               column size of matrix B and C
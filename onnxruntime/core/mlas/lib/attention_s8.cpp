@@ -0,0 +1,142 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    attention_s8.cpp
+
+Abstract:
+
+    This module implements the attention dot products over an int8 key/value
+    cache. Keys and values are quantized symmetrically with one scale per
+    head and are dequantized inside the dot products, which reads a quarter
+    of the bytes of an fp32 cache during token generation.
+
+--*/
+
+#include "mlasi.h"
+
+#if defined(MLAS_NEON_INTRINSICS) || defined(MLAS_SSE2_INTRINSICS)
+
+namespace {
+
+//
+// Loads 8 int8 values and converts them to two float vectors.
+//
+
+MLAS_FORCEINLINE
+void
+MlasLoadS8x8AsFloat32x4x2(
+    const int8_t* Input,
+    MLAS_FLOAT32X4& Low,
+    MLAS_FLOAT32X4& High
+    )
+{
+#if defined(MLAS_NEON_INTRINSICS)
+    int16x8_t Words = vmovl_s8(vld1_s8(Input));
+    Low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(Words)));
+    High = vcvtq_f32_s32(vmovl_s16(vget_high_s16(Words)));
+#else
+    //
+    // Duplicate each byte to the top of a 32-bit lane and shift it back down
+    // to sign extend, since SSE2 has no sign extending conversion.
+    //
+    __m128i Bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(Input));
+    __m128i Words = _mm_unpacklo_epi8(Bytes, Bytes);
+    Low = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(Words, Words), 24));
+    High = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(Words, Words), 24));
+#endif
+}
+
+}  // namespace
+
+#endif
+
+void
+MLASCALL
+MlasAttentionScoresS8(
+    const float* Query,
+    const int8_t* Key,
+    float* Scores,
+    size_t SequenceLength,
+    size_t HeadSize,
+    float Scale
+    )
+{
+    for (size_t t = 0; t < SequenceLength; t++) {
+
+        const int8_t* k = Key + t * HeadSize;
+        size_t h = 0;
+        float Sum = 0.0f;
+
+#if defined(MLAS_NEON_INTRINSICS) || defined(MLAS_SSE2_INTRINSICS)
+        MLAS_FLOAT32X4 Accumulator0 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 Accumulator1 = MlasZeroFloat32x4();
+
+        for (; h + 8 <= HeadSize; h += 8) {
+            MLAS_FLOAT32X4 KeyLow;
+            MLAS_FLOAT32X4 KeyHigh;
+            MlasLoadS8x8AsFloat32x4x2(k + h, KeyLow, KeyHigh);
+            Accumulator0 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Query + h), KeyLow, Accumulator0);
+            Accumulator1 = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Query + h + 4), KeyHigh, Accumulator1);
+        }
+
+        Sum = MlasReduceAddFloat32x4(MlasAddFloat32x4(Accumulator0, Accumulator1));
+#endif
+
+        for (; h < HeadSize; h++) {
+            Sum += Query[h] * static_cast<float>(k[h]);
+        }
+
+        Scores[t] = Sum * Scale;
+    }
+}
+
+void
+MLASCALL
+MlasAttentionValuesS8(
+    const float* Probs,
+    const int8_t* Value,
+    float* Output,
+    size_t SequenceLength,
+    size_t HeadSize,
+    float Scale
+    )
+{
+    std::fill_n(Output, HeadSize, 0.0f);
+
+    //
+    // Accumulate one value row at a time so that the cache is read
+    // sequentially. The output row stays in the L1 cache.
+    //
+
+    for (size_t t = 0; t < SequenceLength; t++) {
+
+        const int8_t* v = Value + t * HeadSize;
+        const float p = Probs[t];
+        size_t h = 0;
+
+#if defined(MLAS_NEON_INTRINSICS) || defined(MLAS_SSE2_INTRINSICS)
+        const MLAS_FLOAT32X4 Prob = MlasBroadcastFloat32x4(p);
+
+        for (; h + 8 <= HeadSize; h += 8) {
+            MLAS_FLOAT32X4 ValueLow;
+            MLAS_FLOAT32X4 ValueHigh;
+            MlasLoadS8x8AsFloat32x4x2(v + h, ValueLow, ValueHigh);
+            MlasStoreFloat32x4(Output + h, MlasMultiplyAddFloat32x4(ValueLow, Prob, MlasLoadFloat32x4(Output + h)));
+            MlasStoreFloat32x4(Output + h + 4, MlasMultiplyAddFloat32x4(ValueHigh, Prob, MlasLoadFloat32x4(Output + h + 4)));
+        }
+#endif
+
+        for (; h < HeadSize; h++) {
+            Output[h] += p * static_cast<float>(v[h]);
+        }
+    }
+
+    for (size_t h = 0; h < HeadSize; h++) {
+        Output[h] *= Scale;
+    }
+}
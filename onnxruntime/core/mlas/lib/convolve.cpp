@@ -843,7 +843,8 @@ Arguments:
 
     Input - Supplies the input tensor.
 
-    Filter - Supplies the filter tensor.
+    Filter - Supplies the filter tensor, or the filter packed by
+        MlasConvWinogradPackFilter if the Winograd algorithm was selected.
 
     Bias - Optionally supplies the bias vector.
 
@@ -903,6 +904,17 @@ Return Value:
         return;
     }
 
+    //
+    // The Winograd algorithm schedules tiles of all batches across threads.
+    //
+
+    if (Algorithm == MlasConvAlgorithmWinograd) {
+
+        MlasConvWinograd(Parameters, Input, Filter, Bias, WorkingBuffer, Output, ThreadPool);
+
+        return;
+    }
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
     if (Algorithm == MlasConvAlgorithmDepthwise) {
@@ -1002,6 +1014,15 @@ Return Value:
 
                     break;
                 }
+
+                case MlasConvAlgorithmWinograd:
+                {
+                    //
+                    // Dispatched above for all batches.
+                    //
+
+                    break;
+                }
             }
 
             //
@@ -1041,7 +1062,8 @@ MlasConvPrepare(
     const MLAS_ACTIVATION* Activation,
     size_t* WorkingBufferSize,
     float Beta,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    bool FilterIsWinogradPacked
     )
 /*++
 
@@ -1088,6 +1110,11 @@ Arguments:
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
+    FilterIsWinogradPacked - Supplies true if the filter has been packed by
+        MlasConvWinogradPackFilter. The convolution must then be supported by
+        MlasConvWinogradIsSupported and is executed with the Winograd
+        algorithm.
+
 Return Value:
 
     None.
@@ -1168,6 +1195,13 @@ Return Value:
 
     *WorkingBufferSize = 0;
 
+    if (FilterIsWinogradPacked) {
+
+        MlasConvWinogradPrepare(Parameters, WorkingBufferSize, ThreadPool);
+
+        return;
+    }
+
     if (AllStridesAreOne && AllPaddingIsZero) {
 
         //
@@ -0,0 +1,754 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convolve_winograd.cpp
+
+Abstract:
+
+    This module implements the single precision Winograd F(4x4,3x3)
+    convolution.
+
+    The input image is split into overlapping 6x6 tiles that produce 4x4
+    output tiles. Each tile is transformed with B^T d B, the 36 transformed
+    points of a block of tiles are multiplied by the transformed filters
+    G g G^T with 36 independent GEMMs, and the products are transformed back
+    with A^T m A. The filter transform is done once by the caller with
+    MlasConvWinogradPackFilter.
+
+--*/
+
+#include "mlasi.h"
+
+#include <vector>
+
+//
+// Define the output tile size, the input tile size and the number of
+// transformed points of a tile.
+//
+
+constexpr size_t MLAS_WINOGRAD_OUTPUT_TILE = 4;
+constexpr size_t MLAS_WINOGRAD_INPUT_TILE = 6;
+constexpr size_t MLAS_WINOGRAD_POINTS = MLAS_WINOGRAD_INPUT_TILE * MLAS_WINOGRAD_INPUT_TILE;
+
+//
+// Define the minimum number of input and output channels for the transformed
+// GEMMs to outweigh the cost of the tile transforms.
+//
+
+constexpr size_t MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS = 32;
+
+//
+// Define the number of working buffer elements that the transformed input
+// and the GEMM output of a block of tiles should fit in, and the bounds on
+// the number of tiles in a block.
+//
+
+constexpr size_t MLAS_WINOGRAD_BLOCK_ELEMENTS = 256 * 1024;
+constexpr size_t MLAS_WINOGRAD_MINIMUM_TILE_BLOCK = 8;
+constexpr size_t MLAS_WINOGRAD_MAXIMUM_TILE_BLOCK = 64;
+
+//
+// Define the parameters to execute the Winograd convolution on worker threads.
+//
+
+struct MLAS_CONV_WINOGRAD_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    const uint8_t* PackedFilter;
+    size_t PackedFilterStride;
+    const float* Bias;
+    float* WorkingBuffer;
+    float* Output;
+    ptrdiff_t ThreadCount;
+};
+
+MLAS_FORCEINLINE
+void
+MlasWinogradInputTransform6(
+    const float* d,
+    size_t dstride,
+    float* r,
+    size_t rstride
+    )
+/*++
+
+Routine Description:
+
+    This routine applies B^T to a vector of six elements.
+
+Arguments:
+
+    d - Supplies the input vector.
+
+    dstride - Supplies the element stride of the input vector.
+
+    r - Receives the transformed vector.
+
+    rstride - Supplies the element stride of the transformed vector.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float d0 = d[0 * dstride];
+    const float d1 = d[1 * dstride];
+    const float d2 = d[2 * dstride];
+    const float d3 = d[3 * dstride];
+    const float d4 = d[4 * dstride];
+    const float d5 = d[5 * dstride];
+
+    r[0 * rstride] = 4.0f * d0 - 5.0f * d2 + d4;
+    r[1 * rstride] = -4.0f * (d1 + d2) + d3 + d4;
+    r[2 * rstride] = 4.0f * (d1 - d2) - d3 + d4;
+    r[3 * rstride] = 2.0f * (d3 - d1) - d2 + d4;
+    r[4 * rstride] = 2.0f * (d1 - d3) - d2 + d4;
+    r[5 * rstride] = 4.0f * d1 - 5.0f * d3 + d5;
+}
+
+MLAS_FORCEINLINE
+void
+MlasWinogradOutputTransform6(
+    const float* m,
+    size_t mstride,
+    float* r,
+    size_t rstride
+    )
+/*++
+
+Routine Description:
+
+    This routine applies A^T to a vector of six elements.
+
+Arguments:
+
+    m - Supplies the input vector.
+
+    mstride - Supplies the element stride of the input vector.
+
+    r - Receives the four element transformed vector.
+
+    rstride - Supplies the element stride of the transformed vector.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float m0 = m[0 * mstride];
+    const float m1 = m[1 * mstride];
+    const float m2 = m[2 * mstride];
+    const float m3 = m[3 * mstride];
+    const float m4 = m[4 * mstride];
+    const float m5 = m[5 * mstride];
+
+    const float s12 = m1 + m2;
+    const float d12 = m1 - m2;
+    const float s34 = m3 + m4;
+    const float d34 = m3 - m4;
+
+    r[0 * rstride] = m0 + s12 + s34;
+    r[1 * rstride] = d12 + 2.0f * d34;
+    r[2 * rstride] = s12 + 4.0f * s34;
+    r[3 * rstride] = d12 + 8.0f * d34 + m5;
+}
+
+bool
+MLASCALL
+MlasConvWinogradIsSupported(
+    size_t Dimensions,
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* StrideShape
+    )
+/*++
+
+Routine Description:
+
+    This routine returns whether a convolution is eligible for the Winograd
+    F(4x4,3x3) algorithm.
+
+    The algorithm is limited to ungrouped 2D convolutions with a 3x3 kernel,
+    unit strides and unit dilations. The channel counts must be large enough
+    for the transformed GEMMs to amortize the tile transforms.
+
+Arguments:
+
+    Dimensions - Supplies the number of dimensions.
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+    KernelShape - Supplies the shape of the kernel transform.
+
+    DilationShape - Supplies the shape of the dilation.
+
+    StrideShape - Supplies the shape of the stride.
+
+Return Value:
+
+    Returns true if the convolution can use the Winograd algorithm.
+
+--*/
+{
+    if (Dimensions != 2 || GroupCount != 1) {
+        return false;
+    }
+
+    if (InputChannels < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS ||
+        FilterCount < MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS) {
+        return false;
+    }
+
+    for (size_t dim = 0; dim < Dimensions; dim++) {
+        if (KernelShape[dim] != 3 || DilationShape[dim] != 1 || StrideShape[dim] != 1) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t InputChannels,
+    size_t FilterCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the transformed and packed
+    filter buffer.
+
+Arguments:
+
+    InputChannels - Supplies the number of input channels.
+
+    FilterCount - Supplies the number of filters.
+
+Return Value:
+
+    Returns the size in bytes for the packed filter buffer.
+
+--*/
+{
+    return MLAS_WINOGRAD_POINTS * MlasGemmPackBSize(FilterCount, InputChannels);
+}
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    void* PackedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a 3x3 filter tensor with G g G^T and packs each of
+    the 36 transformed points as the B matrix of a GEMM.
+
+Arguments:
+
+    InputChannels - Supplies the number of input channels.
+
+    FilterCount - Supplies the number of filters.
+
+    Filter - Supplies the filter tensor in FCHW layout.
+
+    PackedFilter - Supplies the address of the packed filter buffer, which is
+        sized by MlasConvWinogradPackFilterSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    static constexpr float G[MLAS_WINOGRAD_INPUT_TILE][3] = {
+        {1.0f / 4.0f, 0.0f, 0.0f},
+        {-1.0f / 6.0f, -1.0f / 6.0f, -1.0f / 6.0f},
+        {-1.0f / 6.0f, 1.0f / 6.0f, -1.0f / 6.0f},
+        {1.0f / 24.0f, 1.0f / 12.0f, 1.0f / 6.0f},
+        {1.0f / 24.0f, -1.0f / 12.0f, 1.0f / 6.0f},
+        {0.0f, 0.0f, 1.0f},
+    };
+
+    const size_t FilterElements = FilterCount * InputChannels;
+
+    //
+    // Transform the filters to a [36][FilterCount][InputChannels] buffer so
+    // that each transformed point can be packed as a transposed B matrix.
+    //
+
+    std::vector<float> Transformed(MLAS_WINOGRAD_POINTS * FilterElements);
+
+    for (size_t fc = 0; fc < FilterElements; fc++) {
+
+        const float* g = Filter + fc * 9;
+
+        float Gg[MLAS_WINOGRAD_INPUT_TILE][3];
+
+        for (size_t i = 0; i < MLAS_WINOGRAD_INPUT_TILE; i++) {
+            for (size_t j = 0; j < 3; j++) {
+                Gg[i][j] = G[i][0] * g[0 * 3 + j] + G[i][1] * g[1 * 3 + j] + G[i][2] * g[2 * 3 + j];
+            }
+        }
+
+        for (size_t i = 0; i < MLAS_WINOGRAD_INPUT_TILE; i++) {
+            for (size_t j = 0; j < MLAS_WINOGRAD_INPUT_TILE; j++) {
+                Transformed[(i * MLAS_WINOGRAD_INPUT_TILE + j) * FilterElements + fc] =
+                    Gg[i][0] * G[j][0] + Gg[i][1] * G[j][1] + Gg[i][2] * G[j][2];
+            }
+        }
+    }
+
+    const size_t PackedStride = MlasGemmPackBSize(FilterCount, InputChannels);
+
+    for (size_t point = 0; point < MLAS_WINOGRAD_POINTS; point++) {
+        MlasGemmPackB(CblasTrans, FilterCount, InputChannels, &Transformed[point * FilterElements],
+            InputChannels, static_cast<uint8_t*>(PackedFilter) + point * PackedStride);
+    }
+}
+
+void
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the tiling, the threading and the working buffer
+    size of a Winograd convolution.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the convolution operation.
+
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer for intermediate results.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+
+    const size_t TilesH = (Parameters->OutputShape[0] + MLAS_WINOGRAD_OUTPUT_TILE - 1) / MLAS_WINOGRAD_OUTPUT_TILE;
+    const size_t TilesW = (Parameters->OutputShape[1] + MLAS_WINOGRAD_OUTPUT_TILE - 1) / MLAS_WINOGRAD_OUTPUT_TILE;
+    const size_t TileCount = TilesH * TilesW;
+
+    //
+    // Size the block of tiles so that the transformed input and the GEMM
+    // output stay resident in the cache.
+    //
+
+    size_t TileBlock = MLAS_WINOGRAD_BLOCK_ELEMENTS / (MLAS_WINOGRAD_POINTS * (InputChannels + FilterCount));
+
+    TileBlock = std::max(TileBlock, MLAS_WINOGRAD_MINIMUM_TILE_BLOCK);
+    TileBlock = std::min(TileBlock, MLAS_WINOGRAD_MAXIMUM_TILE_BLOCK);
+    TileBlock = std::min(TileBlock, TileCount);
+
+    const size_t BlockCount = (TileCount + TileBlock - 1) / TileBlock;
+    const size_t WorkCount = Parameters->BatchCount * BlockCount;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // convolution operation.
+    //
+
+    const double Complexity = double(Parameters->BatchCount) * double(FilterCount) *
+                              double(Parameters->OutputSize) * double(Parameters->K);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (size_t(TargetThreadCount) >= WorkCount) {
+        TargetThreadCount = ptrdiff_t(WorkCount);
+    }
+
+    Parameters->Algorithm = MlasConvAlgorithmWinograd;
+    Parameters->ThreadCount = TargetThreadCount;
+    Parameters->u.Winograd.TilesH = TilesH;
+    Parameters->u.Winograd.TilesW = TilesW;
+    Parameters->u.Winograd.TileBlock = TileBlock;
+
+    *WorkingBufferSize = size_t(TargetThreadCount) * MLAS_WINOGRAD_POINTS * TileBlock *
+                         (InputChannels + FilterCount);
+}
+
+void
+MlasConvWinogradTransformInput(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    size_t TileStart,
+    size_t TileCount,
+    float* V
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a block of input tiles with B^T d B and stores the
+    result in [36][TileBlock][InputChannels] layout.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input image of one batch.
+
+    TileStart - Supplies the index of the first tile of the block.
+
+    TileCount - Supplies the number of tiles of the block.
+
+    V - Receives the transformed input tiles.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t TilesW = Parameters->u.Winograd.TilesW;
+    const size_t PointStride = Parameters->u.Winograd.TileBlock * InputChannels;
+
+    float d[MLAS_WINOGRAD_INPUT_TILE][MLAS_WINOGRAD_INPUT_TILE];
+    float t[MLAS_WINOGRAD_INPUT_TILE][MLAS_WINOGRAD_INPUT_TILE];
+
+    for (size_t tile = 0; tile < TileCount; tile++) {
+
+        const size_t th = (TileStart + tile) / TilesW;
+        const size_t tw = (TileStart + tile) % TilesW;
+
+        //
+        // The tile origin in padded input coordinates.
+        //
+
+        const ptrdiff_t ih0 = ptrdiff_t(th * MLAS_WINOGRAD_OUTPUT_TILE) - ptrdiff_t(PaddingTop);
+        const ptrdiff_t iw0 = ptrdiff_t(tw * MLAS_WINOGRAD_OUTPUT_TILE) - ptrdiff_t(PaddingLeft);
+
+        const bool Interior = ih0 >= 0 && iw0 >= 0 &&
+                              size_t(ih0) + MLAS_WINOGRAD_INPUT_TILE <= InputHeight &&
+                              size_t(iw0) + MLAS_WINOGRAD_INPUT_TILE <= InputWidth;
+
+        const float* input = Input;
+        float* v = V + tile * InputChannels;
+
+        for (size_t c = 0; c < InputChannels; c++) {
+
+            if (Interior) {
+
+                const float* row = input + size_t(ih0) * InputWidth + size_t(iw0);
+
+                for (size_t i = 0; i < MLAS_WINOGRAD_INPUT_TILE; i++) {
+                    MlasWinogradInputTransform6(row + i * InputWidth, 1, &t[0][i], MLAS_WINOGRAD_INPUT_TILE);
+                }
+
+            } else {
+
+                for (size_t i = 0; i < MLAS_WINOGRAD_INPUT_TILE; i++) {
+
+                    const ptrdiff_t ih = ih0 + ptrdiff_t(i);
+
+                    for (size_t j = 0; j < MLAS_WINOGRAD_INPUT_TILE; j++) {
+
+                        const ptrdiff_t iw = iw0 + ptrdiff_t(j);
+
+                        if (ih >= 0 && size_t(ih) < InputHeight && iw >= 0 && size_t(iw) < InputWidth) {
+                            d[i][j] = input[size_t(ih) * InputWidth + size_t(iw)];
+                        } else {
+                            d[i][j] = 0.0f;
+                        }
+                    }
+
+                    MlasWinogradInputTransform6(&d[i][0], 1, &t[0][i], MLAS_WINOGRAD_INPUT_TILE);
+                }
+            }
+
+            //
+            // Each row of t now holds B^T applied along the width, so apply
+            // B^T along the height and scatter the points.
+            //
+
+            for (size_t j = 0; j < MLAS_WINOGRAD_INPUT_TILE; j++) {
+                MlasWinogradInputTransform6(&t[j][0], 1, v + j * PointStride,
+                    MLAS_WINOGRAD_INPUT_TILE * PointStride);
+            }
+
+            input += InputSize;
+            v++;
+        }
+    }
+}
+
+void
+MlasConvWinogradTransformOutput(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* M,
+    const float* Bias,
+    size_t TileStart,
+    size_t TileCount,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a block of GEMM outputs in
+    [36][TileBlock][FilterCount] layout with A^T m A, adds the optional bias
+    and the scaled existing output, and stores the cropped output tiles.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    M - Supplies the GEMM outputs of the block.
+
+    Bias - Optionally supplies the bias vector.
+
+    TileStart - Supplies the index of the first tile of the block.
+
+    TileCount - Supplies the number of tiles of the block.
+
+    Output - Supplies the output image of one batch.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t TilesW = Parameters->u.Winograd.TilesW;
+    const size_t PointStride = Parameters->u.Winograd.TileBlock * FilterCount;
+    const float Beta = Parameters->Beta;
+
+    float t[MLAS_WINOGRAD_OUTPUT_TILE][MLAS_WINOGRAD_INPUT_TILE];
+    float y[MLAS_WINOGRAD_OUTPUT_TILE][MLAS_WINOGRAD_OUTPUT_TILE];
+
+    for (size_t tile = 0; tile < TileCount; tile++) {
+
+        const size_t th = (TileStart + tile) / TilesW;
+        const size_t tw = (TileStart + tile) % TilesW;
+
+        const size_t oh0 = th * MLAS_WINOGRAD_OUTPUT_TILE;
+        const size_t ow0 = tw * MLAS_WINOGRAD_OUTPUT_TILE;
+        const size_t RowCount = std::min(MLAS_WINOGRAD_OUTPUT_TILE, OutputHeight - oh0);
+        const size_t ColumnCount = std::min(MLAS_WINOGRAD_OUTPUT_TILE, OutputWidth - ow0);
+
+        const float* m = M + tile * FilterCount;
+        float* output = Output + oh0 * OutputWidth + ow0;
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            //
+            // Apply A^T along the height of the 6x6 points and then along the
+            // width of the 4x6 intermediate.
+            //
+
+            for (size_t j = 0; j < MLAS_WINOGRAD_INPUT_TILE; j++) {
+                MlasWinogradOutputTransform6(m + j * PointStride, MLAS_WINOGRAD_INPUT_TILE * PointStride,
+                    &t[0][j], MLAS_WINOGRAD_INPUT_TILE);
+            }
+
+            for (size_t i = 0; i < MLAS_WINOGRAD_OUTPUT_TILE; i++) {
+                MlasWinogradOutputTransform6(&t[i][0], 1, &y[i][0], 1);
+            }
+
+            const float bias = (Bias != nullptr) ? Bias[f] : 0.0f;
+
+            for (size_t i = 0; i < RowCount; i++) {
+                float* row = output + i * OutputWidth;
+                for (size_t j = 0; j < ColumnCount; j++) {
+                    row[j] = (Beta == 0.0f) ? y[i][j] + bias : y[i][j] + bias + Beta * row[j];
+                }
+            }
+
+            output += OutputSize;
+            m++;
+        }
+    }
+}
+
+void
+MlasConvWinogradThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a contiguous range
+    of the (batch, tile block) work items of a Winograd convolution.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = static_cast<const MLAS_CONV_WINOGRAD_WORK_BLOCK*>(Context);
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t TileBlock = Parameters->u.Winograd.TileBlock;
+    const size_t TileCount = Parameters->u.Winograd.TilesH * Parameters->u.Winograd.TilesW;
+    const size_t BlockCount = (TileCount + TileBlock - 1) / TileBlock;
+
+    float* V = WorkBlock->WorkingBuffer +
+               size_t(Index) * MLAS_WINOGRAD_POINTS * TileBlock * (InputChannels + FilterCount);
+    float* M = V + MLAS_WINOGRAD_POINTS * TileBlock * InputChannels;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount, Parameters->BatchCount * BlockCount,
+        &WorkIndex, &WorkRemaining);
+
+    while (WorkRemaining > 0) {
+
+        const size_t batch = WorkIndex / BlockCount;
+        const size_t TileStart = (WorkIndex % BlockCount) * TileBlock;
+        const size_t TilesThisBlock = std::min(TileBlock, TileCount - TileStart);
+
+        const float* Input = WorkBlock->Input + batch * InputChannels * Parameters->InputSize;
+        float* Output = WorkBlock->Output + batch * FilterCount * Parameters->OutputSize;
+
+        MlasConvWinogradTransformInput(Parameters, Input, TileStart, TilesThisBlock, V);
+
+        for (size_t point = 0; point < MLAS_WINOGRAD_POINTS; point++) {
+            MlasGemm(CblasNoTrans, TilesThisBlock, FilterCount, InputChannels, 1.0f,
+                V + point * TileBlock * InputChannels, InputChannels,
+                WorkBlock->PackedFilter + point * WorkBlock->PackedFilterStride, 0.0f,
+                M + point * TileBlock * FilterCount, FilterCount, nullptr);
+        }
+
+        MlasConvWinogradTransformOutput(Parameters, M, WorkBlock->Bias, TileStart, TilesThisBlock,
+            Output);
+
+        WorkIndex++;
+        WorkRemaining--;
+    }
+}
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const void* PackedFilter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the Winograd convolution for all batches.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    PackedFilter - Supplies the filter packed by MlasConvWinogradPackFilter.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WINOGRAD_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.PackedFilter = static_cast<const uint8_t*>(PackedFilter);
+    WorkBlock.PackedFilterStride = MlasGemmPackBSize(Parameters->FilterCount, Parameters->InputChannels);
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer;
+    WorkBlock.Output = Output;
+    WorkBlock.ThreadCount = Parameters->ThreadCount;
+
+    MlasExecuteThreaded(MlasConvWinogradThreaded, &WorkBlock, Parameters->ThreadCount, ThreadPool);
+
+    //
+    // The bias has been added by the output transform, so only apply the
+    // activation.
+    //
+
+    if (Parameters->Activation->ActivationKind != MlasIdentityActivation) {
+
+        const size_t FilterCount = Parameters->FilterCount;
+        const size_t OutputSize = Parameters->OutputSize;
+
+        MlasTrySimpleParallel(ThreadPool, ptrdiff_t(Parameters->BatchCount * FilterCount), [&](ptrdiff_t tid) {
+            MlasActivation(Parameters->Activation, Output + size_t(tid) * OutputSize, nullptr, 1,
+                OutputSize, OutputSize);
+        });
+    }
+}
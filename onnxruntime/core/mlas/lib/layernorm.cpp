@@ -0,0 +1,328 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.cpp
+
+Abstract:
+
+    This module implements layer normalization and RMS normalization of a row
+    for fp32 and fp16 data, with the optional skip connection and bias of
+    SkipLayerNormalization.
+
+    The mean and the variance are accumulated in registers in a single pass
+    over the row. A second pass recomputes the input, which is in the L1 cache
+    for common hidden sizes, and writes the normalized output. fp16 data is
+    converted to fp32 in registers, so no temporary buffers are needed.
+
+--*/
+
+#include "layernorm.h"
+
+template <typename T>
+void
+MLASCALL
+MlasLayerNorm_FallBack(
+    const T* Input,
+    const T* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    T* Output,
+    T* SkipOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+{
+    float Sum = 0.0f;
+    float SumSquares = 0.0f;
+    MlasLayerNormAccumulateRemainder(Input, Skip, SkipBias, SkipOutput, 0, N, Sum, SumSquares);
+
+    float RowMean;
+    float RowInvStdDev;
+    MlasLayerNormStatistics(Sum, SumSquares, N, Epsilon, Simplified, RowMean, RowInvStdDev);
+
+    MlasLayerNormNormalizeRemainder(Input, Skip, SkipBias, Scale, Bias, Output, 0, N, RowMean, RowInvStdDev);
+
+    if (Mean != nullptr) {
+        *Mean = RowMean;
+    }
+    if (InvStdDev != nullptr) {
+        *InvStdDev = RowInvStdDev;
+    }
+}
+
+namespace {
+
+//
+// Portable fp32 kernel for the platforms without a dedicated kernel.
+//
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasLayerNormLoadFloat32x4(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    size_t h
+    )
+{
+    MLAS_FLOAT32X4 x = MlasLoadFloat32x4(Input + h);
+    if (Skip != nullptr) {
+        x = MlasAddFloat32x4(x, MlasLoadFloat32x4(Skip + h));
+    }
+    if (SkipBias != nullptr) {
+        x = MlasAddFloat32x4(x, MlasLoadFloat32x4(SkipBias + h));
+    }
+    return x;
+}
+
+void
+MlasLayerNormKernel(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float* SkipOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+{
+    MLAS_FLOAT32X4 SumVector = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SumSquaresVector = MlasZeroFloat32x4();
+
+    size_t h = 0;
+    for (; h + 4 <= N; h += 4) {
+        MLAS_FLOAT32X4 x = MlasLayerNormLoadFloat32x4(Input, Skip, SkipBias, h);
+        if (SkipOutput != nullptr) {
+            MlasStoreFloat32x4(SkipOutput + h, x);
+        }
+        SumVector = MlasAddFloat32x4(SumVector, x);
+        SumSquaresVector = MlasMultiplyAddFloat32x4(x, x, SumSquaresVector);
+    }
+
+    float Sum = MlasReduceAddFloat32x4(SumVector);
+    float SumSquares = MlasReduceAddFloat32x4(SumSquaresVector);
+    MlasLayerNormAccumulateRemainder(Input, Skip, SkipBias, SkipOutput, h, N, Sum, SumSquares);
+
+    float RowMean;
+    float RowInvStdDev;
+    MlasLayerNormStatistics(Sum, SumSquares, N, Epsilon, Simplified, RowMean, RowInvStdDev);
+
+    const MLAS_FLOAT32X4 MeanVector = MlasBroadcastFloat32x4(RowMean);
+    const MLAS_FLOAT32X4 InvStdDevVector = MlasBroadcastFloat32x4(RowInvStdDev);
+
+    h = 0;
+    for (; h + 4 <= N; h += 4) {
+        MLAS_FLOAT32X4 x = MlasLayerNormLoadFloat32x4(Input, Skip, SkipBias, h);
+        x = MlasMultiplyFloat32x4(MlasSubtractFloat32x4(x, MeanVector), InvStdDevVector);
+        if (Bias != nullptr) {
+            x = MlasMultiplyAddFloat32x4(x, MlasLoadFloat32x4(Scale + h), MlasLoadFloat32x4(Bias + h));
+        } else {
+            x = MlasMultiplyFloat32x4(x, MlasLoadFloat32x4(Scale + h));
+        }
+        MlasStoreFloat32x4(Output + h, x);
+    }
+
+    MlasLayerNormNormalizeRemainder(Input, Skip, SkipBias, Scale, Bias, Output, h, N, RowMean, RowInvStdDev);
+
+    if (Mean != nullptr) {
+        *Mean = RowMean;
+    }
+    if (InvStdDev != nullptr) {
+        *InvStdDev = RowInvStdDev;
+    }
+}
+
+template <typename T>
+void
+MlasLayerNormDispatch(
+    const T* Input,
+    const T* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    T* Output,
+    T* SkipOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    );
+
+template <>
+void
+MlasLayerNormDispatch<float>(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float* SkipOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+{
+    const auto* dispatch = GetMlasPlatform().LayerNormDispatch;
+
+    if (dispatch == nullptr || dispatch->SLayerNorm == nullptr) {
+        MlasLayerNormKernel(Input, Skip, SkipBias, Scale, Bias, Output, SkipOutput, N, Epsilon, Simplified, Mean,
+                            InvStdDev);
+        return;
+    }
+
+    dispatch->SLayerNorm(Input, Skip, SkipBias, Scale, Bias, Output, SkipOutput, N, Epsilon, Simplified, Mean,
+                         InvStdDev);
+}
+
+template <>
+void
+MlasLayerNormDispatch<MLAS_FP16>(
+    const MLAS_FP16* Input,
+    const MLAS_FP16* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    MLAS_FP16* Output,
+    MLAS_FP16* SkipOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+    )
+{
+    const auto* dispatch = GetMlasPlatform().LayerNormDispatch;
+
+    if (dispatch == nullptr || dispatch->HLayerNorm == nullptr) {
+        MlasLayerNorm_FallBack<MLAS_FP16>(Input, Skip, SkipBias, Scale, Bias, Output, SkipOutput, N, Epsilon,
+                                          Simplified, Mean, InvStdDev);
+        return;
+    }
+
+    dispatch->HLayerNorm(Input, Skip, SkipBias, Scale, Bias, Output, SkipOutput, N, Epsilon, Simplified, Mean,
+                         InvStdDev);
+}
+
+}  // namespace
+
+template <typename T>
+void
+MLASCALL
+MlasLayerNorm(
+    const T* Input,
+    const T* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    T* Output,
+    T* SkipOutput,
+    size_t N,
+    float Epsilon,
+    float* Mean,
+    float* InvStdDev
+    )
+{
+    MlasLayerNormDispatch<T>(Input, Skip, SkipBias, Scale, Bias, Output, SkipOutput, N, Epsilon, false, Mean,
+                             InvStdDev);
+}
+
+template <typename T>
+void
+MLASCALL
+MlasRmsNorm(
+    const T* Input,
+    const T* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    T* Output,
+    T* SkipOutput,
+    size_t N,
+    float Epsilon,
+    float* InvStdDev
+    )
+{
+    MlasLayerNormDispatch<T>(Input, Skip, SkipBias, Scale, nullptr, Output, SkipOutput, N, Epsilon, true, nullptr,
+                             InvStdDev);
+}
+
+template
+void
+MLASCALL
+MlasLayerNorm<float>(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float* SkipOutput,
+    size_t N,
+    float Epsilon,
+    float* Mean,
+    float* InvStdDev
+);
+
+template
+void
+MLASCALL
+MlasLayerNorm<MLAS_FP16>(
+    const MLAS_FP16* Input,
+    const MLAS_FP16* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    MLAS_FP16* Output,
+    MLAS_FP16* SkipOutput,
+    size_t N,
+    float Epsilon,
+    float* Mean,
+    float* InvStdDev
+);
+
+template
+void
+MLASCALL
+MlasRmsNorm<float>(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    float* Output,
+    float* SkipOutput,
+    size_t N,
+    float Epsilon,
+    float* InvStdDev
+);
+
+template
+void
+MLASCALL
+MlasRmsNorm<MLAS_FP16>(
+    const MLAS_FP16* Input,
+    const MLAS_FP16* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    MLAS_FP16* Output,
+    MLAS_FP16* SkipOutput,
+    size_t N,
+    float Epsilon,
+    float* InvStdDev
+);
@@ -0,0 +1,182 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.h
+
+Abstract:
+
+    This module includes kernel function prototypes and helper functions for
+    implementing layer normalization and RMS normalization.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+struct MLAS_LAYERNORM_DISPATCH {
+    // layer normalization kernel for fp32. Simplified selects RMS normalization.
+    typedef void(SLayerNorm_Fn)(
+        const float* Input,
+        const float* Skip,
+        const float* SkipBias,
+        const float* Scale,
+        const float* Bias,
+        float* Output,
+        float* SkipOutput,
+        size_t N,
+        float Epsilon,
+        bool Simplified,
+        float* Mean,
+        float* InvStdDev
+    );
+
+    SLayerNorm_Fn* SLayerNorm = nullptr;
+
+    // layer normalization kernel for fp16 input and output. Statistics are
+    // computed in fp32.
+    typedef void(HLayerNorm_Fn)(
+        const MLAS_FP16* Input,
+        const MLAS_FP16* Skip,
+        const float* SkipBias,
+        const float* Scale,
+        const float* Bias,
+        MLAS_FP16* Output,
+        MLAS_FP16* SkipOutput,
+        size_t N,
+        float Epsilon,
+        bool Simplified,
+        float* Mean,
+        float* InvStdDev
+    );
+
+    HLayerNorm_Fn* HLayerNorm = nullptr;
+};
+
+//
+// Computes the mean and the reciprocal standard deviation from the sum and
+// the sum of squares of a row.
+//
+
+MLAS_FORCEINLINE
+void
+MlasLayerNormStatistics(
+    float Sum,
+    float SumSquares,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float& Mean,
+    float& InvStdDev
+    )
+{
+    const float n = static_cast<float>(N);
+    if (Simplified) {
+        Mean = 0.0f;
+        InvStdDev = 1.0f / std::sqrt(SumSquares / n + Epsilon);
+    } else {
+        Mean = Sum / n;
+        InvStdDev = 1.0f / std::sqrt(SumSquares / n - Mean * Mean + Epsilon);
+    }
+}
+
+//
+// Loads element h of the row to normalize, Input + Skip + SkipBias, in fp32.
+//
+
+template <typename T>
+MLAS_FORCEINLINE
+float
+MlasLayerNormLoad(
+    const T* Input,
+    const T* Skip,
+    const float* SkipBias,
+    size_t h
+    )
+{
+    float x = static_cast<float>(Input[h]);
+    if (Skip != nullptr) {
+        x += static_cast<float>(Skip[h]);
+    }
+    if (SkipBias != nullptr) {
+        x += SkipBias[h];
+    }
+    return x;
+}
+
+//
+// Scalar loops for the elements of a row from index h onward, used by the
+// vector kernels for the leftover elements.
+//
+
+template <typename T>
+MLAS_FORCEINLINE
+void
+MlasLayerNormAccumulateRemainder(
+    const T* Input,
+    const T* Skip,
+    const float* SkipBias,
+    T* SkipOutput,
+    size_t h,
+    size_t N,
+    float& Sum,
+    float& SumSquares
+    )
+{
+    for (; h < N; h++) {
+        const float x = MlasLayerNormLoad(Input, Skip, SkipBias, h);
+        if (SkipOutput != nullptr) {
+            SkipOutput[h] = static_cast<T>(x);
+        }
+        Sum += x;
+        SumSquares += x * x;
+    }
+}
+
+template <typename T>
+MLAS_FORCEINLINE
+void
+MlasLayerNormNormalizeRemainder(
+    const T* Input,
+    const T* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    T* Output,
+    size_t h,
+    size_t N,
+    float Mean,
+    float InvStdDev
+    )
+{
+    for (; h < N; h++) {
+        float y = (MlasLayerNormLoad(Input, Skip, SkipBias, h) - Mean) * InvStdDev * Scale[h];
+        if (Bias != nullptr) {
+            y += Bias[h];
+        }
+        Output[h] = static_cast<T>(y);
+    }
+}
+
+template <typename T>
+void
+MLASCALL
+MlasLayerNorm_FallBack(
+    const T* Input,
+    const T* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    T* Output,
+    T* SkipOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+);
@@ -0,0 +1,218 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the layer normalization kernels for AVX2 supported
+    h/w. fp16 data is converted with the F16C instructions.
+
+--*/
+
+#include "layernorm.h"
+
+namespace layernorm_avx2 {
+
+namespace {
+
+template <typename T>
+__m256
+Load8(const T* Input);
+
+template <>
+MLAS_FORCEINLINE
+__m256
+Load8<float>(const float* Input)
+{
+    return _mm256_loadu_ps(Input);
+}
+
+template <>
+MLAS_FORCEINLINE
+__m256
+Load8<MLAS_FP16>(const MLAS_FP16* Input)
+{
+    return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Input)));
+}
+
+MLAS_FORCEINLINE
+void
+Store8(float* Output, __m256 Vector)
+{
+    _mm256_storeu_ps(Output, Vector);
+}
+
+MLAS_FORCEINLINE
+void
+Store8(MLAS_FP16* Output, __m256 Vector)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(Output), _mm256_cvtps_ph(Vector, _MM_FROUND_TO_NEAREST_INT));
+}
+
+MLAS_FORCEINLINE
+float
+ReduceAdd(__m256 Vector)
+{
+    __m128 v = _mm_add_ps(_mm256_castps256_ps128(Vector), _mm256_extractf128_ps(Vector, 1));
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_movehdup_ps(v));
+    return _mm_cvtss_f32(v);
+}
+
+template <typename T>
+MLAS_FORCEINLINE
+__m256
+LoadInput8(const T* Input, const T* Skip, const float* SkipBias, size_t h)
+{
+    __m256 x = Load8(Input + h);
+    if (Skip != nullptr) {
+        x = _mm256_add_ps(x, Load8(Skip + h));
+    }
+    if (SkipBias != nullptr) {
+        x = _mm256_add_ps(x, _mm256_loadu_ps(SkipBias + h));
+    }
+    return x;
+}
+
+template <typename T>
+void
+LayerNormKernel_Avx2_Impl(
+    const T* Input,
+    const T* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    T* Output,
+    T* SkipOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+)
+{
+    //
+    // Two sets of accumulators hide the latency of the additions.
+    //
+
+    __m256 Sum0 = _mm256_setzero_ps();
+    __m256 Sum1 = _mm256_setzero_ps();
+    __m256 SumSquares0 = _mm256_setzero_ps();
+    __m256 SumSquares1 = _mm256_setzero_ps();
+
+    size_t h = 0;
+    for (; h + 16 <= N; h += 16) {
+        __m256 x0 = LoadInput8(Input, Skip, SkipBias, h);
+        __m256 x1 = LoadInput8(Input, Skip, SkipBias, h + 8);
+        if (SkipOutput != nullptr) {
+            Store8(SkipOutput + h, x0);
+            Store8(SkipOutput + h + 8, x1);
+        }
+        Sum0 = _mm256_add_ps(Sum0, x0);
+        Sum1 = _mm256_add_ps(Sum1, x1);
+        SumSquares0 = _mm256_fmadd_ps(x0, x0, SumSquares0);
+        SumSquares1 = _mm256_fmadd_ps(x1, x1, SumSquares1);
+    }
+
+    if (h + 8 <= N) {
+        __m256 x0 = LoadInput8(Input, Skip, SkipBias, h);
+        if (SkipOutput != nullptr) {
+            Store8(SkipOutput + h, x0);
+        }
+        Sum0 = _mm256_add_ps(Sum0, x0);
+        SumSquares0 = _mm256_fmadd_ps(x0, x0, SumSquares0);
+        h += 8;
+    }
+
+    float Sum = ReduceAdd(_mm256_add_ps(Sum0, Sum1));
+    float SumSquares = ReduceAdd(_mm256_add_ps(SumSquares0, SumSquares1));
+    MlasLayerNormAccumulateRemainder(Input, Skip, SkipBias, SkipOutput, h, N, Sum, SumSquares);
+
+    float RowMean;
+    float RowInvStdDev;
+    MlasLayerNormStatistics(Sum, SumSquares, N, Epsilon, Simplified, RowMean, RowInvStdDev);
+
+    const __m256 MeanVector = _mm256_set1_ps(RowMean);
+    const __m256 InvStdDevVector = _mm256_set1_ps(RowInvStdDev);
+
+    h = 0;
+    for (; h + 8 <= N; h += 8) {
+        __m256 x = LoadInput8(Input, Skip, SkipBias, h);
+        x = _mm256_mul_ps(_mm256_sub_ps(x, MeanVector), InvStdDevVector);
+        if (Bias != nullptr) {
+            x = _mm256_fmadd_ps(x, _mm256_loadu_ps(Scale + h), _mm256_loadu_ps(Bias + h));
+        } else {
+            x = _mm256_mul_ps(x, _mm256_loadu_ps(Scale + h));
+        }
+        Store8(Output + h, x);
+    }
+
+    MlasLayerNormNormalizeRemainder(Input, Skip, SkipBias, Scale, Bias, Output, h, N, RowMean, RowInvStdDev);
+
+    if (Mean != nullptr) {
+        *Mean = RowMean;
+    }
+    if (InvStdDev != nullptr) {
+        *InvStdDev = RowInvStdDev;
+    }
+}
+
+void
+LayerNormKernel_Avx2_fp32(
+    const float* Input,
+    const float* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    float* Output,
+    float* SkipOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+)
+{
+    LayerNormKernel_Avx2_Impl<float>(Input, Skip, SkipBias, Scale, Bias, Output, SkipOutput, N, Epsilon, Simplified,
+                                     Mean, InvStdDev);
+}
+
+void
+LayerNormKernel_Avx2_fp16(
+    const MLAS_FP16* Input,
+    const MLAS_FP16* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    MLAS_FP16* Output,
+    MLAS_FP16* SkipOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+)
+{
+    LayerNormKernel_Avx2_Impl<MLAS_FP16>(Input, Skip, SkipBias, Scale, Bias, Output, SkipOutput, N, Epsilon,
+                                         Simplified, Mean, InvStdDev);
+}
+
+}  // namespace
+
+}  // namespace layernorm_avx2
+
+//
+// Kernel dispatch structure definition.
+//
+const MLAS_LAYERNORM_DISPATCH MlasLayerNormDispatchAvx2 = []() {
+    MLAS_LAYERNORM_DISPATCH d;
+    d.SLayerNorm = layernorm_avx2::LayerNormKernel_Avx2_fp32;
+    d.HLayerNorm = layernorm_avx2::LayerNormKernel_Avx2_fp16;
+    return d;
+}();
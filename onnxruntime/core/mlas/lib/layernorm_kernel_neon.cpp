@@ -0,0 +1,33 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_kernel_neon.cpp
+
+Abstract:
+
+    This module implements the layer normalization kernels for ARM NEON. The
+    fp32 kernel is the portable one in layernorm.cpp.
+
+--*/
+
+#include "layernorm.h"
+#include "layernorm_kernel_neon.h"
+
+//
+// Kernel dispatch structure definition.
+//
+const MLAS_LAYERNORM_DISPATCH MlasLayerNormDispatchNeon = []() {
+    MLAS_LAYERNORM_DISPATCH d;
+
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED) && defined(MLAS_TARGET_ARM64)
+    if (MlasFp16AccelerationSupported()) {
+        d.HLayerNorm = layernorm_neon::LayerNormKernel_Fp16;
+    }
+#endif
+    return d;
+}();
@@ -0,0 +1,43 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_kernel_neon.h
+
+Abstract:
+
+    This module includes function declarations for the layer normalization
+    kernels on ARM cpu.
+
+--*/
+
+#pragma once
+
+#include <arm_neon.h>
+
+#include "mlasi.h"
+
+namespace layernorm_neon {
+
+// Layer normalization kernel for fp16 input and output. Normalize one row.
+void
+LayerNormKernel_Fp16(
+    const MLAS_FP16* Input,
+    const MLAS_FP16* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    MLAS_FP16* Output,
+    MLAS_FP16* SkipOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+);
+
+}  // namespace layernorm_neon
@@ -0,0 +1,153 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_kernel_neon_fp16.cpp
+
+Abstract:
+
+    This module implements the fp16 layer normalization kernel for ARM NEON.
+    The fp16 data is widened to fp32 in registers and the statistics are
+    accumulated in fp32.
+
+--*/
+
+#include <arm_neon.h>
+
+#include "fp16_common.h"
+#include "layernorm.h"
+#include "layernorm_kernel_neon.h"
+
+namespace layernorm_neon {
+
+namespace {
+
+MLAS_FORCEINLINE
+void
+LoadInput8(
+    const _mlas_fp16_* Input,
+    const _mlas_fp16_* Skip,
+    const float* SkipBias,
+    size_t h,
+    float32x4_t& Low,
+    float32x4_t& High
+)
+{
+    float16x8_t x = MlasLoadFloat16x8(Input + h);
+    if (Skip != nullptr) {
+        // add in fp32, the sum of two fp16 values may not be representable in fp16.
+        float16x8_t s = MlasLoadFloat16x8(Skip + h);
+        Low = vaddq_f32(vcvt_f32_f16(vget_low_f16(x)), vcvt_f32_f16(vget_low_f16(s)));
+        High = vaddq_f32(vcvt_high_f32_f16(x), vcvt_high_f32_f16(s));
+    } else {
+        Low = vcvt_f32_f16(vget_low_f16(x));
+        High = vcvt_high_f32_f16(x);
+    }
+    if (SkipBias != nullptr) {
+        Low = vaddq_f32(Low, vld1q_f32(SkipBias + h));
+        High = vaddq_f32(High, vld1q_f32(SkipBias + h + 4));
+    }
+}
+
+MLAS_FORCEINLINE
+void
+Store8(_mlas_fp16_* Output, float32x4_t Low, float32x4_t High)
+{
+    MlasStoreFloat16x8(Output, vcvt_high_f16_f32(vcvt_f16_f32(Low), High));
+}
+
+MLAS_FORCEINLINE
+float32x4_t
+Normalize4(
+    float32x4_t x,
+    const float* Scale,
+    const float* Bias,
+    float32x4_t Mean,
+    float32x4_t InvStdDev
+)
+{
+    x = vmulq_f32(vsubq_f32(x, Mean), InvStdDev);
+    if (Bias != nullptr) {
+        return vfmaq_f32(vld1q_f32(Bias), x, vld1q_f32(Scale));
+    }
+    return vmulq_f32(x, vld1q_f32(Scale));
+}
+
+}  // namespace
+
+void
+LayerNormKernel_Fp16(
+    const MLAS_FP16* Input,
+    const MLAS_FP16* Skip,
+    const float* SkipBias,
+    const float* Scale,
+    const float* Bias,
+    MLAS_FP16* Output,
+    MLAS_FP16* SkipOutput,
+    size_t N,
+    float Epsilon,
+    bool Simplified,
+    float* Mean,
+    float* InvStdDev
+)
+{
+    const auto* input = reinterpret_cast<const _mlas_fp16_*>(Input);
+    const auto* skip = reinterpret_cast<const _mlas_fp16_*>(Skip);
+    auto* output = reinterpret_cast<_mlas_fp16_*>(Output);
+    auto* skip_output = reinterpret_cast<_mlas_fp16_*>(SkipOutput);
+
+    float32x4_t Sum0 = vdupq_n_f32(0.0f);
+    float32x4_t Sum1 = vdupq_n_f32(0.0f);
+    float32x4_t SumSquares0 = vdupq_n_f32(0.0f);
+    float32x4_t SumSquares1 = vdupq_n_f32(0.0f);
+
+    size_t h = 0;
+    for (; h + 8 <= N; h += 8) {
+        float32x4_t Low;
+        float32x4_t High;
+        LoadInput8(input, skip, SkipBias, h, Low, High);
+        if (skip_output != nullptr) {
+            Store8(skip_output + h, Low, High);
+        }
+        Sum0 = vaddq_f32(Sum0, Low);
+        Sum1 = vaddq_f32(Sum1, High);
+        SumSquares0 = vfmaq_f32(SumSquares0, Low, Low);
+        SumSquares1 = vfmaq_f32(SumSquares1, High, High);
+    }
+
+    float Sum = vaddvq_f32(vaddq_f32(Sum0, Sum1));
+    float SumSquares = vaddvq_f32(vaddq_f32(SumSquares0, SumSquares1));
+    MlasLayerNormAccumulateRemainder(Input, Skip, SkipBias, SkipOutput, h, N, Sum, SumSquares);
+
+    float RowMean;
+    float RowInvStdDev;
+    MlasLayerNormStatistics(Sum, SumSquares, N, Epsilon, Simplified, RowMean, RowInvStdDev);
+
+    const float32x4_t MeanVector = vdupq_n_f32(RowMean);
+    const float32x4_t InvStdDevVector = vdupq_n_f32(RowInvStdDev);
+
+    h = 0;
+    for (; h + 8 <= N; h += 8) {
+        float32x4_t Low;
+        float32x4_t High;
+        LoadInput8(input, skip, SkipBias, h, Low, High);
+        Low = Normalize4(Low, Scale + h, Bias == nullptr ? nullptr : Bias + h, MeanVector, InvStdDevVector);
+        High = Normalize4(High, Scale + h + 4, Bias == nullptr ? nullptr : Bias + h + 4, MeanVector, InvStdDevVector);
+        Store8(output + h, Low, High);
+    }
+
+    MlasLayerNormNormalizeRemainder(Input, Skip, SkipBias, Scale, Bias, Output, h, N, RowMean, RowInvStdDev);
+
+    if (Mean != nullptr) {
+        *Mean = RowMean;
+    }
+    if (InvStdDev != nullptr) {
+        *InvStdDev = RowInvStdDev;
+    }
+}
+
+}  // namespace layernorm_neon
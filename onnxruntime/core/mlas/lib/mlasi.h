@@ -988,7 +988,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr
     );
 
 //
@@ -1085,6 +1086,19 @@ struct MLAS_ROPE_DISPATCH;
 extern const MLAS_ROPE_DISPATCH MlasRopeDispatchNeon;
 extern const MLAS_ROPE_DISPATCH MlasRopeDispatchAvx2;
 
+//
+// Layer normalization dispatch structure.
+//
+struct MLAS_LAYERNORM_DISPATCH;
+extern const MLAS_LAYERNORM_DISPATCH MlasLayerNormDispatchNeon;
+extern const MLAS_LAYERNORM_DISPATCH MlasLayerNormDispatchAvx2;
+
+//
+// Small matrix SGEMM dispatch structure.
+//
+struct MLAS_SGEMM_SMALL_DISPATCH;
+extern const MLAS_SGEMM_SMALL_DISPATCH MlasSgemmSmallDispatchAvx2;
+
 //
 // half gemm dispatch structure
 //
@@ -1267,6 +1281,8 @@ struct MLAS_PLATFORM {
     const MLAS_HGEMM_DISPATCH* HGemmDispatch{nullptr};
     const MLAS_SOFTMAX_DISPATCH* SoftmaxDispatch{nullptr};
     const MLAS_ELTWISE_DISPATCH* EltwiseDispatch{nullptr};
+    const MLAS_LAYERNORM_DISPATCH* LayerNormDispatch{nullptr};
+    const MLAS_SGEMM_SMALL_DISPATCH* SgemmSmallDispatch{nullptr};
 };
 
 inline
@@ -1417,6 +1433,28 @@ MlasFp32FromBits(
 #pragma warning(pop)
 #endif
 
+//
+// Winograd convolution routines.
+//
+
+void
+MlasConvWinogradPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const void* PackedFilter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
 void
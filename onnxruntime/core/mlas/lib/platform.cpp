@@ -404,6 +404,8 @@ Return Value:
                 this->CastF16ToF32Kernel = &MlasCastF16ToF32KernelAvx2;
                 this->CastF32ToF16Kernel = &MlasCastF32ToF16KernelAvx2;
                 this->RopeDispatch = &MlasRopeDispatchAvx2;
+                this->LayerNormDispatch = &MlasLayerNormDispatchAvx2;
+                this->SgemmSmallDispatch = &MlasSgemmSmallDispatchAvx2;
 
 
                 //
@@ -551,6 +553,7 @@ Return Value:
     this->HGemmDispatch = &MlasHGemmDispatchNeon;
     this->SoftmaxDispatch = &MlasSoftmaxDispatchNeon;
     this->EltwiseDispatch = &MlasEltwiseDispatchNeon;
+    this->LayerNormDispatch = &MlasLayerNormDispatchNeon;
 
     //
     // Check if the processor supports ASIMD dot product instructions.
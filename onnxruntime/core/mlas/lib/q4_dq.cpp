@@ -328,7 +328,7 @@ struct BitsTraits {
     static constexpr float halfRange = static_cast<float>(kMid - kMin);
 
     // number of qbit elements to pack into whole bytes
-    static constexpr int kPackSize = (qbits == 8) ? 1 : ((qbits == 4) ? 2 : ((qbits == 2) ? 4 : 0));
+    static constexpr int kPackSize = (qbits == 8) ? 1 : ((qbits == 4) ? 2 : ((qbits == 2) ? 4 : ((qbits == 3) ? 8 : 0)));
     static_assert(kPackSize != 0, "Packing to whole bytes not supported for this qbits!");
 };
 
@@ -404,7 +404,8 @@ template <
 struct BlockwiseQuantizer {
     // To support other qbits, need to add bit packing code for
     // storing to dst and zero points
-    static_assert(qbits == 2 || qbits == 4 || qbits == 8, "Only 2b, 4b and 8b block quantization is supported!");
+    static_assert(qbits == 2 || qbits == 3 || qbits == 4 || qbits == 8,
+                  "Only 2b, 3b, 4b and 8b block quantization is supported!");
 
     using QuantBlk = std::conditional_t<Columnwise, Shape2D<block_size, 1>, Shape2D<1, block_size>>;
     using ThreadBlk = Shape2D<QuantBlk::kRow * BitsTraits<qbits, false>::kPackSize, QuantBlk::kColumn>;
@@ -416,6 +417,43 @@ struct BlockwiseQuantizer {
         return (val >> (qbits * idx)) & ((1 << qbits) - 1);
     }
 
+    /**
+     * @brief Read element idx from a little endian bit stream of qbits elements. Used when
+     *        elements straddle byte boundaries, e.g. 3b.
+     * @param packed  start of the bit stream
+     * @param size    number of bytes in the bit stream
+     */
+    static
+    MLAS_FORCEINLINE
+    int GetStreamElem(const uint8_t* packed, int size, int idx)
+    {
+        const int bit = idx * qbits;
+        int val = packed[bit / 8];
+        if ((bit % 8) + qbits > 8 && (bit / 8) + 1 < size) {
+            val |= packed[bit / 8 + 1] << 8;
+        }
+        return (val >> (bit % 8)) & ((1 << qbits) - 1);
+    }
+
+    /**
+     * @brief Store count (<= kPackSize) elements starting at element idx, a multiple of kPackSize,
+     *        to a little endian bit stream. Bytes past the end of the stream are not written.
+     */
+    static
+    MLAS_FORCEINLINE
+    void SetStreamElems(uint8_t* packed, int size, int idx, const uint8_t* vals, int count)
+    {
+        constexpr int kPackSize = BitsTraits<qbits, false>::kPackSize;
+        uint64_t bits = 0;
+        for (int l = 0; l < count; l++) {
+            bits |= uint64_t(vals[l] & ((1 << qbits) - 1)) << (l * qbits);
+        }
+        const int offset = idx * qbits / 8;
+        for (int b = 0; b < kPackSize * qbits / 8 && offset + b < size; b++) {
+            packed[offset + b] = static_cast<uint8_t>(bits >> (8 * b));
+        }
+    }
+
     static
     MLAS_FORCEINLINE
     void quantizeMetaShape(int rows, int columns, int& meta_rows, int& meta_cols)
@@ -449,7 +487,7 @@ struct BlockwiseQuantizer {
         scale_num_elements = meta_rows * meta_cols;
 
         if (zero_point_bytes) {
-            // this works for qbits == 2, 4 or 8 but may need to be updated for other qbits values
+            // zero points of a column are packed into a little endian bit stream
             *zero_point_bytes = ((meta_rows * qbits + 7) / 8) * meta_cols;
         }
     }
@@ -533,8 +571,12 @@ struct BlockwiseQuantizer {
                 }
 
                 if (zero_points != nullptr) {
-                    const int32_t meta_idx = meta_col * ((row_blks + kPackSize - 1) / kPackSize) + meta_row / kPackSize;
-                    if constexpr (qbits == 8) {
+                    [[maybe_unused]] const int32_t meta_idx = meta_col * ((row_blks + kPackSize - 1) / kPackSize) + meta_row / kPackSize;
+                    if constexpr (qbits == 3) {
+                        const int32_t zp_col_bytes = (row_blks * qbits + 7) / 8;
+                        SetStreamElems(zero_points + meta_col * zp_col_bytes, zp_col_bytes, meta_row, zp_bytes,
+                                       std::min(kPackSize, row_blks - meta_row));
+                    } else if constexpr (qbits == 8) {
                         zero_points[meta_idx] = zp_bytes[0];
                     } else if constexpr (qbits == 4) {
                         zero_points[meta_idx] = (zp_bytes[0] & 0xf) | (zp_bytes[1] << 4);
@@ -559,7 +601,9 @@ struct BlockwiseQuantizer {
                                                         0.0f, BitsTraits<qbits, false>::kMaxFp);
                         }
 
-                        if constexpr (qbits == 8) {
+                        if constexpr (qbits == 3) {
+                            SetStreamElems(dst + j * q_rows, q_rows, i, vi, std::min(kPackSize, r_end - i));
+                        } else if constexpr (qbits == 8) {
                             dst[j * q_rows + i / kPackSize] = vi[0];
                         } else if constexpr (qbits == 4) {
                             dst[j * q_rows + i / kPackSize] = (vi[0] & 0xf) | (vi[1] << 4);
@@ -622,6 +666,16 @@ struct BlockwiseQuantizer {
                     for (int32_t i = r; i < r_end; ++i) {
                         const int32_t meta_row = i / QuantBlk::kRow;
                         const float scale = static_cast<float>(scales[meta_col * row_blks + meta_row]);
+                        if constexpr (qbits == 3) {
+                            const int32_t zp_col_bytes = (row_blks * qbits + 7) / 8;
+                            const int zp =
+                                zero_points
+                                    ? GetStreamElem(zero_points + meta_col * zp_col_bytes, zp_col_bytes, meta_row)
+                                    : BitsTraits<qbits, false>::kMid;
+                            const int vi = GetStreamElem(weights + j * q_rows, q_rows, i);
+                            dst[j * rows + i] = ElementT((vi - zp) * scale);
+                            continue;
+                        }
                         const int zp_pair =
                             zero_points
                             ? zero_points[meta_col * ((row_blks + kPackSize - 1) / kPackSize) + meta_row / kPackSize]
@@ -1425,6 +1479,17 @@ MlasBlockwiseQuantMetaShape<float, 2>(
     int& meta_cols
     );
 
+template
+void
+MlasBlockwiseQuantMetaShape<float, 3>(
+    int block_size,
+    bool columnwise,
+    int rows,
+    int columns,
+    int& meta_rows,
+    int& meta_cols
+    );
+
 template
 void
 MlasBlockwiseQuantMetaShape<MLAS_FP16, 2>(
@@ -1436,6 +1501,17 @@ MlasBlockwiseQuantMetaShape<MLAS_FP16, 2>(
     int& meta_cols
     );
 
+template
+void
+MlasBlockwiseQuantMetaShape<MLAS_FP16, 3>(
+    int block_size,
+    bool columnwise,
+    int rows,
+    int columns,
+    int& meta_rows,
+    int& meta_cols
+    );
+
 template
 void
 MlasBlockwiseQuantMetaShape<float, 4>(
@@ -1491,6 +1567,17 @@ MlasBlockwiseQuantizedShape<float, 2>(
     int& q_cols
     );
 
+template
+void
+MlasBlockwiseQuantizedShape<float, 3>(
+    int block_size,
+    bool columnwise,
+    int rows,
+    int columns,
+    int& q_rows,
+    int& q_cols
+    );
+
 template
 void
 MlasBlockwiseQuantizedShape<MLAS_FP16, 2>(
@@ -1502,6 +1589,17 @@ MlasBlockwiseQuantizedShape<MLAS_FP16, 2>(
     int& q_cols
     );
 
+template
+void
+MlasBlockwiseQuantizedShape<MLAS_FP16, 3>(
+    int block_size,
+    bool columnwise,
+    int rows,
+    int columns,
+    int& q_rows,
+    int& q_cols
+    );
+
 template
 void
 MlasBlockwiseQuantizedShape<float, 4>(
@@ -1642,6 +1740,18 @@ MlasBlockwiseQuantizedBufferSizes<2>(
     size_t* q_zero_point_size_in_bytes
 );
 
+template
+void MLASCALL
+MlasBlockwiseQuantizedBufferSizes<3>(
+    int block_size,
+    bool columnwise,
+    int rows,
+    int columns,
+    size_t& q_data_size_in_bytes,
+    size_t& q_scale_num_elements,
+    size_t* q_zero_point_size_in_bytes
+);
+
 template
 void MLASCALL
 MlasBlockwiseQuantizedBufferSizes<4>(
@@ -1753,6 +1863,21 @@ MlasQuantizeBlockwise<float, 2>(
     MLAS_THREADPOOL* thread_pool
     );
 
+template
+void
+MlasQuantizeBlockwise<float, 3>(
+    uint8_t* dst,
+    float* scales,
+    uint8_t* zero_points,
+    const float* src,
+    int block_size,
+    bool columnwise,
+    int rows,
+    int columns,
+    int leading_dimension,
+    MLAS_THREADPOOL* thread_pool
+    );
+
 template
 void
 MlasQuantizeBlockwise<MLAS_FP16, 2>(
@@ -1768,6 +1893,21 @@ MlasQuantizeBlockwise<MLAS_FP16, 2>(
     MLAS_THREADPOOL* thread_pool
     );
 
+template
+void
+MlasQuantizeBlockwise<MLAS_FP16, 3>(
+    uint8_t* dst,
+    MLAS_FP16* scales,
+    uint8_t* zero_points,
+    const MLAS_FP16* src,
+    int block_size,
+    bool columnwise,
+    int rows,
+    int columns,
+    int leading_dimension,
+    MLAS_THREADPOOL* thread_pool
+    );
+
 template
 void
 MlasQuantizeBlockwise<float, 4>(
@@ -1907,6 +2047,19 @@ MlasDequantizeBlockwise<float, 2>(
     MLAS_THREADPOOL* thread_pool
 );
 
+template void
+MlasDequantizeBlockwise<float, 3>(
+    float* dst,
+    const uint8_t* src,
+    const float* scales,
+    const uint8_t* zero_points,
+    int block_size,
+    bool columnwise,
+    int rows,
+    int columns,
+    MLAS_THREADPOOL* thread_pool
+);
+
 template void
 MlasDequantizeBlockwise<MLAS_FP16, 2>(
     MLAS_FP16* dst,
@@ -1920,6 +2073,19 @@ MlasDequantizeBlockwise<MLAS_FP16, 2>(
     MLAS_THREADPOOL* thread_pool
 );
 
+template void
+MlasDequantizeBlockwise<MLAS_FP16, 3>(
+    MLAS_FP16* dst,
+    const uint8_t* src,
+    const MLAS_FP16* scales,
+    const uint8_t* zero_points,
+    int block_size,
+    bool columnwise,
+    int rows,
+    int columns,
+    MLAS_THREADPOOL* thread_pool
+);
+
 template void
 MlasDequantizeBlockwise<float, 4>(
     float* dst,
@@ -33,6 +33,8 @@ enum QNBitGemmVariant {
     HQ4BitGemmVariant_CompFp16,
     HQ4BitGemmVariant_CompInt8,
     SQ8BitGemmVariant_CompInt8,
+    SQ2BitGemmVariant_CompFp32,
+    SQ3BitGemmVariant_CompFp32,
 
     // End of valid variants
 
@@ -63,6 +65,14 @@ GetQNBitGemmVariant(
             if (ComputeType == SQNBIT_CompInt8) {
                 return SQ8BitGemmVariant_CompInt8;
             }
+        } else if (BlkBitWidth == 2) {
+            if (ComputeType == SQNBIT_CompFp32) {
+                return SQ2BitGemmVariant_CompFp32;
+            }
+        } else if (BlkBitWidth == 3) {
+            if (ComputeType == SQNBIT_CompFp32) {
+                return SQ3BitGemmVariant_CompFp32;
+            }
         }
     }
 
@@ -106,6 +116,14 @@ MlasIsQNBitGemmAvailable(
                    Dispatch->SQ8BitGemmKernel_BlkSum_CompInt8 != nullptr &&
                    Dispatch->QuantizeARowComputeBlkSum_CompInt8 != nullptr;
         }
+        case SQ2BitGemmVariant_CompFp32: {
+            return Dispatch->SQ2BitGemmM1Kernel_CompFp32 != nullptr &&
+                   Dispatch->SQ2BitBlkDequantBForSgemm_CompFp32 != nullptr;
+        }
+        case SQ3BitGemmVariant_CompFp32: {
+            return Dispatch->SQ3BitGemmM1Kernel_CompFp32 != nullptr &&
+                   Dispatch->SQ3BitBlkDequantBForSgemm_CompFp32 != nullptr;
+        }
         default: {
             return false;
         }
@@ -223,6 +241,10 @@ MlasQNBitGemmPackQuantBDataSize(
         return Dispatch->Q8BitGemmPackQuantBDataSize(
             N, K, BlkLen, HasZeroPoint, ComputeType
         );
+    } else if ((BlkBitWidth == 2 || BlkBitWidth == 3) && ComputeType == SQNBIT_CompFp32) {
+        // the 2-bit and 3-bit kernels read B in its original layout
+        const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+        return N * BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
     }
 
     return 0;
@@ -321,6 +343,19 @@ MlasQNBitGemmPackQuantBData(
                 ThreadPool
             );
         }
+    } else if ((BlkBitWidth == 2 || BlkBitWidth == 3) && ComputeType == SQNBIT_CompFp32) {
+        if (QuantBData == nullptr) {
+            return;
+        }
+
+        const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+        const size_t ColStrideInBytes = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+        MlasTrySimpleParallel(ThreadPool, N, [&](ptrdiff_t n) {
+            std::copy_n(
+                static_cast<const std::byte*>(QuantBData) + n * ColStrideInBytes, ColStrideInBytes,
+                static_cast<std::byte*>(PackedQuantBDataAndOrBlkSumWorkspace) + n * ColStrideInBytes
+            );
+        });
     }
 }
 
@@ -376,8 +411,9 @@ AddBiasForGemm(const float* Bias, float* C, size_t CountM, size_t CountN, size_t
     }
 }
 
+template <size_t BlkBitWidth>
 void
-SQ4BitGemm_CompFp32(
+SQNBitGemm_CompFp32(
     const size_t BlkLen,
     const size_t K,
     const MLAS_QNBIT_GEMM_DATA_PARAMS<float>* const DataParams,
@@ -388,10 +424,18 @@ SQ4BitGemm_CompFp32(
     const size_t RangeCountN
 )
 {
-    constexpr size_t BlkBitWidth = 4;
+    static_assert(BlkBitWidth == 2 || BlkBitWidth == 3 || BlkBitWidth == 4);
 
     MLAS_UNREFERENCED_PARAMETER(PerGemmWorkspace);
 
+    const auto* Dispatch = GetMlasPlatform().QNBitGemmDispatch;
+    const auto M1Kernel = (BlkBitWidth == 2)   ? Dispatch->SQ2BitGemmM1Kernel_CompFp32
+                          : (BlkBitWidth == 3) ? Dispatch->SQ3BitGemmM1Kernel_CompFp32
+                                               : Dispatch->SQ4BitGemmM1Kernel_CompFp32;
+    const auto DequantBForSgemm = (BlkBitWidth == 2)   ? Dispatch->SQ2BitBlkDequantBForSgemm_CompFp32
+                                  : (BlkBitWidth == 3) ? Dispatch->SQ3BitBlkDequantBForSgemm_CompFp32
+                                                       : Dispatch->SQ4BitBlkDequantBForSgemm_CompFp32;
+
     const size_t lda = DataParams->lda;
     const size_t ldc = DataParams->ldc;
 
@@ -425,7 +469,7 @@ SQ4BitGemm_CompFp32(
             float* c_blk = C + n;
             const float* bias = (Bias == nullptr) ? nullptr : Bias + n;
 
-            GetMlasPlatform().QNBitGemmDispatch->SQ4BitGemmM1Kernel_CompFp32(
+            M1Kernel(
                 BlkLen,
                 a_row, b_col, b_col_scale, b_col_zp, c_blk, CountN, K, k_blks, bias
             );
@@ -463,7 +507,7 @@ SQ4BitGemm_CompFp32(
         float* c_blk = C + n;
         const float* bias = (Bias == nullptr) ? nullptr : Bias + n;
 
-        GetMlasPlatform().QNBitGemmDispatch->SQ4BitBlkDequantBForSgemm_CompFp32(
+        DequantBForSgemm(
             BlkLen,
             dequant_b, b_col, b_col_scale, b_col_zp, CountN, K, k_blks
         );
@@ -956,7 +1000,11 @@ GetQNBitGemm(QNBitGemmVariant variant)
 {
     switch (variant) {
         case SQ4BitGemmVariant_CompFp32:
-            return SQ4BitGemm_CompFp32;
+            return SQNBitGemm_CompFp32<4>;
+        case SQ2BitGemmVariant_CompFp32:
+            return SQNBitGemm_CompFp32<2>;
+        case SQ3BitGemmVariant_CompFp32:
+            return SQNBitGemm_CompFp32<3>;
         case SQ4BitGemmVariant_CompInt8:
             return SQ4BitGemm_CompInt8;
         case SQ8BitGemmVariant_CompInt8:
@@ -75,11 +75,26 @@ template <size_t BlkBitWidth>
 constexpr MLAS_FORCEINLINE size_t
 MlasQNBitZeroPointsForBlksSizeInBytes(size_t BlkCount)
 {
-    if constexpr (BlkBitWidth <= 4) {
-        return MlasDivRoundup(BlkCount, 2);  // 2 blocks per byte
-    } else {
-        return BlkCount;
+    // zero points are packed into a little endian bit stream, e.g., 2 blocks per byte for 4-bit
+    return MlasDivRoundup(BlkCount * BlkBitWidth, 8);
+}
+
+/**
+ * @brief Reads the zero point of block BlkIdx from the packed zero points of a column.
+ *        A 3-bit zero point may straddle two bytes.
+ */
+template <size_t BlkBitWidth>
+MLAS_FORCEINLINE uint8_t
+MlasQNBitZeroPointForBlk(const std::byte* ZeroPoints, size_t BlkIdx)
+{
+    const size_t BitOffset = BlkIdx * BlkBitWidth;
+    uint32_t Bits = std::to_integer<uint32_t>(ZeroPoints[BitOffset / 8]);
+    if constexpr (8 % BlkBitWidth != 0) {
+        if (BitOffset % 8 + BlkBitWidth > 8) {
+            Bits |= std::to_integer<uint32_t>(ZeroPoints[BitOffset / 8 + 1]) << 8;
+        }
     }
+    return static_cast<uint8_t>((Bits >> (BitOffset % 8)) & ((1u << BlkBitWidth) - 1));
 }
 
 //
@@ -262,6 +277,18 @@ struct MLAS_QNBIT_GEMM_DISPATCH {
 
     Q4BitBlkDequantBForSgemm_CompFp32_Fn* SQ4BitBlkDequantBForSgemm_CompFp32 = nullptr;
 
+    //
+    // SQNBIT_CompFp32 kernels for 2-bit and 3-bit B. They have the same signatures as the 4-bit kernels above.
+    // B keeps the MatMulNBits layout, i.e., the values of a block and the zero points of a column are each
+    // packed into a little endian bit stream.
+    //
+
+    SQ4BitGemmM1Kernel_CompFp32_Fn* SQ2BitGemmM1Kernel_CompFp32 = nullptr;
+    SQ4BitGemmM1Kernel_CompFp32_Fn* SQ3BitGemmM1Kernel_CompFp32 = nullptr;
+
+    Q4BitBlkDequantBForSgemm_CompFp32_Fn* SQ2BitBlkDequantBForSgemm_CompFp32 = nullptr;
+    Q4BitBlkDequantBForSgemm_CompFp32_Fn* SQ3BitBlkDequantBForSgemm_CompFp32 = nullptr;
+
     /**
      * @brief Dequantize B into the format expected by the Sgemm kernel.
      *        B is a quantized 4-bit integer matrix that is block quantized and column major.
@@ -304,6 +304,10 @@ GetMlasQNBitGemmDispatchNeon(
 
         d.SQ4BitGemmM1Kernel_CompFp32 = sqnbitgemm_neon::SQ4BitGemmM1Kernel_CompFp32;
         d.SQ4BitBlkDequantBForSgemm_CompFp32 = sqnbitgemm_neon::SQ4BitBlkDequantBForSgemm_CompFp32;
+        d.SQ2BitGemmM1Kernel_CompFp32 = sqnbitgemm_neon::SQ2Or3BitGemmM1Kernel_CompFp32<2>;
+        d.SQ3BitGemmM1Kernel_CompFp32 = sqnbitgemm_neon::SQ2Or3BitGemmM1Kernel_CompFp32<3>;
+        d.SQ2BitBlkDequantBForSgemm_CompFp32 = sqnbitgemm_neon::SQ2Or3BitBlkDequantBForSgemm_CompFp32<2>;
+        d.SQ3BitBlkDequantBForSgemm_CompFp32 = sqnbitgemm_neon::SQ2Or3BitBlkDequantBForSgemm_CompFp32<3>;
 
         if (InitializeWithDotSupport) {
             d.SQ4BitGemmKernel_CompInt8 = sqnbitgemm_neon::SQ4BitGemmKernel_CompInt8;
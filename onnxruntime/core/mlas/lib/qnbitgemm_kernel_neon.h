@@ -65,6 +65,36 @@ SQ4BitBlkDequantBForSgemm_CompFp32(
     size_t BlockCountK
 );
 
+// BlkBitWidth is 2 or 3
+template <size_t BlkBitWidth>
+void
+SQ2Or3BitGemmM1Kernel_CompFp32(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    const float* Bias
+);
+
+// BlkBitWidth is 2 or 3
+template <size_t BlkBitWidth>
+void
+SQ2Or3BitBlkDequantBForSgemm_CompFp32(
+    size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK
+);
+
 // HQNBIT_CompFp16 declarations
 #if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED) && defined(MLAS_TARGET_ARM64)
 void
@@ -16,6 +16,9 @@ Abstract:
 --*/
 
 #include "mlasi.h"
+#include "sgemm_small.h"
+
+#include <vector>
 
 //
 // Define the number of rows from matrix A to transpose to a local buffer.
@@ -26,6 +29,39 @@ Abstract:
 
 #define MLAS_SGEMM_TRANSA_ROWS              12
 
+//
+// Define the number of rows of matrix B in a block of a block sparse packed
+// matrix. A block spans MLAS_SGEMM_STRIDEN_THREAD_ALIGN columns, so that the
+// thread partition along the N dimension never splits a block.
+//
+
+#define MLAS_SGEMM_BLOCK_SPARSE_STRIDEK     16
+
+//
+// Define the layout of a block sparse packed matrix B.
+//
+// The header is followed by the index of the first run of each column panel,
+// with one extra entry marking the end of the last panel, then by the runs.
+// A run is a range of consecutive non-zero blocks of a column panel, packed
+// as a single panel of MLAS_SGEMM_STRIDEN_THREAD_ALIGN columns that the
+// kernels consume directly. The packed data starts at the preferred buffer
+// alignment.
+//
+
+struct MLAS_SGEMM_BLOCK_SPARSE_HEADER {
+    size_t N;
+    size_t K;
+    size_t PanelCount;
+    size_t RunCount;
+    size_t DataOffset;
+};
+
+struct MLAS_SGEMM_BLOCK_SPARSE_RUN {
+    size_t StartK;
+    size_t CountK;
+    size_t Offset;
+};
+
 //
 // Define the parameters to execute segments of a SGEMM operation on worker
 // threads.
@@ -1003,6 +1039,107 @@ Return Value:
 
 #endif
 
+void
+MlasSgemmApplyEpilogue(
+    const MLAS_SGEMM_EPILOGUE* Epilogue,
+    float* C,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the bias, residual and activation of the epilogue to
+    a block of the output matrix that has just been computed.
+
+Arguments:
+
+    Epilogue - Supplies the epilogue parameters. The bias vector and the
+        residual matrix are relative to the start of matrix C.
+
+    C - Supplies the address of the output block.
+
+    StartM - Supplies the first row of the output block.
+
+    StartN - Supplies the first column of the output block.
+
+    CountM - Supplies the number of rows of the output block.
+
+    CountN - Supplies the number of columns of the output block.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* Bias = Epilogue->Bias;
+    const float* Residual = Epilogue->Residual;
+
+    if (Bias != nullptr || Residual != nullptr) {
+
+        if (Bias != nullptr) {
+            Bias += StartN;
+        }
+
+        if (Residual != nullptr) {
+            Residual += StartM * Epilogue->ldr + StartN;
+        }
+
+        float* c = C;
+
+        for (size_t m = 0; m < CountM; m++) {
+
+            size_t n = 0;
+
+            while (n + 4 <= CountN) {
+
+                MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(c + n);
+
+                if (Bias != nullptr) {
+                    Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Bias + n));
+                }
+
+                if (Residual != nullptr) {
+                    Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Residual + n));
+                }
+
+                MlasStoreFloat32x4(c + n, Vector);
+                n += 4;
+            }
+
+            while (n < CountN) {
+
+                if (Bias != nullptr) {
+                    c[n] += Bias[n];
+                }
+
+                if (Residual != nullptr) {
+                    c[n] += Residual[n];
+                }
+
+                n += 1;
+            }
+
+            c += ldc;
+
+            if (Residual != nullptr) {
+                Residual += Epilogue->ldr;
+            }
+        }
+    }
+
+    if (Epilogue->Activation != nullptr) {
+        MlasActivation(Epilogue->Activation, C, nullptr, CountM, CountN, ldc);
+    }
+}
+
 MLAS_FORCEINLINE
 float*
 MlasSgemmKernelLoop(
@@ -1015,7 +1152,10 @@ MlasSgemmKernelLoop(
     size_t lda,
     size_t ldc,
     float alpha,
-    bool ZeroMode
+    bool ZeroMode,
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr,
+    size_t StartM = 0,
+    size_t StartN = 0
     )
 /*++
 
@@ -1051,6 +1191,14 @@ Arguments:
     ZeroMode - Supplies true if the output matrix must be zero initialized,
         else false if the output matrix is accumulated into.
 
+    Epilogue - Optionally supplies the epilogue to apply to the rows after the
+        kernel has computed them. Only supplied for the last slice along the K
+        dimension.
+
+    StartM - Supplies the first row of the output relative to the epilogue.
+
+    StartN - Supplies the first column of the output relative to the epilogue.
+
 Return Value:
 
     Returns the next address of matrix C.
@@ -1071,6 +1219,11 @@ Return Value:
         }
 #endif
 
+        if (Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, C, StartM, StartN, RowsHandled, CountN, ldc);
+            StartM += RowsHandled;
+        }
+
         C += ldc * RowsHandled;
         A += lda * RowsHandled;
         CountM -= RowsHandled;
@@ -1093,7 +1246,8 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
     )
 /*++
 
@@ -1131,6 +1285,9 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Optionally supplies the epilogue to apply to matrix C. The bias
+        vector and the residual matrix are relative to the start of matrix C.
+
 Return Value:
 
     None.
@@ -1147,6 +1304,9 @@ Return Value:
 
     if (K == 0) {
         MlasSgemmMultiplyBeta(C, M, N, ldc, beta);
+        if (Epilogue != nullptr) {
+            MlasSgemmApplyEpilogue(Epilogue, C, 0, 0, M, N, ldc);
+        }
         return;
     }
 
@@ -1171,6 +1331,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, 0, 0, 1, N, ldc);
+            }
             return;
         }
 
@@ -1178,6 +1341,9 @@ Return Value:
 
         if (TransB == CblasNoTrans) {
             MlasGemvFloatKernel(A, B, C, K, N, ldb, (beta == 0.0f));
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, 0, 0, 1, N, ldc);
+            }
             return;
         }
 
@@ -1207,6 +1373,9 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(B, A, C, K, M, lda, beta);
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, 0, 0, M, 1, ldc);
+            }
             return;
         }
 
@@ -1214,6 +1383,37 @@ Return Value:
 
     }
 
+    //
+    // Handle the case of a small product. Packing the panels of matrix B
+    // would cost as much as the multiply itself, so use the kernels that read
+    // matrix A and matrix B in place.
+    //
+
+    if (M <= MLAS_SGEMM_SMALL_MAX_M && N <= MLAS_SGEMM_SMALL_MAX_N && K <= MLAS_SGEMM_SMALL_MAX_K) {
+
+        const MLAS_SGEMM_SMALL_DISPATCH* SgemmSmallDispatch = GetMlasPlatform().SgemmSmallDispatch;
+
+        const bool UseSmallKernel = (TransB == CblasNoTrans) ||
+            (TransA == CblasNoTrans && M <= MLAS_SGEMM_SMALL_TRANSB_MAX_M && K >= MLAS_SGEMM_SMALL_TRANSB_MIN_K);
+
+        if (SgemmSmallDispatch != nullptr && UseSmallKernel) {
+
+            const size_t StrideAm = (TransA == CblasNoTrans) ? lda : 1;
+            const size_t StrideAk = (TransA == CblasNoTrans) ? 1 : lda;
+
+            if (TransB == CblasNoTrans) {
+                SgemmSmallDispatch->Kernel(A, StrideAm, StrideAk, B, ldb, C, ldc, M, N, K, alpha, beta);
+            } else {
+                SgemmSmallDispatch->KernelTransposeB(A, StrideAm, StrideAk, B, ldb, C, ldc, M, N, K, alpha, beta);
+            }
+
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, C, 0, 0, M, N, ldc);
+            }
+            return;
+        }
+    }
+
     //
     // Compute the strides to step through slices of the input matrices.
     //
@@ -1269,6 +1469,13 @@ Return Value:
 
             CountK = std::min(K - k, StrideK);
 
+            //
+            // Apply the epilogue with the last slice along the K dimension
+            // while the output rows are still in the cache.
+            //
+
+            const MLAS_SGEMM_EPILOGUE* SliceEpilogue = (k + CountK == K) ? Epilogue : nullptr;
+
             //
             // Copy or transpose a panel of matrix B to a local packed buffer.
             //
@@ -1287,7 +1494,8 @@ Return Value:
 
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    SliceEpilogue, 0, n);
 
             } else {
 
@@ -1304,14 +1512,15 @@ Return Value:
 
                     MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
 
-                    RowsRemaining -= RowsTransposed;
-                    a += RowsTransposed;
-
                     //
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        SliceEpilogue, M - RowsRemaining, n);
+
+                    RowsRemaining -= RowsTransposed;
+                    a += RowsTransposed;
                 }
             }
 
@@ -1334,7 +1543,8 @@ MlasSgemmPackedOperation(
     size_t AlignedN,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
     )
 /*++
 
@@ -1374,6 +1584,9 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    Epilogue - Optionally supplies the epilogue to apply to matrix C. The bias
+        vector and the residual matrix are relative to the start of matrix C.
+
 Return Value:
 
     None.
@@ -1413,6 +1626,8 @@ Return Value:
 
             CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
 
+            const MLAS_SGEMM_EPILOGUE* SliceEpilogue = (k + CountK == K) ? Epilogue : nullptr;
+
             //
             // Step through each slice of matrix A along the M dimension.
             //
@@ -1422,7 +1637,8 @@ Return Value:
 
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    SliceEpilogue, 0, n);
 
             } else {
 
@@ -1439,14 +1655,169 @@ Return Value:
 
                     MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
 
-                    RowsRemaining -= RowsTransposed;
-                    a += RowsTransposed;
-
                     //
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        SliceEpilogue, M - RowsRemaining, n);
+
+                    RowsRemaining -= RowsTransposed;
+                    a += RowsTransposed;
+                }
+            }
+
+            ZeroMode = false;
+        }
+    }
+}
+
+void
+MlasSgemmBlockSparseOperation(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    const MLAS_SGEMM_EPILOGUE* Epilogue
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) with a block sparse packed matrix B. Only the non-zero
+    blocks of matrix B are multiplied.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    RangeStartN - Supplies the starting column from packed matrix B. This is
+        a multiple of MLAS_SGEMM_STRIDEN_THREAD_ALIGN.
+
+    RangeCountN - Supplies the number of columns of matrix B and matrix C.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of the matrix B packed by
+        MlasGemmBlockSparsePackB.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    Epilogue - Optionally supplies the epilogue to apply to matrix C. The bias
+        vector and the residual matrix are relative to the start of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_PACKED_STRIDEK];
+
+    const auto* Header = static_cast<const MLAS_SGEMM_BLOCK_SPARSE_HEADER*>(PackedB);
+    const auto* PanelRuns = reinterpret_cast<const size_t*>(Header + 1);
+    const auto* Runs = reinterpret_cast<const MLAS_SGEMM_BLOCK_SPARSE_RUN*>(PanelRuns + Header->PanelCount + 1);
+    const float* Data = reinterpret_cast<const float*>(static_cast<const uint8_t*>(PackedB) + Header->DataOffset);
+
+    //
+    // Step through each column panel of matrix B.
+    //
+
+    size_t CountN;
+
+    for (size_t n = 0; n < RangeCountN; n += CountN) {
+
+        const size_t Panel = (RangeStartN + n) / MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+        CountN = std::min(RangeCountN - n, size_t(MLAS_SGEMM_STRIDEN_THREAD_ALIGN));
+
+        float* c = C + n;
+
+        //
+        // Multiply the output matrix by beta as needed.
+        //
+
+        if (beta != 0.0f && beta != 1.0f) {
+            MlasSgemmMultiplyBeta(c, M, CountN, ldc, beta);
+        }
+
+        const size_t FirstRun = PanelRuns[Panel];
+        const size_t LastRun = PanelRuns[Panel + 1];
+
+        //
+        // A column panel without non-zero blocks only contributes beta times
+        // the output.
+        //
+
+        if (FirstRun == LastRun) {
+
+            if (beta == 0.0f) {
+                for (size_t m = 0; m < M; m++) {
+                    std::fill_n(c + m * ldc, CountN, 0.0f);
+                }
+            }
+
+            if (Epilogue != nullptr) {
+                MlasSgemmApplyEpilogue(Epilogue, c, 0, n, M, CountN, ldc);
+            }
+
+            continue;
+        }
+
+        //
+        // Step through each run of non-zero blocks of the column panel.
+        //
+
+        bool ZeroMode = (beta == 0.0f);
+
+        for (size_t r = FirstRun; r < LastRun; r++) {
+
+            const size_t k = Runs[r].StartK;
+            const size_t CountK = Runs[r].CountK;
+            const float* pb = Data + Runs[r].Offset;
+
+            const MLAS_SGEMM_EPILOGUE* SliceEpilogue = (r + 1 == LastRun) ? Epilogue : nullptr;
+
+            if (TransA == CblasNoTrans) {
+
+                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    SliceEpilogue, 0, n);
+
+            } else {
+
+                const float* a = A + k * lda;
+                float* cc = c;
+                size_t RowsRemaining = M;
+
+                while (RowsRemaining > 0) {
+
+                    size_t RowsTransposed = std::min(RowsRemaining, size_t(MLAS_SGEMM_TRANSA_ROWS));
+
+                    MlasSgemmTransposeA(PanelA, a, lda, RowsTransposed, CountK);
+
+                    cc = MlasSgemmKernelLoop(PanelA, pb, cc, CountK, RowsTransposed, CountN, CountK, ldc, alpha,
+                        ZeroMode, SliceEpilogue, M - RowsRemaining, n);
+
+                    RowsRemaining -= RowsTransposed;
+                    a += RowsTransposed;
                 }
             }
 
@@ -1538,11 +1909,38 @@ Return Value:
     const float* A = DataParams->A + RangeStartM * ((TransA == CblasNoTrans) ? lda : 1);
     float* C = DataParams->C + RangeStartM * ldc + RangeStartN;
 
-    if (DataParams->BIsPacked) {
+    //
+    // Rebase the epilogue to the partitioned output.
+    //
+
+    MLAS_SGEMM_EPILOGUE RangeEpilogue;
+    const MLAS_SGEMM_EPILOGUE* Epilogue = nullptr;
+
+    if (DataParams->Epilogue != nullptr) {
+
+        RangeEpilogue = *DataParams->Epilogue;
+
+        if (RangeEpilogue.Bias != nullptr) {
+            RangeEpilogue.Bias += RangeStartN;
+        }
+
+        if (RangeEpilogue.Residual != nullptr) {
+            RangeEpilogue.Residual += RangeStartM * RangeEpilogue.ldr + RangeStartN;
+        }
+
+        Epilogue = &RangeEpilogue;
+    }
+
+    if (DataParams->BIsBlockSparse) {
+
+        MlasSgemmBlockSparseOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
+            DataParams->alpha, A, lda, DataParams->B, DataParams->beta, C, ldc, Epilogue);
+
+    } else if (DataParams->BIsPacked) {
 
         MlasSgemmPackedOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
             K, DataParams->alpha, A, lda, DataParams->B,
-            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc);
+            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc, Epilogue);
 
     } else {
 
@@ -1551,7 +1949,7 @@ Return Value:
         const float* B = (const float*)DataParams->B + RangeStartN * ((TransB == CblasNoTrans) ? 1 : ldb);
 
         MlasSgemmOperation(TransA, TransB, RangeCountM, RangeCountN, K,
-            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc);
+            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc, Epilogue);
     }
 }
 #if defined(_MSC_VER) && !defined(__clang__)
@@ -1569,13 +1967,46 @@ MlasGemmBatch(
     size_t K,
     const MLAS_SGEMM_DATA_PARAMS* Data,
     size_t BatchSize,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    const MLAS_SGEMM_THREADING* Threading
     )
 {
+    const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    ptrdiff_t ThreadsPerGemm;
+    ptrdiff_t ThreadCountM;
+    ptrdiff_t ThreadCountN;
 
     //
-    // Compute the number of target threads given the complexity of the SGEMM
-    // operation. Small requests should run using the single threaded path.
+    // Use the thread partition supplied by the caller, typically the result
+    // of tuning the operation for this shape. Each dimension is clamped to
+    // the number of segments that the dimension can be split into.
+    //
+
+    if (Threading != nullptr &&
+        (Threading->ThreadCountM != 0 || Threading->ThreadCountN != 0)) {
+
+        ThreadCountM = ptrdiff_t(std::min(std::max(Threading->ThreadCountM, size_t{1}), std::max(M, size_t{1})));
+        ThreadCountN = ptrdiff_t(std::min(std::max(Threading->ThreadCountN, size_t{1}), std::max(BlockedN, size_t{1})));
+        ThreadsPerGemm = ThreadCountM * ThreadCountN;
+
+        MlasTrySimpleParallel(ThreadPool,
+            ThreadsPerGemm * static_cast<ptrdiff_t>(BatchSize),
+            [=](ptrdiff_t tid)
+        {
+            ptrdiff_t GemmIdx = tid / ThreadsPerGemm;
+            ptrdiff_t ThreadIdx = tid % ThreadsPerGemm;
+            MlasSgemmThreaded(ThreadCountM, ThreadCountN,
+                TransA, TransB, M, N, K, &(Data[GemmIdx]), ThreadIdx);
+        });
+
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the SGEMM
+    // operation. Small requests should run using the single threaded path.
     //
 
     const double Complexity = double(M) * double(N) * double(K);
@@ -1594,15 +2025,10 @@ MlasGemmBatch(
     // works okay for operations involving skinny matrices.
     //
 
-    ptrdiff_t ThreadsPerGemm = (TargetThreadCount + BatchSize - 1) / BatchSize;
-    ptrdiff_t ThreadCountM;
-    ptrdiff_t ThreadCountN;
+    ThreadsPerGemm = (TargetThreadCount + BatchSize - 1) / BatchSize;
 
     if (N > M) {
 
-        const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
-            MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
-
         if (size_t(ThreadsPerGemm) > BlockedN) {
             ThreadsPerGemm = ptrdiff_t(BlockedN);
         }
@@ -1634,6 +2060,155 @@ MlasGemmBatch(
 #pragma warning(pop)
 #endif
 
+void
+MLASCALL
+MlasGemmGrouped(
+    const MLAS_SGEMM_GROUPED_PARAMS* Problems,
+    size_t ProblemCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) for a group of multiplications of different shapes.
+
+Arguments:
+
+    Problems - Supplies the array of multiplications.
+
+    ProblemCount - Supplies the number of multiplications.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Compute the number of target threads given the total complexity of the
+    // multiplications. A multiplication with an empty K dimension still has
+    // to scale the output matrix by beta.
+    //
+
+    double TotalComplexity = 0.0;
+
+    for (size_t i = 0; i < ProblemCount; i++) {
+        const MLAS_SGEMM_GROUPED_PARAMS& Problem = Problems[i];
+        TotalComplexity += double(Problem.M) * double(Problem.N) * double(std::max(Problem.K, size_t{1}));
+    }
+
+    if (TotalComplexity == 0.0) {
+        return;
+    }
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(TotalComplexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Run the whole group on the current thread if the group is too small to
+    // benefit from threading.
+    //
+
+    if (TargetThreadCount == 1) {
+
+        for (size_t i = 0; i < ProblemCount; i++) {
+            const MLAS_SGEMM_GROUPED_PARAMS& Problem = Problems[i];
+            if (Problem.M != 0 && Problem.N != 0) {
+                MlasSgemmThreaded(1, 1, Problem.TransA, Problem.TransB, Problem.M, Problem.N, Problem.K,
+                    &Problem.Data, 0);
+            }
+        }
+
+        return;
+    }
+
+    //
+    // Split each multiplication into a number of segments proportional to its
+    // share of the total complexity. As with MlasGemmBatch, the segments are
+    // a 1D partition along the larger of the M and N dimensions.
+    //
+
+    struct MLAS_SGEMM_GROUPED_PARTITION {
+        ptrdiff_t ThreadCountM;
+        ptrdiff_t ThreadCountN;
+    };
+
+    std::vector<MLAS_SGEMM_GROUPED_PARTITION> Partitions(ProblemCount);
+    std::vector<ptrdiff_t> FirstSegments(ProblemCount);
+
+    ptrdiff_t SegmentCount = 0;
+
+    for (size_t i = 0; i < ProblemCount; i++) {
+
+        const MLAS_SGEMM_GROUPED_PARAMS& Problem = Problems[i];
+        MLAS_SGEMM_GROUPED_PARTITION& Partition = Partitions[i];
+
+        Partition.ThreadCountM = 0;
+        Partition.ThreadCountN = 0;
+        FirstSegments[i] = SegmentCount;
+
+        if (Problem.M == 0 || Problem.N == 0) {
+            continue;
+        }
+
+        const double Complexity = double(Problem.M) * double(Problem.N) * double(std::max(Problem.K, size_t{1}));
+
+        ptrdiff_t ThreadsPerGemm = ptrdiff_t(std::ceil(double(TargetThreadCount) * Complexity / TotalComplexity));
+
+        const size_t BlockedN = (Problem.N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+            MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+        if (Problem.N > Problem.M) {
+
+            if (size_t(ThreadsPerGemm) > BlockedN) {
+                ThreadsPerGemm = ptrdiff_t(BlockedN);
+            }
+
+            Partition.ThreadCountM = 1;
+            Partition.ThreadCountN = ThreadsPerGemm;
+
+        } else {
+
+            if (size_t(ThreadsPerGemm) > Problem.M) {
+                ThreadsPerGemm = ptrdiff_t(Problem.M);
+            }
+
+            Partition.ThreadCountM = ThreadsPerGemm;
+            Partition.ThreadCountN = 1;
+        }
+
+        SegmentCount += ThreadsPerGemm;
+    }
+
+    MlasTrySimpleParallel(ThreadPool, SegmentCount, [&](ptrdiff_t tid)
+    {
+        //
+        // Find the multiplication that owns this segment. Empty
+        // multiplications share their first segment with the next one, so
+        // take the last multiplication that starts at or before the segment.
+        //
+
+        const size_t ProblemIdx = size_t(std::upper_bound(FirstSegments.begin(), FirstSegments.end(), tid) -
+            FirstSegments.begin()) - 1;
+
+        const MLAS_SGEMM_GROUPED_PARAMS& Problem = Problems[ProblemIdx];
+        const MLAS_SGEMM_GROUPED_PARTITION& Partition = Partitions[ProblemIdx];
+
+        MlasSgemmThreaded(Partition.ThreadCountM, Partition.ThreadCountN,
+            Problem.TransA, Problem.TransB, Problem.M, Problem.N, Problem.K,
+            &Problem.Data, tid - FirstSegments[ProblemIdx]);
+    });
+}
+
 size_t
 MLASCALL
 MlasGemmPackBSize(
@@ -1734,3 +2309,340 @@ Return Value:
         PackedB = (float*)PackedB + AlignedN * CountK;
     }
 }
+
+bool
+MlasSgemmIsZeroBlock(
+    CBLAS_TRANSPOSE TransB,
+    const float* B,
+    size_t ldb,
+    size_t StartK,
+    size_t CountK,
+    size_t StartN,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine returns whether a block of matrix B only contains zeros.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    StartK - Supplies the first row of the block.
+
+    CountK - Supplies the number of rows of the block.
+
+    StartN - Supplies the first column of the block.
+
+    CountN - Supplies the number of columns of the block.
+
+Return Value:
+
+    Returns true if all elements of the block are zero.
+
+--*/
+{
+    for (size_t k = StartK; k < StartK + CountK; k++) {
+        for (size_t n = StartN; n < StartN + CountN; n++) {
+            const float b = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+            if (b != 0.0f) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+template<typename RunCallback>
+void
+MlasSgemmBlockSparseForEachRun(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    RunCallback Callback
+    )
+/*++
+
+Routine Description:
+
+    This routine enumerates the runs of consecutive non-zero blocks of each
+    column panel of matrix B. Runs are limited to MLAS_SGEMM_PACKED_STRIDEK
+    rows so that a run of a dense matrix is sliced like the packed SGEMM.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    Callback - Supplies the routine invoked with the panel index, the first
+        row and the number of rows of each run, in order.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    for (size_t n = 0; n < N; n += MLAS_SGEMM_STRIDEN_THREAD_ALIGN) {
+
+        const size_t Panel = n / MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+        const size_t CountN = std::min(N - n, size_t(MLAS_SGEMM_STRIDEN_THREAD_ALIGN));
+
+        size_t RunStartK = 0;
+        size_t RunCountK = 0;
+
+        for (size_t k = 0; k < K; k += MLAS_SGEMM_BLOCK_SPARSE_STRIDEK) {
+
+            const size_t CountK = std::min(K - k, size_t(MLAS_SGEMM_BLOCK_SPARSE_STRIDEK));
+
+            if (MlasSgemmIsZeroBlock(TransB, B, ldb, k, CountK, n, CountN)) {
+                if (RunCountK > 0) {
+                    Callback(Panel, RunStartK, RunCountK);
+                    RunCountK = 0;
+                }
+                continue;
+            }
+
+            if (RunCountK > 0 && RunCountK + CountK > MLAS_SGEMM_PACKED_STRIDEK) {
+                Callback(Panel, RunStartK, RunCountK);
+                RunCountK = 0;
+            }
+
+            if (RunCountK == 0) {
+                RunStartK = k;
+            }
+
+            RunCountK += CountK;
+        }
+
+        if (RunCountK > 0) {
+            Callback(Panel, RunStartK, RunCountK);
+        }
+    }
+}
+
+float
+MLASCALL
+MlasGemmBlockSparsity(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the fraction of the blocks of matrix B that only
+    contain zeros and are skipped by a block sparse packed matrix.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    Returns the fraction of zero blocks, between 0 and 1.
+
+--*/
+{
+    if (N == 0 || K == 0) {
+        return 0.0f;
+    }
+
+    size_t NonZeroRows = 0;
+
+    MlasSgemmBlockSparseForEachRun(TransB, N, K, B, ldb, [&](size_t, size_t, size_t CountK) {
+        NonZeroRows += CountK;
+    });
+
+    const size_t PanelCount = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) / MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    return 1.0f - float(double(NonZeroRows) / (double(PanelCount) * double(K)));
+}
+
+size_t
+MLASCALL
+MlasGemmBlockSparsePackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the block sparse packed
+    matrix B buffer. The length depends on the number of non-zero blocks of
+    matrix B.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    Returns the size in bytes for the block sparse packed matrix B buffer.
+
+--*/
+{
+    size_t RunCount = 0;
+    size_t NonZeroRows = 0;
+
+    MlasSgemmBlockSparseForEachRun(TransB, N, K, B, ldb, [&](size_t, size_t, size_t CountK) {
+        RunCount++;
+        NonZeroRows += CountK;
+    });
+
+    const size_t PanelCount = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) / MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+
+    size_t BytesRequired = sizeof(MLAS_SGEMM_BLOCK_SPARSE_HEADER) + (PanelCount + 1) * sizeof(size_t) +
+                           RunCount * sizeof(MLAS_SGEMM_BLOCK_SPARSE_RUN);
+
+    BytesRequired = (BytesRequired + BufferAlignment - 1) & ~(BufferAlignment - 1);
+    BytesRequired += NonZeroRows * MLAS_SGEMM_STRIDEN_THREAD_ALIGN * sizeof(float);
+    BytesRequired = (BytesRequired + BufferAlignment - 1) & ~(BufferAlignment - 1);
+
+    return BytesRequired;
+}
+
+void
+MLASCALL
+MlasGemmBlockSparsePackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the non-zero blocks of matrix B to the destination
+    buffer. The destination buffer should be sized based on
+    MlasGemmBlockSparsePackBSize() and aligned to the value returned from
+    MlasGetPreferredBufferAlignment().
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of packed matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    size_t RunCount = 0;
+
+    MlasSgemmBlockSparseForEachRun(TransB, N, K, B, ldb, [&](size_t, size_t, size_t) {
+        RunCount++;
+    });
+
+    const size_t PanelCount = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) / MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+
+    size_t DataOffset = sizeof(MLAS_SGEMM_BLOCK_SPARSE_HEADER) + (PanelCount + 1) * sizeof(size_t) +
+                        RunCount * sizeof(MLAS_SGEMM_BLOCK_SPARSE_RUN);
+
+    DataOffset = (DataOffset + BufferAlignment - 1) & ~(BufferAlignment - 1);
+
+    auto* Header = static_cast<MLAS_SGEMM_BLOCK_SPARSE_HEADER*>(PackedB);
+    auto* PanelRuns = reinterpret_cast<size_t*>(Header + 1);
+    auto* Runs = reinterpret_cast<MLAS_SGEMM_BLOCK_SPARSE_RUN*>(PanelRuns + PanelCount + 1);
+    float* Data = reinterpret_cast<float*>(static_cast<uint8_t*>(PackedB) + DataOffset);
+
+    Header->N = N;
+    Header->K = K;
+    Header->PanelCount = PanelCount;
+    Header->RunCount = RunCount;
+    Header->DataOffset = DataOffset;
+
+    //
+    // Pack each run as a panel of MLAS_SGEMM_STRIDEN_THREAD_ALIGN columns,
+    // zero padding the columns beyond N.
+    //
+
+    size_t RunIndex = 0;
+    size_t Offset = 0;
+    size_t NextPanel = 0;
+
+    MlasSgemmBlockSparseForEachRun(TransB, N, K, B, ldb, [&](size_t Panel, size_t StartK, size_t CountK) {
+
+        while (NextPanel <= Panel) {
+            PanelRuns[NextPanel++] = RunIndex;
+        }
+
+        const size_t StartN = Panel * MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+        const size_t CountN = std::min(N - StartN, size_t(MLAS_SGEMM_STRIDEN_THREAD_ALIGN));
+
+        float* D = Data + Offset;
+
+        std::fill_n(D, CountK * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, 0.0f);
+
+        if (TransB == CblasNoTrans) {
+            MlasSgemmCopyPackB(D, B + StartK * ldb + StartN, ldb, CountN, CountK);
+        } else {
+            MlasSgemmTransposePackB(D, B + StartN * ldb + StartK, ldb, CountN, CountK);
+        }
+
+        Runs[RunIndex].StartK = StartK;
+        Runs[RunIndex].CountK = CountK;
+        Runs[RunIndex].Offset = Offset;
+
+        RunIndex++;
+        Offset += CountK * MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    });
+
+    while (NextPanel <= PanelCount) {
+        PanelRuns[NextPanel++] = RunIndex;
+    }
+}
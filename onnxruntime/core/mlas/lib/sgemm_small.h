@@ -0,0 +1,72 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_small.h
+
+Abstract:
+
+    This module includes kernel function prototypes for the single precision
+    matrix/matrix multiply operation (SGEMM) of small matrices.
+
+    For a small product, copying panels of matrix B to a packed buffer costs
+    as much as the multiply itself. The small kernels read matrix A and matrix
+    B in place. Each kernel is specialized at compile time for the number of
+    rows and columns it computes at once, and the specializations are chosen
+    from the shape of the product.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+//
+// Define the maximum dimensions of a product handled by the small kernels.
+//
+
+#define MLAS_SGEMM_SMALL_MAX_M                      16
+#define MLAS_SGEMM_SMALL_MAX_N                      256
+#define MLAS_SGEMM_SMALL_MAX_K                      256
+
+//
+// Define the limits for a transposed matrix B. The kernel computes dot
+// products along the K dimension, which only beats packing matrix B for a few
+// rows of matrix A and a long enough K dimension.
+//
+
+#define MLAS_SGEMM_SMALL_TRANSB_MAX_M               4
+#define MLAS_SGEMM_SMALL_TRANSB_MIN_K               32
+
+struct MLAS_SGEMM_SMALL_DISPATCH {
+    //
+    // Computes C = alpha * A * B + beta * C for CountM rows of matrix C. The
+    // element (m, k) of matrix A is at A[m * StrideAm + k * StrideAk]. Matrix
+    // C is not read when beta is zero.
+    //
+    typedef void(SgemmSmallKernel_Fn)(
+        const float* A,
+        size_t StrideAm,
+        size_t StrideAk,
+        const float* B,
+        size_t ldb,
+        float* C,
+        size_t ldc,
+        size_t CountM,
+        size_t CountN,
+        size_t CountK,
+        float alpha,
+        float beta
+    );
+
+    // matrix B is stored as K x N.
+    SgemmSmallKernel_Fn* Kernel = nullptr;
+
+    // matrix B is stored as N x K. Rows of matrix A must be contiguous, so
+    // StrideAk must be one.
+    SgemmSmallKernel_Fn* KernelTransposeB = nullptr;
+};
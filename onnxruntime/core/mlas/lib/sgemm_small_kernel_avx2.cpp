@@ -0,0 +1,372 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_small_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the small matrix SGEMM kernels for AVX2 supported
+    h/w.
+
+--*/
+
+#include <utility>
+
+#include "sgemm_small.h"
+
+namespace sgemm_small_avx2 {
+
+namespace {
+
+template <typename IterationFn, size_t... Indices>
+MLAS_FORCEINLINE void
+UnrolledLoopIterations(IterationFn&& f, std::index_sequence<Indices...> /* indices */)
+{
+    (f(Indices), ...);
+}
+
+template <size_t N, typename IterationFn>
+MLAS_FORCEINLINE void
+UnrolledLoop(IterationFn&& f)
+{
+    UnrolledLoopIterations(std::forward<IterationFn>(f), std::make_index_sequence<N>());
+}
+
+//
+// Mask table for loading and storing the trailing columns of a row. Loading
+// eight entries from index (8 - n) selects the first n lanes.
+//
+
+MLAS_DECLSPEC_ALIGN(const int32_t MaskTable[16], 32) = {
+    -1, -1, -1, -1, -1, -1, -1, -1,
+    0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+MLAS_FORCEINLINE
+__m256i
+LoadMask(size_t Count)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&MaskTable[8 - Count]));
+}
+
+MLAS_FORCEINLINE
+void
+StoreOutput(float* C, __m256 Accumulator, __m256 Alpha, __m256 Beta, bool ZeroMode)
+{
+    __m256 c = _mm256_mul_ps(Accumulator, Alpha);
+    if (!ZeroMode) {
+        c = _mm256_fmadd_ps(_mm256_loadu_ps(C), Beta, c);
+    }
+    _mm256_storeu_ps(C, c);
+}
+
+MLAS_FORCEINLINE
+void
+StoreOutputMasked(float* C, __m256i Mask, __m256 Accumulator, __m256 Alpha, __m256 Beta, bool ZeroMode)
+{
+    __m256 c = _mm256_mul_ps(Accumulator, Alpha);
+    if (!ZeroMode) {
+        c = _mm256_fmadd_ps(_mm256_maskload_ps(C, Mask), Beta, c);
+    }
+    _mm256_maskstore_ps(C, Mask, c);
+}
+
+//
+// Computes RowCount rows of matrix C for a matrix B stored as K x N. Each
+// step along the K dimension broadcasts one element of each row of matrix A
+// and multiplies it with 16 columns of a row of matrix B.
+//
+
+template <size_t RowCount>
+MLAS_FORCEINLINE
+void
+SgemmSmallKernelRows(
+    const float* A,
+    size_t StrideAm,
+    size_t StrideAk,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t CountK,
+    __m256 Alpha,
+    __m256 Beta,
+    bool ZeroMode
+    )
+{
+    size_t n = 0;
+
+    for (; n + 16 <= CountN; n += 16) {
+
+        __m256 acc[RowCount][2];
+        UnrolledLoop<RowCount>([&](size_t r) {
+            acc[r][0] = _mm256_setzero_ps();
+            acc[r][1] = _mm256_setzero_ps();
+        });
+
+        const float* a = A;
+        const float* b = B + n;
+
+        for (size_t k = 0; k < CountK; k++) {
+            const __m256 b0 = _mm256_loadu_ps(b);
+            const __m256 b1 = _mm256_loadu_ps(b + 8);
+            UnrolledLoop<RowCount>([&](size_t r) {
+                const __m256 av = _mm256_broadcast_ss(a + r * StrideAm);
+                acc[r][0] = _mm256_fmadd_ps(av, b0, acc[r][0]);
+                acc[r][1] = _mm256_fmadd_ps(av, b1, acc[r][1]);
+            });
+            a += StrideAk;
+            b += ldb;
+        }
+
+        UnrolledLoop<RowCount>([&](size_t r) {
+            StoreOutput(C + r * ldc + n, acc[r][0], Alpha, Beta, ZeroMode);
+            StoreOutput(C + r * ldc + n + 8, acc[r][1], Alpha, Beta, ZeroMode);
+        });
+    }
+
+    for (; n < CountN; n += 8) {
+
+        const __m256i mask = LoadMask(std::min(CountN - n, size_t{8}));
+
+        __m256 acc[RowCount];
+        UnrolledLoop<RowCount>([&](size_t r) {
+            acc[r] = _mm256_setzero_ps();
+        });
+
+        const float* a = A;
+        const float* b = B + n;
+
+        for (size_t k = 0; k < CountK; k++) {
+            const __m256 b0 = _mm256_maskload_ps(b, mask);
+            UnrolledLoop<RowCount>([&](size_t r) {
+                acc[r] = _mm256_fmadd_ps(_mm256_broadcast_ss(a + r * StrideAm), b0, acc[r]);
+            });
+            a += StrideAk;
+            b += ldb;
+        }
+
+        UnrolledLoop<RowCount>([&](size_t r) {
+            StoreOutputMasked(C + r * ldc + n, mask, acc[r], Alpha, Beta, ZeroMode);
+        });
+    }
+}
+
+//
+// Reduces the accumulators of four columns to a vector of four sums.
+//
+
+MLAS_FORCEINLINE
+__m128
+ReduceAdd4(__m256 Acc0, __m256 Acc1, __m256 Acc2, __m256 Acc3)
+{
+    const __m256 h01 = _mm256_hadd_ps(Acc0, Acc1);
+    const __m256 h23 = _mm256_hadd_ps(Acc2, Acc3);
+    const __m256 h = _mm256_hadd_ps(h01, h23);
+    return _mm_add_ps(_mm256_castps256_ps128(h), _mm256_extractf128_ps(h, 1));
+}
+
+MLAS_FORCEINLINE
+float
+ReduceAdd(__m256 Acc)
+{
+    __m128 v = _mm_add_ps(_mm256_castps256_ps128(Acc), _mm256_extractf128_ps(Acc, 1));
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_movehdup_ps(v));
+    return _mm_cvtss_f32(v);
+}
+
+//
+// Computes RowCount rows and ColCount columns of matrix C for a matrix B
+// stored as N x K. Each output is the dot product of a row of matrix A and a
+// row of matrix B, accumulated eight elements along the K dimension at a
+// time.
+//
+
+template <size_t RowCount, size_t ColCount>
+MLAS_FORCEINLINE
+void
+SgemmSmallKernelTransposeBBlock(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountK,
+    float alpha,
+    float beta
+    )
+{
+    static_assert(ColCount == 1 || ColCount == 4);
+
+    __m256 acc[RowCount][ColCount];
+    UnrolledLoop<RowCount>([&](size_t r) {
+        UnrolledLoop<ColCount>([&](size_t j) {
+            acc[r][j] = _mm256_setzero_ps();
+        });
+    });
+
+    size_t k = 0;
+
+    for (; k + 8 <= CountK; k += 8) {
+        __m256 av[RowCount];
+        UnrolledLoop<RowCount>([&](size_t r) {
+            av[r] = _mm256_loadu_ps(A + r * lda + k);
+        });
+        UnrolledLoop<ColCount>([&](size_t j) {
+            const __m256 bv = _mm256_loadu_ps(B + j * ldb + k);
+            UnrolledLoop<RowCount>([&](size_t r) {
+                acc[r][j] = _mm256_fmadd_ps(av[r], bv, acc[r][j]);
+            });
+        });
+    }
+
+    if (k < CountK) {
+        const __m256i mask = LoadMask(CountK - k);
+        __m256 av[RowCount];
+        UnrolledLoop<RowCount>([&](size_t r) {
+            av[r] = _mm256_maskload_ps(A + r * lda + k, mask);
+        });
+        UnrolledLoop<ColCount>([&](size_t j) {
+            const __m256 bv = _mm256_maskload_ps(B + j * ldb + k, mask);
+            UnrolledLoop<RowCount>([&](size_t r) {
+                acc[r][j] = _mm256_fmadd_ps(av[r], bv, acc[r][j]);
+            });
+        });
+    }
+
+    for (size_t r = 0; r < RowCount; r++) {
+        float* c = C + r * ldc;
+        if constexpr (ColCount == 4) {
+            __m128 sums = _mm_mul_ps(ReduceAdd4(acc[r][0], acc[r][1], acc[r][2], acc[r][3]), _mm_set1_ps(alpha));
+            if (beta != 0.0f) {
+                sums = _mm_fmadd_ps(_mm_loadu_ps(c), _mm_set1_ps(beta), sums);
+            }
+            _mm_storeu_ps(c, sums);
+        } else {
+            float sum = ReduceAdd(acc[r][0]) * alpha;
+            if (beta != 0.0f) {
+                sum += c[0] * beta;
+            }
+            c[0] = sum;
+        }
+    }
+}
+
+template <size_t RowCount>
+MLAS_FORCEINLINE
+void
+SgemmSmallKernelTransposeBRows(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    float beta
+    )
+{
+    size_t n = 0;
+
+    for (; n + 4 <= CountN; n += 4) {
+        SgemmSmallKernelTransposeBBlock<RowCount, 4>(A, lda, B + n * ldb, ldb, C + n, ldc, CountK, alpha, beta);
+    }
+
+    for (; n < CountN; n++) {
+        SgemmSmallKernelTransposeBBlock<RowCount, 1>(A, lda, B + n * ldb, ldb, C + n, ldc, CountK, alpha, beta);
+    }
+}
+
+}  // namespace
+
+void
+SgemmSmallKernel_Avx2(
+    const float* A,
+    size_t StrideAm,
+    size_t StrideAk,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    float beta
+    )
+{
+    const __m256 Alpha = _mm256_set1_ps(alpha);
+    const __m256 Beta = _mm256_set1_ps(beta);
+    const bool ZeroMode = (beta == 0.0f);
+
+    while (CountM >= 4) {
+        SgemmSmallKernelRows<4>(A, StrideAm, StrideAk, B, ldb, C, ldc, CountN, CountK, Alpha, Beta, ZeroMode);
+        A += 4 * StrideAm;
+        C += 4 * ldc;
+        CountM -= 4;
+    }
+
+    switch (CountM) {
+        case 3:
+            SgemmSmallKernelRows<3>(A, StrideAm, StrideAk, B, ldb, C, ldc, CountN, CountK, Alpha, Beta, ZeroMode);
+            break;
+        case 2:
+            SgemmSmallKernelRows<2>(A, StrideAm, StrideAk, B, ldb, C, ldc, CountN, CountK, Alpha, Beta, ZeroMode);
+            break;
+        case 1:
+            SgemmSmallKernelRows<1>(A, StrideAm, StrideAk, B, ldb, C, ldc, CountN, CountK, Alpha, Beta, ZeroMode);
+            break;
+    }
+}
+
+void
+SgemmSmallKernelTransposeB_Avx2(
+    const float* A,
+    size_t StrideAm,
+    size_t StrideAk,
+    const float* B,
+    size_t ldb,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    float alpha,
+    float beta
+    )
+{
+    MLAS_UNREFERENCED_PARAMETER(StrideAk);
+
+    while (CountM >= 2) {
+        SgemmSmallKernelTransposeBRows<2>(A, StrideAm, B, ldb, C, ldc, CountN, CountK, alpha, beta);
+        A += 2 * StrideAm;
+        C += 2 * ldc;
+        CountM -= 2;
+    }
+
+    if (CountM > 0) {
+        SgemmSmallKernelTransposeBRows<1>(A, StrideAm, B, ldb, C, ldc, CountN, CountK, alpha, beta);
+    }
+}
+
+}  // namespace sgemm_small_avx2
+
+//
+// Kernel dispatch structure definition.
+//
+const MLAS_SGEMM_SMALL_DISPATCH MlasSgemmSmallDispatchAvx2 = []() {
+    MLAS_SGEMM_SMALL_DISPATCH d;
+    d.Kernel = sgemm_small_avx2::SgemmSmallKernel_Avx2;
+    d.KernelTransposeB = sgemm_small_avx2::SgemmSmallKernelTransposeB_Avx2;
+    return d;
+}();
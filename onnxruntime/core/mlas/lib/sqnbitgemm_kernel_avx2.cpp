@@ -17,6 +17,7 @@ Abstract:
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <utility>
 
 #include "qnbitgemm.h"
@@ -1302,6 +1303,289 @@ SQ4BitGemmM1Kernel_CompFp32_avx2(
     }
 }
 
+//
+// SQNBIT_CompFp32 kernels for 2-bit and 3-bit B.
+// The values of a block are packed into a little endian bit stream, so a sub-block of 16 values
+// takes 4 bytes (2-bit) or 6 bytes (3-bit).
+//
+
+template <size_t BlkBitWidth>
+MLAS_FORCEINLINE void
+UnpackQNBitSubBlk16_avx2(const std::byte* QuantBDataPtr, __m256& bv_lo, __m256& bv_hi)
+{
+    static_assert(BlkBitWidth == 2 || BlkBitWidth == 3);
+
+    const __m256i mask = _mm256_set1_epi32((1 << BlkBitWidth) - 1);
+    const __m256i shift = _mm256_setr_epi32(
+        0 * BlkBitWidth, 1 * BlkBitWidth, 2 * BlkBitWidth, 3 * BlkBitWidth,
+        4 * BlkBitWidth, 5 * BlkBitWidth, 6 * BlkBitWidth, 7 * BlkBitWidth
+    );
+
+    // | v0 .. v7 | in the low 8 * BlkBitWidth bits of bits_lo and | v8 .. v15 | in those of bits_hi
+    uint32_t bits_lo, bits_hi;
+    if constexpr (BlkBitWidth == 2) {
+        uint32_t bits;
+        memcpy(&bits, QuantBDataPtr, sizeof(bits));
+        bits_lo = bits;
+        bits_hi = bits >> 16;
+    } else {
+        uint64_t bits = 0;
+        memcpy(&bits, QuantBDataPtr, 6);
+        bits_lo = static_cast<uint32_t>(bits);
+        bits_hi = static_cast<uint32_t>(bits >> 24);
+    }
+
+    const __m256i bv_lo_epi32 = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(bits_lo), shift), mask);
+    const __m256i bv_hi_epi32 = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(bits_hi), shift), mask);
+    bv_lo = _mm256_cvtepi32_ps(bv_lo_epi32);
+    bv_hi = _mm256_cvtepi32_ps(bv_hi_epi32);
+}
+
+template <size_t BlkBitWidth, bool HasZeroPoint>
+MLAS_FORCEINLINE void
+SQNBitGemmM1Kernel_CompFp32_avx2_Impl(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    constexpr size_t NCols4 = 4;
+    constexpr size_t SubBlkLen16 = 16;
+    constexpr float DefaultZeroPoint = float(1 << (BlkBitWidth - 1));
+
+    const size_t BlockCountK = MlasDivRoundup(CountK, BlkLen);
+    const size_t blk_data_size_in_bytes = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    constexpr size_t subblk_data_size_in_bytes = SubBlkLen16 * BlkBitWidth / 8;
+    const size_t StrideQuantBData = BlockStrideQuantB * blk_data_size_in_bytes;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockStrideQuantB);
+
+    for (size_t n = 0; n < CountN; n += NCols4) {
+        const size_t cols = std::min(NCols4, CountN - n);
+
+        __m256 acc[NCols4];
+        UnrolledLoop<NCols4>([&](size_t i) { acc[i] = _mm256_setzero_ps(); });
+
+        for (size_t k_blk = 0; k_blk < BlockCountK; k_blk++) {
+            const size_t k_blk_start = k_blk * BlkLen;
+            const size_t k_blk_len = std::min(BlkLen, CountK - k_blk_start);
+
+            __m256 blk_acc[NCols4];
+            UnrolledLoop<NCols4>([&](size_t i) { blk_acc[i] = _mm256_setzero_ps(); });
+            __m256 a_sum = _mm256_setzero_ps();
+
+            const std::byte* b_blk_ptr = QuantBData + n * StrideQuantBData + k_blk * blk_data_size_in_bytes;
+
+            for (size_t kk = 0; kk < k_blk_len; kk += SubBlkLen16) {
+                // values of A past CountK are zero, so the padding of the last block of B does not contribute
+                const int k_remaining = static_cast<int>(k_blk_len - kk);
+                const __m256 av_lo = load_float_n_avx2(A + k_blk_start + kk, std::min(k_remaining, 8));
+                const __m256 av_hi = load_float_n_avx2(A + k_blk_start + kk + 8, std::min(k_remaining - 8, 8));
+                a_sum = _mm256_add_ps(a_sum, _mm256_add_ps(av_lo, av_hi));
+
+                const std::byte* b_subblk_ptr = b_blk_ptr + (kk / SubBlkLen16) * subblk_data_size_in_bytes;
+                UnrolledLoop<NCols4>([&](size_t i) {
+                    if (i < cols) {
+                        __m256 bv_lo, bv_hi;
+                        UnpackQNBitSubBlk16_avx2<BlkBitWidth>(b_subblk_ptr + i * StrideQuantBData, bv_lo, bv_hi);
+                        blk_acc[i] = _mm256_fmadd_ps(bv_lo, av_lo, blk_acc[i]);
+                        blk_acc[i] = _mm256_fmadd_ps(bv_hi, av_hi, blk_acc[i]);
+                    }
+                });
+            }
+
+            // sum((b - zp) * a) * scale = (sum(b * a) - zp * sum(a)) * scale
+            UnrolledLoop<NCols4>([&](size_t i) {
+                if (i < cols) {
+                    float zp = DefaultZeroPoint;
+                    if constexpr (HasZeroPoint) {
+                        zp = static_cast<float>(MlasQNBitZeroPointForBlk<BlkBitWidth>(
+                            QuantBZeroPoint + (n + i) * StrideQuantBZeroPoint, k_blk
+                        ));
+                    }
+                    const __m256 scale = _mm256_set1_ps(QuantBScale[(n + i) * BlockStrideQuantB + k_blk]);
+                    const __m256 dot = _mm256_fnmadd_ps(_mm256_set1_ps(zp), a_sum, blk_acc[i]);
+                    acc[i] = _mm256_fmadd_ps(dot, scale, acc[i]);
+                }
+            });
+        }
+
+        if (cols == NCols4) {
+            __m128 acc_x = FoldAccumulators(acc[0], acc[1], acc[2], acc[3]);
+            if (Bias != nullptr) {
+                acc_x = _mm_add_ps(acc_x, _mm_loadu_ps(Bias + n));
+            }
+            _mm_storeu_ps(C + n, acc_x);
+        } else {
+            for (size_t i = 0; i < cols; i++) {
+                C[n + i] = hsum_float_8(acc[i]) + ((Bias != nullptr) ? Bias[n + i] : 0.0f);
+            }
+        }
+    }
+}
+
+template <size_t BlkBitWidth>
+void
+SQNBitGemmM1Kernel_CompFp32_avx2(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    if (QuantBZeroPoint != nullptr) {
+        SQNBitGemmM1Kernel_CompFp32_avx2_Impl<BlkBitWidth, true>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    } else {
+        SQNBitGemmM1Kernel_CompFp32_avx2_Impl<BlkBitWidth, false>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+        );
+    }
+}
+
+template void SQNBitGemmM1Kernel_CompFp32_avx2<2>(
+    size_t, const float*, const std::byte*, const float*, const std::byte*, float*, size_t, size_t, size_t, const float*
+);
+template void SQNBitGemmM1Kernel_CompFp32_avx2<3>(
+    size_t, const float*, const std::byte*, const float*, const std::byte*, float*, size_t, size_t, size_t, const float*
+);
+
+//
+// Transposes 8 columns of 8 values each and stores them as 8 rows of the 16 wide Sgemm B panel.
+//
+MLAS_FORCEINLINE void
+Transpose8x8StoreSgemmPanel_avx2(const __m256 (&v)[8], float* dst)
+{
+    constexpr size_t GemmFloatKernelWidth16 = 16;
+
+    const __m256 a0 = _mm256_unpacklo_ps(v[0], v[1]);
+    const __m256 a1 = _mm256_unpackhi_ps(v[0], v[1]);
+    const __m256 a2 = _mm256_unpacklo_ps(v[2], v[3]);
+    const __m256 a3 = _mm256_unpackhi_ps(v[2], v[3]);
+    const __m256 a4 = _mm256_unpacklo_ps(v[4], v[5]);
+    const __m256 a5 = _mm256_unpackhi_ps(v[4], v[5]);
+    const __m256 a6 = _mm256_unpacklo_ps(v[6], v[7]);
+    const __m256 a7 = _mm256_unpackhi_ps(v[6], v[7]);
+
+    const __m256 b0 = _mm256_shuffle_ps(a0, a2, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 b1 = _mm256_shuffle_ps(a0, a2, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 b2 = _mm256_shuffle_ps(a1, a3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 b3 = _mm256_shuffle_ps(a1, a3, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 b4 = _mm256_shuffle_ps(a4, a6, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 b5 = _mm256_shuffle_ps(a4, a6, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 b6 = _mm256_shuffle_ps(a5, a7, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 b7 = _mm256_shuffle_ps(a5, a7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    _mm256_storeu_ps(dst + 0 * GemmFloatKernelWidth16, _mm256_permute2f128_ps(b0, b4, 0x20));
+    _mm256_storeu_ps(dst + 1 * GemmFloatKernelWidth16, _mm256_permute2f128_ps(b1, b5, 0x20));
+    _mm256_storeu_ps(dst + 2 * GemmFloatKernelWidth16, _mm256_permute2f128_ps(b2, b6, 0x20));
+    _mm256_storeu_ps(dst + 3 * GemmFloatKernelWidth16, _mm256_permute2f128_ps(b3, b7, 0x20));
+    _mm256_storeu_ps(dst + 4 * GemmFloatKernelWidth16, _mm256_permute2f128_ps(b0, b4, 0x31));
+    _mm256_storeu_ps(dst + 5 * GemmFloatKernelWidth16, _mm256_permute2f128_ps(b1, b5, 0x31));
+    _mm256_storeu_ps(dst + 6 * GemmFloatKernelWidth16, _mm256_permute2f128_ps(b2, b6, 0x31));
+    _mm256_storeu_ps(dst + 7 * GemmFloatKernelWidth16, _mm256_permute2f128_ps(b3, b7, 0x31));
+}
+
+template <size_t BlkBitWidth>
+void
+SQNBitBlkDequantBForSgemm_CompFp32_avx2(
+    const size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    const size_t CountN,
+    const size_t CountK,
+    const size_t BlockCountK
+)
+{
+    constexpr size_t NCols8 = 8;                   // process NCols8 columns of QuantB at a time
+    constexpr size_t GemmFloatKernelWidth16 = 16;  // mlas GemmFloatKernel requires B with width 16
+    constexpr size_t SubBlkLen16 = 16;             // process SubBlkLen16 rows of QuantB at a time
+    constexpr float DefaultZeroPoint = float(1 << (BlkBitWidth - 1));
+
+    const size_t blk_data_size_in_bytes = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    constexpr size_t subblk_data_size_in_bytes = SubBlkLen16 * BlkBitWidth / 8;
+    const size_t b_data_col_stride_in_bytes = BlockCountK * blk_data_size_in_bytes;
+    const size_t zp_col_stride_in_bytes = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    for (size_t col = 0; col < CountN; col += NCols8) {
+        const size_t cols = std::min(NCols8, CountN - col);
+        for (size_t k = 0; k < BlockCountK; k++) {
+            // count # of tiles plus blks of the current tile from top
+            const size_t tile_count = col / GemmFloatKernelWidth16;
+            float* dst_ptr = FpData + (tile_count * CountK + k * BlkLen) * GemmFloatKernelWidth16;
+            if (col % GemmFloatKernelWidth16 >= NCols8) {
+                // for the second half to 16 width tile
+                dst_ptr += NCols8;
+            }
+            const std::byte* b_data_ptr = QuantBData + col * b_data_col_stride_in_bytes + k * blk_data_size_in_bytes;
+
+            __m256 scale_8_ps[NCols8];
+            __m256 zp_8_ps[NCols8];
+            UnrolledLoop<NCols8>([&](size_t col_) {
+                if (col_ < cols) {
+                    float zp = DefaultZeroPoint;
+                    if (QuantBZeroPoint != nullptr) {
+                        zp = static_cast<float>(MlasQNBitZeroPointForBlk<BlkBitWidth>(
+                            QuantBZeroPoint + (col + col_) * zp_col_stride_in_bytes, k
+                        ));
+                    }
+                    scale_8_ps[col_] = _mm256_set1_ps(QuantBScale[(col + col_) * BlockCountK + k]);
+                    zp_8_ps[col_] = _mm256_set1_ps(zp);
+                } else {
+                    scale_8_ps[col_] = _mm256_setzero_ps();
+                    zp_8_ps[col_] = _mm256_setzero_ps();
+                }
+            });
+
+            for (size_t kk = 0; kk < BlkLen; kk += SubBlkLen16) {
+                __m256 weight_lo_8_ps[NCols8];
+                __m256 weight_hi_8_ps[NCols8];
+                UnrolledLoop<NCols8>([&](size_t col_) {
+                    if (col_ < cols) {
+                        __m256 bv_lo, bv_hi;
+                        UnpackQNBitSubBlk16_avx2<BlkBitWidth>(
+                            b_data_ptr + col_ * b_data_col_stride_in_bytes, bv_lo, bv_hi
+                        );
+                        weight_lo_8_ps[col_] = _mm256_mul_ps(_mm256_sub_ps(bv_lo, zp_8_ps[col_]), scale_8_ps[col_]);
+                        weight_hi_8_ps[col_] = _mm256_mul_ps(_mm256_sub_ps(bv_hi, zp_8_ps[col_]), scale_8_ps[col_]);
+                    } else {
+                        weight_lo_8_ps[col_] = _mm256_setzero_ps();
+                        weight_hi_8_ps[col_] = _mm256_setzero_ps();
+                    }
+                });
+
+                Transpose8x8StoreSgemmPanel_avx2(weight_lo_8_ps, dst_ptr);
+                Transpose8x8StoreSgemmPanel_avx2(weight_hi_8_ps, dst_ptr + 8 * GemmFloatKernelWidth16);
+
+                dst_ptr += SubBlkLen16 * GemmFloatKernelWidth16;
+                b_data_ptr += subblk_data_size_in_bytes;
+            }
+        }
+    }
+}
+
+template void SQNBitBlkDequantBForSgemm_CompFp32_avx2<2>(
+    size_t, float*, const std::byte*, const float*, const std::byte*, size_t, size_t, size_t
+);
+template void SQNBitBlkDequantBForSgemm_CompFp32_avx2<3>(
+    size_t, float*, const std::byte*, const float*, const std::byte*, size_t, size_t, size_t
+);
+
 void MLASCALL
 QuantizeARow_CompInt8_avx2(
     size_t BlkLen,
@@ -1453,6 +1737,10 @@ const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx2 = []() {
 
     d.SQ4BitGemmM1Kernel_CompFp32 = SQ4BitGemmM1Kernel_CompFp32_avx2;
     d.SQ4BitBlkDequantBForSgemm_CompFp32 = Q4BitBlkDequantBForSgemm_CompFp32_avx2;
+    d.SQ2BitGemmM1Kernel_CompFp32 = SQNBitGemmM1Kernel_CompFp32_avx2<2>;
+    d.SQ3BitGemmM1Kernel_CompFp32 = SQNBitGemmM1Kernel_CompFp32_avx2<3>;
+    d.SQ2BitBlkDequantBForSgemm_CompFp32 = SQNBitBlkDequantBForSgemm_CompFp32_avx2<2>;
+    d.SQ3BitBlkDequantBForSgemm_CompFp32 = SQNBitBlkDequantBForSgemm_CompFp32_avx2<3>;
 
     d.SQ4BitGemmKernel_BlkSum_CompInt8 = SQ4BitGemmKernel_BlkSum_CompInt8_avx2;
     d.SQ8BitGemmKernel_BlkSum_CompInt8 = SQ8BitGemmKernel_BlkSum_CompInt8_avx2<false>;
@@ -1475,6 +1763,10 @@ const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx2vnni = []() {
 
     d.SQ4BitGemmM1Kernel_CompFp32 = SQ4BitGemmM1Kernel_CompFp32_avx2;
     d.SQ4BitBlkDequantBForSgemm_CompFp32 = Q4BitBlkDequantBForSgemm_CompFp32_avx2;
+    d.SQ2BitGemmM1Kernel_CompFp32 = SQNBitGemmM1Kernel_CompFp32_avx2<2>;
+    d.SQ3BitGemmM1Kernel_CompFp32 = SQNBitGemmM1Kernel_CompFp32_avx2<3>;
+    d.SQ2BitBlkDequantBForSgemm_CompFp32 = SQNBitBlkDequantBForSgemm_CompFp32_avx2<2>;
+    d.SQ3BitBlkDequantBForSgemm_CompFp32 = SQNBitBlkDequantBForSgemm_CompFp32_avx2<3>;
 
     d.SQ4BitGemmKernel_BlkSum_CompInt8 = SQ4BitGemmKernel_BlkSum_CompInt8_avx2vnni;
     d.SQ8BitGemmKernel_BlkSum_CompInt8 = SQ8BitGemmKernel_BlkSum_CompInt8_avx2<true>;
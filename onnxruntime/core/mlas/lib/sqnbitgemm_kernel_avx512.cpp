@@ -486,6 +486,10 @@ const MLAS_QNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512 = []() {
 
     d.SQ4BitGemmM1Kernel_CompFp32 = SQ4BitGemmM1Kernel_CompFp32_avx512;
     d.SQ4BitBlkDequantBForSgemm_CompFp32 = Q4BitBlkDequantBForSgemm_CompFp32_avx2;
+    d.SQ2BitGemmM1Kernel_CompFp32 = SQNBitGemmM1Kernel_CompFp32_avx2<2>;
+    d.SQ3BitGemmM1Kernel_CompFp32 = SQNBitGemmM1Kernel_CompFp32_avx2<3>;
+    d.SQ2BitBlkDequantBForSgemm_CompFp32 = SQNBitBlkDequantBForSgemm_CompFp32_avx2<2>;
+    d.SQ3BitBlkDequantBForSgemm_CompFp32 = SQNBitBlkDequantBForSgemm_CompFp32_avx2<3>;
 
     d.SQ4BitGemmKernel_BlkSum_CompInt8 = SQ4BitGemmKernel_BlkSum_CompInt8_avx512;
     d.SQ8BitGemmKernel_BlkSum_CompInt8 = SQ8BitGemmKernel_BlkSum_CompInt8_avx512;
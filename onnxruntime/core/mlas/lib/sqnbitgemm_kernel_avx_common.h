@@ -518,6 +518,38 @@ Q4BitBlkDequantBForSgemm_CompFp32_avx2(
     const size_t BlockStrideQuantB
 );
 
+//
+// 2-bit and 3-bit SQNBIT_CompFp32 kernels, instantiated in sqnbitgemm_kernel_avx2.cpp.
+//
+
+template <size_t BlkBitWidth>
+void
+SQNBitGemmM1Kernel_CompFp32_avx2(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+);
+
+template <size_t BlkBitWidth>
+void
+SQNBitBlkDequantBForSgemm_CompFp32_avx2(
+    const size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    const size_t CountN,
+    const size_t CountK,
+    const size_t BlockStrideQuantB
+);
+
 size_t
 SQ4BitGemmKernel_CompInt8_avx2(
     size_t BlkLen,
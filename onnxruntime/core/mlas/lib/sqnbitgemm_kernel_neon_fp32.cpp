@@ -20,6 +20,7 @@ Abstract:
 #include <arm_neon.h>
 
 #include <cassert>
+#include <cstring>
 
 #include "qnbitgemm.h"
 #include "qnbitgemm_kernel_neon.h"
@@ -644,4 +645,348 @@ SQ4BitBlkDequantBForSgemm_CompFp32(
     }
 }
 
+//
+// SQNBIT_CompFp32 kernels for 2-bit and 3-bit B.
+// The values of a block are packed into a little endian bit stream, so a sub-block of 16 values
+// takes 4 bytes (2-bit) or 6 bytes (3-bit).
+//
+
+namespace
+{
+
+template <size_t BlkBitWidth>
+MLAS_FORCEINLINE void
+UnpackQNBitSubBlk16(const std::byte* QuantBDataPtr, float32x4_t (&bv)[4])
+{
+    static_assert(BlkBitWidth == 2 || BlkBitWidth == 3);
+
+    // negative shift counts shift right
+    constexpr int32_t shift[8] = {
+        -0 * int32_t(BlkBitWidth), -1 * int32_t(BlkBitWidth), -2 * int32_t(BlkBitWidth), -3 * int32_t(BlkBitWidth),
+        -4 * int32_t(BlkBitWidth), -5 * int32_t(BlkBitWidth), -6 * int32_t(BlkBitWidth), -7 * int32_t(BlkBitWidth),
+    };
+    const int32x4_t shift_lo = vld1q_s32(shift);
+    const int32x4_t shift_hi = vld1q_s32(shift + 4);
+    const uint32x4_t mask = vdupq_n_u32((1u << BlkBitWidth) - 1);
+
+    // v0 .. v7 in the low 8 * BlkBitWidth bits of bits_lo and v8 .. v15 in those of bits_hi
+    uint32_t bits_lo, bits_hi;
+    if constexpr (BlkBitWidth == 2) {
+        uint32_t bits;
+        memcpy(&bits, QuantBDataPtr, sizeof(bits));
+        bits_lo = bits;
+        bits_hi = bits >> 16;
+    } else {
+        uint64_t bits = 0;
+        memcpy(&bits, QuantBDataPtr, 6);
+        bits_lo = static_cast<uint32_t>(bits);
+        bits_hi = static_cast<uint32_t>(bits >> 24);
+    }
+
+    const uint32x4_t bits_lo_v = vdupq_n_u32(bits_lo);
+    const uint32x4_t bits_hi_v = vdupq_n_u32(bits_hi);
+    bv[0] = vcvtq_f32_u32(vandq_u32(vshlq_u32(bits_lo_v, shift_lo), mask));
+    bv[1] = vcvtq_f32_u32(vandq_u32(vshlq_u32(bits_lo_v, shift_hi), mask));
+    bv[2] = vcvtq_f32_u32(vandq_u32(vshlq_u32(bits_hi_v, shift_lo), mask));
+    bv[3] = vcvtq_f32_u32(vandq_u32(vshlq_u32(bits_hi_v, shift_hi), mask));
+}
+
+template <size_t BlkBitWidth, size_t NCols, bool HasZeroPoint>
+MLAS_FORCEINLINE void
+ComputeDotProducts_BlkBitWidth2Or3_CompFp32(
+    size_t BlkLen,
+    const float* ARowPtr,
+    const std::byte* QuantBDataColPtr,
+    const float* QuantBScaleColPtr,
+    const std::byte* QuantBZeroPointColPtr,
+    float* SumPtr,
+    size_t CountK,
+    size_t StrideQuantBData,
+    size_t StrideQuantBScale,
+    size_t StrideQuantBZeroPoint,
+    const float* BiasPtr
+)
+{
+    constexpr size_t SubBlkLen = 16;
+    constexpr float DefaultZeroPoint = float(1 << (BlkBitWidth - 1));
+
+    static_assert(NCols == 1 || NCols == 4, "NCols must be 1 or 4");
+
+    assert(BlkLen >= SubBlkLen && BlkLen % SubBlkLen == 0);
+
+    float32x4_t acc[NCols]{};
+
+    const std::byte* QuantBData = QuantBDataColPtr;
+
+    for (size_t k = 0, k_blk_idx = 0; k < CountK; k += BlkLen, ++k_blk_idx) {
+        const size_t k_blk_len = std::min(CountK - k, BlkLen);
+
+        float32x4_t blk_acc[NCols]{};
+        float32x4_t a_sum = vdupq_n_f32(0.0f);
+
+        for (size_t k_idx_in_blk = 0; k_idx_in_blk < k_blk_len; k_idx_in_blk += SubBlkLen) {
+            // load `SubBlkLen` elements from A, padded with 0's if there aren't enough
+            const size_t k_subblk_len = std::min(k_blk_len - k_idx_in_blk, SubBlkLen);
+            float32x4_t av[4]{};
+            LoadFloatData<SubBlkLen>(ARowPtr + k + k_idx_in_blk, k_subblk_len, av);
+            a_sum = vaddq_f32(a_sum, vaddq_f32(vaddq_f32(av[0], av[1]), vaddq_f32(av[2], av[3])));
+
+            const size_t b_data_block_offset = k_idx_in_blk * BlkBitWidth / 8;
+            UnrolledLoop<NCols>([&](size_t i) {
+                float32x4_t bv[4];
+                UnpackQNBitSubBlk16<BlkBitWidth>(QuantBData + i * StrideQuantBData + b_data_block_offset, bv);
+                UnrolledLoop<4>([&](size_t j) { blk_acc[i] = vfmaq_f32(blk_acc[i], av[j], bv[j]); });
+            });
+        }
+
+        // sum((b - zp) * a) * scale = (sum(b * a) - zp * sum(a)) * scale
+        UnrolledLoop<NCols>([&](size_t i) {
+            float zp = DefaultZeroPoint;
+            if constexpr (HasZeroPoint) {
+                zp = static_cast<float>(
+                    MlasQNBitZeroPointForBlk<BlkBitWidth>(QuantBZeroPointColPtr + i * StrideQuantBZeroPoint, k_blk_idx)
+                );
+            }
+            const float32x4_t dot = vfmsq_f32(blk_acc[i], a_sum, vdupq_n_f32(zp));
+            acc[i] = vfmaq_f32(acc[i], dot, vdupq_n_f32(QuantBScaleColPtr[i * StrideQuantBScale + k_blk_idx]));
+        });
+
+        QuantBData += MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    }
+
+    if constexpr (NCols == 4) {
+        float32x4_t sum = FoldAccumulators(acc[0], acc[1], acc[2], acc[3]);
+
+        if (BiasPtr != nullptr) {
+            sum = vaddq_f32(sum, vld1q_f32(BiasPtr));
+        }
+
+        vst1q_f32(SumPtr, sum);
+    } else {
+        for (size_t i = 0; i < NCols; ++i) {
+            SumPtr[i] = vaddvq_f32(acc[i]);
+            if (BiasPtr != nullptr) {
+                SumPtr[i] += BiasPtr[i];
+            }
+        }
+    }
+}
+
+template <size_t BlkBitWidth, bool HasZeroPoint>
+void
+SQ2Or3BitGemmM1Kernel_CompFp32_Impl(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    const float* Bias
+)
+{
+    constexpr size_t NCols = 4;
+
+    const size_t StrideQuantBData = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBScale = BlockCountK;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    size_t n = 0;
+    for (; n + NCols <= CountN; n += NCols) {
+        ComputeDotProducts_BlkBitWidth2Or3_CompFp32<BlkBitWidth, NCols, HasZeroPoint>(
+            BlkLen,
+            A, QuantBData + n * StrideQuantBData, QuantBScale + n * StrideQuantBScale,
+            HasZeroPoint ? QuantBZeroPoint + n * StrideQuantBZeroPoint : nullptr, C + n, CountK,
+            StrideQuantBData, StrideQuantBScale, StrideQuantBZeroPoint,
+            Bias != nullptr ? Bias + n : nullptr
+        );
+    }
+
+    // left over columns less than `NCols`
+    for (; n < CountN; ++n) {
+        ComputeDotProducts_BlkBitWidth2Or3_CompFp32<BlkBitWidth, 1, HasZeroPoint>(
+            BlkLen,
+            A, QuantBData + n * StrideQuantBData, QuantBScale + n * StrideQuantBScale,
+            HasZeroPoint ? QuantBZeroPoint + n * StrideQuantBZeroPoint : nullptr, C + n, CountK,
+            StrideQuantBData, StrideQuantBScale, StrideQuantBZeroPoint,
+            Bias != nullptr ? Bias + n : nullptr
+        );
+    }
+}
+
+// Block dequantize a 16 x NCols section of 2-bit or 3-bit B from column major source to row major destination.
+template <size_t BlkBitWidth, size_t NCols>
+MLAS_FORCEINLINE void
+Q2Or3BitBlkDequantB_16xNCols(
+    const std::byte* QuantBDataPtr,
+    size_t StrideQuantBData,
+    const float* QuantBColScalePtr,  // pointer to NCols scales of adjacent columns
+    const float* QuantBColZeroPointPtr,  // pointer to NCols zero points of adjacent columns
+    float* DstColPtr
+)
+{
+    float32x4_t bv[NCols][4];
+    UnrolledLoop<NCols>([&](size_t i) {
+        UnpackQNBitSubBlk16<BlkBitWidth>(QuantBDataPtr + i * StrideQuantBData, bv[i]);
+
+        const float32x4_t zp_v = vdupq_n_f32(QuantBColZeroPointPtr[i]);
+        const float32x4_t scale_v = vdupq_n_f32(QuantBColScalePtr[i]);
+        UnrolledLoop<4>([&](size_t j) { bv[i][j] = vmulq_f32(vsubq_f32(bv[i][j], zp_v), scale_v); });
+    });
+
+    // write, transposed, 16 x NCols values
+    if constexpr (NCols == 4) {
+        UnrolledLoop<4>([&](size_t j) {
+            Transpose4x4(bv[0][j], bv[1][j], bv[2][j], bv[3][j]);
+
+            vst1q_f32(&DstColPtr[(j * 4 + 0) * 16], bv[0][j]);
+            vst1q_f32(&DstColPtr[(j * 4 + 1) * 16], bv[1][j]);
+            vst1q_f32(&DstColPtr[(j * 4 + 2) * 16], bv[2][j]);
+            vst1q_f32(&DstColPtr[(j * 4 + 3) * 16], bv[3][j]);
+        });
+    } else {
+        UnrolledLoop<NCols>([&](size_t i) {
+            UnrolledLoop<4>([&](size_t j) {
+                DstColPtr[(j * 4 + 0) * 16 + i] = vgetq_lane_f32(bv[i][j], 0);
+                DstColPtr[(j * 4 + 1) * 16 + i] = vgetq_lane_f32(bv[i][j], 1);
+                DstColPtr[(j * 4 + 2) * 16 + i] = vgetq_lane_f32(bv[i][j], 2);
+                DstColPtr[(j * 4 + 3) * 16 + i] = vgetq_lane_f32(bv[i][j], 3);
+            });
+        });
+    }
+}
+
+template <size_t BlkBitWidth>
+void
+Q2Or3BitBlkDequantBForSgemm_CompFp32_Impl(
+    size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK
+)
+{
+    constexpr float DefaultZeroPoint = float(1 << (BlkBitWidth - 1));
+
+    float* Dst = FpData;
+
+    const size_t StrideQuantBData = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    //
+    // Proceed down 16 column-wide regions of B. Dequantize and write output 16 x 16 elements at a time.
+    //
+
+    // scales and zero points of blocks from 16 adjacent columns
+    float scale[16];
+    float zero_point[16];
+
+    for (size_t n = 0; n < CountN; n += 16) {
+        const size_t n_cols = std::min(CountN - n, size_t{16});
+
+        for (size_t k = 0, k_blk_idx = 0; k < CountK; k += BlkLen, ++k_blk_idx) {
+            for (size_t nn = 0; nn < n_cols; ++nn) {
+                scale[nn] = QuantBScale[(n + nn) * BlockCountK + k_blk_idx];
+                zero_point[nn] = (QuantBZeroPoint == nullptr)
+                                     ? DefaultZeroPoint
+                                     : static_cast<float>(MlasQNBitZeroPointForBlk<BlkBitWidth>(
+                                           QuantBZeroPoint + (n + nn) * StrideQuantBZeroPoint, k_blk_idx
+                                       ));
+            }
+
+            const size_t kklen = std::min(CountK - k, BlkLen);
+
+            for (size_t kk = 0; kk < kklen; kk += 16) {
+                const std::byte* QuantBDataPtr = QuantBData + n * StrideQuantBData + (k + kk) * BlkBitWidth / 8;
+
+                if (n_cols < 16) {
+                    // zero out the 16x16 block in Dst first to ensure zero padding
+                    const float32x4_t zero_v = vdupq_n_f32(0.0f);
+                    UnrolledLoop<16 * 4>([&](size_t i) {
+                        vst1q_f32(Dst + 4 * i, zero_v);
+                    });
+                }
+
+                size_t nn = 0;
+                for (; nn + 4 <= n_cols; nn += 4) {
+                    Q2Or3BitBlkDequantB_16xNCols<BlkBitWidth, 4>(
+                        QuantBDataPtr + nn * StrideQuantBData, StrideQuantBData, &scale[nn], &zero_point[nn], Dst + nn
+                    );
+                }
+                for (; nn < n_cols; ++nn) {
+                    Q2Or3BitBlkDequantB_16xNCols<BlkBitWidth, 1>(
+                        QuantBDataPtr + nn * StrideQuantBData, StrideQuantBData, &scale[nn], &zero_point[nn], Dst + nn
+                    );
+                }
+
+                Dst += 16 * std::min(kklen - kk, size_t{16});
+            }
+        }
+    }
+}
+
+}  // namespace
+
+template <size_t BlkBitWidth>
+void
+SQ2Or3BitGemmM1Kernel_CompFp32(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    const float* Bias
+)
+{
+    if (QuantBZeroPoint != nullptr) {
+        SQ2Or3BitGemmM1Kernel_CompFp32_Impl<BlkBitWidth, true>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockCountK, Bias
+        );
+    } else {
+        SQ2Or3BitGemmM1Kernel_CompFp32_Impl<BlkBitWidth, false>(
+            BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockCountK, Bias
+        );
+    }
+}
+
+template <size_t BlkBitWidth>
+void
+SQ2Or3BitBlkDequantBForSgemm_CompFp32(
+    size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK
+)
+{
+    Q2Or3BitBlkDequantBForSgemm_CompFp32_Impl<BlkBitWidth>(
+        BlkLen, FpData, QuantBData, QuantBScale, QuantBZeroPoint, CountN, CountK, BlockCountK
+    );
+}
+
+template void SQ2Or3BitGemmM1Kernel_CompFp32<2>(
+    size_t, const float*, const std::byte*, const float*, const std::byte*, float*, size_t, size_t, size_t, const float*
+);
+template void SQ2Or3BitGemmM1Kernel_CompFp32<3>(
+    size_t, const float*, const std::byte*, const float*, const std::byte*, float*, size_t, size_t, size_t, const float*
+);
+template void SQ2Or3BitBlkDequantBForSgemm_CompFp32<2>(
+    size_t, float*, const std::byte*, const float*, const std::byte*, size_t, size_t, size_t
+);
+template void SQ2Or3BitBlkDequantBForSgemm_CompFp32<3>(
+    size_t, float*, const std::byte*, const float*, const std::byte*, size_t, size_t, size_t
+);
+
 }  // namespace sqnbitgemm_neon
@@ -0,0 +1,245 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_fusion.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+
+// Largest number of nodes fused into a FusedElementwise node.
+constexpr size_t kMaxFusedNodes = 32;
+
+bool IsFloatTensor(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+bool IsBinaryElementwiseOp(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7, 13, 14});
+}
+
+bool IsUnaryElementwiseOp(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gelu", {1}, kMSDomain);
+}
+
+bool IsFusibleNode(const Node& node, const InlinedHashSet<std::string_view>& compatible_providers) {
+  const bool is_supported_op = IsBinaryElementwiseOp(node) || IsUnaryElementwiseOp(node) ||
+                               graph_utils::IsSupportedOptypeVersionAndDomain(node, "BiasGelu", {1}, kMSDomain) ||
+                               graph_utils::IsSupportedOptypeVersionAndDomain(node, "QuickGelu", {1}, kMSDomain);
+  if (!is_supported_op || !graph_utils::IsSupportedProvider(node, compatible_providers) ||
+      node.OutputDefs().size() != 1 || !IsFloatTensor(*node.OutputDefs()[0])) {
+    return false;
+  }
+
+  return std::all_of(node.InputDefs().begin(), node.InputDefs().end(),
+                     [](const NodeArg* input) { return input->Exists() && IsFloatTensor(*input); });
+}
+
+}  // namespace
+
+Status ElementwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                    const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  InlinedHashMap<NodeIndex, size_t> topological_position;
+  for (size_t i = 0; i < node_topology_list.size(); ++i) {
+    topological_position[node_topology_list[i]] = i;
+  }
+
+  // Visit the nodes in reverse topological order, so that each group of fused nodes grows from the node that
+  // produces its output towards its inputs.
+  for (auto it = node_topology_list.rbegin(); it != node_topology_list.rend(); ++it) {
+    auto* p_node = graph.GetNode(*it);
+    if (p_node == nullptr)
+      continue;  // node was removed as part of an earlier fusion
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!IsFusibleNode(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // Add the producers of the inputs whose consumers are all in the group. A producer that is rejected because
+    // one of its consumers is not in the group yet is visited again when that consumer is added.
+    InlinedVector<Node*> group{&node};
+    InlinedHashSet<NodeIndex> group_indices{node.Index()};
+    for (size_t i = 0; i < group.size() && group.size() < kMaxFusedNodes; ++i) {
+      for (auto edge = group[i]->InputEdgesBegin(); edge != group[i]->InputEdgesEnd(); ++edge) {
+        const Node& producer = edge->GetNode();
+        if (group_indices.count(producer.Index()) > 0 ||
+            !IsFusibleNode(producer, GetCompatibleExecutionProviders()) ||
+            graph.NodeProducesGraphOutput(producer)) {
+          continue;
+        }
+
+        const bool all_consumers_in_group =
+            std::all_of(producer.OutputNodesBegin(), producer.OutputNodesEnd(),
+                        [&](const Node& consumer) { return group_indices.count(consumer.Index()) > 0; });
+        if (all_consumers_in_group && group.size() < kMaxFusedNodes) {
+          group.push_back(graph.GetNode(producer.Index()));
+          group_indices.insert(producer.Index());
+        }
+      }
+    }
+
+    if (group.size() < 2) {
+      continue;
+    }
+
+    // Every node of the group feeds the first one, so it is the last in topological order.
+    std::sort(group.begin(), group.end(), [&](const Node* a, const Node* b) {
+      return topological_position.at(a->Index()) < topological_position.at(b->Index());
+    });
+
+    const auto is_computed_in_group = [&](const NodeArg& arg) {
+      const Node* producer = graph.GetProducerNode(arg.Name());
+      return producer != nullptr && group_indices.count(producer->Index()) > 0;
+    };
+
+    // The values read by the group, in the order of their first use.
+    InlinedVector<const NodeArg*> external_args;
+    for (const Node* group_node : group) {
+      for (const NodeArg* input : group_node->InputDefs()) {
+        if (!is_computed_in_group(*input) &&
+            std::find(external_args.begin(), external_args.end(), input) == external_args.end()) {
+          external_args.push_back(input);
+        }
+      }
+    }
+
+    // A scalar constant of rank 1 can only become an attribute if another input has at least the same rank, as it
+    // would otherwise determine the rank of the output.
+    int max_input_rank = 0;
+    InlinedHashMap<const NodeArg*, float> scalar_constants;
+    for (const NodeArg* arg : external_args) {
+      float value;
+      if (optimizer_utils::GetScalarInitializerValue(graph, *arg, value, true)) {
+        scalar_constants[arg] = value;
+      } else if (arg->Shape() != nullptr) {
+        max_input_rank = std::max(max_input_rank, arg->Shape()->dim_size());
+      }
+    }
+
+    InlinedVector<NodeArg*> inputs;
+    std::vector<float> constants;
+    InlinedVector<const NodeArg*> constant_args;
+    for (const NodeArg* arg : external_args) {
+      auto constant = scalar_constants.find(arg);
+      if (constant != scalar_constants.end() && arg->Shape()->dim_size() <= max_input_rank) {
+        constants.push_back(constant->second);
+        constant_args.push_back(arg);
+      } else {
+        inputs.push_back(graph.GetNodeArg(arg->Name()));
+      }
+    }
+
+    // A group that only reads constants would have no inputs, which its schema doesn't allow. Constant folding
+    // computes such groups when it is enabled.
+    if (inputs.empty()) {
+      continue;
+    }
+
+    // QuickGelu multiplies its input by the alpha attribute.
+    InlinedHashMap<NodeIndex, int64_t> quick_gelu_alpha;
+    for (const Node* group_node : group) {
+      if (group_node->OpType() == "QuickGelu") {
+        const auto* alpha_attr = graph_utils::GetNodeAttribute(*group_node, "alpha");
+        quick_gelu_alpha[group_node->Index()] = static_cast<int64_t>(constants.size());
+        constants.push_back(alpha_attr != nullptr ? alpha_attr->f() : 1.702f);
+      }
+    }
+
+    // Operands refer to the inputs, then to the constants, then to the results of the instructions.
+    const auto num_inputs = static_cast<int64_t>(inputs.size());
+    const auto num_leaves = num_inputs + static_cast<int64_t>(constants.size());
+    InlinedHashMap<const NodeArg*, int64_t> value_index;
+    for (int64_t i = 0; i < num_inputs; ++i) {
+      value_index[inputs[i]] = i;
+    }
+    for (size_t i = 0; i < constant_args.size(); ++i) {
+      value_index[constant_args[i]] = num_inputs + static_cast<int64_t>(i);
+    }
+
+    std::vector<std::string> ops;
+    std::vector<int64_t> operands;
+    const auto emit = [&](const std::string& op, int64_t operand0, int64_t operand1) {
+      ops.push_back(op);
+      operands.push_back(operand0);
+      operands.push_back(operand1);
+      return num_leaves + static_cast<int64_t>(ops.size()) - 1;
+    };
+
+    for (const Node* group_node : group) {
+      const auto operand = [&](size_t i) { return value_index.at(group_node->InputDefs()[i]); };
+
+      int64_t result;
+      if (group_node->OpType() == "QuickGelu") {
+        // x * Sigmoid(alpha * x), in the order that the QuickGelu kernel computes it.
+        const int64_t x = operand(0);
+        const int64_t alpha = num_inputs + quick_gelu_alpha.at(group_node->Index());
+        result = emit("Mul", x, emit("Sigmoid", emit("Mul", x, alpha), -1));
+      } else if (group_node->OpType() == "BiasGelu") {
+        result = emit("Gelu", emit("Add", operand(0), operand(1)), -1);
+      } else if (IsBinaryElementwiseOp(*group_node)) {
+        result = emit(group_node->OpType(), operand(0), operand(1));
+      } else {
+        result = emit(group_node->OpType(), operand(0), -1);
+      }
+      value_index[group_node->OutputDefs()[0]] = result;
+    }
+
+    Node& root_node = *group.back();
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName(root_node.Name() + "/ElementwiseFusion/"),
+                                     "FusedElementwise", "fused elementwise ops", inputs,
+                                     std::array{root_node.MutableOutputDefs()[0]}, nullptr, kMSDomain);
+    fused_node.AddAttribute("ops", ops);
+    fused_node.AddAttribute("operands", operands);
+    if (!constants.empty()) {
+      fused_node.AddAttribute("constants", constants);
+    }
+    fused_node.SetExecutionProviderType(root_node.GetExecutionProviderType());
+
+    InlinedVector<std::reference_wrapper<Node>> nodes_to_fuse;
+    for (Node* group_node : group) {
+      nodes_to_fuse.emplace_back(*group_node);
+    }
+    graph_utils::FinalizeNodeFusion(graph, nodes_to_fuse, fused_node);
+
+    // FinalizeNodeFusion only moves the input edges of the first node, so connect the remaining inputs.
+    for (int i = 0; i < static_cast<int>(inputs.size()); ++i) {
+      const Node* producer = graph.GetProducerNode(inputs[i]->Name());
+      if (producer != nullptr) {
+        graph.AddEdge(producer->Index(), fused_node.Index(),
+                      optimizer_utils::IndexOfNodeOutput(*producer, *inputs[i]), i);
+      }
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
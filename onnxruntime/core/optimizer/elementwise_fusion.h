@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ElementwiseFusion
+
+Rewrite connected elementwise nodes (Add, Sub, Mul, Div, Neg, Relu, Sigmoid, Tanh, Erf, Exp, Sqrt, and the Gelu,
+BiasGelu and QuickGelu contrib ops) to a single FusedElementwise node, which evaluates the whole expression on
+cache-sized tiles instead of running each node over the full tensors.
+
+A node is fused with the nodes that consume its output only if all of them are fused, so the intermediate results
+are never needed outside of the fused node. Scalar constant initializers become constants of the fused node.
+*/
+class ElementwiseFusion : public GraphTransformer {
+ public:
+  ElementwiseFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -36,6 +36,7 @@
 #include "core/optimizer/double_qdq_pairs_remover.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_fusion.h"
 #include "core/optimizer/embed_layer_norm_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
@@ -435,6 +436,13 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       // PR #6351 implemented similar fusion-pattern for CUDA only, and can only fuse conv-add-relu,
       // while we can fuse more activation.
       transformers.emplace_back(std::make_unique<ConvAddActivationFusion>(cpu_ep));
+
+      // ElementwiseFusion runs last so that the fusions above, which replace elementwise nodes with cheaper
+      // epilogues of Conv, Gemm and MatMul, take priority. Only the remaining chains of elementwise nodes are fused.
+      // It needs to be manually enabled.
+      if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableElementwiseFusion, "0") == "1") {
+        transformers.emplace_back(std::make_unique<ElementwiseFusion>(cpu_ep));
+      }
 #endif
 
     } break;
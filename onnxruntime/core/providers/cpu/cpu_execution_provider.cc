@@ -28,7 +28,7 @@ struct KernelRegistryAndStatus {
 
 namespace onnxruntime {
 CPUExecutionProvider::CPUExecutionProvider(const CPUExecutionProviderInfo& info)
-    : IExecutionProvider{onnxruntime::kCpuExecutionProvider}, info_{info} {}
+    : IExecutionProvider{onnxruntime::kCpuExecutionProvider}, info_{info}, tuning_context_(this, &info_.tunable_op) {}
 
 std::vector<AllocatorPtr> CPUExecutionProvider::CreatePreferredAllocators() {
   const bool create_arena = DoesCpuAllocatorSupportArenaUsage() ? info_.create_arena : false;
@@ -3652,4 +3652,8 @@ std::unique_ptr<IDataTransfer> CPUExecutionProvider::GetDataTransfer() const {
   return std::make_unique<CPUDataTransfer>();
 }
 
+ITuningContext* CPUExecutionProvider::GetTuningContext() const {
+  return const_cast<cpu::tunable::CpuTuningContext*>(&tuning_context_);
+}
+
 }  // namespace onnxruntime
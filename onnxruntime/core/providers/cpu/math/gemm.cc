@@ -6,6 +6,7 @@
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
 #include "core/providers/cpu/math/gemm_matmul_common.h"
+#include "core/providers/cpu/tunable/sgemm.h"
 #include "core/util/math_cpuonly.h"
 #include "gemm_helper.h"
 #include "core/mlas/inc/mlas.h"
@@ -418,30 +419,67 @@ Status Gemm<float>::Compute(OpKernelContext* context) const {
   const float* c_data = C != nullptr ? C->Data<float>() : nullptr;
   const TensorShape* c_shape = C != nullptr ? &C->Shape() : nullptr;
 
-  if (B) {
-    ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, A->Data<float>(), B->Data<float>(), beta_,
-                c_data, c_shape, y_data, thread_pool);
-  } else {
+  if (K == 0) {
     GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
-    if (K > 0) {
-      MlasGemm(
-          trans_A_,
-          static_cast<size_t>(M),
-          static_cast<size_t>(N),
-          static_cast<size_t>(K),
-          alpha_,
-          A->Data<float>(),
-          static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K),
-          packed_b_.get(),
-          c_data != nullptr ? beta_ : 0.0f,
-          y_data,
-          static_cast<size_t>(N),
-          thread_pool);
-    } else if (beta_ == 0 || c_data == nullptr) {
+    if (beta_ == 0 || c_data == nullptr) {
       EigenMatrixMapRowMajor<float> dest(y_data, narrow<Eigen::Index>(M), narrow<Eigen::Index>(N));
       dest.setZero();
     }
+    if (mlas_activation_) {
+      MlasActivation(&*mlas_activation_, y_data, nullptr, static_cast<size_t>(M), static_cast<size_t>(N),
+                     static_cast<size_t>(N));
+    }
+    ComputeActivation(y_data, SafeInt<size_t>(M) * N, thread_pool);
+    return Status::OK();
+  }
+
+  // The gemm epilogue adds a bias row or a C of the output shape and applies the fused activation while the
+  // output block is still in the cache. Other shapes of C are broadcast into Y before the gemm.
+  MLAS_SGEMM_EPILOGUE epilogue;
+  bool use_epilogue = false;
+  float beta = c_data != nullptr ? beta_ : 0.0f;
+
+  if (c_data != nullptr && beta_ == 1.0f) {
+    const size_t c_rank = c_shape->NumDimensions();
+    if (c_shape->Size() == N && (c_rank == 1 || (c_rank == 2 && (*c_shape)[0] == 1))) {
+      epilogue.Bias = c_data;
+    } else if (c_rank == 2 && (*c_shape)[0] == M && (*c_shape)[1] == N) {
+      epilogue.Residual = c_data;
+      epilogue.ldr = static_cast<size_t>(N);
+    }
+  }
+
+  if (epilogue.Bias != nullptr || epilogue.Residual != nullptr) {
+    use_epilogue = true;
+    beta = 0.0f;
+  } else {
+    GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
+  }
+
+  if (mlas_activation_) {
+    epilogue.Activation = &*mlas_activation_;
+    use_epilogue = true;
+  }
+
+  MLAS_SGEMM_DATA_PARAMS data;
+  data.A = A->Data<float>();
+  data.lda = static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K);
+  if (B) {
+    data.B = B->Data<float>();
+    data.ldb = static_cast<size_t>(trans_B_ != CblasNoTrans ? K : N);
+  } else {
+    data.B = static_cast<const float*>(packed_b_.get());
+    data.BIsPacked = true;
   }
+  data.C = y_data;
+  data.ldc = static_cast<size_t>(N);
+  data.alpha = alpha_;
+  data.beta = beta;
+  data.Epilogue = use_epilogue ? &epilogue : nullptr;
+
+  ORT_RETURN_IF_ERROR(cpu::tunable::SgemmBatch(cpu::tunable::GetTuningContext(Info()), trans_A_, trans_B_,
+                                               static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K),
+                                               &data, 1, thread_pool));
 
   ComputeActivation(y_data, SafeInt<size_t>(M) * N, thread_pool);
 
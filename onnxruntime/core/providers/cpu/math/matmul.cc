@@ -4,6 +4,7 @@
 #include "core/providers/cpu/math/matmul.h"
 #include "core/providers/cpu/math/gemm_matmul_common.h"
 #include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/cpu/tunable/sgemm.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
@@ -172,6 +173,44 @@ bool GemmPackBBfloat16(AllocatorPtr& alloc,
 }
 #endif
 
+// Minimum fraction of all-zero 16x16 blocks in a constant B before the block
+// sparse packed format is used instead of the dense packed format.
+static constexpr float kBlockSparseThreshold = 0.5f;
+
+static bool GemmPackBBlockSparseFp32(AllocatorPtr& alloc,
+                                     const Tensor& tensor_b,
+                                     bool trans_b,
+                                     IAllocatorUniquePtr<void>& packed_b,
+                                     size_t& packed_b_size,
+                                     TensorShape& b_shape) {
+  if (tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+
+  const size_t K = trans_b ? static_cast<size_t>(tensor_b.Shape()[1]) : static_cast<size_t>(tensor_b.Shape()[0]);
+  const size_t N = trans_b ? static_cast<size_t>(tensor_b.Shape()[0]) : static_cast<size_t>(tensor_b.Shape()[1]);
+  const CBLAS_TRANSPOSE trans = trans_b ? CblasTrans : CblasNoTrans;
+  const float* b_data = tensor_b.Data<float>();
+
+  if (MlasGemmBlockSparsity(trans, N, K, b_data, trans_b ? K : N) < kBlockSparseThreshold) {
+    return false;
+  }
+
+  packed_b_size = MlasGemmBlockSparsePackBSize(trans, N, K, b_data, trans_b ? K : N);
+  if (packed_b_size == 0) {
+    return false;
+  }
+
+  b_shape = tensor_b.Shape();
+
+  packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
+  auto* packed_b_data = packed_b.get();
+
+  memset(packed_b_data, 0, packed_b_size);
+  MlasGemmBlockSparsePackB(trans, N, K, b_data, trans_b ? K : N, packed_b_data);
+  return true;
+}
+
 Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ AllocatorPtr alloc,
                               /*out*/ bool& is_packed,
                               /*out*/ PrePackedWeights* prepacked_weights) {
@@ -195,7 +234,10 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
     } else
 #endif
     {
-      is_packed = GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      packed_b_is_block_sparse_ =
+          GemmPackBBlockSparseFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      is_packed = packed_b_is_block_sparse_ ||
+                  GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
     }
 
     bool share_prepacked_weights = (prepacked_weights != nullptr);
@@ -279,18 +321,21 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   {
     std::vector<MLAS_SGEMM_DATA_PARAMS> data(max_len);
     for (size_t i = 0; i < max_len; i++) {
-      data[i].BIsPacked = bool(packed_b_);
+      data[i].BIsPacked = bool(packed_b_) && !packed_b_is_block_sparse_;
+      data[i].BIsBlockSparse = bool(packed_b_) && packed_b_is_block_sparse_;
       data[i].A = a_data + helper.LeftOffsets()[i];
       data[i].lda = lda;
-      data[i].B = data[i].BIsPacked ? (float*)packed_b_.get() : b_data + helper.RightOffsets()[i];
+      data[i].B = packed_b_ ? (float*)packed_b_.get() : b_data + helper.RightOffsets()[i];
       data[i].ldb = ldb;
       data[i].C = y_data + helper.OutputOffsets()[i];
       data[i].ldc = N;
       data[i].alpha = alpha_attr_;
       data[i].beta = 0.0f;
     }
-    MlasGemmBatch(trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
-                  M, N, K, data.data(), max_len, thread_pool);
+    ORT_RETURN_IF_ERROR(cpu::tunable::SgemmBatch(cpu::tunable::GetTuningContext(Info()),
+                                                 trans_a ? CblasTrans : CblasNoTrans,
+                                                 trans_b ? CblasTrans : CblasNoTrans,
+                                                 M, N, K, data.data(), max_len, thread_pool));
   }
   return Status::OK();
 }
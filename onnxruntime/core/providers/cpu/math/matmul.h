@@ -48,6 +48,8 @@ class MatMul<float> final : public OpKernel {
  private:
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
+  // Whether packed_b_ holds the block sparse format of a pruned weight
+  bool packed_b_is_block_sparse_{false};
 
   // For FusedMatMul contrib ops
   float alpha_attr_;
@@ -38,8 +38,8 @@ class LabelEncoder final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  std::unordered_map<std::string, int64_t> string_to_int_map_;
-  std::unordered_map<int64_t, std::string> int_to_string_map_;
+  InlinedHashMap<std::string, int64_t> string_to_int_map_;
+  InlinedHashMap<int64_t, std::string> int_to_string_map_;
 
   std::string default_string_;
   int64_t default_int_;
@@ -74,14 +74,10 @@ class LabelEncoder_2 final : public OpKernel {
 
     auto input = X->template DataAsSpan<TKey>();
     auto output = Y->template MutableDataAsSpan<TValue>();
-    auto input_iter = input.begin();
-    auto output_iter = output.begin();
-    while (input_iter != input.end()) {
-      const auto found = map_.find(*input_iter);
-      *output_iter = found == map_.end() ? default_value_ : found->second;
-      ++output_iter;
-      ++input_iter;
-    }
+    BatchLookup(context->GetOperatorThreadPool(), input, output, [this](const TKey& key) -> const TValue& {
+      const auto found = map_.find(key);
+      return found == map_.end() ? default_value_ : found->second;
+    });
     return Status::OK();
   }
 
@@ -213,14 +209,10 @@ class LabelEncoder_4 final : public OpKernel {
 
     auto input = X->template DataAsSpan<TKey>();
     auto output = Y->template MutableDataAsSpan<TValue>();
-    auto input_iter = input.begin();
-    auto output_iter = output.begin();
-    while (input_iter != input.end()) {
-      const auto found = map_.find(*input_iter);
-      *output_iter = found == map_.end() ? default_value_ : found->second;
-      ++output_iter;
-      ++input_iter;
-    }
+    BatchLookup(context->GetOperatorThreadPool(), input, output, [this](const TKey& key) -> const TValue& {
+      const auto found = map_.find(key);
+      return found == map_.end() ? default_value_ : found->second;
+    });
     return Status::OK();
   }
 
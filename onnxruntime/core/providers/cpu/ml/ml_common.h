@@ -389,6 +389,40 @@ static void write_scores(InlinedVector<T>& scores, POST_EVAL_TRANSFORM post_tran
   write_scores(scores, post_transform, out_p, add_second_class);
 }
 
+// Estimated cost of looking up one key of `input` in a hash map and writing the mapped value. For string keys the
+// hashing and comparison cost grows with the key length, which is estimated from a sample of the input.
+template <typename TKey, typename TValue>
+TensorOpCost HashLookupCost(gsl::span<const TKey> input) {
+  constexpr double kProbeCycles = 40.0;  // hash mixing, control byte match and (likely) cache miss on the slot
+  double key_bytes = sizeof(TKey);
+  if constexpr (std::is_same_v<TKey, std::string>) {
+    const size_t sample_size = std::min<size_t>(input.size(), 64);
+    size_t sample_bytes = 0;
+    for (size_t i = 0; i < sample_size; ++i) {
+      sample_bytes += input[i].size();
+    }
+    key_bytes += sample_size > 0 ? static_cast<double>(sample_bytes) / sample_size : 0.0;
+  }
+  return TensorOpCost{key_bytes, static_cast<double>(sizeof(TValue)), kProbeCycles + key_bytes};
+}
+
+// Writes lookup(input[i]) to output[i] for every element. Lookups are independent so the batch is split across the
+// thread pool.
+template <typename TKey, typename TValue, typename TLookup>
+void BatchLookup(concurrency::ThreadPool* threadpool, gsl::span<const TKey> input, gsl::span<TValue> output,
+                 const TLookup& lookup) {
+  ORT_ENFORCE(input.size() == output.size());
+  const TKey* input_data = input.data();
+  TValue* output_data = output.data();
+  concurrency::ThreadPool::TryParallelFor(
+      threadpool, static_cast<std::ptrdiff_t>(input.size()), HashLookupCost<TKey, TValue>(input),
+      [input_data, output_data, &lookup](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          output_data[i] = lookup(input_data[i]);
+        }
+      });
+}
+
 // TODO: Update TreeEnsemble* ops to use this instead of write_scores if possible.
 //       Attempted to parallelize the calculations if the number of scores to process was large, but no clear benefit
 //       was seen from testing with the arbitrary values of 1000 scores per threads.
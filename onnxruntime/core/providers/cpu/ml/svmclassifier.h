@@ -12,6 +12,49 @@
 namespace onnxruntime {
 namespace ml {
 
+// Size of the block of support vectors reused across batch rows by the RBF kernel. Fits comfortably in L1.
+constexpr ptrdiff_t kRbfSupportVectorBlockBytes = 16 * 1024;
+
+// Computes the RBF kernel out[i, j] = exp(-gamma * ||a[i] - b[j]||^2) of the m rows of a and the n rows of b, which
+// have k features each.
+// ||a[i] - b[j]||^2 is computed directly instead of being expanded to ||a[i]||^2 + ||b[j]||^2 - 2 * a[i].b[j] and
+// evaluated with a GEMM, as the expansion cancels catastrophically for support vectors with large norms.
+// Rows of a are processed in parallel. Within a thread the rows of b are visited in blocks that stay in cache while
+// the differences against every row of a are accumulated with Eigen's vectorized reductions, then the exponential is
+// applied to the whole output range with MLAS. Each distance is reduced over one contiguous pair of rows; a row-wise
+// reduction of the whole block against a broadcast row of a doesn't vectorize and is several times slower.
+template <typename T>
+void ComputeRbfKernel(const gsl::span<const T> a, const gsl::span<const T> b,
+                      ptrdiff_t m, ptrdiff_t n, ptrdiff_t k,
+                      float gamma,
+                      const gsl::span<T> out,
+                      concurrency::ThreadPool* threadpool) {
+  const ptrdiff_t row_bytes = std::max<ptrdiff_t>(k, 1) * static_cast<ptrdiff_t>(sizeof(T));
+  const ptrdiff_t block_size = std::max<ptrdiff_t>(1, kRbfSupportVectorBlockBytes / row_bytes);
+  const TensorOpCost cost{static_cast<double>(k) * sizeof(T), static_cast<double>(n) * sizeof(T),
+                          3.0 * static_cast<double>(n) * static_cast<double>(k)};
+
+  concurrency::ThreadPool::TryParallelFor(
+      threadpool, m, cost,
+      [&](ptrdiff_t first_batch, ptrdiff_t last_batch) {
+        for (ptrdiff_t block_start = 0; block_start < n; block_start += block_size) {
+          const ptrdiff_t block_end = std::min(block_start + block_size, n);
+
+          for (ptrdiff_t batch = first_batch; batch < last_batch; ++batch) {
+            const auto features = ConstEigenVectorMap<T>(a.data() + batch * k, k);
+            T* batch_out = out.data() + batch * n;
+            for (ptrdiff_t support_vector = block_start; support_vector < block_end; ++support_vector) {
+              batch_out[support_vector] =
+                  (ConstEigenVectorMap<T>(b.data() + support_vector * k, k) - features).squaredNorm() * (-gamma);
+            }
+          }
+        }
+
+        const ptrdiff_t offset = first_batch * n;
+        MlasComputeExp(out.data() + offset, out.data() + offset, static_cast<size_t>((last_batch - first_batch) * n));
+      });
+}
+
 // code shared by SVMClassifier and SVMRegressor
 class SVMCommon {
  protected:
@@ -39,28 +82,7 @@ class SVMCommon {
     assert(a.size() == size_t(m * k) && b.size() == size_t(k * n) && out.size() == size_t(m * n));
 
     if (kernel_type_ == KERNEL::RBF) {
-      T* cur_out = out.data();
-      const T* cur_batch = a.data();
-
-      // each batch has 'k' features
-      for (int64_t batch = 0; batch < m; ++batch) {
-        const T* cur_support_vector = b.data();
-
-        // broadcast the support vectors against the k features in each batch. output is one value per support vector
-        for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
-          T sum = 0.f;
-          const T* cur_input = cur_batch;
-
-          for (int64_t feature = 0; feature < k; ++feature) {
-            T val = *cur_input++ - *cur_support_vector++;
-            sum += val * val;
-          }
-
-          *cur_out++ = std::exp(-gamma_ * sum);
-        }
-
-        cur_batch += k;  // move to start of next batch
-      }
+      ComputeRbfKernel<T>(a, b, m, n, k, gamma_, out, threadpool);
     } else {
       float alpha = 1.f;
       float beta = 1.f;
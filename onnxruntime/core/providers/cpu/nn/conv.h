@@ -6,6 +6,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/conv_attributes.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
@@ -26,14 +27,28 @@ class Conv<float> : public OpKernel {
  public:
   Conv(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
     activation_.ActivationKind = MlasIdentityActivation;
+    use_winograd_ = info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsMlasConvWinogradDisable, "0") != "1";
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  protected:
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  // The filter transformed for the MLAS Winograd algorithm when W is a constant initializer that qualifies.
+  bool use_winograd_{true};
+  TensorShape W_shape_;
+  IAllocatorUniquePtr<void> packed_W_;
 };
 
 }  // namespace onnxruntime
@@ -18,7 +18,7 @@ namespace {
 
 template <typename T,
           typename U,
-          typename = std::enable_if_t<std::is_same_v<T, float> || std::is_same_v<T, double>, void>>
+          typename = std::enable_if_t<std::is_same_v<T, double>, void>>
 void ComputeJob(
     const T* X_data,
     const T* scale_data,
@@ -32,11 +32,9 @@ void ComputeJob(
     bool simplified,
     T* Y_data,
     U* mean_data,
-    U* inv_std_dev_data,
-    AllocatorPtr alloc) {
-  ORT_UNUSED_PARAMETER(scale_float_ptr);  // only used in MLFloat16 overload
-  ORT_UNUSED_PARAMETER(bias_float_ptr);   // only used in MLFloat16 overload
-  ORT_UNUSED_PARAMETER(alloc);
+    U* inv_std_dev_data) {
+  ORT_UNUSED_PARAMETER(scale_float_ptr);  // only used in float/MLFloat16 overloads
+  ORT_UNUSED_PARAMETER(bias_float_ptr);   // only used in float/MLFloat16 overloads
 
   const T* p_input = X_data + task_idx * norm_size;
   T* p_output = Y_data + task_idx * norm_size;
@@ -80,77 +78,92 @@ void ComputeJob(
   }
 }
 
-template <typename U>
-void ComputeJob(
-    const MLFloat16* X_data,
-    const MLFloat16* scale_data,
-    const MLFloat16* bias_data,
+// Normalizes one row with the MLAS kernels, which compute the statistics in fp32 and read and write MLFloat16 data
+// without converting the whole tensor. Scale and bias are fp32.
+template <typename T, typename U>
+void ComputeJobMlas(
+    const T* X_data,
     const ptrdiff_t task_idx,
     const int64_t norm_size,
     const int64_t broadcast_param,
-    const float* scale_float_ptr,
-    const float* bias_float_ptr,
+    const float* scale_data,
+    const float* bias_data,
     float epsilon,
     bool simplified,
-    MLFloat16* Y_data,
+    T* Y_data,
     U* mean_data,
-    U* inv_std_dev_data,
-    AllocatorPtr alloc) {
-  ORT_UNUSED_PARAMETER(scale_data);  // only used in float/double overload
-  ORT_UNUSED_PARAMETER(bias_data);   // only used in float/double overload
-
-  const MLFloat16* p_input = X_data + task_idx * norm_size;
-  MLFloat16* p_output = Y_data + task_idx * norm_size;
-
-  float mean(0.0f);
-  float mean_square(0.0f);
-
-  const size_t num_elems = static_cast<size_t>(norm_size);
-  IAllocatorUniquePtr<float> input_float_uptr = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-  MlasConvertHalfToFloatBuffer(p_input, input_float_uptr.get(), num_elems);
-
-  IAllocatorUniquePtr<float> output_float_uptr = IAllocator::MakeUniquePtr<float>(alloc, num_elems);
-  float* output_float_ptr = output_float_uptr.get();
+    U* inv_std_dev_data) {
+  const T* p_input = X_data + task_idx * norm_size;
+  T* p_output = Y_data + task_idx * norm_size;
 
-  const float* input_float_ptr = input_float_uptr.get();
-  for (size_t h = 0; h < num_elems; h++) {
-    output_float_ptr[h] = input_float_ptr[h];
-    mean += input_float_ptr[h];
-    mean_square += input_float_ptr[h] * input_float_ptr[h];
-  }
+  // Compute the offset of gamma and beta to support broadcasting.
+  const int64_t i = LAYER_NORM_SCALE_BIAS_OFFSET(broadcast_param, task_idx, norm_size);
+  const float* p_scale = scale_data + i;
+  const float* p_bias = bias_data == nullptr ? nullptr : bias_data + i;
 
-  mean = mean / norm_size;
+  float mean = 0.0f;
+  float inv_std_dev = 0.0f;
   if (simplified) {
-    mean_square = sqrt(mean_square / norm_size + epsilon);
+    MlasRmsNorm<T>(p_input, nullptr, nullptr, p_scale, p_output, nullptr, static_cast<size_t>(norm_size), epsilon,
+                   &inv_std_dev);
   } else {
-    mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
-  }
-
-  // Compute the offset of gamma and beta to support broadcasting.
-  int64_t i = LAYER_NORM_SCALE_BIAS_OFFSET(broadcast_param, task_idx, norm_size);
-
-  for (size_t h = 0; h < num_elems; h++, i++) {
-    if (simplified) {
-      output_float_ptr[h] = output_float_ptr[h] / mean_square * scale_float_ptr[i];
-    } else if (nullptr == bias_float_ptr) {
-      output_float_ptr[h] = (output_float_ptr[h] - mean) / mean_square * scale_float_ptr[i];
-    } else {
-      output_float_ptr[h] = (output_float_ptr[h] - mean) / mean_square * scale_float_ptr[i] + bias_float_ptr[i];
-    }
+    MlasLayerNorm<T>(p_input, nullptr, nullptr, p_scale, p_bias, p_output, nullptr, static_cast<size_t>(norm_size),
+                     epsilon, &mean, &inv_std_dev);
   }
 
-  MlasConvertFloatToHalfBuffer(output_float_ptr, p_output, num_elems);
-
   if (mean_data != nullptr) {
-    // ONNX spec doesn't support 'double' for 'U' so when 'T' == double, 'U' == float and we need to narrow
-    mean_data[task_idx] = MLFloat16(mean);
+    mean_data[task_idx] = static_cast<U>(mean);
   }
 
   if (inv_std_dev_data != nullptr) {
-    inv_std_dev_data[task_idx] = MLFloat16(1 / mean_square);
+    inv_std_dev_data[task_idx] = static_cast<U>(inv_std_dev);
   }
 }
 
+template <typename U>
+void ComputeJob(
+    const float* X_data,
+    const float* scale_data,
+    const float* bias_data,
+    const ptrdiff_t task_idx,
+    const int64_t norm_size,
+    const int64_t broadcast_param,
+    const float* scale_float_ptr,
+    const float* bias_float_ptr,
+    float epsilon,
+    bool simplified,
+    float* Y_data,
+    U* mean_data,
+    U* inv_std_dev_data) {
+  ORT_UNUSED_PARAMETER(scale_float_ptr);  // only used in MLFloat16 overload
+  ORT_UNUSED_PARAMETER(bias_float_ptr);   // only used in MLFloat16 overload
+
+  ComputeJobMlas(X_data, task_idx, norm_size, broadcast_param, scale_data, simplified ? nullptr : bias_data, epsilon,
+                 simplified, Y_data, mean_data, inv_std_dev_data);
+}
+
+template <typename U>
+void ComputeJob(
+    const MLFloat16* X_data,
+    const MLFloat16* scale_data,
+    const MLFloat16* bias_data,
+    const ptrdiff_t task_idx,
+    const int64_t norm_size,
+    const int64_t broadcast_param,
+    const float* scale_float_ptr,
+    const float* bias_float_ptr,
+    float epsilon,
+    bool simplified,
+    MLFloat16* Y_data,
+    U* mean_data,
+    U* inv_std_dev_data) {
+  ORT_UNUSED_PARAMETER(scale_data);  // only used in float/double overloads
+  ORT_UNUSED_PARAMETER(bias_data);   // only used in float/double overloads
+
+  ComputeJobMlas(X_data, task_idx, norm_size, broadcast_param, scale_float_ptr, simplified ? nullptr : bias_float_ptr,
+                 epsilon, simplified, Y_data, mean_data, inv_std_dev_data);
+}
+
 void ConvertMLFloat16ToFloatIfNeeded(const Tensor& tensor, AllocatorPtr alloc, IAllocatorUniquePtr<float>& dest, bool& is_packed) {
   if (tensor.GetElementType() == utils::ToTensorProtoElementType<MLFloat16>()) {
     auto tensor_data_ptr = tensor.Data<MLFloat16>();
@@ -291,7 +304,7 @@ Status LayerNormImpl::ComputeWithoutContext(
         ComputeJob(X_data, scale_data, bias_data, task_idx, params.norm_size, params.broadcast_param,
                    prepacked_scale_fp32_data_ ? prepacked_scale_fp32_data_.get() : scale_fp32.get(),
                    prepacked_bias_fp32_data_ ? prepacked_bias_fp32_data_.get() : bias_fp32.get(),
-                   epsilon, simplified, Y_data, mean_data, inv_std_dev_data, alloc);
+                   epsilon, simplified, Y_data, mean_data, inv_std_dev_data);
       },
       0);
 
@@ -566,6 +566,7 @@ UniDirectionalGru<T>::UniDirectionalGru(AllocatorPtr allocator,
   h_alpha_ = activation_func_g.alpha;
   h_beta_ = activation_func_g.beta;
 
+  SetNumThreads();
   AllocateBuffers();
 
   if (use_bias_) {
@@ -744,111 +745,118 @@ void UniDirectionalGru<T>::ComputeImpl(gsl::span<const T> inputs_arg,
   span_T_const_iter batched_bias_WRz_local_end = batched_bias_WRz_.end();
   span_T_const_iter batched_bias_WRr_local_end = batched_bias_WRr_.end();
   span_T_const_iter batched_bias_Wh_local_end = batched_bias_Wh_.end();
-  span_T_const_iter batched_bias_Rh_local_end = batched_bias_Rh_.end();
   span_T_const_iter batched_bias_WRh_local_end = batched_bias_WRh_.end();
 
-  size_t out_added_offset;
-
-  span_T_const_iter prev_Ht = batched_hidden0_.begin();  // Ht-1
-  span_T_const_iter prev_Ht_end = batched_hidden0_.end();
-  span_T_iter cur_h_local = cur_h_.begin();
-  span_T_iter cur_h_local_end = cur_h_.end();
+  int num_seq_to_compute = batch_size_;
+  if (batch_parallel_) {
+    num_seq_to_compute = batch_size_ / num_threads_;
+    if (batch_size_ % num_threads_ != 0)
+      num_seq_to_compute++;
+  }
 
-  span_T_const_iter batched_bias_WRz_local{};
-  span_T_const_iter batched_bias_WRr_local{};
-  span_T_const_iter batched_bias_WRh_local{};
-  span_T_const_iter batched_bias_Wh_local{};
-  span_T_const_iter batched_bias_Rh_local{};
-
-  if (use_bias_) {
-    batched_bias_WRz_local = batched_bias_WRz_.begin();
-    batched_bias_WRr_local = batched_bias_WRr_.begin();
+  // lambda to run all the steps for the block of num_seq_to_compute sequences starting at seq_start.
+  // the rows of a block only depend on each other, so when batch_parallel_ is set the blocks run concurrently and
+  // ttp is nullptr to avoid nested parallelism in the GEMMs.
+  auto sequences_calculator = [&](int seq_start, onnxruntime::concurrency::ThreadPool* ttp) {
+    const int num_rows = std::min(num_seq_to_compute, batch_size_ - seq_start);
+    const int row_offset = seq_start * hidden_size_;
+
+    span_T_const_iter prev_Ht = batched_hidden0_.begin() + row_offset;  // Ht-1
+    span_T_const_iter prev_Ht_end = batched_hidden0_.end();
+    span_T_iter cur_h_local = cur_h_.begin() + row_offset;
+    span_T_iter cur_h_local_end = cur_h_.end();
+    span_T_iter linear_output_local{};
+
+    span_T_const_iter batched_bias_WRz_local{};
+    span_T_const_iter batched_bias_WRr_local{};
+    span_T_const_iter batched_bias_WRh_local{};
+    span_T_const_iter batched_bias_Wh_local{};
+    span_T_const_iter batched_bias_Rh_local{};
 
     if (linear_before_reset_) {
-      batched_bias_Wh_local = batched_bias_Wh_.begin();
-      batched_bias_Rh_local = batched_bias_Rh_.begin();
-    } else {
-      batched_bias_WRh_local = batched_bias_WRh_.begin();
+      linear_output_local = linear_output_.begin() + row_offset;
     }
-  }
 
-  {
-    // Enter a parallel section encompassing the kernels invoked
-    // below.  This lets the runtime system amortize loop entry/exit
-    // costs over a series of short kernels, and promotes cache
-    // affinity between iterations of successive loops.
-    onnxruntime::concurrency::ThreadPool::ParallelSection ps(ttp_);
+    if (use_bias_) {
+      batched_bias_WRz_local = batched_bias_WRz_.begin() + row_offset;
+      batched_bias_WRr_local = batched_bias_WRr_.begin() + row_offset;
+
+      if (linear_before_reset_) {
+        batched_bias_Wh_local = batched_bias_Wh_.begin() + row_offset;
+        batched_bias_Rh_local = batched_bias_Rh_.begin() + row_offset;
+      } else {
+        batched_bias_WRh_local = batched_bias_WRh_.begin() + row_offset;
+      }
+    }
 
     // for each item in sequence run all calculations
     for (int step = 0; step < max_sequence_length; step++) {
 #if defined(DUMP_MATRIXES)
-      const std::string seqno_str = " [seqno=" + std::to_string(step) + "]";
+      const std::string seqno_str = " [seqno=" + std::to_string(step) + ",row=" + std::to_string(seq_start) + "]";
 #endif
-      DumpMatrix("Ht-1" + seqno_str, &*prev_Ht, batch_size_, hidden_size_);
+      DumpMatrix("Ht-1" + seqno_str, &*prev_Ht, num_rows, hidden_size_);
 
-      out_added_offset = (step * batch_size_) * hidden_size_x3;
+      const size_t out_added_offset = (step * batch_size_ + seq_start) * hidden_size_x3;
 
       // calculate Ht-1*R[zr], and add to the weighted inputs that are in zrh
       // Ht-1 * R[zr] + Xt*(W[zr]^T)
       if (!recurrent_weightsZR_s.is_prepacked_) {
-        ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
+        ComputeGemm(num_rows, hidden_size_x2, hidden_size_, alpha,
                     prev_Ht, prev_Ht_end,
                     hidden_size_,
                     recurrent_weightsZR.begin(), recurrent_weightsZR.end(),
                     hidden_size_, 1.f,  // beta == 1 so we add existing values in zrh
                     zrh.begin() + out_added_offset, zrh.end(),
-                    hidden_size_x3, ttp_);
+                    hidden_size_x3, ttp);
       } else {
         MlasGemm(
             CblasNoTrans,
-            static_cast<size_t>(batch_size_), static_cast<size_t>(hidden_size_x2), static_cast<size_t>(hidden_size_), alpha,
+            static_cast<size_t>(num_rows), static_cast<size_t>(hidden_size_x2), static_cast<size_t>(hidden_size_), alpha,
             &*prev_Ht,
             static_cast<size_t>(hidden_size_),
             recurrent_weightsZR_s.buffer_,
             1.f,
             &*(zrh.begin() + out_added_offset),
-            static_cast<size_t>(hidden_size_x3), ttp_);
+            static_cast<size_t>(hidden_size_x3), ttp);
       }
 
       DumpMatrix("Ht-1 * R[zr] + Xt*(W[zr]^T)" + seqno_str,
-                 zrh.data() + out_added_offset, batch_size_, hidden_size_x2, 0, hidden_size_x3);
+                 zrh.data() + out_added_offset, num_rows, hidden_size_x2, 0, hidden_size_x3);
 
       if (linear_before_reset_) {
         // copy Rbh to linear output
         if (use_bias_) {
-          gsl::copy(batched_bias_Rh_.subspan(batched_bias_Rh_local - batched_bias_Rh_.begin(),
-                                             batched_bias_Rh_local_end - batched_bias_Rh_local),
-                    linear_output_);
+          std::copy_n(batched_bias_Rh_local, num_rows * hidden_size_, linear_output_local);
         }
 
         // compute Ht-1 * (Rh^T) + Rbh
         if (!recurrent_weightsH_s.is_prepacked_) {
-          ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
+          ComputeGemm(num_rows, hidden_size_, hidden_size_, alpha,
                       prev_Ht, prev_Ht_end,  // Ht-1
                       hidden_size_,
                       recurrent_weightsH.begin(), recurrent_weightsH.end(),  // Rh^T
                       hidden_size_,
                       use_bias_ ? 1.f : 0.f,  // don't add values in linear_output_ if no bias input
-                      linear_output_.begin(),
+                      linear_output_local,
                       linear_output_.end(),  // pre: Rbh if use_bias_, post:output
-                      hidden_size_, ttp_);
+                      hidden_size_, ttp);
         } else {
           MlasGemm(
               CblasNoTrans,
-              static_cast<size_t>(batch_size_), static_cast<size_t>(hidden_size_), static_cast<size_t>(hidden_size_), alpha,
+              static_cast<size_t>(num_rows), static_cast<size_t>(hidden_size_), static_cast<size_t>(hidden_size_), alpha,
               &*prev_Ht,
               static_cast<size_t>(hidden_size_),
               recurrent_weightsH_s.buffer_,
               use_bias_ ? 1.f : 0.f,  // don't add values in linear_output_ if no bias input
-              &*linear_output_.begin(),
-              static_cast<size_t>(hidden_size_), ttp_);
+              &*linear_output_local,
+              static_cast<size_t>(hidden_size_), ttp);
         }
 
-        DumpMatrix("Ht-1 * (Rh^T) + Rbh " + seqno_str, linear_output_.data(), batch_size_, hidden_size_);
+        DumpMatrix("Ht-1 * (Rh^T) + Rbh " + seqno_str, &*linear_output_local, num_rows, hidden_size_);
       }
 
       // 1st Set Of Activations
-      for (int r = 0; r < batch_size_; r++) {
+      for (int r = 0; r < num_rows; r++) {
         const T* p_bias_r = use_bias_ ? SafeRawConstPointer<T>(batched_bias_WRr_local + r * hidden_size_,
                                                                batched_bias_WRr_local_end, hidden_size_)
                                       : nullptr;
@@ -859,18 +867,24 @@ void UniDirectionalGru<T>::ComputeImpl(gsl::span<const T> inputs_arg,
         // add the bias and clip. post: p_rt == Xt*(Wr^T) + Ht-1*(Rr^T) + Wbr + Rbr
         clip_with_bias_ptr_(clip_, p_bias_r, p_rt, hidden_size_);
 
+        T* p_cur_h = SafeRawPointer<T>(cur_h_local + r * hidden_size_, cur_h_local_end, hidden_size_);
+
         if (linear_before_reset_) {
           // p_linear_output = Ht-1 * (Rh^T) + Rbh
-          T* p_linear_output = SafeRawPointer<T>(linear_output_, r * hidden_size_, hidden_size_);
-          T* p_cur_h = SafeRawPointer<T>(cur_h_local + r * hidden_size_, cur_h_local_end, hidden_size_);
+          T* p_linear_output = SafeRawPointer<T>(linear_output_local + r * hidden_size_, linear_output_.end(),
+                                                 hidden_size_);
 
           // calculate rt in-place [p_rt = f(p_rt)]
           // calculate rt (.) (Ht-1 * (Rh^T) + Rbh) using p_linear_output. write to p_cur_h
           reset_gate_(p_linear_output, p_rt, p_cur_h, hidden_size_, zr_alpha_, zr_beta_);
 
+          // add rt (.) (Ht-1*(Rh^T) + Rbh) to Xt*(Wh^T) while the row is still in cache
+          T* p_out_H = SafeRawPointer(zrh, out_added_offset + r * hidden_size_x3 + hidden_size_x2, hidden_size_);
+          for (int h = 0; h < hidden_size_; ++h) {
+            p_out_H[h] += p_cur_h[h];
+          }
         } else {
           const T* p_prev_Ht = SafeRawConstPointer<T>(prev_Ht + r * hidden_size_, prev_Ht_end, hidden_size_);
-          T* p_cur_h = SafeRawPointer<T>(cur_h_local + r * hidden_size_, cur_h_local_end, hidden_size_);
 
           // calculate rt in-place [p_rt = f(p_rt)]
           // calculate rt (.) Ht-1 using p_prev_Ht, and write to p_cur_h
@@ -881,24 +895,9 @@ void UniDirectionalGru<T>::ComputeImpl(gsl::span<const T> inputs_arg,
 #if defined(DUMP_MATRIXES)
       std::string label = linear_before_reset_ ? "rt (.) (Ht-1 * (Rh^T) + Rbh)" : "rt (.) Ht-1";
 #endif
-      DumpMatrix(label + seqno_str, &*cur_h_local, batch_size_, hidden_size_);
+      DumpMatrix(label + seqno_str, &*cur_h_local, num_rows, hidden_size_);
 
-      if (linear_before_reset_) {
-        // input contains rt (.) (Ht-1*(Rh^T) + Rbh)
-        auto input = cur_h_local;
-        // out_H currently contains Xt*(W[zrh]^T).
-        auto out_H = zrh.begin() + out_added_offset;
-
-        for (int r = 0; r < batch_size_; r++) {
-          // skip over the inputs with Z and R weights
-          out_H += hidden_size_x2;
-          for (int h = 0; h < hidden_size_; ++h) {
-            *out_H += *input;
-            ++out_H;
-            ++input;
-          }
-        }
-      } else {
+      if (!linear_before_reset_) {
 #if defined(DUMP_MATRIXES)
         label += " * Rh^T";
 #endif
@@ -908,46 +907,47 @@ void UniDirectionalGru<T>::ComputeImpl(gsl::span<const T> inputs_arg,
 
         // Calculate Xt*(Wh^T) + rt (.) Ht-1 * Rh
         if (!recurrent_weightsH_s.is_prepacked_) {
-          ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
+          ComputeGemm(num_rows, hidden_size_, hidden_size_, alpha,
                       cur_h_local, cur_h_local_end,  // rt (.) Ht-1
                       hidden_size_,
                       recurrent_weightsH.begin(), recurrent_weightsH.end(),  // Rh^T
                       hidden_size_, 1.f,                                     // beta == 1 to add Xt*(Wh^T) from out_H
                       out_H, zrh.end(),
-                      hidden_size_x3, ttp_);
+                      hidden_size_x3, ttp);
         } else {
           MlasGemm(
               CblasNoTrans,
-              static_cast<size_t>(batch_size_), static_cast<size_t>(hidden_size_), static_cast<size_t>(hidden_size_), alpha,
+              static_cast<size_t>(num_rows), static_cast<size_t>(hidden_size_), static_cast<size_t>(hidden_size_), alpha,
               &*cur_h_local,
               static_cast<size_t>(hidden_size_),
               recurrent_weightsH_s.buffer_,
               1.f,  // beta == 1 to add Xt*(Wh^T) from out_H
               &*out_H,
-              static_cast<size_t>(hidden_size_x3), ttp_);
+              static_cast<size_t>(hidden_size_x3), ttp);
         }
       }
 
       DumpMatrix("Xt*(Wh^T) + (" + label + ")" + seqno_str, zrh.data() + out_added_offset,
-                 batch_size_, hidden_size_, hidden_size_x2, hidden_size_x3);
+                 num_rows, hidden_size_, hidden_size_x2, hidden_size_x3);
 
       // 2nd Set of Activations
       span_T_iter output;
       span_T_iter output_end;
       if (output_sequence) {
-        output = outputs.begin() + step * output_step_length;
+        output = outputs.begin() + step * output_step_length + row_offset;
         output_end = outputs.end();
 
       } else {
-        output = final_hidden_state.begin();
+        output = final_hidden_state.begin() + row_offset;
         output_end = final_hidden_state.end();
       }
 
-      for (int r = 0; r < batch_size_; r++) {
-        if (step >= min_sequence_length && step >= sequence_lengths[r]) {
+      for (int r = 0; r < num_rows; r++) {
+        const int seq_length = sequence_lengths[seq_start + r];
+        if (step >= min_sequence_length && step >= seq_length) {
           // if we need output for every step,
           // or we need to set prev_Ht for an empty sequence to avoid warnings about using uninitialized values
-          if (output_sequence || (step == 0 && sequence_lengths[r] == 0)) {
+          if (output_sequence || (step == 0 && seq_length == 0)) {
             auto fill_output = output + r * hidden_size_;
             std::fill_n(&*fill_output, hidden_size_, T{});
           }
@@ -955,7 +955,7 @@ void UniDirectionalGru<T>::ComputeImpl(gsl::span<const T> inputs_arg,
           continue;
         }
 
-        const T* p_bias_z = use_bias_ ? SafeRawConstPointer<T>(batched_bias_WRz_local,
+        const T* p_bias_z = use_bias_ ? SafeRawConstPointer<T>(batched_bias_WRz_local + r * hidden_size_,
                                                                batched_bias_WRz_local_end, hidden_size_)
                                       : nullptr;
 
@@ -968,7 +968,7 @@ void UniDirectionalGru<T>::ComputeImpl(gsl::span<const T> inputs_arg,
         // calculate zt in-place. p_zt = f(p_zt)
         update_gate_(p_zt, hidden_size_, zr_alpha_, zr_beta_);
 
-        DumpMatrix("zt[" + std::to_string(r) + "]" + seqno_str, p_zt, 1, hidden_size_);
+        DumpMatrix("zt[" + std::to_string(seq_start + r) + "]" + seqno_str, p_zt, 1, hidden_size_);
 
         const T* p_bias_h = nullptr;
         if (use_bias_) {
@@ -992,7 +992,7 @@ void UniDirectionalGru<T>::ComputeImpl(gsl::span<const T> inputs_arg,
         // add Wbh [and Wrh] and clip
         clip_with_bias_ptr_(clip_, p_bias_h, p_ht, hidden_size_);  // post: p_ht == input to g() for calculating ht
 
-        DumpMatrix("ht input [" + std::to_string(r) + "]" + seqno_str, p_ht, 1, hidden_size_);
+        DumpMatrix("ht input [" + std::to_string(seq_start + r) + "]" + seqno_str, p_ht, 1, hidden_size_);
 
         const T* p_prev_Ht = SafeRawConstPointer<T>(prev_Ht + r * hidden_size_, prev_Ht_end, hidden_size_);
         T* p_Ht = SafeRawPointer<T>(output + r * hidden_size_, output_end, hidden_size_);
@@ -1002,12 +1002,32 @@ void UniDirectionalGru<T>::ComputeImpl(gsl::span<const T> inputs_arg,
         output_gate_(p_ht, p_zt, p_prev_Ht, p_Ht, hidden_size_, h_alpha_, h_beta_);  // calculate ht and Ht
       }
 
-      DumpMatrix("output" + seqno_str, &*output, batch_size_, hidden_size_);
+      DumpMatrix("output" + seqno_str, &*output, num_rows, hidden_size_);
 
       prev_Ht = output;
       prev_Ht_end = output_end;
     }
-  }  // End parallel section
+  };
+
+  if (batch_parallel_) {
+    const int num_blocks = (batch_size_ + num_seq_to_compute - 1) / num_seq_to_compute;
+    const double gemm_cost = static_cast<double>(num_seq_to_compute) * hidden_size_x3 * hidden_size_;
+    const double cost = max_sequence_length * (gemm_cost + num_seq_to_compute);
+    concurrency::ThreadPool::TryParallelFor(
+        ttp_, num_blocks, cost,
+        [&sequences_calculator, num_seq_to_compute](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (auto block = first; block < last; ++block) {
+            sequences_calculator(static_cast<int>(block) * num_seq_to_compute, nullptr);
+          }
+        });
+  } else {
+    // Enter a parallel section encompassing the kernels invoked
+    // below.  This lets the runtime system amortize loop entry/exit
+    // costs over a series of short kernels, and promotes cache
+    // affinity between iterations of successive loops.
+    onnxruntime::concurrency::ThreadPool::ParallelSection ps(ttp_);
+    sequences_calculator(0, ttp_);
+  }
 
   // copy last output to final_hidden_state
   for (int i = 0; i < batch_size_; i++) {
@@ -1046,6 +1066,16 @@ void UniDirectionalGru<T>::ComputeImpl(gsl::span<const T> inputs_arg,
   }
 }
 
+template <typename T>
+void UniDirectionalGru<T>::SetNumThreads() {
+  num_threads_ = std::max(1, concurrency::ThreadPool::DegreeOfParallelism(ttp_));
+
+  // the recurrent GEMMs are [batch_size, hidden_size] x [hidden_size, 3 * hidden_size] so for small hidden sizes
+  // there is too little work per step to split them. partition the batch rows across threads instead, as is done
+  // for LSTM.
+  batch_parallel_ = num_threads_ > 1 && (batch_size_ > 4 || (batch_size_ >= 2 && hidden_size_ <= 256));
+}
+
 template <typename T>
 void UniDirectionalGru<T>::AllocateBuffers() {
   cur_h_ = Allocate(allocator_, hidden_size_ * batch_size_, cur_h_ptr_);
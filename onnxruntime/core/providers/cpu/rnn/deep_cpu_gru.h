@@ -190,9 +190,15 @@ class UniDirectionalGru {
   rnn::detail::deepcpu::GruOutputGateFuncPtr output_gate_{};
 
   void AllocateBuffers();
+  void SetNumThreads();
 
   onnxruntime::concurrency::ThreadPool* ttp_;
 
+  // when set, ComputeImpl splits the batch into num_threads_ blocks of rows and runs all the steps for each block
+  // on a separate thread instead of parallelizing within each (small) per-step GEMM.
+  int num_threads_ = 1;
+  bool batch_parallel_ = false;
+
   const bool training_mode_ = false;
 };
 }  // namespace detail
@@ -3,8 +3,15 @@
 
 #include "regex_full_match.h"
 #include "core/common/common.h"
+#include "core/providers/cpu/text/string_parallel.h"
 
 namespace onnxruntime {
+
+namespace {
+// Approximate cost of running the RE2 DFA over one byte of input.
+constexpr double kMatchCyclesPerByte = 10.0;
+}  // namespace
+
 ONNX_CPU_OPERATOR_KERNEL(
     RegexFullMatch,
     20,
@@ -21,14 +28,18 @@ Status RegexFullMatch::Compute(OpKernelContext* context) const {
   const auto* input_tensor = context->Input<Tensor>(0);
   const auto input_data = input_tensor->template DataAsSpan<std::string>();
   auto* output_tensor = context->Output(0, input_tensor->Shape());
-  auto output_data = output_tensor->template MutableDataAsSpan<bool>();
-  auto output_iter = output_data.begin();
-  auto input_iter = input_data.begin();
-  while (input_iter != input_data.end()) {
-    *output_iter = RE2::FullMatch(*input_iter, re_);
-    input_iter++;
-    output_iter++;
-  }
+  auto* output_data = output_tensor->template MutableData<bool>();
+
+  // RE2 objects are thread-safe for matching, so elements are matched in parallel. Matching is roughly linear in the
+  // input length, so the per-element cost is derived from the average string length.
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(input_data.size()),
+      string_parallel::ElementCost(input_data, kMatchCyclesPerByte, sizeof(bool)),
+      [this, &input_data, output_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          output_data[i] = RE2::FullMatch(input_data[static_cast<size_t>(i)], re_);
+        }
+      });
   return Status::OK();
 }
 
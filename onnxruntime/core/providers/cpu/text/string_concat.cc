@@ -4,8 +4,15 @@
 #include "string_concat.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 #include "core/common/common.h"
+#include "core/providers/cpu/text/string_parallel.h"
 
 namespace onnxruntime {
+
+namespace {
+// Approximate cost, in cycles, of allocating the buffer of one output string.
+constexpr double kPerElementAllocationCost = 64.0;
+}  // namespace
+
 ONNX_CPU_OPERATOR_KERNEL(StringConcat, 20,
                          KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<std::string>()),
                          StringConcat);
@@ -53,7 +60,12 @@ Status StringConcat::Compute(OpKernelContext* context) const {
                                                 output_iter++;
                                               }
                                             }};
-  UntypedBroadcastTwo(*context, broadcast_funcs);
+  // Concatenation cost is dominated by copying the bytes of both inputs into a new allocation, so the unit cost used
+  // to chunk the output across threads is derived from the average input lengths.
+  const double unit_cost = string_parallel::AverageLength(context->Input<Tensor>(0)->DataAsSpan<std::string>()) +
+                           string_parallel::AverageLength(context->Input<Tensor>(1)->DataAsSpan<std::string>()) +
+                           kPerElementAllocationCost;
+  UntypedBroadcastTwo(*context, broadcast_funcs, unit_cost);
   return Status::OK();
 }
 
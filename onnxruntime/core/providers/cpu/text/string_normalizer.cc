@@ -4,6 +4,7 @@
 #include "string_normalizer.h"
 #include "core/common/common.h"
 #include "core/framework/tensor.h"
+#include "core/providers/cpu/text/string_parallel.h"
 // Used below HAS_DEPRECATED_DECLARATIONS
 #include "onnxruntime_config.h"
 
@@ -522,116 +523,97 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   // and compare with the original strings. Otherwise, we need to convert the string
   // to widechar, lowercase it and then compare. Case-insensitive comparison is complicated
   // for UTF-8 and requires additional dependency.
+  //
+  // The input is split into partitions of roughly equal byte size which are processed in parallel. Each partition
+  // uses its own converter and conversion buffer; the locale and stop word sets are only read.
 
   Locale locale(locale_name_);
-  Utf8Converter converter;
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+  const auto partitions = string_parallel::PartitionByLength(tp, input_span);
+  const size_t num_partitions = partitions.size() - 1;
 
-  // Compute the largest widestring buffer needed.
-  size_t max_wide_buffer_len = 0;
-  for (const auto& s : input_span) {
+  // Converts s to wchar_t UNICODE in wchar_buffer and changes its case.
+  auto to_wide_char = [&locale](Utf8Converter& converter, const std::string& s, CaseAction caseaction,
+                                std::wstring& wchar_buffer) -> Status {
     size_t wchars = 0;
-    // Checks for invalid UTF-8 characters on Windows
     ORT_RETURN_IF_ERROR(converter.ComputeRequiredSizeToWideChar(s, wchars));
-    max_wide_buffer_len = std::max(max_wide_buffer_len, wchars);
-  }
-
-  // Reuse reserved space
-  std::wstring wchar_buffer;
-  wchar_buffer.reserve(max_wide_buffer_len);
-
-  // Output everything and change case as required
-  auto output_no_filtering = [&](const TensorShape& output_shape) {
-    auto output_tensor = ctx->Output(0, output_shape);
-    auto const output_data = output_tensor->MutableData<std::string>();
-    for (size_t i = 0, lim = input_span.size(); i < lim; ++i) {
-      const std::string& s = input_span[i];
-      wchar_buffer.resize(max_wide_buffer_len);
-      ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
-      locale.ChangeCase(case_change_action_, wchar_buffer);
-
-      auto& dest = output_data[i];
-      size_t utf8_buffer_len = converter.ComputeRequiredSizeToUtf8(wchar_buffer);
-      dest.resize(utf8_buffer_len);
-      ORT_RETURN_IF_ERROR(converter.ConvertToUtf8(wchar_buffer, dest));
-    }
+    wchar_buffer.resize(wchars);
+    ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
+    locale.ChangeCase(caseaction, wchar_buffer);
     return Status::OK();
   };
 
-  auto output_filtered = [&](const TensorShape& output_shape, gsl::span<const size_t> filtered_indices) {
-    auto output_tensor = ctx->Output(0, output_shape);
-    auto output_data = output_tensor->MutableData<std::string>();
-    for (size_t i : filtered_indices) {
-      const std::string& s = input_span[i];
-      if (case_change_action_ != NONE) {
-        wchar_buffer.resize(max_wide_buffer_len);
-        ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
-        locale.ChangeCase(case_change_action_, wchar_buffer);
-
-        auto& dest = *output_data++;
-        size_t utf8_buffer_len = converter.ComputeRequiredSizeToUtf8(wchar_buffer);
-        dest.resize(utf8_buffer_len);
-        ORT_RETURN_IF_ERROR(converter.ConvertToUtf8(wchar_buffer, dest));
-      } else {
-        *output_data++ = s;
-      }
-    }
-    return Status::OK();
-  };
-
-  Status status;
-
-  if (is_case_sensitive_) {
-    if (stopwords_.empty()) {
-      assert(case_change_action_ != NONE);
-      output_shape.push_back(C);
-      status = output_no_filtering(output_shape);
-    } else {
-      // we need to filter
-      InlinedVector<size_t> filtered_strings_indices;
-      filtered_strings_indices.reserve(input_span.size());
-
-      for (size_t i = 0, lim = input_span.size(); i < lim; ++i) {
-        const std::string& s = input_span[i];
-        if (stopwords_.count(s) == 0) {
-          filtered_strings_indices.push_back(i);
+  // Pass 1: validate the input and decide which strings are kept.
+  const bool filter = is_case_sensitive_ ? !stopwords_.empty() : !wstopwords_.empty();
+  InlinedVector<uint8_t> keep(input_span.size(), 1);
+  InlinedVector<size_t> partition_kept(num_partitions, 0);
+
+  ORT_RETURN_IF_ERROR(string_parallel::ForEachPartition(
+      tp, partitions, [&](size_t partition, size_t begin, size_t end) -> Status {
+        Utf8Converter converter;
+        std::wstring wchar_buffer;
+        size_t kept = 0;
+        for (size_t i = begin; i < end; ++i) {
+          const std::string& s = input_span[i];
+          if (!filter || is_case_sensitive_) {
+            size_t wchars = 0;
+            // Checks for invalid UTF-8 characters on Windows
+            ORT_RETURN_IF_ERROR(converter.ComputeRequiredSizeToWideChar(s, wchars));
+            keep[i] = !filter || stopwords_.count(s) == 0;
+          } else {
+            // Case insensitive filtering is performed by converting the input strings
+            // to compare_caseaction_. For that we convert to wchar_t UNICODE.
+            // Otherwise, we need to pull ICU library on all platforms.
+            ORT_RETURN_IF_ERROR(to_wide_char(converter, s, compare_caseaction_, wchar_buffer));
+            keep[i] = wstopwords_.count(wchar_buffer) == 0;
+          }
+          kept += keep[i];
         }
-      }
+        partition_kept[partition] = kept;
+        return Status::OK();
+      }));
+
+  // Output position of the first string kept by each partition.
+  InlinedVector<size_t> partition_output_offset(num_partitions, 0);
+  for (size_t partition = 1; partition < num_partitions; ++partition) {
+    partition_output_offset[partition] = partition_output_offset[partition - 1] + partition_kept[partition - 1];
+  }
+  const size_t total_kept = partition_output_offset.back() + partition_kept.back();
 
-      // According to the spec, if all strings are filtered out
-      // the output must have a shape of {1} with a single empty string.
-      const int64_t filtered_count = std::max<int64_t>(1, narrow<int64_t>(filtered_strings_indices.size()));
-      output_shape.push_back(filtered_count);
-      status = output_filtered(output_shape, filtered_strings_indices);
-    }
+  if (filter) {
+    // According to the spec, if all strings are filtered out
+    // the output must have a shape of {1} with a single empty string.
+    output_shape.push_back(std::max<int64_t>(1, narrow<int64_t>(total_kept)));
   } else {
-    if (wstopwords_.empty()) {
-      assert(case_change_action_ != NONE);
-      output_shape.push_back(C);
-      status = output_no_filtering(output_shape);
-    } else {
-      // Case insensitive filtering is performed by converting the input strings
-      // to compare_caseaction_. For that we convert to wchar_t UNICODE.
-      // Otherwise, we need to pull ICU library on all platforms.
-      InlinedVector<size_t> filtered_strings_indices;
-      filtered_strings_indices.reserve(input_span.size());
-      for (size_t i = 0, lim = input_span.size(); i < lim; ++i) {
-        const std::string& s = input_span[i];
-        wchar_buffer.resize(max_wide_buffer_len);
-        ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
-        locale.ChangeCase(compare_caseaction_, wchar_buffer);
-        if (wstopwords_.count(wchar_buffer) == 0) {
-          filtered_strings_indices.push_back(i);
-        }
-      }
-
-      // According to the spec, if all strings are filtered out
-      // the output must have a shape of {1} with a single empty string.
-      const int64_t filtered_count = std::max<int64_t>(1, narrow<int64_t>(filtered_strings_indices.size()));
-      output_shape.push_back(filtered_count);
-      status = output_filtered(output_shape, filtered_strings_indices);
-    }
+    assert(case_change_action_ != NONE);
+    output_shape.push_back(C);
   }
 
-  return status;
+  // Pass 2: output the kept strings and change case as required
+  auto output_tensor = ctx->Output(0, output_shape);
+  auto* const output_data = output_tensor->MutableData<std::string>();
+  return string_parallel::ForEachPartition(
+      tp, partitions, [&](size_t partition, size_t begin, size_t end) -> Status {
+        Utf8Converter converter;
+        std::wstring wchar_buffer;
+        std::string* dest = output_data + partition_output_offset[partition];
+        for (size_t i = begin; i < end; ++i) {
+          if (!keep[i]) {
+            continue;
+          }
+
+          const std::string& s = input_span[i];
+          if (case_change_action_ != NONE) {
+            ORT_RETURN_IF_ERROR(to_wide_char(converter, s, case_change_action_, wchar_buffer));
+            size_t utf8_buffer_len = converter.ComputeRequiredSizeToUtf8(wchar_buffer);
+            dest->resize(utf8_buffer_len);
+            ORT_RETURN_IF_ERROR(converter.ConvertToUtf8(wchar_buffer, *dest));
+          } else {
+            *dest = s;
+          }
+          ++dest;
+        }
+        return Status::OK();
+      });
 }
 }  // namespace onnxruntime
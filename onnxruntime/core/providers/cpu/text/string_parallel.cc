@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/text/string_parallel.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+namespace string_parallel {
+
+namespace {
+
+inline size_t ElementWeight(const std::string& s) {
+  return s.size() + sizeof(std::string);
+}
+
+}  // namespace
+
+double AverageLength(gsl::span<const std::string> input) {
+  if (input.empty()) {
+    return 0.0;
+  }
+
+  size_t total = 0;
+  for (const auto& s : input) {
+    total += s.size();
+  }
+  return static_cast<double>(total) / static_cast<double>(input.size());
+}
+
+TensorOpCost ElementCost(gsl::span<const std::string> input, double cycles_per_byte, double bytes_stored) {
+  const double average_length = AverageLength(input);
+  return TensorOpCost{average_length + sizeof(std::string), bytes_stored, average_length * cycles_per_byte};
+}
+
+InlinedVector<size_t> PartitionByLength(const concurrency::ThreadPool* tp, gsl::span<const std::string> input,
+                                        size_t min_bytes_per_partition) {
+  const size_t num_elements = input.size();
+  InlinedVector<size_t> boundaries{0};
+
+  const size_t max_partitions = static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(tp));
+  size_t total_bytes = 0;
+  if (max_partitions > 1) {
+    for (const auto& s : input) {
+      total_bytes += ElementWeight(s);
+    }
+  }
+
+  const size_t num_partitions = std::min({max_partitions, num_elements,
+                                          total_bytes / std::max<size_t>(min_bytes_per_partition, 1)});
+  if (num_partitions > 1) {
+    const size_t bytes_per_partition = (total_bytes + num_partitions - 1) / num_partitions;
+    size_t accumulated = 0;
+    for (size_t i = 0; i + 1 < num_elements && boundaries.size() < num_partitions; ++i) {
+      accumulated += ElementWeight(input[i]);
+      if (accumulated >= bytes_per_partition * boundaries.size()) {
+        boundaries.push_back(i + 1);
+      }
+    }
+  }
+
+  boundaries.push_back(num_elements);
+  return boundaries;
+}
+
+Status ForEachPartition(concurrency::ThreadPool* tp, gsl::span<const size_t> boundaries,
+                        const std::function<Status(size_t partition, size_t begin, size_t end)>& fn) {
+  const size_t num_partitions = boundaries.size() - 1;
+  if (num_partitions == 1) {
+    return fn(0, boundaries[0], boundaries[1]);
+  }
+
+  InlinedVector<Status> statuses(num_partitions);
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      tp, static_cast<std::ptrdiff_t>(num_partitions),
+      [&](std::ptrdiff_t partition) {
+        const auto p = static_cast<size_t>(partition);
+        statuses[p] = fn(p, boundaries[p], boundaries[p + 1]);
+      });
+
+  for (auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+  return Status::OK();
+}
+
+}  // namespace string_parallel
+}  // namespace onnxruntime
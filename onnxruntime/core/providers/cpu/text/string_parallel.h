@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace string_parallel {
+
+/// Minimum number of input bytes worth handing to another thread. Elements are weighted by their length plus
+/// sizeof(std::string) so batches of many short strings are still split.
+constexpr size_t kMinBytesPerPartition = 16 * 1024;
+
+/// Returns the average length in bytes of the strings in `input`.
+double AverageLength(gsl::span<const std::string> input);
+
+/// Cost of processing one element of `input` for ThreadPool::TryParallelFor, derived from the average input string
+/// length so the pool picks larger blocks for short strings and smaller ones for long strings.
+TensorOpCost ElementCost(gsl::span<const std::string> input, double cycles_per_byte, double bytes_stored);
+
+/// Splits `input` into contiguous ranges holding approximately the same number of bytes, at most one per thread
+/// of `tp`. Partition i covers [boundaries[i], boundaries[i + 1]); there is always at least one partition.
+InlinedVector<size_t> PartitionByLength(const concurrency::ThreadPool* tp, gsl::span<const std::string> input,
+                                        size_t min_bytes_per_partition = kMinBytesPerPartition);
+
+/// Calls fn(partition_index, begin, end) for every partition in `boundaries`, in parallel when there is more than
+/// one partition. Returns the status of the first failing partition.
+Status ForEachPartition(concurrency::ThreadPool* tp, gsl::span<const size_t> boundaries,
+                        const std::function<Status(size_t partition, size_t begin, size_t end)>& fn);
+
+}  // namespace string_parallel
+}  // namespace onnxruntime
@@ -6,6 +6,8 @@
 #include <limits>
 #include <string>
 #include "core/common/common.h"
+#include "core/providers/cpu/text/string_parallel.h"
+
 namespace onnxruntime {
 
 ONNX_CPU_OPERATOR_KERNEL(StringSplit, 20,
@@ -64,33 +66,52 @@ StringSplit::StringSplit(const OpKernelInfo& info) : OpKernel(info) {
 Status StringSplit::Compute(OpKernelContext* context) const {
   const Tensor* input = context->Input<Tensor>(0);
   auto input_data = input->template DataAsSpan<std::string>();
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
 
   // Set up number of tokens output
   auto num_tokens_data = context->Output(1, input->Shape())->template MutableDataAsSpan<int64_t>();
-  auto num_tokens_iter = num_tokens_data.begin();
 
-  InlinedVector<InlinedVector<std::string_view>> input_slices;
-  input_slices.reserve(input_data.size());
-  size_t last_dim = 0;
+  // Rows are split into partitions of roughly equal byte size that are processed in parallel. Within a partition the
+  // tokens of all rows are stored back to back as views into the input: row i owns the num_tokens[i] entries
+  // following those of row i - 1. This avoids a separate token vector per input row.
+  const auto partitions = string_parallel::PartitionByLength(tp, input_data);
+  const size_t num_partitions = partitions.size() - 1;
+  InlinedVector<InlinedVector<std::string_view>> partition_tokens(num_partitions);
+  InlinedVector<size_t> partition_last_dim(num_partitions, 0);
 
-  for (const auto& s : input_data) {
-    auto& substrs = input_slices.emplace_back();
-    ComputeSubstrings(s, delimiter_, maxsplit_, substrs);
-    auto substr_count = substrs.size();
-    last_dim = std::max(last_dim, substr_count);
-    *num_tokens_iter = static_cast<int64_t>(substr_count);
-    ++num_tokens_iter;
-  }
+  ORT_RETURN_IF_ERROR(string_parallel::ForEachPartition(
+      tp, partitions, [&](size_t partition, size_t begin, size_t end) {
+        auto& tokens = partition_tokens[partition];
+        tokens.reserve(end - begin);
+        size_t last_dim = 0;
+        for (size_t i = begin; i < end; ++i) {
+          const size_t row_begin = tokens.size();
+          ComputeSubstrings(input_data[i], delimiter_, maxsplit_, tokens);
+          const size_t substr_count = tokens.size() - row_begin;
+          last_dim = std::max(last_dim, substr_count);
+          num_tokens_data[i] = static_cast<int64_t>(substr_count);
+        }
+        partition_last_dim[partition] = last_dim;
+        return Status::OK();
+      }));
+
+  const size_t last_dim = *std::max_element(partition_last_dim.begin(), partition_last_dim.end());
 
   // Set up splits output
   auto splits_shape = input->Shape().AsShapeVector();
   splits_shape.push_back(last_dim);
 
-  auto splits_data = context->Output(0, splits_shape)->template MutableDataAsSpan<std::string>();
-  auto slices_iter = input_slices.begin();
-  for (auto output_splits_iter = splits_data.begin(); output_splits_iter != splits_data.end(); output_splits_iter += last_dim, ++slices_iter) {
-    std::copy(slices_iter->begin(), slices_iter->end(), output_splits_iter);
-  }
+  std::string* splits_data = context->Output(0, splits_shape)->template MutableData<std::string>();
+  ORT_RETURN_IF_ERROR(string_parallel::ForEachPartition(
+      tp, partitions, [&](size_t partition, size_t begin, size_t end) {
+        auto tokens_iter = partition_tokens[partition].cbegin();
+        for (size_t i = begin; i < end; ++i) {
+          const auto substr_count = static_cast<ptrdiff_t>(num_tokens_data[i]);
+          std::copy(tokens_iter, tokens_iter + substr_count, splits_data + i * last_dim);
+          tokens_iter += substr_count;
+        }
+        return Status::OK();
+      }));
 
   return Status::OK();
 }
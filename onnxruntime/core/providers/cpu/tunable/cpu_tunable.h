@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+
+#include "core/framework/tunable.h"
+#include "core/providers/cpu/tunable/cpu_tuning_context.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+// CPU kernels run synchronously on the calling thread, the timer does not use a stream.
+using StreamT = void*;
+
+class Timer : public ITimer<StreamT> {
+ public:
+  using TimerBase = ITimer<StreamT>;
+
+  explicit Timer(StreamT stream) : TimerBase{stream} {}
+
+  void Start() override {
+    start_ = std::chrono::steady_clock::now();
+  }
+
+  void End() override {
+    end_ = std::chrono::steady_clock::now();
+  }
+
+  float Duration() override {
+    return std::chrono::duration_cast<std::chrono::duration<float, std::milli>>(end_ - start_).count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::steady_clock::time_point end_;
+};
+
+using OpParams = OpParams<CpuTuningContext, StreamT>;
+
+template <typename ParamsT>
+using Op = Op<ParamsT>;
+
+template <typename ParamsT>
+using TunableOp = TunableOp<ParamsT, Timer>;
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
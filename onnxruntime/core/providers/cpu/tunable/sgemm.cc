@@ -0,0 +1,192 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tunable/sgemm.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "core/graph/constants.h"
+#include "core/providers/cpu/tunable/cpu_tunable.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+namespace {
+
+struct SgemmParams : OpParams {
+  std::string Signature() const override {
+    std::string sig;
+    sig += trans_a == CblasNoTrans ? "N" : "T";
+    sig += trans_b == CblasNoTrans ? "N" : "T";
+    sig += "_" + std::to_string(m) + "_" + std::to_string(n) + "_" + std::to_string(k);
+    sig += "_batch" + std::to_string(batch_size);
+    sig += data[0].BIsPacked ? "_packed" : "";
+    sig += data[0].BIsBlockSparse ? "_blocksparse" : "";
+    sig += "_threads" + std::to_string(concurrency::ThreadPool::DegreeOfParallelism(thread_pool));
+    return sig;
+  }
+
+  CBLAS_TRANSPOSE trans_a;
+  CBLAS_TRANSPOSE trans_b;
+  size_t m;
+  size_t n;
+  size_t k;
+  const MLAS_SGEMM_DATA_PARAMS* data;
+  size_t batch_size;
+  concurrency::ThreadPool* thread_pool;
+
+  // Owns the copies of the outputs and data parameters of a proxy params used for tuning.
+  std::vector<MLAS_SGEMM_DATA_PARAMS> proxy_data;
+  std::vector<float> proxy_c;
+};
+
+enum class SgemmPartition {
+  M,
+  N,
+  MN,
+};
+
+// Runs the multiplication with the thread count of the pool divided by `divisor`, split along M, along N, or as a
+// grid proportional to the shape of C.
+Status SgemmWithPartition(const SgemmParams* params, SgemmPartition partition, size_t divisor) {
+  const size_t thread_count =
+      static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(params->thread_pool)) / divisor;
+  const size_t blocked_n = (params->n + 15) / 16;  // MLAS splits N in blocks of 16 columns
+  TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(thread_count < 2, "a single thread is tuned as its own candidate");
+
+  MLAS_SGEMM_THREADING threading;
+  switch (partition) {
+    case SgemmPartition::M:
+      TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(thread_count > params->m, "more threads than rows");
+      threading.ThreadCountM = thread_count;
+      threading.ThreadCountN = 1;
+      break;
+    case SgemmPartition::N:
+      TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(thread_count > blocked_n, "more threads than column blocks");
+      threading.ThreadCountM = 1;
+      threading.ThreadCountN = thread_count;
+      break;
+    case SgemmPartition::MN: {
+      const double ratio = static_cast<double>(params->m) / static_cast<double>(blocked_n);
+      const size_t count_m = std::clamp<size_t>(
+          static_cast<size_t>(std::lround(std::sqrt(static_cast<double>(thread_count) * ratio))), 1, thread_count);
+      threading.ThreadCountM = count_m;
+      threading.ThreadCountN = thread_count / count_m;
+      TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(threading.ThreadCountM < 2 || threading.ThreadCountN < 2,
+                                                "the grid degenerates to a one dimensional split");
+      TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(threading.ThreadCountM > params->m ||
+                                                    threading.ThreadCountN > blocked_n,
+                                                "more threads than rows or column blocks");
+      break;
+    }
+  }
+
+  MlasGemmBatch(params->trans_a, params->trans_b, params->m, params->n, params->k, params->data, params->batch_size,
+                params->thread_pool, &threading);
+  return Status::OK();
+}
+
+class SgemmTunableOp : public TunableOp<SgemmParams> {
+ public:
+  SgemmTunableOp() {
+    // The partition MLAS derives from the complexity of the operation.
+    this->RegisterOp([](const SgemmParams* params) {
+      MlasGemmBatch(params->trans_a, params->trans_b, params->m, params->n, params->k, params->data,
+                    params->batch_size, params->thread_pool);
+      return Status::OK();
+    });
+
+    // Single threaded, for multiplications too small to amortize the thread pool dispatch.
+    this->RegisterOp([](const SgemmParams* params) {
+      MLAS_SGEMM_THREADING threading;
+      threading.ThreadCountM = 1;
+      threading.ThreadCountN = 1;
+      MlasGemmBatch(params->trans_a, params->trans_b, params->m, params->n, params->k, params->data,
+                    params->batch_size, params->thread_pool, &threading);
+      return Status::OK();
+    });
+
+    for (size_t divisor : {size_t{1}, size_t{2}, size_t{4}}) {
+      for (auto partition : {SgemmPartition::M, SgemmPartition::N, SgemmPartition::MN}) {
+        this->RegisterOp([partition, divisor](const SgemmParams* params) {
+          return SgemmWithPartition(params, partition, divisor);
+        });
+      }
+    }
+  }
+
+  // The candidates accumulate into C when beta is not zero, so they are tuned on a copy of the outputs.
+  const SgemmParams* PreTuning(const SgemmParams* params) override {
+    const bool reads_c = std::any_of(params->data, params->data + params->batch_size,
+                                     [](const MLAS_SGEMM_DATA_PARAMS& data) { return data.beta != 0.0f; });
+    if (!reads_c) {
+      return params;
+    }
+
+    auto* proxy = new SgemmParams(*params);
+    proxy->proxy_data.assign(params->data, params->data + params->batch_size);
+    size_t ldc = 0;
+    for (size_t i = 0; i < params->batch_size; i++) {
+      ldc = std::max(ldc, params->data[i].ldc);
+    }
+    const size_t c_size = (params->m - 1) * ldc + params->n;
+    proxy->proxy_c.resize(c_size * params->batch_size);
+    for (size_t i = 0; i < params->batch_size; i++) {
+      float* c = proxy->proxy_c.data() + i * c_size;
+      std::copy_n(params->data[i].C, (params->m - 1) * params->data[i].ldc + params->n, c);
+      proxy->proxy_data[i].C = c;
+    }
+    proxy->data = proxy->proxy_data.data();
+    return proxy;
+  }
+
+  void PostTuning(const SgemmParams* params) override {
+    if (!params->proxy_data.empty()) {
+      delete params;
+    }
+  }
+};
+
+}  // namespace
+
+CpuTuningContext* GetTuningContext(const OpKernelInfo& info) {
+  const auto* ep = info.GetExecutionProvider();
+  if (ep == nullptr || ep->Type() != kCpuExecutionProvider) {
+    return nullptr;
+  }
+  return static_cast<CpuTuningContext*>(ep->GetTuningContext());
+}
+
+Status SgemmBatch(CpuTuningContext* tuning_ctx,
+                  CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
+                  size_t M, size_t N, size_t K,
+                  const MLAS_SGEMM_DATA_PARAMS* data, size_t batch_size,
+                  concurrency::ThreadPool* thread_pool) {
+  if (tuning_ctx == nullptr || !tuning_ctx->IsTunableOpEnabled() ||
+      M == 0 || N == 0 || batch_size == 0) {
+    MlasGemmBatch(trans_a, trans_b, M, N, K, data, batch_size, thread_pool);
+    return Status::OK();
+  }
+
+  SgemmParams params;
+  params.tuning_ctx = tuning_ctx;
+  params.trans_a = trans_a;
+  params.trans_b = trans_b;
+  params.m = M;
+  params.n = N;
+  params.k = K;
+  params.data = data;
+  params.batch_size = batch_size;
+  params.thread_pool = thread_pool;
+
+  static SgemmTunableOp op;
+  return op(&params);
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
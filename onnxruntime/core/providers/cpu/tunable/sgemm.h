@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tunable/cpu_tuning_context.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+// Returns the tuning context of the CPU execution provider the kernel is assigned to, or nullptr if the kernel runs
+// on another execution provider.
+CpuTuningContext* GetTuningContext(const OpKernelInfo& info);
+
+// Runs MlasGemmBatch. If TunableOp is enabled in `tuning_ctx`, the thread partition of the multiplication is the
+// one found fastest for this shape and thread pool size, tuning it first if there is no result yet and tuning is
+// enabled. Otherwise MLAS derives the partition from the complexity of the operation.
+Status SgemmBatch(CpuTuningContext* tuning_ctx,
+                  CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
+                  size_t M, size_t N, size_t K,
+                  const MLAS_SGEMM_DATA_PARAMS* data, size_t batch_size,
+                  concurrency::ThreadPool* thread_pool);
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
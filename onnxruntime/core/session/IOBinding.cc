@@ -7,6 +7,8 @@
 #include "core/framework/op_kernel.h"
 #include "core/framework/utils.h"
 
+#include <utility>
+
 namespace onnxruntime {
 IOBinding::IOBinding(const SessionState& session_state) : session_state_(session_state) {
 }
@@ -38,6 +40,24 @@ common::Status IOBinding::BindInput(const std::string& name, const OrtValue& ml_
 
   ORT_ENFORCE(mapped_feed_names_.size() == feed_names_.size(), "Size mismatch:", mapped_feed_names_.size(), "!=", feed_names_.size(), " index=", it.first->second, " it.second=", it.second);
 
+  // Binding a state input again resets the state to the new value: the output of the last Run() is not fed, and the
+  // new value is not reused as an output buffer. The output of the last Run() may still be held by the caller, so the
+  // next output is allocated by the session instead of written to it.
+  for (auto& state : states_) {
+    if (state.input_index != it.first->second) {
+      continue;
+    }
+    if (state.output_produced) {
+      OrtValue& output = outputs_[state.output_index];
+      if (output.IsTensor()) {
+        outputs_device_info_[state.output_index] = output.Get<Tensor>().Location().device;
+      }
+      output = OrtValue();
+    }
+    state.output_produced = false;
+    state.input_produced = false;
+  }
+
   return Status::OK();
 }
 
@@ -45,6 +65,7 @@ void IOBinding::ClearInputs() {
   mapped_feed_names_.clear();
   feed_names_.clear();
   feeds_.clear();
+  states_.clear();
 }
 
 static common::Status SyncProviders(const SessionState::NameNodeInfoMapType& node_info_map,
@@ -100,6 +121,13 @@ common::Status IOBinding::BindOutputImpl(const std::string& name, const OrtValue
   }
   ORT_ENFORCE(mapped_output_names_.size() == output_names_.size(), "Size mismatch", mapped_output_names_.size(), "!=", output_names_.size());
 
+  // The value bound to a state output is written by the next Run(), it is not a state to feed.
+  for (auto& state : states_) {
+    if (state.output_index == index) {
+      state.output_produced = false;
+    }
+  }
+
   return Status::OK();
 }
 
@@ -108,6 +136,61 @@ void IOBinding::ClearOutputs() {
   output_names_.clear();
   outputs_.clear();
   outputs_device_info_.clear();
+  states_.clear();
+}
+
+common::Status IOBinding::BindOutputToInput(const std::string& output_name, const std::string& input_name) {
+  auto output = mapped_output_names_.find(output_name);
+  ORT_RETURN_IF(output == mapped_output_names_.end(), "Output '", output_name,
+                "' must be bound before it is bound to an input.");
+  auto input = mapped_feed_names_.find(input_name);
+  ORT_RETURN_IF(input == mapped_feed_names_.end(), "Input '", input_name,
+                "' must be bound to its initial value before an output is bound to it.");
+
+  for (const auto& state : states_) {
+    ORT_RETURN_IF(state.input_index == input->second, "Input '", input_name, "' is already bound to an output.");
+    ORT_RETURN_IF(state.output_index == output->second, "Output '", output_name, "' is already bound to an input.");
+  }
+
+  states_.push_back({output->second, input->second, false, false});
+  return Status::OK();
+}
+
+void IOBinding::FeedStates() {
+  for (auto& state : states_) {
+    if (!state.output_produced) {
+      continue;
+    }
+
+    OrtValue& output = outputs_[state.output_index];
+    OrtValue previous_input = std::exchange(feeds_[state.input_index], output);
+
+    // Reuse the buffer of the previous state for the next output if the state keeps its shape. Otherwise let the
+    // session allocate the output on the device the state lives on.
+    const Tensor* previous_tensor =
+        state.input_produced && previous_input.IsTensor() ? &previous_input.Get<Tensor>() : nullptr;
+    const Tensor* current_tensor = output.IsTensor() ? &output.Get<Tensor>() : nullptr;
+    if (previous_tensor != nullptr && current_tensor != nullptr &&
+        previous_tensor->DataType() == current_tensor->DataType() &&
+        previous_tensor->Shape() == current_tensor->Shape() &&
+        previous_tensor->Location().device == current_tensor->Location().device) {
+      output = std::move(previous_input);
+    } else {
+      if (current_tensor != nullptr) {
+        outputs_device_info_[state.output_index] = current_tensor->Location().device;
+      }
+      output = OrtValue();
+    }
+
+    state.output_produced = false;
+    state.input_produced = true;
+  }
+}
+
+void IOBinding::OnRunCompleted() {
+  for (auto& state : states_) {
+    state.output_produced = true;
+  }
 }
 
 const std::vector<std::string>& IOBinding::GetOutputNames() const { return output_names_; }
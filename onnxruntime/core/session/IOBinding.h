@@ -35,6 +35,10 @@ class SessionState;
  * session.Run(io_binding);
  *
  * vector<OrtValue>& outputs = io_binding->GetOutputs();
+ *
+ * For models that carry state between runs (e.g. streaming audio or RNN models with explicit state inputs and
+ * outputs), bind the initial state as an input, bind the state output, then call BindOutputToInput(). Each Run()
+ * then feeds the state produced by the previous Run() without copying it.
  */
 class IOBinding {
  public:
@@ -71,8 +75,24 @@ class IOBinding {
    */
   common::Status BindOutput(const std::string& name, OrtDevice device = {});
 
+  /**
+   * Feed an output back as an input: after each successful Run() the value of output `output_name` becomes the
+   * value of input `input_name` for the next Run(), without a copy.
+   * Both names must already be bound, the input with its initial value and the output with a value or a device.
+   * The buffers are double buffered: once the input holds a value produced by Run(), it is reused as the
+   * pre-allocated output of the next Run() if the shape of the state didn't change. The initial input value is never
+   * written to.
+   * Binding the input again with BindInput() resets the state: the next Run() uses the new value instead of the
+   * output of the last Run(). Binding the output again drops the output of the last Run() instead of feeding it.
+   * ClearInputs() and ClearOutputs() remove the state bindings.
+   */
+  common::Status BindOutputToInput(const std::string& output_name, const std::string& input_name);
+
   /**
    * This simply collects the outputs obtained after calling Run() inside the @param outputs.
+   * The values of outputs bound with BindOutputToInput() are recycled: the value returned after a Run() is the input
+   * of the next Run() and its buffer is written as the output of the Run() after that. Copy it before the second
+   * following Run() to keep it.
    */
   const std::vector<std::string>& GetOutputNames() const;
   const std::vector<OrtValue>& GetOutputs() const;
@@ -107,6 +127,14 @@ class IOBinding {
   std::vector<OrtValue> outputs_;
   std::vector<OrtDevice> outputs_device_info_;
 
+  struct StateBinding {
+    size_t output_index;
+    size_t input_index;
+    bool output_produced;  // outputs_[output_index] holds the state produced by the last Run()
+    bool input_produced;   // feeds_[input_index] was produced by a Run(), so its buffer can be reused
+  };
+  std::vector<StateBinding> states_;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IOBinding);
 
   // device info for all outputs. only used by InferenceSession if the output is not pre-allocated.
@@ -114,5 +142,10 @@ class IOBinding {
 
   // The implementation for the BindOutput() overloads
   common::Status BindOutputImpl(const std::string& name, const OrtValue& ml_value, OrtDevice device);
+
+  // Called by InferenceSession before a Run() to feed the states produced by the previous Run(), and after a
+  // successful Run() to record that the state outputs hold new values.
+  void FeedStates();
+  void OnRunCompleted();
 };
 }  // namespace onnxruntime
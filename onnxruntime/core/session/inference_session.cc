@@ -2129,6 +2129,26 @@ common::Status InferenceSession::Initialize() {
       }
     }
 
+    if (auto* cpu_ep = execution_providers_.Get(onnxruntime::kCpuExecutionProvider); cpu_ep != nullptr) {
+      auto* tuning_ctx = cpu_ep->GetTuningContext();
+      const auto& config_options = session_options_.config_options;
+      if (config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpEnable, "0") == "1") {
+        tuning_ctx->EnableTunableOp();
+      }
+      if (config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpTuningEnable, "0") == "1") {
+        tuning_ctx->EnableTuning();
+      }
+      const std::string max_tuning_duration_ms =
+          config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs, "");
+      if (!max_tuning_duration_ms.empty()) {
+        int duration_ms = 0;
+        ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale<int>(max_tuning_duration_ms, duration_ms),
+                          "Invalid value for ", kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs, ": ",
+                          max_tuning_duration_ms);
+        tuning_ctx->SetMaxTuningDurationMs(duration_ms);
+      }
+    }
+
 #if !defined(ORT_MINIMAL_BUILD)
     const std::string node_stats_file = session_options_.config_options.GetConfigOrDefault(
         kOrtSessionOptionsCollectNodeMemoryStatsToFile, "");
@@ -3326,8 +3346,11 @@ common::Status InferenceSession::NewIOBinding(std::unique_ptr<IOBinding>* io_bin
 common::Status InferenceSession::Run(const RunOptions& run_options, IOBinding& io_binding) {
   // TODO should Run() call io_binding.SynchronizeInputs() or should it let the callers do it?
   // io_binding.SynchronizeInputs();
-  return Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(), io_binding.GetOutputNames(),
-             &io_binding.GetOutputs(), &io_binding.GetOutputsDeviceInfo());
+  io_binding.FeedStates();
+  ORT_RETURN_IF_ERROR(Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(), io_binding.GetOutputNames(),
+                          &io_binding.GetOutputs(), &io_binding.GetOutputsDeviceInfo()));
+  io_binding.OnRunCompleted();
+  return Status::OK();
 }
 
 common::Status InferenceSession::Run(IOBinding& io_binding) {
@@ -943,6 +943,17 @@ ORT_API_STATUS_IMPL(OrtApis::BindOutputToDevice, _Inout_ OrtIoBinding* binding_p
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::BindOutputToInput, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* output_name,
+                    _In_ const char* input_name) {
+  API_IMPL_BEGIN
+  auto st = binding_ptr->binding_->BindOutputToInput(output_name, input_name);
+  if (!st.IsOK()) {
+    return ToOrtStatus(st);
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::GetBoundOutputNames, _In_ const OrtIoBinding* binding_ptr, _In_ OrtAllocator* allocator,
                     _Out_ char** buffer, _Outptr_result_maybenull_ size_t** lengths, _Out_ size_t* count) {
   API_IMPL_BEGIN
@@ -3539,6 +3550,7 @@ static constexpr OrtApi ort_api_1_to_23 = {
     &OrtApis::Node_GetImplicitInputs,
     &OrtApis::Node_GetSubgraphs,
     &OrtApis::Node_GetParentGraph,
+    &OrtApis::BindOutputToInput,
 
 };
 
@@ -666,4 +666,7 @@ ORT_API_STATUS_IMPL(Node_GetSubgraphs, _In_ const OrtNode* node, _Outptr_ OrtArr
 ORT_API_STATUS_IMPL(Node_GetParentGraph, _In_ const OrtNode* node,
                     _Outptr_result_maybenull_ const OrtGraph** parent_graph);
 
+ORT_API_STATUS_IMPL(BindOutputToInput, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* output_name,
+                    _In_ const char* input_name);
+
 }  // namespace OrtApis
@@ -839,6 +839,18 @@ class IOBinding:
         """
         self._iobinding.bind_ortvalue_output(name, ortvalue._ortvalue)
 
+    def bind_output_to_input(self, output_name, input_name):
+        """
+        Feeds the value of an output back to an input on the next run, without copying it. This carries state between
+        runs of streaming models with explicit state inputs and outputs. Both names must already be bound: the input
+        with its initial state and the output with a device or an OrtValue. Binding the input again resets the state.
+        The output values returned after a run are overwritten two runs later, copy them to keep them.
+
+        :param output_name: name of the state output
+        :param input_name: name of the state input
+        """
+        self._iobinding.bind_output_to_input(output_name, input_name)
+
     def synchronize_outputs(self):
         self._iobinding.synchronize_outputs()
 
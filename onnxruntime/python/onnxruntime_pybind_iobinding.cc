@@ -167,6 +167,13 @@ void addIoBindingMethods(pybind11::module& m) {
           throw std::runtime_error("Error when binding output: " + status.ErrorMessage());
         }
       })
+      // Feeds the value of an output to an input on the next run, for state carried between runs.
+      .def("bind_output_to_input", [](SessionIOBinding* io_binding, const std::string& output_name, const std::string& input_name) -> void {
+        auto status = io_binding->Get()->BindOutputToInput(output_name, input_name);
+        if (!status.IsOK()) {
+          throw std::runtime_error("Error when binding output to input: " + status.ErrorMessage());
+        }
+      })
       .def("synchronize_outputs", [](SessionIOBinding* io_binding) -> void {
         auto status = io_binding->Get()->SynchronizeOutputs();
         if (!status.IsOK()) {
@@ -295,7 +295,8 @@ def parse_arguments(argv: list[str] | None = None) -> argparse.Namespace:
         required=False,
         action="store_true",
         help="Uses `DecoderMaskedSelfAttention` or `DecoderMaskedMultiHeadAttention` to optimize the decoding Attention computation. "
-        "Must be used with `past_present_share_buffer`. Currently, only Attention head sizes of 32, 64 and 128 are supported.",
+        "Must be used with `past_present_share_buffer`. Currently, only Attention head sizes of 32, 64 and 128 are supported. "
+        "Requires `use_gpu` for gpt2.",
     )
     model_group.set_defaults(use_decoder_masked_attention=False)
 
@@ -2601,10 +2602,10 @@ def convert_generation_model(
     if args.use_decoder_masked_attention and not past_present_share_buffer:
         raise ValueError("`past_present_share_buffer` MUST be turned on to use `use_decoder_masked_attention`")
 
-    # For any kind of sampling, using decoder masked multihead attention is only supported
-    # on GPUs
-    if args.use_decoder_masked_attention and not args.use_gpu:
-        raise ValueError("`use_decoder_masked_attention` option is only supported on GPUs")
+    # DecoderMaskedSelfAttention used by gpt2 is only supported on GPUs, while DecoderMaskedMultiHeadAttention used by
+    # encoder-decoder models also has a CPU kernel
+    if args.use_decoder_masked_attention and is_gpt2 and not args.use_gpu:
+        raise ValueError("`use_decoder_masked_attention` option is only supported on GPUs for gpt2")
 
     if is_gpt2:
         if args.decoder_onnx and os.path.exists(args.decoder_onnx):
@@ -2867,10 +2868,12 @@ def convert_generation_model(
             else:
                 logger.info("*****DecoderMaskedMultiHeadAttention is not applied to T5 decoder*****")
 
-            if pack_qkv_for_decoder_masked_mha(decoder_model):
-                logger.info("*****pack qkv for decoder masked mha successfully!!!*****")
-            else:
-                logger.info("*****pack qkv for decoder masked mha failed!!!*****")
+            # The CPU kernel of DecoderMaskedMultiHeadAttention takes separate query, key and value
+            if args.use_gpu:
+                if pack_qkv_for_decoder_masked_mha(decoder_model):
+                    logger.info("*****pack qkv for decoder masked mha successfully!!!*****")
+                else:
+                    logger.info("*****pack qkv for decoder masked mha failed!!!*****")
 
         if not args.disable_shared_initializers:
             # Unique shared initializers from the decoder and decoder_init could reduce memory usage in inference.
@@ -3335,6 +3338,7 @@ def test_gpt_model(
         is_same = torch_decoded_sequences == ort_decoded_sequences
         print("Torch and ORT result is", "same" if is_same else "different")
         output["parity"] = is_same
+        output["decoded_sequences"] = ort_decoded_sequences
 
     if args.torch_performance:
         torch_latency_output = test_torch_performance(
@@ -3525,6 +3529,7 @@ def test_t5_model(args: argparse.Namespace, sentences: list[str] | None = None):
         is_same = torch_decoded_sequences == ort_decoded_sequences
         print("Torch and ORT result is ", "same" if is_same else "different")
         output["parity"] = is_same
+        output["decoded_sequences"] = ort_decoded_sequences
 
     if args.torch_performance:
         torch_latency_output = test_torch_performance(
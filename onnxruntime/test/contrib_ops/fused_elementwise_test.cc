@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Returns the elements of a broadcast to shape dims, with a of shape a_dims.
+std::vector<float> Broadcast(const std::vector<float>& a, const std::vector<int64_t>& a_dims,
+                             const std::vector<int64_t>& dims) {
+  int64_t size = 1;
+  for (int64_t dim : dims) {
+    size *= dim;
+  }
+
+  std::vector<float> result(static_cast<size_t>(size));
+  const size_t offset = dims.size() - a_dims.size();
+  for (int64_t i = 0; i < size; i++) {
+    int64_t index = i;
+    int64_t a_index = 0;
+    int64_t a_stride = 1;
+    for (size_t d = dims.size(); d-- > 0;) {
+      const int64_t position = index % dims[d];
+      index /= dims[d];
+      if (d >= offset) {
+        const int64_t a_dim = a_dims[d - offset];
+        a_index += (a_dim == 1 ? 0 : position) * a_stride;
+        a_stride *= a_dim;
+      }
+    }
+    result[static_cast<size_t>(i)] = a[static_cast<size_t>(a_index)];
+  }
+  return result;
+}
+
+float Gelu(float x) {
+  return 0.5f * x * (1.0f + std::erf(x * static_cast<float>(M_SQRT1_2)));
+}
+
+float Sigmoid(float x) {
+  return 1.0f / (1.0f + std::exp(-x));
+}
+
+}  // namespace
+
+// y = (x * w + b) * Sigmoid(x * w + b), with w and b broadcast along the rows of x.
+TEST(FusedElementwiseTest, SwishWithBroadcastInputs) {
+  RandomValueGenerator random{};
+  const std::vector<int64_t> x_dims{3, 5, 700};
+  const std::vector<int64_t> w_dims{5, 1};
+  const std::vector<int64_t> b_dims{700};
+  const std::vector<float> x = random.Uniform<float>(x_dims, -2.0f, 2.0f);
+  const std::vector<float> w = random.Uniform<float>(w_dims, -2.0f, 2.0f);
+  const std::vector<float> b = random.Uniform<float>(b_dims, -1.0f, 1.0f);
+
+  const std::vector<float> w_broadcast = Broadcast(w, w_dims, x_dims);
+  const std::vector<float> b_broadcast = Broadcast(b, b_dims, x_dims);
+  std::vector<float> expected(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    const float y = x[i] * w_broadcast[i] + b_broadcast[i];
+    expected[i] = y * Sigmoid(y);
+  }
+
+  OpTester tester("FusedElementwise", 1, onnxruntime::kMSDomain);
+  // Values 0-2 are the inputs, values 3-6 the results of the instructions.
+  tester.AddAttribute("ops", std::vector<std::string>{"Mul", "Add", "Sigmoid", "Mul"});
+  tester.AddAttribute("operands", std::vector<int64_t>{0, 1, 3, 2, 4, -1, 4, 5});
+  tester.AddInput<float>("x", x_dims, x);
+  tester.AddInput<float>("w", w_dims, w);
+  tester.AddInput<float>("b", b_dims, b);
+  tester.AddOutput<float>("y", x_dims, expected);
+  tester.SetOutputTolerance(0.0001f);
+  tester.Run();
+}
+
+// y = Gelu(x + b) * 0.5 - s, with the constant 0.5 and the scalar input s.
+TEST(FusedElementwiseTest, GeluWithConstants) {
+  RandomValueGenerator random{};
+  const std::vector<int64_t> x_dims{4, 1000};
+  const std::vector<int64_t> b_dims{1000};
+  const std::vector<float> x = random.Uniform<float>(x_dims, -3.0f, 3.0f);
+  const std::vector<float> b = random.Uniform<float>(b_dims, -1.0f, 1.0f);
+  const float s = 0.25f;
+
+  std::vector<float> expected(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    expected[i] = Gelu(x[i] + b[i % b.size()]) * 0.5f - s;
+  }
+
+  OpTester tester("FusedElementwise", 1, onnxruntime::kMSDomain);
+  // Values 0-2 are the inputs, value 3 the constant, values 4-7 the results of the instructions.
+  tester.AddAttribute("ops", std::vector<std::string>{"Add", "Gelu", "Mul", "Sub"});
+  tester.AddAttribute("operands", std::vector<int64_t>{0, 1, 4, -1, 5, 3, 6, 2});
+  tester.AddAttribute("constants", std::vector<float>{0.5f});
+  tester.AddInput<float>("x", x_dims, x);
+  tester.AddInput<float>("b", b_dims, b);
+  tester.AddInput<float>("s", {}, {s});
+  tester.AddOutput<float>("y", x_dims, expected);
+  tester.SetOutputTolerance(0.0001f);
+  tester.Run();
+}
+
+// The output shape is the broadcast of inputs that each have a dimension of size 1.
+TEST(FusedElementwiseTest, OuterBroadcast) {
+  const std::vector<float> a{1.0f, -2.0f, 3.0f};
+  const std::vector<float> b{0.5f, 1.0f, -1.5f, 2.0f};
+
+  std::vector<float> expected;
+  for (float a_value : a) {
+    for (float b_value : b) {
+      expected.push_back(std::max(std::tanh(a_value - b_value), 0.0f) + std::sqrt(std::exp(-b_value)));
+    }
+  }
+
+  OpTester tester("FusedElementwise", 1, onnxruntime::kMSDomain);
+  // Relu(Tanh(a - b)) + Sqrt(Exp(Neg(b))).
+  tester.AddAttribute("ops", std::vector<std::string>{"Sub", "Tanh", "Relu", "Neg", "Exp", "Sqrt", "Add"});
+  tester.AddAttribute("operands", std::vector<int64_t>{0, 1, 2, -1, 3, -1, 1, -1, 5, -1, 6, -1, 4, 7});
+  tester.AddInput<float>("a", {3, 1}, a);
+  tester.AddInput<float>("b", {1, 4}, b);
+  tester.AddOutput<float>("y", {3, 4}, expected);
+  tester.SetOutputTolerance(0.0001f);
+  tester.Run();
+}
+
+// y = x * Sigmoid(b * 2) + Exp(Neg(b)) * Sqrt(s + (2 + 1)). The instructions that only read b, s or the constants
+// are evaluated before the tiles, on the elements of b and s.
+TEST(FusedElementwiseTest, BroadcastInputSubexpressions) {
+  RandomValueGenerator random{};
+  const std::vector<int64_t> x_dims{6, 500};
+  const std::vector<int64_t> b_dims{500};
+  const std::vector<float> x = random.Uniform<float>(x_dims, -2.0f, 2.0f);
+  const std::vector<float> b = random.Uniform<float>(b_dims, -2.0f, 2.0f);
+  const float s = 1.5f;
+
+  std::vector<float> expected(x.size());
+  for (size_t i = 0; i < x.size(); i++) {
+    const float b_value = b[i % b.size()];
+    expected[i] = x[i] * Sigmoid(b_value * 2.0f) + std::exp(-b_value) * std::sqrt(s + 3.0f);
+  }
+
+  OpTester tester("FusedElementwise", 1, onnxruntime::kMSDomain);
+  // Values 0-2 are the inputs, values 3-4 the constants, values 5-14 the results of the instructions.
+  tester.AddAttribute("ops", std::vector<std::string>{"Add", "Mul", "Sigmoid", "Mul", "Neg", "Exp", "Add", "Sqrt",
+                                                      "Mul", "Add"});
+  tester.AddAttribute("operands", std::vector<int64_t>{3, 4, 1, 3, 6, -1, 0, 7, 1, -1, 9, -1, 2, 5, 11, -1, 10, 12,
+                                                       8, 13});
+  tester.AddAttribute("constants", std::vector<float>{2.0f, 1.0f});
+  tester.AddInput<float>("x", x_dims, x);
+  tester.AddInput<float>("b", b_dims, b);
+  tester.AddInput<float>("s", {}, {s});
+  tester.AddOutput<float>("y", x_dims, expected);
+  tester.SetOutputTolerance(0.0001f);
+  tester.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
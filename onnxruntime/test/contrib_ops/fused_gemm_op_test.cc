@@ -0,0 +1,143 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+enum class FusedGemmBias {
+  None,
+  Scalar,  // C shape is {1}
+  Row,     // C shape is {N}
+  Full,    // C shape is {M, N}
+};
+
+// Runs FusedGemm with A {M, K} and B {K, N} and compares with a reference computed here.
+void RunFusedGemmTest(int64_t M, int64_t N, int64_t K, float beta, FusedGemmBias bias_type,
+                      const std::string& activation, const std::vector<float>& activation_params,
+                      bool b_is_initializer, const std::function<float(float)>& activation_fn) {
+  std::vector<float> a(M * K);
+  std::vector<float> b(K * N);
+  for (size_t i = 0; i < a.size(); i++) {
+    a[i] = static_cast<float>(static_cast<int>(i % 11) - 5) * 0.25f;
+  }
+  for (size_t i = 0; i < b.size(); i++) {
+    b[i] = static_cast<float>(static_cast<int>(i % 7) - 3) * 0.5f;
+  }
+
+  std::vector<int64_t> c_dims;
+  switch (bias_type) {
+    case FusedGemmBias::None:
+      break;
+    case FusedGemmBias::Scalar:
+      c_dims = {1};
+      break;
+    case FusedGemmBias::Row:
+      c_dims = {N};
+      break;
+    case FusedGemmBias::Full:
+      c_dims = {M, N};
+      break;
+  }
+
+  std::vector<float> c;
+  if (bias_type != FusedGemmBias::None) {
+    const int64_t c_size = bias_type == FusedGemmBias::Scalar ? 1 : (bias_type == FusedGemmBias::Row ? N : M * N);
+    c.resize(c_size);
+    for (size_t i = 0; i < c.size(); i++) {
+      c[i] = static_cast<float>(static_cast<int>(i % 5) - 2) * 0.75f;
+    }
+  }
+
+  std::vector<float> expected(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += a[m * K + k] * b[k * N + n];
+      }
+      switch (bias_type) {
+        case FusedGemmBias::None:
+          break;
+        case FusedGemmBias::Scalar:
+          sum += beta * c[0];
+          break;
+        case FusedGemmBias::Row:
+          sum += beta * c[n];
+          break;
+        case FusedGemmBias::Full:
+          sum += beta * c[m * N + n];
+          break;
+      }
+      expected[m * N + n] = activation_fn(sum);
+    }
+  }
+
+  OpTester test("FusedGemm", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("transA", static_cast<int64_t>(0));
+  test.AddAttribute("transB", static_cast<int64_t>(0));
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", beta);
+  test.AddAttribute("activation", activation);
+  if (activation_params.size() > 0) {
+    test.AddAttribute("activation_alpha", activation_params[0]);
+  }
+  if (activation_params.size() > 1) {
+    test.AddAttribute("activation_beta", activation_params[1]);
+  }
+
+  test.AddInput<float>("A", {M, K}, a);
+  test.AddInput<float>("B", {K, N}, b, b_is_initializer);
+  if (bias_type != FusedGemmBias::None) {
+    test.AddInput<float>("C", c_dims, c);
+  }
+  test.AddOutput<float>("Y", {M, N}, expected);
+  test.SetOutputTolerance(1e-4f);
+  test.Run();
+}
+
+float Relu(float x) { return std::max(x, 0.0f); }
+
+}  // namespace
+
+TEST(FusedGemmOpTest, RowBiasRelu) {
+  for (bool b_is_initializer : {false, true}) {
+    RunFusedGemmTest(3, 5, 4, 1.0f, FusedGemmBias::Row, "Relu", {}, b_is_initializer, Relu);
+    RunFusedGemmTest(1, 37, 19, 1.0f, FusedGemmBias::Row, "Relu", {}, b_is_initializer, Relu);
+    RunFusedGemmTest(70, 300, 33, 1.0f, FusedGemmBias::Row, "Relu", {}, b_is_initializer, Relu);
+  }
+}
+
+TEST(FusedGemmOpTest, FullBiasLeakyRelu) {
+  auto leaky_relu = [](float x) { return x >= 0.0f ? x : x * 0.1f; };
+  for (bool b_is_initializer : {false, true}) {
+    RunFusedGemmTest(4, 9, 6, 1.0f, FusedGemmBias::Full, "LeakyRelu", {0.1f}, b_is_initializer, leaky_relu);
+    RunFusedGemmTest(65, 130, 40, 1.0f, FusedGemmBias::Full, "LeakyRelu", {0.1f}, b_is_initializer, leaky_relu);
+  }
+}
+
+TEST(FusedGemmOpTest, BroadcastBiasSigmoid) {
+  auto sigmoid = [](float x) { return 1.0f / (1.0f + std::exp(-x)); };
+  RunFusedGemmTest(5, 7, 3, 1.0f, FusedGemmBias::Scalar, "Sigmoid", {}, false, sigmoid);
+  RunFusedGemmTest(5, 7, 3, 0.5f, FusedGemmBias::Row, "Sigmoid", {}, false, sigmoid);
+  RunFusedGemmTest(5, 7, 3, 0.5f, FusedGemmBias::Full, "Sigmoid", {}, true, sigmoid);
+  RunFusedGemmTest(5, 7, 3, 1.0f, FusedGemmBias::None, "Sigmoid", {}, true, sigmoid);
+}
+
+// Elu is not supported by the MLAS epilogue and runs as a separate pass over the output.
+TEST(FusedGemmOpTest, RowBiasElu) {
+  auto elu = [](float x) { return x > 0.0f ? x : 0.5f * (std::exp(x) - 1.0f); };
+  RunFusedGemmTest(6, 10, 8, 1.0f, FusedGemmBias::Row, "Elu", {0.5f}, false, elu);
+  RunFusedGemmTest(6, 10, 8, 1.0f, FusedGemmBias::Row, "Elu", {0.5f}, true, elu);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -1,11 +1,17 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 #include "gtest/gtest.h"
 #include <gsl/gsl>
+#include "core/graph/model.h"
+#include "core/graph/onnx_protobuf.h"
 #include "core/session/onnxruntime_cxx_api.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/common/cuda_op_test_utils.h"
 
 #ifdef USE_CUDA
@@ -17,6 +23,69 @@ extern std::unique_ptr<Ort::Env> ort_env;
 namespace onnxruntime {
 namespace test {
 
+namespace {
+
+// Returns the serialized testdata/transformers/tiny_gpt2_greedysearch_with_init_decoder.onnx with the given int
+// attributes of its GreedySearch node set.
+std::string LoadGreedySearchModel(const std::vector<std::pair<std::string, int64_t>>& attributes) {
+  ONNX_NAMESPACE::ModelProto model_proto;
+  ORT_THROW_IF_ERROR(Model::Load(ORT_TSTR("testdata/transformers/tiny_gpt2_greedysearch_with_init_decoder.onnx"),
+                                 model_proto));
+  for (auto& node : *model_proto.mutable_graph()->mutable_node()) {
+    if (node.op_type() != "GreedySearch") {
+      continue;
+    }
+
+    for (const auto& [name, value] : attributes) {
+      auto& node_attributes = *node.mutable_attribute();
+      auto it = std::find_if(node_attributes.begin(), node_attributes.end(),
+                             [&name = name](const ONNX_NAMESPACE::AttributeProto& attribute) {
+                               return attribute.name() == name;
+                             });
+      ONNX_NAMESPACE::AttributeProto* attribute = it != node_attributes.end() ? &*it : node.add_attribute();
+      attribute->set_name(name);
+      attribute->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_INT);
+      attribute->set_i(value);
+    }
+  }
+
+  std::string model_data;
+  model_proto.SerializeToString(&model_data);
+  return model_data;
+}
+
+// Runs the greedy search model on input_ids of shape (batch_size, input_ids.size() / batch_size) and returns the
+// sequences.
+std::vector<int32_t> RunGreedySearch(Ort::Session& session, std::vector<int32_t> input_ids, int64_t batch_size,
+                                     int32_t max_length) {
+  std::vector<int64_t> input_ids_shape{batch_size, static_cast<int64_t>(input_ids.size()) / batch_size};
+  std::vector<int64_t> parameter_shape{1};
+  std::vector<int32_t> max_length_data{max_length};
+  std::vector<int32_t> min_length_data{1};
+  std::vector<float> repetition_penalty{1.0f};
+
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  std::vector<Ort::Value> ort_inputs;
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, input_ids.data(), input_ids.size(), input_ids_shape.data(), input_ids_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, max_length_data.data(), max_length_data.size(), parameter_shape.data(), parameter_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, min_length_data.data(), min_length_data.size(), parameter_shape.data(), parameter_shape.size()));
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, repetition_penalty.data(), repetition_penalty.size(), parameter_shape.data(), parameter_shape.size()));
+  const char* input_names[] = {"input_ids", "max_length", "min_length", "repetition_penalty"};
+  const char* const output_names[] = {"sequences"};
+
+  auto ort_outputs = session.Run(Ort::RunOptions{}, input_names, ort_inputs.data(), ort_inputs.size(),
+                                 output_names, 1);
+  const auto& sequences = ort_outputs[0];
+  const auto* result_vals = sequences.GetTensorData<int32_t>();
+  return std::vector<int32_t>(result_vals, result_vals + sequences.GetTensorTypeAndShapeInfo().GetElementCount());
+}
+
+}  // namespace
+
 TEST(GreedySearchTest, GptGreedySearchFp16_VocabPadded) {
   std::vector<int64_t> input_ids_shape{2, 4};
   std::vector<int32_t> input_ids{
@@ -183,5 +252,94 @@ TEST(GreedySearchTest, GptGreedySearchFp32) {
   }
 }
 
+// A prompt whose past state is reused from the prefix cache, skipping the init decoder run, generates the same
+// sequence as without the cache.
+TEST(GreedySearchTest, GptGreedySearchFp32_PrefixCache) {
+  constexpr int32_t max_length = 30;
+  const std::vector<int32_t> prompt{52, 195, 731, 114, 204, 321, 17, 88, 402, 5,
+                                    613, 77, 290, 146, 930, 61, 505, 248, 19, 700};
+  std::vector<int32_t> shared_prefix_prompt(prompt.begin(), prompt.begin() + 18);
+  shared_prefix_prompt.push_back(43);
+  shared_prefix_prompt.push_back(861);
+  shared_prefix_prompt.push_back(9);
+
+  const ORTCHAR_T* model_path = ORT_TSTR("testdata/transformers/tiny_gpt2_greedysearch_with_init_decoder.onnx");
+  Ort::Session session(*ort_env, model_path, Ort::SessionOptions{});
+  const std::vector<int32_t> expected = RunGreedySearch(session, prompt, 1, max_length);
+  const std::vector<int32_t> shared_prefix_expected = RunGreedySearch(session, shared_prefix_prompt, 1, max_length);
+
+  Ort::SessionOptions session_options;
+  session_options.AddConfigEntry(kOrtSessionOptionsGenerationPrefixCacheSizeInBytes, "1048576");
+  Ort::Session cached_session(*ort_env, model_path, session_options);
+
+  // The first run fills the cache, the second one reuses all but the last prompt token.
+  EXPECT_EQ(RunGreedySearch(cached_session, prompt, 1, max_length), expected);
+  EXPECT_EQ(RunGreedySearch(cached_session, prompt, 1, max_length), expected);
+  EXPECT_EQ(RunGreedySearch(cached_session, shared_prefix_prompt, 1, max_length), shared_prefix_expected);
+}
+
+// Rows that finish before the others are dropped from the decoder batch. The remaining rows generate the same
+// sequences as when each row runs alone, which never drops rows.
+TEST(GreedySearchTest, GptGreedySearchFp32_RowsFinishAtDifferentSteps) {
+  constexpr int32_t max_length = 10;
+  constexpr int32_t eos_token_id = 114;
+  const std::vector<std::vector<int32_t>> rows{
+      {0, 0, 0, 52},
+      {0, 0, 195, 731},
+      {0, 195, 731, 731}};
+
+  const std::string model_data = LoadGreedySearchModel({{"eos_token_id", eos_token_id}});
+  Ort::Session session(*ort_env, model_data.data(), model_data.size(), Ort::SessionOptions{});
+
+  std::vector<int32_t> input_ids;
+  for (const auto& row : rows) {
+    input_ids.insert(input_ids.end(), row.begin(), row.end());
+  }
+  const std::vector<int32_t> sequences = RunGreedySearch(session, input_ids, static_cast<int64_t>(rows.size()),
+                                                         max_length);
+  ASSERT_EQ(sequences.size(), rows.size() * max_length);
+
+  // The second row generates 731, 114 and finishes while the first one runs to max_length.
+  EXPECT_EQ(sequences[max_length + 5], eos_token_id);
+  EXPECT_EQ(std::count(sequences.begin(), sequences.begin() + max_length, eos_token_id), 0);
+
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const std::vector<int32_t> expected = RunGreedySearch(session, rows[i], 1, max_length);
+    const std::vector<int32_t> row_sequence(sequences.begin() + i * max_length,
+                                            sequences.begin() + (i + 1) * max_length);
+    EXPECT_EQ(row_sequence, expected) << "row " << i;
+  }
+}
+
+// Prompt lookup decoding keeps the draft tokens that match the greedy tokens and drops the others from the past
+// state, so it generates the same sequences as decoding one token per run.
+TEST(GreedySearchTest, GptGreedySearchFp32_PromptLookup) {
+  constexpr int32_t max_length = 32;
+  // The prompts repeat n-grams with different continuations, e.g. 52 204 followed by 17 and by 204, so drafts copied
+  // from the prompt are partly rejected, while drafts copied from the repetitive generated tokens are accepted.
+  const std::vector<std::vector<int32_t>> prompts{
+      {52, 204, 17, 88, 402, 52, 204, 204, 731, 52},
+      {195, 731, 731, 114, 195, 731, 321, 114, 114, 195, 731}};
+
+  const std::string model_data = LoadGreedySearchModel({{"prompt_lookup_num_tokens", 0}});
+  Ort::Session session(*ort_env, model_data.data(), model_data.size(), Ort::SessionOptions{});
+  std::vector<std::vector<int32_t>> expected;
+  for (const auto& prompt : prompts) {
+    expected.push_back(RunGreedySearch(session, prompt, 1, max_length));
+  }
+
+  // 30 draft tokens exceed the room left before max_length, which limits the drafts instead.
+  for (int64_t prompt_lookup_num_tokens : {1, 4, 30}) {
+    const std::string lookup_model_data = LoadGreedySearchModel({{"prompt_lookup_num_tokens",
+                                                                  prompt_lookup_num_tokens}});
+    Ort::Session lookup_session(*ort_env, lookup_model_data.data(), lookup_model_data.size(),
+                                Ort::SessionOptions{});
+    for (size_t i = 0; i < prompts.size(); ++i) {
+      EXPECT_EQ(RunGreedySearch(lookup_session, prompts[i], 1, max_length), expected[i])
+          << "prompt " << i << ", prompt_lookup_num_tokens " << prompt_lookup_num_tokens;
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
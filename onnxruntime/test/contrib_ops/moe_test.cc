@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 #include "gtest/gtest.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
@@ -20,7 +23,8 @@ static void RunMoETest(const std::vector<float>& input, const std::vector<float>
   constexpr int max_cuda_arch = 900;
 
   bool enable_cuda = HasCudaEnvironment(min_cuda_arch) && !NeedSkipIfCudaArchGreaterEqualThan(max_cuda_arch);
-  if (enable_cuda) {
+  bool enable_cpu = (nullptr != DefaultCpuExecutionProvider().get()) && !use_float16;
+  if (enable_cuda || enable_cpu) {
     OpTester tester("MoE", 1, onnxruntime::kMSDomain);
     tester.AddAttribute<int64_t>("k", static_cast<int64_t>(top_k));
     tester.AddAttribute<std::string>("activation_type", activation_type);
@@ -77,9 +81,17 @@ static void RunMoETest(const std::vector<float>& input, const std::vector<float>
       tester.SetOutputTolerance(0.001f);
     }
 
-    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
-    execution_providers.push_back(DefaultCudaExecutionProvider());
-    tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+    if (enable_cuda) {
+      std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+      execution_providers.push_back(DefaultCudaExecutionProvider());
+      tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+    }
+
+    if (enable_cpu) {
+      std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+      execution_providers.push_back(DefaultCpuExecutionProvider());
+      tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+    }
   }
 }
 
@@ -132,6 +144,150 @@ static void RunQMoETest(const std::vector<float>& input, const std::vector<float
   }
 }
 
+// The CPU kernel takes the row major (K, N) weights of each expert as unsigned values with an implicit zero point,
+// rather than the weights preprocessed for the CUDA kernels, so the expected output is computed from the
+// dequantized weights.
+static void RunQMoECpuTest(int expert_weight_bits, int num_rows, int num_experts, int hidden_size, int inter_size,
+                           const std::string& activation_type, int top_k, int normalize_routing_weights,
+                           bool use_fc3, bool use_bias) {
+  RandomValueGenerator random{};
+  const int zero_point = expert_weight_bits == 4 ? 8 : 128;
+  const float max_scale = expert_weight_bits == 4 ? 0.05f : 0.005f;
+
+  struct FcLayer {
+    std::vector<uint8_t> weights;
+    std::vector<float> scales;
+    std::vector<float> bias;
+    std::vector<float> dequantized_weights;
+  };
+
+  const auto make_fc = [&](int k, int n) {
+    FcLayer fc;
+    const std::vector<int32_t> values = random.Uniform<int32_t>(std::vector<int64_t>{num_experts, k, n}, 0,
+                                                                1 << expert_weight_bits);
+    fc.scales = random.Uniform<float>(std::vector<int64_t>{num_experts, n}, max_scale / 2, max_scale);
+    if (use_bias) {
+      fc.bias = random.Uniform<float>(std::vector<int64_t>{num_experts, n}, -0.5f, 0.5f);
+    }
+    fc.weights.resize(values.size() * expert_weight_bits / 8);
+    fc.dequantized_weights.resize(values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+      const size_t expert = i / (static_cast<size_t>(k) * n);
+      const size_t column = i % n;
+      fc.dequantized_weights[i] = static_cast<float>(values[i] - zero_point) * fc.scales[expert * n + column];
+      if (expert_weight_bits == 4) {
+        fc.weights[i / 2] |= static_cast<uint8_t>(values[i] << ((i % 2) * 4));
+      } else {
+        fc.weights[i] = static_cast<uint8_t>(values[i]);
+      }
+    }
+    return fc;
+  };
+
+  const std::vector<float> input = random.Uniform<float>(std::vector<int64_t>{num_rows, hidden_size}, -1.0f, 1.0f);
+  const std::vector<float> router_probs =
+      random.Uniform<float>(std::vector<int64_t>{num_rows, num_experts}, -2.0f, 2.0f);
+  const FcLayer fc1 = make_fc(hidden_size, inter_size);
+  const FcLayer fc2 = make_fc(inter_size, hidden_size);
+  const FcLayer fc3 = use_fc3 ? make_fc(hidden_size, inter_size) : FcLayer{};
+
+  const auto fc_row = [](const FcLayer& fc, int expert, const float* x, int k, int n) {
+    std::vector<float> y(n);
+    for (int j = 0; j < n; j++) {
+      float sum = fc.bias.empty() ? 0.0f : fc.bias[expert * n + j];
+      for (int i = 0; i < k; i++) {
+        sum += x[i] * fc.dequantized_weights[(static_cast<size_t>(expert) * k + i) * n + j];
+      }
+      y[j] = sum;
+    }
+    return y;
+  };
+
+  std::vector<float> output(static_cast<size_t>(num_rows) * hidden_size, 0.0f);
+  for (int row = 0; row < num_rows; row++) {
+    const float* logits = router_probs.data() + row * num_experts;
+    const float max_logit = *std::max_element(logits, logits + num_experts);
+    std::vector<float> probs(num_experts);
+    float sum = 0.0f;
+    for (int e = 0; e < num_experts; e++) {
+      probs[e] = std::exp(logits[e] - max_logit);
+      sum += probs[e];
+    }
+
+    std::vector<int> experts(num_experts);
+    std::iota(experts.begin(), experts.end(), 0);
+    std::stable_sort(experts.begin(), experts.end(), [&](int a, int b) { return probs[a] > probs[b]; });
+
+    float selected_sum = 0.0f;
+    for (int k_idx = 0; k_idx < top_k; k_idx++) {
+      selected_sum += probs[experts[k_idx]] / sum;
+    }
+
+    const float* x = input.data() + row * hidden_size;
+    for (int k_idx = 0; k_idx < top_k; k_idx++) {
+      const int e = experts[k_idx];
+      float weight = probs[e] / sum;
+      if (normalize_routing_weights) {
+        weight /= selected_sum;
+      }
+
+      std::vector<float> h = fc_row(fc1, e, x, hidden_size, inter_size);
+      const std::vector<float> gate = use_fc3 ? fc_row(fc3, e, x, hidden_size, inter_size) : std::vector<float>{};
+      for (int j = 0; j < inter_size; j++) {
+        if (activation_type == "relu") {
+          h[j] = std::max(h[j], 0.0f);
+        } else if (activation_type == "silu") {
+          h[j] = h[j] / (1.0f + std::exp(-h[j]));
+        }
+        if (use_fc3) {
+          h[j] *= gate[j];
+        }
+      }
+
+      const std::vector<float> y = fc_row(fc2, e, h.data(), inter_size, hidden_size);
+      for (int j = 0; j < hidden_size; j++) {
+        output[row * hidden_size + j] += weight * y[j];
+      }
+    }
+  }
+
+  const int pack_size = 8 / expert_weight_bits;
+
+  // Constant weights are packed by the kernel, other weights are dequantized when the op runs.
+  for (bool weights_are_initializers : {false, true}) {
+    OpTester tester("QMoE", 1, onnxruntime::kMSDomain);
+    tester.AddAttribute<int64_t>("k", static_cast<int64_t>(top_k));
+    tester.AddAttribute<std::string>("activation_type", activation_type);
+    tester.AddAttribute<int64_t>("normalize_routing_weights", static_cast<int64_t>(normalize_routing_weights));
+    tester.AddAttribute<int64_t>("expert_weight_bits", static_cast<int64_t>(expert_weight_bits));
+
+    const auto add_fc = [&](const char* weights_name, const char* scales_name, const char* bias_name,
+                            const FcLayer& fc, int k, int n) {
+      tester.AddInput<uint8_t>(weights_name, {num_experts, k, n / pack_size}, fc.weights, weights_are_initializers);
+      tester.AddInput<float>(scales_name, {num_experts, n}, fc.scales);
+      if (use_bias) {
+        tester.AddInput<float>(bias_name, {num_experts, n}, fc.bias);
+      } else {
+        tester.AddOptionalInputEdge<float>();
+      }
+    };
+
+    tester.AddInput<float>("input", {num_rows, hidden_size}, input);
+    tester.AddInput<float>("router_probs", {num_rows, num_experts}, router_probs);
+    add_fc("fc1_experts_weights", "fc1_scales", "fc1_experts_bias", fc1, hidden_size, inter_size);
+    add_fc("fc2_experts_weights", "fc2_scales", "fc2_experts_bias", fc2, inter_size, hidden_size);
+    if (use_fc3) {
+      add_fc("fc3_experts_weights", "fc3_scales", "fc3_experts_bias", fc3, hidden_size, inter_size);
+    }
+    tester.AddOutput<float>("output", {num_rows, hidden_size}, output);
+    tester.SetOutputTolerance(0.001f);
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
+}
+
 TEST(MoETest, MoETest_Gelu) {
   int num_rows = 4;
   int num_experts = 4;
@@ -1270,6 +1426,60 @@ TEST(MoETest, QMoETest_Mixtral_Int4) {
               1, /*normalize_routing_weights*/
               2 /*top_k*/);
 }
+
+TEST(MoETest, QMoETest_CPU_Int4) {
+  RunQMoECpuTest(4, 5, 8, 64, 32, "silu", 2, 1, /*use_fc3*/ true, /*use_bias*/ false);
+  RunQMoECpuTest(4, 3, 4, 48, 64, "relu", 1, 0, /*use_fc3*/ false, /*use_bias*/ true);
+}
+
+TEST(MoETest, QMoETest_CPU_Int8) {
+  RunQMoECpuTest(8, 5, 8, 64, 32, "silu", 2, 1, /*use_fc3*/ true, /*use_bias*/ false);
+  RunQMoECpuTest(8, 3, 4, 48, 64, "relu", 1, 0, /*use_fc3*/ false, /*use_bias*/ true);
+}
+
+// Pins the weight layout documented for the CPU kernel with weights small enough to dequantize by hand: row major
+// (K, N), the even column in the low nibble and zero points of 8 and 128. Reading the weights as (N, K) or swapping
+// the nibbles changes the output.
+TEST(MoETest, QMoETest_CPU_WeightLayout) {
+  // fc1 dequantizes to {{1, 1}, {0, 2}} with scales {1, 0.5} and fc2 to {{0, -1}, {1, 0}} with scales {1, 1}, so the
+  // input {3, 5} gives {3, 13} after fc1 and {13, -3} after fc2.
+  const std::vector<float> input = {3.0f, 5.0f};
+  const std::vector<float> router_probs = {0.0f};
+  const std::vector<float> fc1_scales = {1.0f, 0.5f};
+  const std::vector<float> fc2_scales = {1.0f, 1.0f};
+  const std::vector<float> output = {13.0f, -3.0f};
+
+  for (int expert_weight_bits : {4, 8}) {
+    std::vector<uint8_t> fc1_experts_weights;
+    std::vector<uint8_t> fc2_experts_weights;
+    if (expert_weight_bits == 4) {
+      fc1_experts_weights = {0xA9, 0xC8};  // {{9, 10}, {8, 12}}
+      fc2_experts_weights = {0x78, 0x89};  // {{8, 7}, {9, 8}}
+    } else {
+      fc1_experts_weights = {129, 130, 128, 132};
+      fc2_experts_weights = {128, 127, 129, 128};
+    }
+    const int64_t row_bytes = 2 * expert_weight_bits / 8;
+
+    OpTester tester("QMoE", 1, onnxruntime::kMSDomain);
+    tester.AddAttribute<int64_t>("k", 1);
+    tester.AddAttribute<std::string>("activation_type", "identity");
+    tester.AddAttribute<int64_t>("expert_weight_bits", static_cast<int64_t>(expert_weight_bits));
+    tester.AddInput<float>("input", {1, 2}, input);
+    tester.AddInput<float>("router_probs", {1, 1}, router_probs);
+    tester.AddInput<uint8_t>("fc1_experts_weights", {1, 2, row_bytes}, fc1_experts_weights);
+    tester.AddInput<float>("fc1_scales", {1, 2}, fc1_scales);
+    tester.AddOptionalInputEdge<float>();
+    tester.AddInput<uint8_t>("fc2_experts_weights", {1, 2, row_bytes}, fc2_experts_weights);
+    tester.AddInput<float>("fc2_scales", {1, 2}, fc2_scales);
+    tester.AddOptionalInputEdge<float>();
+    tester.AddOutput<float>("output", {1, 2}, output);
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
+}
 #endif
 
 }  // namespace test
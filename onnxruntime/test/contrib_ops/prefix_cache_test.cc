@@ -0,0 +1,176 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "core/framework/allocator.h"
+#include "core/framework/config_options.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "contrib_ops/cpu/transformers/prefix_cache.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+namespace test {
+
+namespace {
+
+constexpr int64_t kNumHeads = 2;
+constexpr int64_t kHeadSize = 4;
+constexpr int kNumLayers = 2;
+
+// Returns tokens first, first + 1, ..., first + length - 1.
+std::vector<int32_t> MakeTokens(int32_t first, size_t length) {
+  std::vector<int32_t> tokens(length);
+  std::iota(tokens.begin(), tokens.end(), first);
+  return tokens;
+}
+
+// Returns the present state of kNumLayers layers with shape (2, 1, kNumHeads, length, kHeadSize). Element i of layer l
+// has value seed + 1000 * l + i, so that copies can be told apart.
+std::vector<OrtValue> MakePresent(int64_t length, float seed, AllocatorPtr allocator) {
+  std::vector<OrtValue> present(kNumLayers);
+  for (int layer = 0; layer < kNumLayers; ++layer) {
+    Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({2, 1, kNumHeads, length, kHeadSize}), allocator,
+                         present[layer]);
+    auto data = present[layer].GetMutable<Tensor>()->MutableDataAsSpan<float>();
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = seed + 1000.0f * static_cast<float>(layer) + static_cast<float>(i);
+    }
+  }
+  return present;
+}
+
+size_t EntryBytes(size_t length) {
+  return length * sizeof(int32_t) + kNumLayers * 2 * kNumHeads * length * kHeadSize * sizeof(float);
+}
+
+// Checks that past holds the first prefix_length tokens along axis 3 of present.
+void ExpectSequencePrefix(const std::vector<OrtValue>& present, const std::vector<OrtValue>& past,
+                          int64_t prefix_length) {
+  ASSERT_EQ(past.size(), present.size());
+  for (size_t layer = 0; layer < past.size(); ++layer) {
+    const Tensor& source = present[layer].Get<Tensor>();
+    const Tensor& target = past[layer].Get<Tensor>();
+    const int64_t length = source.Shape()[3];
+    ASSERT_EQ(target.Shape(), TensorShape({2, 1, kNumHeads, prefix_length, kHeadSize}));
+
+    const auto source_data = source.DataAsSpan<float>();
+    const auto target_data = target.DataAsSpan<float>();
+    for (int64_t outer = 0; outer < 2 * kNumHeads; ++outer) {
+      for (int64_t t = 0; t < prefix_length; ++t) {
+        for (int64_t d = 0; d < kHeadSize; ++d) {
+          EXPECT_EQ(target_data[(outer * prefix_length + t) * kHeadSize + d],
+                    source_data[(outer * length + t) * kHeadSize + d]);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(PrefixCacheTest, LookupCopiesLongestPrefix) {
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  PrefixCache cache(1 << 20);
+
+  const std::vector<int32_t> tokens = MakeTokens(100, 24);
+  const std::vector<OrtValue> present = MakePresent(24, 0.0f, allocator);
+  cache.Insert(tokens, present, allocator);
+  EXPECT_EQ(cache.SizeInBytes(), EntryBytes(24));
+
+  // A prompt that diverges after 20 tokens reuses those 20 tokens.
+  std::vector<int32_t> prompt = MakeTokens(100, 20);
+  prompt.push_back(7);
+  prompt.push_back(8);
+  std::vector<OrtValue> past;
+  ASSERT_EQ(cache.Lookup(prompt, prompt.size(), allocator, past), 20U);
+  ExpectSequencePrefix(present, past, 20);
+
+  // The prefix is limited to max_length, as the last prompt token has to run through the decoder.
+  ASSERT_EQ(cache.Lookup(tokens, tokens.size() - 1, allocator, past), 23U);
+  ExpectSequencePrefix(present, past, 23);
+}
+
+TEST(PrefixCacheTest, LookupRequiresMinPrefixLength) {
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  PrefixCache cache(1 << 20);
+
+  const std::vector<int32_t> tokens = MakeTokens(100, 24);
+  cache.Insert(tokens, MakePresent(24, 0.0f, allocator), allocator);
+
+  std::vector<OrtValue> past;
+
+  // Prompts that share fewer than kMinPrefixLength tokens don't match, nor do prompts with a different first token,
+  // even if the rest of their tokens match.
+  std::vector<int32_t> prompt = tokens;
+  prompt[PrefixCache::kMinPrefixLength - 1] = 1;
+  EXPECT_EQ(cache.Lookup(prompt, prompt.size(), allocator, past), 0U);
+  prompt = tokens;
+  prompt[0] = 1;
+  EXPECT_EQ(cache.Lookup(prompt, prompt.size(), allocator, past), 0U);
+  EXPECT_EQ(cache.Lookup(tokens, PrefixCache::kMinPrefixLength - 1, allocator, past), 0U);
+  EXPECT_TRUE(past.empty());
+
+  // Prompts shorter than kMinPrefixLength are not added.
+  const std::vector<int32_t> short_tokens = MakeTokens(500, PrefixCache::kMinPrefixLength - 1);
+  cache.Insert(short_tokens, MakePresent(short_tokens.size(), 0.0f, allocator), allocator);
+  EXPECT_EQ(cache.SizeInBytes(), EntryBytes(24));
+}
+
+TEST(PrefixCacheTest, EvictsLeastRecentlyUsed) {
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  // Room for two entries of 20 tokens.
+  PrefixCache cache(2 * EntryBytes(20) + EntryBytes(20) / 2);
+
+  const std::vector<int32_t> first = MakeTokens(100, 20);
+  const std::vector<int32_t> second = MakeTokens(200, 20);
+  const std::vector<int32_t> third = MakeTokens(300, 20);
+  cache.Insert(first, MakePresent(20, 0.0f, allocator), allocator);
+  cache.Insert(second, MakePresent(20, 0.5f, allocator), allocator);
+  EXPECT_EQ(cache.SizeInBytes(), 2 * EntryBytes(20));
+
+  // Inserting the same tokens again only marks the entry as used.
+  cache.Insert(first, MakePresent(20, 0.25f, allocator), allocator);
+  EXPECT_EQ(cache.SizeInBytes(), 2 * EntryBytes(20));
+
+  // The first entry was used more recently, so the second one is evicted.
+  const std::vector<OrtValue> third_present = MakePresent(20, 0.75f, allocator);
+  cache.Insert(third, third_present, allocator);
+  EXPECT_EQ(cache.SizeInBytes(), 2 * EntryBytes(20));
+
+  std::vector<OrtValue> past;
+  EXPECT_EQ(cache.Lookup(second, second.size(), allocator, past), 0U);
+  EXPECT_EQ(cache.Lookup(first, first.size(), allocator, past), 20U);
+  ASSERT_EQ(cache.Lookup(third, third.size(), allocator, past), 20U);
+  ExpectSequencePrefix(third_present, past, 20);
+
+  // An entry larger than the cache is not added and evicts nothing.
+  const std::vector<int32_t> long_tokens = MakeTokens(400, 60);
+  cache.Insert(long_tokens, MakePresent(60, 0.0f, allocator), allocator);
+  EXPECT_EQ(cache.SizeInBytes(), 2 * EntryBytes(20));
+  EXPECT_EQ(cache.Lookup(long_tokens, long_tokens.size(), allocator, past), 0U);
+}
+
+TEST(PrefixCacheTest, CreateFromSessionOption) {
+  ConfigOptions config_options;
+  EXPECT_EQ(PrefixCache::Create(config_options), nullptr);
+
+  ASSERT_STATUS_OK(config_options.AddConfigEntry(kOrtSessionOptionsGenerationPrefixCacheSizeInBytes, "0"));
+  EXPECT_EQ(PrefixCache::Create(config_options), nullptr);
+
+  ASSERT_STATUS_OK(config_options.AddConfigEntry(kOrtSessionOptionsGenerationPrefixCacheSizeInBytes, "4096"));
+  EXPECT_NE(PrefixCache::Create(config_options), nullptr);
+
+  ASSERT_STATUS_OK(config_options.AddConfigEntry(kOrtSessionOptionsGenerationPrefixCacheSizeInBytes, "4k"));
+  EXPECT_THROW(PrefixCache::Create(config_options), OnnxRuntimeException);
+}
+
+}  // namespace test
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "contrib_ops/cpu/transformers/sampling_top_p.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace test {
+
+namespace {
+
+constexpr float kFilterValue = -std::numeric_limits<float>::infinity();
+
+// Top-p filter of one row as the Sampling op did it before the partial selection: the whole row is sorted, the
+// softmax of the sorted scores accumulated, and the tokens past the cut-off set to filter_value.
+void TopPFilterFullSort(std::vector<float>& scores, float top_p, size_t min_tokens_to_keep, bool custom_sampling) {
+  const size_t vocab_size = scores.size();
+  std::function<bool(float, float)> predicator;
+  if (custom_sampling) {
+    predicator = std::greater<float>();
+  } else {
+    predicator = std::less<float>();
+  }
+
+  std::vector<size_t> sorted_indices(vocab_size);
+  std::iota(sorted_indices.begin(), sorted_indices.end(), size_t{0});
+  std::sort(sorted_indices.begin(), sorted_indices.end(),
+            [&](size_t i1, size_t i2) { return predicator(scores[i1], scores[i2]); });
+  std::vector<float> sorted_scores = scores;
+  std::sort(sorted_scores.begin(), sorted_scores.end(), predicator);
+
+  std::vector<float> cumulative_probs(vocab_size);
+  MlasComputeSoftmax(sorted_scores.data(), cumulative_probs.data(), 1, vocab_size, false, false, nullptr);
+
+  if (custom_sampling) {
+    if (cumulative_probs[0] > top_p) {
+      scores[sorted_indices[1]] = kFilterValue;
+    }
+    for (size_t j = 1; j < vocab_size - 1; j++) {
+      cumulative_probs[j] += cumulative_probs[j - 1];
+      if (cumulative_probs[j] > top_p) {
+        scores[sorted_indices[j + 1]] = kFilterValue;
+      }
+    }
+  } else {
+    if (cumulative_probs[0] <= 1 - top_p) {
+      scores[sorted_indices[0]] = kFilterValue;
+    }
+    for (size_t j = 1; j < vocab_size - min_tokens_to_keep; j++) {
+      cumulative_probs[j] += cumulative_probs[j - 1];
+      if (cumulative_probs[j] <= 1 - top_p) {
+        scores[sorted_indices[j]] = kFilterValue;
+      }
+    }
+  }
+}
+
+// Returns the scores of the kept tokens in descending order. Tokens with equal scores are interchangeable, so this
+// compares the kept sets of two filters even when they keep different tokens of a tie at the cut-off.
+std::vector<float> KeptScores(const std::vector<float>& scores) {
+  std::vector<float> kept;
+  std::copy_if(scores.begin(), scores.end(), std::back_inserter(kept), [](float s) { return s != kFilterValue; });
+  std::sort(kept.begin(), kept.end(), std::greater<float>());
+  return kept;
+}
+
+// Returns the probabilities the kept tokens are sampled with, in descending order.
+std::vector<float> RenormalizedProbs(const std::vector<float>& scores) {
+  std::vector<float> probs(scores.size());
+  MlasComputeSoftmax(scores.data(), probs.data(), 1, scores.size(), false, false, nullptr);
+  std::sort(probs.begin(), probs.end(), std::greater<float>());
+  return probs;
+}
+
+// Filters each row of logits with TopPFilter and with the full sort, and checks that the same tokens are kept with the
+// same probabilities.
+void RunTopPFilter(const std::vector<float>& logits, size_t batch_size, float top_p, size_t min_tokens_to_keep,
+                   bool custom_sampling) {
+  const size_t vocab_size = logits.size() / batch_size;
+  std::vector<float> scores = logits;
+  std::vector<float> probs(scores.size());
+  std::vector<int32_t> indices(scores.size());
+  SamplingCpuHelper::TopPFilter(gsl::make_span(scores), batch_size, top_p, kFilterValue, min_tokens_to_keep,
+                                custom_sampling, gsl::make_span(probs), gsl::make_span(indices), nullptr);
+
+  for (size_t row = 0; row < batch_size; ++row) {
+    const auto row_begin = logits.begin() + row * vocab_size;
+    std::vector<float> expected(row_begin, row_begin + vocab_size);
+    TopPFilterFullSort(expected, top_p, min_tokens_to_keep, custom_sampling);
+    const auto actual_begin = scores.begin() + row * vocab_size;
+    const std::vector<float> actual(actual_begin, actual_begin + vocab_size);
+
+    ASSERT_EQ(KeptScores(actual), KeptScores(expected))
+        << "row " << row << ", top_p " << top_p << ", min_tokens_to_keep " << min_tokens_to_keep
+        << ", custom_sampling " << custom_sampling;
+
+    const std::vector<float> actual_probs = RenormalizedProbs(actual);
+    const std::vector<float> expected_probs = RenormalizedProbs(expected);
+    for (size_t i = 0; i < vocab_size; ++i) {
+      ASSERT_NEAR(actual_probs[i], expected_probs[i], 1e-6f) << "row " << row << ", rank " << i;
+    }
+  }
+}
+
+// Normally distributed logits, rounded to multiples of step when step > 0 so that many tokens tie.
+std::vector<float> MakeLogits(size_t size, float stddev, float step) {
+  std::mt19937 gen(17);
+  std::normal_distribution<float> dist(0.0f, stddev);
+  std::vector<float> logits(size);
+  for (auto& v : logits) {
+    v = dist(gen);
+    if (step > 0.0f) {
+      v = std::round(v / step) * step;
+    }
+  }
+  return logits;
+}
+
+}  // namespace
+
+TEST(SamplingTopPTest, MatchesFullSort) {
+  // A peaked distribution keeps a few tokens from the first candidates. A flat one keeps thousands, which grows the
+  // candidate set past kTopPInitialCandidates several times.
+  for (float stddev : {6.0f, 1.0f}) {
+    const auto logits = MakeLogits(3 * 20000, stddev, 0.0f);
+    for (bool custom_sampling : {false, true}) {
+      for (float top_p : {0.3f, 0.7f, 0.9f, 0.99f}) {
+        RunTopPFilter(logits, 3, top_p, 1, custom_sampling);
+      }
+    }
+  }
+}
+
+TEST(SamplingTopPTest, Ties) {
+  // Logits rounded to multiples of 0.5 leave hundreds of tokens with equal scores at most cut-offs.
+  const auto logits = MakeLogits(2 * 5000, 2.0f, 0.5f);
+  for (bool custom_sampling : {false, true}) {
+    for (float top_p : {0.5f, 0.8f, 0.95f}) {
+      RunTopPFilter(logits, 2, top_p, 1, custom_sampling);
+    }
+  }
+
+  // All tokens tie. top_p is between two multiples of the token probability, as float rounding decides a cut-off that
+  // falls exactly on one.
+  const std::vector<float> uniform(1000, 0.25f);
+  for (bool custom_sampling : {false, true}) {
+    RunTopPFilter(uniform, 1, 0.5005f, 1, custom_sampling);
+  }
+}
+
+TEST(SamplingTopPTest, TopPOne) {
+  // Logits with a wide range, so that the probabilities of the least likely tokens underflow to 0.
+  const auto logits = MakeLogits(2 * 20000, 20.0f, 0.0f);
+  for (bool custom_sampling : {false, true}) {
+    RunTopPFilter(logits, 2, 1.0f, 1, custom_sampling);
+  }
+}
+
+TEST(SamplingTopPTest, SmallTopP) {
+  const auto logits = MakeLogits(2 * 20000, 3.0f, 0.0f);
+  for (bool custom_sampling : {false, true}) {
+    for (float top_p : {1e-6f, 1e-3f}) {
+      RunTopPFilter(logits, 2, top_p, 1, custom_sampling);
+    }
+  }
+}
+
+TEST(SamplingTopPTest, MinTokensToKeep) {
+  const auto logits = MakeLogits(2 * 20000, 6.0f, 0.0f);
+  // More tokens than top_p keeps, including more than kTopPInitialCandidates.
+  for (size_t min_tokens_to_keep : {size_t{1}, size_t{5}, size_t{100}, size_t{1000}}) {
+    for (float top_p : {1e-3f, 0.5f, 0.9f}) {
+      RunTopPFilter(logits, 2, top_p, min_tokens_to_keep, false);
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace contrib
+}  // namespace onnxruntime
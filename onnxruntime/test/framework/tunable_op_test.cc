@@ -7,9 +7,8 @@
 
 #include "core/common/common.h"
 #include "core/framework/tunable.h"
-#define TUNING_CONTEXT_IMPL
-#include "core/framework/tuning_context_impl.h"
-#undef TUNING_CONTEXT_IMPL
+// The implementation of the tuning context is linked from the CPU execution provider, see cpu_tuning_context.cc.
+#include "core/framework/tuning_context.h"
 
 using namespace std::chrono_literals;
 
@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "benchmark/benchmark.h"
+#include "bench_util.h"
+
+// Attention of one query row over a key/value cache of sequence_length tokens, as done per head during token
+// generation. The fp32 variant runs the two matrix products like the GroupQueryAttention CPU kernel does for a float
+// cache, the s8 variant runs them on an int8 cache.
+
+static void AttentionArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"sequence_length", "head_size"});
+  b->ArgsProduct({
+      {256, 1024, 4096, 16384},  // sequence_length
+      {64, 128},                 // head_size
+  });
+}
+
+static void ATTENTION_FP32(benchmark::State& state) {
+  const auto sequence_length = static_cast<size_t>(state.range(0));
+  const auto head_size = static_cast<size_t>(state.range(1));
+
+  auto query = RandomVectorUniform(head_size, -1.0f, 1.0f);
+  auto key = RandomVectorUniform(sequence_length * head_size, -1.0f, 1.0f);
+  auto value = RandomVectorUniform(sequence_length * head_size, -1.0f, 1.0f);
+  std::vector<float> scores(sequence_length, 1.0f / sequence_length);
+  std::vector<float> output(head_size);
+
+  for (auto _ : state) {
+    MlasGemm(CblasNoTrans, CblasTrans, 1, sequence_length, head_size, 0.125f, query.data(), head_size,
+             key.data(), head_size, 0.0f, scores.data(), sequence_length, nullptr);
+    MlasGemm(CblasNoTrans, CblasNoTrans, 1, head_size, sequence_length, 1.0f, scores.data(), sequence_length,
+             value.data(), head_size, 0.0f, output.data(), head_size, nullptr);
+  }
+
+  state.SetBytesProcessed(state.iterations() * 2 * sequence_length * head_size * sizeof(float));
+}
+
+static void ATTENTION_S8(benchmark::State& state) {
+  const auto sequence_length = static_cast<size_t>(state.range(0));
+  const auto head_size = static_cast<size_t>(state.range(1));
+
+  auto query = RandomVectorUniform(head_size, -1.0f, 1.0f);
+  auto key = RandomVectorUniform(sequence_length * head_size, int8_t(-127), int8_t(127));
+  auto value = RandomVectorUniform(sequence_length * head_size, int8_t(-127), int8_t(127));
+  std::vector<float> scores(sequence_length, 1.0f / sequence_length);
+  std::vector<float> output(head_size);
+
+  for (auto _ : state) {
+    MlasAttentionScoresS8(query.data(), key.data(), scores.data(), sequence_length, head_size, 0.125f / 127.0f);
+    MlasAttentionValuesS8(scores.data(), value.data(), output.data(), sequence_length, head_size, 1.0f / 127.0f);
+  }
+
+  state.SetBytesProcessed(state.iterations() * 2 * sequence_length * head_size * sizeof(int8_t));
+}
+
+BENCHMARK(ATTENTION_FP32)->Apply(AttentionArgs)->UseRealTime();
+BENCHMARK(ATTENTION_S8)->Apply(AttentionArgs)->UseRealTime();
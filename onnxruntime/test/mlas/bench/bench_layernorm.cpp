@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "benchmark/benchmark.h"
+#include "bench_util.h"
+#include "core/framework/float16.h"
+
+using namespace onnxruntime;
+
+// Normalizes `rows` rows of `hidden_size` elements, like the LayerNormalization and SkipLayerNormalization CPU kernels
+// do per row.
+
+static void LayerNormArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"rows", "hidden_size", "skip"});
+  b->ArgsProduct({
+      {1, 128},                         // rows
+      {768, 2048, 4096},                // hidden_size
+      {int64_t{false}, int64_t{true}},  // skip
+  });
+}
+
+template <typename T>
+static void LayerNorm(benchmark::State& state) {
+  const auto rows = narrow<size_t>(state.range(0));
+  const auto hidden_size = narrow<size_t>(state.range(1));
+  const auto skip = narrow<bool>(state.range(2));
+
+  auto input_fp32 = RandomVectorUniform(rows * hidden_size, -2.0f, 2.0f);
+  auto skip_fp32 = RandomVectorUniform(rows * hidden_size, -2.0f, 2.0f);
+  auto scale = RandomVectorUniform(hidden_size, -1.0f, 1.0f);
+  auto bias = RandomVectorUniform(hidden_size, -1.0f, 1.0f);
+
+  std::vector<T> input(input_fp32.begin(), input_fp32.end());
+  std::vector<T> skip_input(skip_fp32.begin(), skip_fp32.end());
+  std::vector<T> output(rows * hidden_size);
+
+  for (auto _ : state) {
+    for (size_t row = 0; row < rows; row++) {
+      const size_t offset = row * hidden_size;
+      MlasLayerNorm<T>(input.data() + offset, skip ? skip_input.data() + offset : nullptr, nullptr, scale.data(),
+                       bias.data(), output.data() + offset, nullptr, hidden_size, 1e-5f, nullptr, nullptr);
+    }
+  }
+
+  state.SetBytesProcessed(state.iterations() * rows * hidden_size * (skip ? 3 : 2) * sizeof(T));
+}
+
+// The fp16 path the kernels used before: convert the tensors to fp32, normalize and convert the output back.
+static void LayerNorm_Fp16ViaFp32(benchmark::State& state) {
+  const auto rows = narrow<size_t>(state.range(0));
+  const auto hidden_size = narrow<size_t>(state.range(1));
+  const auto skip = narrow<bool>(state.range(2));
+  const size_t size = rows * hidden_size;
+
+  auto input_fp32 = RandomVectorUniform(size, -2.0f, 2.0f);
+  auto skip_fp32 = RandomVectorUniform(size, -2.0f, 2.0f);
+  auto scale = RandomVectorUniform(hidden_size, -1.0f, 1.0f);
+  auto bias = RandomVectorUniform(hidden_size, -1.0f, 1.0f);
+
+  std::vector<MLFloat16> input(input_fp32.begin(), input_fp32.end());
+  std::vector<MLFloat16> skip_input(skip_fp32.begin(), skip_fp32.end());
+  std::vector<MLFloat16> output(size);
+  std::vector<float> input_buffer(size);
+  std::vector<float> skip_buffer(size);
+  std::vector<float> output_buffer(size);
+
+  for (auto _ : state) {
+    MlasConvertHalfToFloatBuffer(input.data(), input_buffer.data(), size);
+    if (skip) {
+      MlasConvertHalfToFloatBuffer(skip_input.data(), skip_buffer.data(), size);
+    }
+    for (size_t row = 0; row < rows; row++) {
+      const size_t offset = row * hidden_size;
+      MlasLayerNorm<float>(input_buffer.data() + offset, skip ? skip_buffer.data() + offset : nullptr, nullptr,
+                           scale.data(), bias.data(), output_buffer.data() + offset, nullptr, hidden_size, 1e-5f,
+                           nullptr, nullptr);
+    }
+    MlasConvertFloatToHalfBuffer(output_buffer.data(), output.data(), size);
+  }
+
+  state.SetBytesProcessed(state.iterations() * size * (skip ? 3 : 2) * sizeof(MLFloat16));
+}
+
+BENCHMARK(LayerNorm<float>)->Apply(LayerNormArgs)->UseRealTime();
+BENCHMARK(LayerNorm<MLFloat16>)->Apply(LayerNormArgs)->UseRealTime();
+BENCHMARK(LayerNorm_Fp16ViaFp32)->Apply(LayerNormArgs)->UseRealTime();
@@ -4,7 +4,9 @@
 #include "mlas_q4.h"
 #include "mlas_qnbit.h"
 
+#include <algorithm>
 #include <memory>
+#include <random>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
@@ -134,10 +136,143 @@ static void QNBitGemmArgs(benchmark::internal::Benchmark* b) {
   });
 }
 
+BENCHMARK(QNBITGEMM<float, 2>)->Apply(QNBitGemmArgs<float>)->UseRealTime();
+BENCHMARK(QNBITGEMM<float, 3>)->Apply(QNBitGemmArgs<float>)->UseRealTime();
 BENCHMARK(QNBITGEMM<float, 4>)->Apply(QNBitGemmArgs<float>)->UseRealTime();
 BENCHMARK(QNBITGEMM<float, 8>)->Apply(QNBitGemmArgs<float>)->UseRealTime();
 BENCHMARK(QNBITGEMM<MLAS_FP16, 4>)->Apply(QNBitGemmArgs<MLAS_FP16>)->UseRealTime();
 
+// Mixture of experts layer: the rows of the tokens are routed to the experts with a skewed distribution and each
+// expert multiplies its rows by its own 4 bit weights. The loop runs the experts one after another with the threads
+// of MlasQNBitGemmBatch, the segmented run splits the columns of every expert in proportion to its rows and runs
+// all the segments on the thread pool at once, as the CPU QMoE kernel does.
+void QNBITGEMM_MOE(benchmark::State& state, bool segmented) {
+  using onnxruntime::narrow;
+
+  const auto Experts = narrow<size_t>(state.range(0));
+  const auto Tokens = narrow<size_t>(state.range(1));
+  const auto N = narrow<size_t>(state.range(2));
+  const auto K = narrow<size_t>(state.range(3));
+  const auto Threads = narrow<size_t>(state.range(4));
+
+  constexpr size_t BlkBitWidth = 4;
+  constexpr size_t BlkLen = 128;
+  constexpr MLAS_QNBIT_GEMM_COMPUTE_TYPE ComputeType = SQNBIT_CompFp32;
+
+  if (!MlasIsQNBitGemmAvailable(BlkBitWidth, BlkLen, ComputeType)) {
+    state.SkipWithMessage("QNBitGemm is not available with the given configuration on the current machine.");
+    return;
+  }
+
+  std::default_random_engine generator(static_cast<unsigned>(Experts * Tokens));
+  std::exponential_distribution<double> popularity(1.0);
+  std::vector<double> weights(Experts);
+  for (auto& w : weights) w = popularity(generator);
+  std::discrete_distribution<size_t> router(weights.begin(), weights.end());
+  std::vector<size_t> rows(Experts);
+  for (size_t t = 0; t < Tokens; t++) rows[router(generator)]++;
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = static_cast<int>(Threads);
+  tpo.auto_set_affinity = true;
+
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  size_t QuantBDataSizeInBytes, QuantBScaleSize;
+  MlasBlockwiseQuantizedBufferSizes<BlkBitWidth>(
+      static_cast<int>(BlkLen), /* columnwise */ true,
+      static_cast<int>(K), static_cast<int>(N),
+      QuantBDataSizeInBytes, QuantBScaleSize, nullptr);
+  const size_t PackedQuantBDataSize =
+      MlasQNBitGemmPackQuantBDataSize(N, K, BlkBitWidth, BlkLen, false, ComputeType);
+
+  const auto A = RandomVectorUniform(Tokens * K, -1.0f, 1.0f);
+  const auto B = RandomVectorUniform(K * N, -1.0f, 1.0f);
+  std::vector<float> C(Tokens * N);
+
+  // Every expert gets a copy of the same quantized weights, packed separately so the experts do not share cache lines.
+  std::vector<uint8_t> QuantBData(QuantBDataSizeInBytes);
+  std::vector<float> QuantBScale(QuantBScaleSize);
+  MlasQuantizeBlockwise<float, BlkBitWidth>(QuantBData.data(), QuantBScale.data(), nullptr,
+                                            B.data(), static_cast<int>(BlkLen), /* columnwise */ true,
+                                            static_cast<int>(K), static_cast<int>(N), static_cast<int>(N),
+                                            tp.get());
+
+  auto PackedQuantBData = std::make_unique<std::byte[]>(PackedQuantBDataSize * Experts);
+  for (size_t e = 0; e < Experts; e++) {
+    MlasQNBitGemmPackQuantBData(N, K, BlkBitWidth, BlkLen, ComputeType, QuantBData.data(),
+                                PackedQuantBData.get() + e * PackedQuantBDataSize,
+                                nullptr, false, nullptr, tp.get());
+  }
+
+  struct Segment {
+    size_t M;
+    size_t N;
+    MLAS_QNBIT_GEMM_DATA_PARAMS<float> Data;
+  };
+
+  const size_t BlockCount = (K + BlkLen - 1) / BlkLen;
+  const size_t ldb = BlockCount * BlkLen / 2;
+  const size_t TargetSegments = segmented ? 2 * Threads : Experts;
+
+  std::vector<Segment> segments;
+  size_t row = 0;
+  for (size_t e = 0; e < Experts; e++) {
+    if (rows[e] == 0) {
+      continue;
+    }
+
+    const size_t RangeCount = segmented ? (TargetSegments * rows[e] + Tokens - 1) / Tokens : 1;
+    const size_t RangeN = ((N + RangeCount - 1) / RangeCount + 15) / 16 * 16;
+    for (size_t n = 0; n < N; n += RangeN) {
+      Segment segment;
+      segment.M = rows[e];
+      segment.N = std::min(RangeN, N - n);
+      segment.Data.A = A.data() + row * K;
+      segment.Data.lda = K;
+      segment.Data.PackedQuantBData = PackedQuantBData.get() + e * PackedQuantBDataSize + n * ldb;
+      segment.Data.QuantBScale = QuantBScale.data() + n * BlockCount;
+      segment.Data.C = C.data() + row * N + n;
+      segment.Data.ldc = N;
+      segments.push_back(segment);
+    }
+    row += rows[e];
+  }
+
+  auto run = [&]() {
+    if (segmented) {
+      onnxruntime::concurrency::ThreadPool::TrySimpleParallelFor(
+          tp.get(), static_cast<std::ptrdiff_t>(segments.size()), [&](std::ptrdiff_t i) {
+            Segment& segment = segments[static_cast<size_t>(i)];
+            MlasQNBitGemmBatch(segment.M, segment.N, K, 1, BlkBitWidth, BlkLen, ComputeType, &segment.Data,
+                               nullptr, nullptr);
+          });
+    } else {
+      for (auto& segment : segments) {
+        MlasQNBitGemmBatch(segment.M, segment.N, K, 1, BlkBitWidth, BlkLen, ComputeType, &segment.Data,
+                           nullptr, tp.get());
+      }
+    }
+  };
+
+  // warm up run
+  run();
+
+  for (auto _ : state) {
+    run();
+  }
+}
+
+static void QNBitGemmMoEArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"Experts", "Tokens", "N", "K", "Threads"});
+  b->ArgsProduct({{8, 16, 32, 64}, {16, 256, 2048}, {1024, 4096}, {1024}, {8}});
+}
+
+BENCHMARK_CAPTURE(QNBITGEMM_MOE, Loop, false)->Apply(QNBitGemmMoEArgs)->UseRealTime();
+BENCHMARK_CAPTURE(QNBITGEMM_MOE, Segmented, true)->Apply(QNBitGemmMoEArgs)->UseRealTime();
+
 // This test gets benchmark arguments from environment variables.
 template <typename AType, size_t BlkBitWidth>
 void QNBITGEMM_ENV(benchmark::State& state) {
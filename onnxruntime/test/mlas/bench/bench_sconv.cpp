@@ -38,8 +38,7 @@ static const std::vector<std::string>& ArgNamesForConv(size_t rank) {
   return rank_to_args_name[rank];
 }
 
-// dummy for some strange build error when using Bench capture
-void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
+static void SconvNchw(benchmark::State& state, bool winograd) {
   const int64_t rank = state.range(0);                       // Rank
   const int64_t batch_size = state.range(1);                 // N
   const int64_t groups = state.range(2);                     // G
@@ -91,6 +90,34 @@ void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
   std::vector<int64_t> y_shape = {batch_size, GF};
   y_shape.insert(y_shape.end(), output_shape.begin(), output_shape.end());
 
+  auto X = RandomVectorUniform(x_shape, -2.0, 2.0);
+  auto F = RandomVectorUniform(f_shape, -1.0, 1.0);
+  int64_t y_size = std::accumulate(y_shape.begin(), y_shape.end(), 1LL, std::multiplies<int64_t>());
+  std::vector<float> Y(static_cast<size_t>(y_size));
+
+  // The Winograd algorithm runs with the filter transformed ahead of time, as done by the Conv kernel's PrePack.
+  std::vector<uint8_t> packed_filter;
+  const float* filter = F.data();
+  if (winograd) {
+    if (!MlasConvWinogradIsSupported(static_cast<size_t>(rank), static_cast<size_t>(groups),
+                                     static_cast<size_t>(input_channels_per_group),
+                                     static_cast<size_t>(output_channels_per_group),
+                                     kernel_shape.data(), dilations.data(), strides.data())) {
+      state.SkipWithError("convolution is not supported by the Winograd algorithm");
+      return;
+    }
+    // The packed GEMM kernels load the filter with aligned loads.
+    constexpr uintptr_t alignment = 64;
+    packed_filter.resize(MlasConvWinogradPackFilterSize(static_cast<size_t>(input_channels_per_group),
+                                                        static_cast<size_t>(output_channels_per_group)) +
+                         alignment);
+    auto* packed = reinterpret_cast<uint8_t*>(
+        (reinterpret_cast<uintptr_t>(packed_filter.data()) + alignment - 1) & ~(alignment - 1));
+    MlasConvWinogradPackFilter(static_cast<size_t>(input_channels_per_group),
+                               static_cast<size_t>(output_channels_per_group), F.data(), packed);
+    filter = reinterpret_cast<const float*>(packed);
+  }
+
   MLAS_ACTIVATION activation;
   activation.ActivationKind = MlasIdentityActivation;
   MLAS_CONV_PARAMETERS Parameters;
@@ -110,18 +137,15 @@ void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
                   &activation,
                   &WorkingBufferSize,
                   0.0f,
-                  nullptr);
+                  nullptr,
+                  winograd);
 
-  auto X = RandomVectorUniform(x_shape, -2.0, 2.0);
-  auto F = RandomVectorUniform(f_shape, -1.0, 1.0);
-  int64_t y_size = std::accumulate(y_shape.begin(), y_shape.end(), 1LL, std::multiplies<int64_t>());
-  std::vector<float> Y(static_cast<size_t>(y_size));
   std::vector<float> working_buffer(WorkingBufferSize);
 
   // warm up first round.
   MlasConv(&Parameters,
            X.data(),
-           F.data(),
+           filter,
            nullptr,
            working_buffer.data(),
            Y.data(),
@@ -130,7 +154,7 @@ void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
   for (auto _ : state) {
     MlasConv(&Parameters,
              X.data(),
-             F.data(),
+             filter,
              nullptr,
              working_buffer.data(),
              Y.data(),
@@ -138,6 +162,15 @@ void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
   }
 }
 
+// dummy for some strange build error when using Bench capture
+void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
+  SconvNchw(state, false);
+}
+
+void SCONV_NCHW_WINOGRAD(benchmark::State& state, const char* /*dummy*/) {
+  SconvNchw(state, true);
+}
+
 static void ResNet50(benchmark::internal::Benchmark* b) {
   b->ArgNames(ArgNamesForConv(2));
 
@@ -245,3 +278,21 @@ static void General_Conv2d(benchmark::internal::Benchmark* b) {
 }
 
 BENCHMARK_CAPTURE(SCONV_NCHW, 2d, "")->Apply(General_Conv2d)->UseRealTime();
+
+//
+// The 3x3 stride 1 convolutions of ResNet50 and wider variants of the Teams model, run with both the default
+// algorithm selection and the Winograd algorithm.
+//
+static void Winograd_Conv2d(benchmark::internal::Benchmark* b) {
+  b->ArgNames(ArgNamesForConv(2));
+  //    Rank, N, G, Cpg, Fpg,  I,   , K, , P, , , , S, , D, ,
+  b->Args({2, 1, 1, 64, 64, 56, 56, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+  b->Args({2, 1, 1, 128, 128, 28, 28, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+  b->Args({2, 1, 1, 256, 256, 14, 14, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+  b->Args({2, 1, 1, 512, 512, 7, 7, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+  b->Args({2, 4, 1, 64, 64, 56, 56, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+  b->Args({2, 1, 1, 48, 48, 48, 80, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1});
+}
+
+BENCHMARK_CAPTURE(SCONV_NCHW, Winograd_Conv2d, "")->Apply(Winograd_Conv2d)->UseRealTime();
+BENCHMARK_CAPTURE(SCONV_NCHW_WINOGRAD, Winograd_Conv2d, "")->Apply(Winograd_Conv2d)->UseRealTime();
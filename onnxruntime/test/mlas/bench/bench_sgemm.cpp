@@ -5,6 +5,7 @@
 #include "bench_util.h"
 #include "core/util/thread_utils.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <numeric>
 
@@ -126,9 +127,175 @@ BENCHMARK_CAPTURE(SGEMM, GEMV_ABTrans, false, true, true)->Apply(GemmSizeWithOne
 BENCHMARK_CAPTURE(SGEMM, PACKB_NoTransA, true, false, false)->Apply(GemmSizeProducts)->UseRealTime();
 BENCHMARK_CAPTURE(SGEMM, PACKB_TransA, true, true, false)->Apply(GemmSizeProducts)->UseRealTime();
 
+//
+// Small products, which read matrix B in place on the platforms with small
+// kernels. PACKB runs the same shapes with a prepacked matrix B.
+//
+
+static void GemmSmallSizeProducts(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sgemm_bench_arg_names);
+  b->ArgsProduct({{1, 2, 4, 8, 16}, {16, 64, 256}, {16, 64, 256}});
+}
+
+BENCHMARK_CAPTURE(SGEMM, SMALL_NoTrans, false, false, false)->Apply(GemmSmallSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM, SMALL_TransA, false, true, false)->Apply(GemmSmallSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM, SMALL_TransB, false, false, true)->Apply(GemmSmallSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM, SMALL_PACKB, true, false, false)->Apply(GemmSmallSizeProducts)->UseRealTime();
+
 static void GemmLLMSizeProducts(benchmark::internal::Benchmark* b) {
   b->ArgNames(sgemm_bench_arg_names);
   b->ArgsProduct({{1, 1024, 2048}, {4096, 11008}, {4096, 11008}});
 }
 
 BENCHMARK_CAPTURE(SGEMM, LLM, false, false, true)->Apply(GemmLLMSizeProducts)->UseRealTime();
+
+//
+// Compares the dense packed B against the block sparse packed B for a B where
+// the given percentage of 16x16 blocks is zero.
+//
+
+void SGEMM_BLOCKSPARSE(benchmark::State& state, bool block_sparse) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  if (state.range(3) < 0 || state.range(3) > 100) throw std::invalid_argument("Sparsity must be in [0, 100]!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  const float sparsity = static_cast<float>(state.range(3)) / 100.0f;
+
+  auto A = RandomVectorUniform(static_cast<size_t>(M * K), -1.0f, 1.0f);
+  auto B = RandomVectorUniform(static_cast<size_t>(N * K), -1.0f, 1.0f);
+  std::vector<float> C(static_cast<size_t>(M * N));
+
+  std::default_random_engine generator(static_cast<unsigned>(N * K));
+  std::uniform_real_distribution<float> keep(0.0f, 1.0f);
+  for (size_t k0 = 0; k0 < K; k0 += 16) {
+    for (size_t n0 = 0; n0 < N; n0 += 16) {
+      if (keep(generator) < sparsity) {
+        for (size_t k = k0; k < std::min(K, k0 + 16); k++) {
+          std::fill_n(B.data() + k * N + n0, std::min(N, n0 + 16) - n0, 0.0f);
+        }
+      }
+    }
+  }
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 8;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  const size_t pack_b_size = block_sparse ? MlasGemmBlockSparsePackBSize(CblasNoTrans, N, K, B.data(), N)
+                                          : MlasGemmPackBSize(N, K);
+  std::vector<float> B_packed((pack_b_size + sizeof(float) - 1) / sizeof(float));
+  if (block_sparse) {
+    MlasGemmBlockSparsePackB(CblasNoTrans, N, K, B.data(), N, B_packed.data());
+  } else {
+    MlasGemmPackB(CblasNoTrans, N, K, B.data(), N, B_packed.data());
+  }
+
+  MLAS_SGEMM_DATA_PARAMS data;
+  data.A = A.data();
+  data.lda = K;
+  data.B = B_packed.data();
+  data.ldb = 0;
+  data.C = C.data();
+  data.ldc = N;
+  data.BIsPacked = !block_sparse;
+  data.BIsBlockSparse = block_sparse;
+
+  MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, &data, 1, tp.get());
+
+  for (auto _ : state) {
+    MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, &data, 1, tp.get());
+  }
+}
+
+static void GemmBlockSparseSizeProducts(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N", "K", "Sparsity"});
+  b->ArgsProduct({{1, 64, 1024}, {1024, 4096}, {1024, 4096}, {0, 50, 70, 80, 90}});
+}
+
+BENCHMARK_CAPTURE(SGEMM_BLOCKSPARSE, Dense, false)->Apply(GemmBlockSparseSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM_BLOCKSPARSE, BlockSparse, true)->Apply(GemmBlockSparseSizeProducts)->UseRealTime();
+
+//
+// Compares a grouped SGEMM against a loop of SGEMM calls for the experts of a
+// mixture of experts layer. The tokens are routed unevenly, so the experts
+// multiply matrices A with different row counts, and some experts receive no
+// tokens at all.
+//
+
+void SGEMM_GROUPED(benchmark::State& state, bool grouped) {
+  if (state.range(0) <= 0) throw std::invalid_argument("Experts must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("Tokens must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(3) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t experts = static_cast<size_t>(state.range(0));
+  const size_t tokens = static_cast<size_t>(state.range(1));
+  const size_t N = static_cast<size_t>(state.range(2));
+  const size_t K = static_cast<size_t>(state.range(3));
+
+  std::default_random_engine generator(static_cast<unsigned>(experts * tokens));
+  std::exponential_distribution<double> popularity(1.0);
+  std::vector<double> weights(experts);
+  for (auto& w : weights) w = popularity(generator);
+  std::discrete_distribution<size_t> router(weights.begin(), weights.end());
+  std::vector<size_t> rows(experts);
+  for (size_t t = 0; t < tokens; t++) rows[router(generator)]++;
+
+  auto A = RandomVectorUniform(static_cast<size_t>(tokens * K), -1.0f, 1.0f);
+  auto B = RandomVectorUniform(static_cast<size_t>(experts * N * K), -1.0f, 1.0f);
+  std::vector<float> C(static_cast<size_t>(tokens * N));
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 8;
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  std::vector<MLAS_SGEMM_GROUPED_PARAMS> problems(experts);
+  size_t row = 0;
+  for (size_t e = 0; e < experts; e++) {
+    MLAS_SGEMM_GROUPED_PARAMS& problem = problems[e];
+    problem.M = rows[e];
+    problem.N = N;
+    problem.K = K;
+    problem.Data.A = A.data() + row * K;
+    problem.Data.lda = K;
+    problem.Data.B = B.data() + e * N * K;
+    problem.Data.ldb = N;
+    problem.Data.C = C.data() + row * N;
+    problem.Data.ldc = N;
+    row += rows[e];
+  }
+
+  auto run = [&]() {
+    if (grouped) {
+      MlasGemmGrouped(problems.data(), problems.size(), tp.get());
+    } else {
+      for (const auto& problem : problems) {
+        if (problem.M != 0) {
+          MlasGemm(problem.TransA, problem.TransB, problem.M, problem.N, problem.K, problem.Data, tp.get());
+        }
+      }
+    }
+  };
+
+  run();
+
+  for (auto _ : state) {
+    run();
+  }
+}
+
+static void GemmGroupedSizeProducts(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"Experts", "Tokens", "N", "K"});
+  b->ArgsProduct({{8, 64}, {16, 256, 2048}, {1024, 4096}, {1024}});
+}
+
+BENCHMARK_CAPTURE(SGEMM_GROUPED, Loop, false)->Apply(GemmGroupedSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM_GROUPED, Grouped, true)->Apply(GemmGroupedSizeProducts)->UseRealTime();
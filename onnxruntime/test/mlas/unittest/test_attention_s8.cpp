@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasAttentionS8Test : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferQuery;
+  MatrixGuardBuffer<float> BufferKey;
+  MatrixGuardBuffer<int8_t> BufferKeyS8;
+  MatrixGuardBuffer<float> BufferScores;
+  MatrixGuardBuffer<float> BufferOutput;
+
+  void Test(size_t SequenceLength, size_t HeadSize) {
+    const size_t KeySize = SequenceLength * HeadSize;
+    float* Query = BufferQuery.GetBuffer(HeadSize);
+    float* Key = BufferKey.GetBuffer(KeySize);
+    int8_t* KeyS8 = BufferKeyS8.GetBuffer(KeySize);
+    float* Scores = BufferScores.GetBuffer(SequenceLength);
+    float* Output = BufferOutput.GetBuffer(HeadSize);
+
+    std::default_random_engine generator(static_cast<unsigned>(SequenceLength * 131 + HeadSize));
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+    for (size_t h = 0; h < HeadSize; h++) {
+      Query[h] = distribution(generator);
+    }
+
+    float MaximumKey = 0.0f;
+    for (size_t i = 0; i < KeySize; i++) {
+      Key[i] = distribution(generator);
+      MaximumKey = std::max(MaximumKey, std::fabs(Key[i]));
+    }
+
+    const float KeyScale = MaximumKey / 127.0f;
+    MlasQuantizeLinear<int8_t>(Key, KeyS8, KeySize, KeyScale, 0);
+
+    //
+    // The scores are exact for the quantized keys, and within half a
+    // quantization step per element of the float keys.
+    //
+
+    constexpr float ScoreScale = 0.125f;
+    MlasAttentionScoresS8(Query, KeyS8, Scores, SequenceLength, HeadSize, KeyScale * ScoreScale);
+
+    float QueryNorm = 0.0f;
+    for (size_t h = 0; h < HeadSize; h++) {
+      QueryNorm += std::fabs(Query[h]);
+    }
+    const float QuantizationTolerance = ScoreScale * KeyScale * 0.5f * QueryNorm + 1e-4f;
+
+    for (size_t t = 0; t < SequenceLength; t++) {
+      float Dequantized = 0.0f;
+      float Magnitude = 0.0f;
+      float Original = 0.0f;
+      for (size_t h = 0; h < HeadSize; h++) {
+        Dequantized += Query[h] * static_cast<float>(KeyS8[t * HeadSize + h]);
+        Magnitude += std::fabs(Query[h] * static_cast<float>(KeyS8[t * HeadSize + h]));
+        Original += Query[h] * Key[t * HeadSize + h];
+      }
+      Dequantized *= KeyScale * ScoreScale;
+      Magnitude *= KeyScale * ScoreScale;
+      Original *= ScoreScale;
+
+      // only the order of the additions differs from the reference.
+      ASSERT_LE(std::fabs(Scores[t] - Dequantized), Magnitude * 1e-5f + 1e-6f)
+          << "Scores[" << t << "] " << Scores[t] << " expected " << Dequantized
+          << ", SequenceLength=" << SequenceLength << ", HeadSize=" << HeadSize;
+      ASSERT_LE(std::fabs(Scores[t] - Original), QuantizationTolerance)
+          << "Scores[" << t << "] " << Scores[t] << " expected " << Original
+          << ", SequenceLength=" << SequenceLength << ", HeadSize=" << HeadSize;
+    }
+
+    //
+    // Use the keys as values, weighted by probabilities that sum to one.
+    //
+
+    float ProbabilitySum = 0.0f;
+    for (size_t t = 0; t < SequenceLength; t++) {
+      Scores[t] = std::fabs(distribution(generator)) + 0.01f;
+      ProbabilitySum += Scores[t];
+    }
+    for (size_t t = 0; t < SequenceLength; t++) {
+      Scores[t] /= ProbabilitySum;
+    }
+
+    MlasAttentionValuesS8(Scores, KeyS8, Output, SequenceLength, HeadSize, KeyScale);
+
+    for (size_t h = 0; h < HeadSize; h++) {
+      float Dequantized = 0.0f;
+      float Original = 0.0f;
+      for (size_t t = 0; t < SequenceLength; t++) {
+        Dequantized += Scores[t] * static_cast<float>(KeyS8[t * HeadSize + h]);
+        Original += Scores[t] * Key[t * HeadSize + h];
+      }
+      Dequantized *= KeyScale;
+
+      ASSERT_LE(std::fabs(Output[h] - Dequantized), 127.0f * KeyScale * 1e-5f)
+          << "Output[" << h << "] " << Output[h] << " expected " << Dequantized
+          << ", SequenceLength=" << SequenceLength << ", HeadSize=" << HeadSize;
+      ASSERT_LE(std::fabs(Output[h] - Original), KeyScale * 0.5f + 1e-4f)
+          << "Output[" << h << "] " << Output[h] << " expected " << Original
+          << ", SequenceLength=" << SequenceLength << ", HeadSize=" << HeadSize;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("AttentionS8");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t HeadSize : {1, 7, 8, 15, 64, 80, 128}) {
+      for (size_t SequenceLength : {1, 2, 17, 256}) {
+        Test(SequenceLength, HeadSize);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasAttentionS8Test>::RegisterShortExecute();
+  }
+  return count;
+});
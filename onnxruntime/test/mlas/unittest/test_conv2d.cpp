@@ -4,6 +4,129 @@
 #include "test_conv2d.h"
 #include "test_conv2d_fixture.h"
 
+//
+// Tests the Winograd F(4x4,3x3) algorithm against the IM2COL reference. The
+// transforms reassociate the products, so the outputs are compared with a
+// tolerance instead of bitwise.
+//
+
+template <bool Threaded>
+class MlasConv2DWinogradTest : public MlasConv2DTest<Threaded> {
+ private:
+  MatrixGuardBuffer<uint8_t> BufferPackedFilter;
+
+  void Test(size_t BatchCount,
+            size_t InputChannels,
+            size_t InputHeight,
+            size_t InputWidth,
+            size_t FilterCount,
+            size_t PaddingTop,
+            size_t PaddingLeft,
+            size_t PaddingBottom,
+            size_t PaddingRight,
+            MLAS_ACTIVATION_KIND ActivationKind,
+            float Beta) {
+    const size_t OutputHeight = InputHeight + PaddingTop + PaddingBottom - 2;
+    const size_t OutputWidth = InputWidth + PaddingLeft + PaddingRight - 2;
+
+    const size_t InputElements = BatchCount * InputChannels * InputHeight * InputWidth;
+    const size_t FilterElements = FilterCount * InputChannels * 9;
+    const size_t OutputElements = BatchCount * FilterCount * OutputHeight * OutputWidth;
+
+    std::vector<float> Input(InputElements);
+    std::vector<float> Filter(FilterElements);
+    std::vector<float> Bias(FilterCount);
+    std::vector<float> Output(OutputElements);
+    std::vector<float> OutputReference(OutputElements);
+
+    std::default_random_engine generator(static_cast<unsigned>(BatchCount * 131 + InputChannels * 17 +
+                                                               InputHeight * 7 + InputWidth));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (auto& v : Input) v = distribution(generator);
+    for (auto& v : Filter) v = distribution(generator);
+    for (auto& v : Bias) v = distribution(generator);
+    for (auto& v : Output) v = distribution(generator);
+
+    std::vector<float> OutputInitial(Output);
+
+    int64_t InputShape[] = {int64_t(InputHeight), int64_t(InputWidth)};
+    int64_t KernelShape[] = {3, 3};
+    int64_t DilationShape[] = {1, 1};
+    int64_t Padding[] = {int64_t(PaddingTop), int64_t(PaddingLeft), int64_t(PaddingBottom), int64_t(PaddingRight)};
+    int64_t StrideShape[] = {1, 1};
+    int64_t OutputShape[] = {int64_t(OutputHeight), int64_t(OutputWidth)};
+
+    ASSERT_TRUE(MlasConvWinogradIsSupported(2, 1, InputChannels, FilterCount, KernelShape, DilationShape,
+                                            StrideShape));
+
+    void* PackedFilter = BufferPackedFilter.GetBuffer(MlasConvWinogradPackFilterSize(InputChannels, FilterCount));
+    MlasConvWinogradPackFilter(InputChannels, FilterCount, Filter.data(), PackedFilter);
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = ActivationKind;
+
+    MLAS_CONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+
+    MlasConvPrepare(&Parameters, 2, BatchCount, 1, InputChannels, InputShape, KernelShape, DilationShape,
+                    Padding, StrideShape, OutputShape, FilterCount, &Activation, &WorkingBufferSize, Beta,
+                    this->threadpool_, true);
+
+    ASSERT_EQ(Parameters.Algorithm, MlasConvAlgorithmWinograd);
+
+    MlasConv(&Parameters, Input.data(), static_cast<const float*>(PackedFilter), Bias.data(),
+             this->BufferWorking.GetBuffer(WorkingBufferSize), Output.data(), this->threadpool_);
+
+    this->ReferenceConv2D(BatchCount, 1, InputChannels, InputHeight, InputWidth, FilterCount, 3, 3,
+                          PaddingTop, PaddingLeft, 1, 1, 1, 1, OutputHeight, OutputWidth,
+                          Input.data(), Filter.data(), Bias.data(), OutputReference.data());
+
+    for (size_t i = 0; i < OutputElements; i++) {
+      float Expected = OutputReference[i] + Beta * OutputInitial[i];
+      if (ActivationKind == MlasReluActivation) {
+        Expected = std::max(Expected, 0.0f);
+      }
+      ASSERT_NEAR(Output[i], Expected, std::fabs(Expected) * 1e-4f + 1e-3f)
+          << "B" << BatchCount << "/"
+          << "C" << InputChannels << "/"
+          << "F" << FilterCount << "/"
+          << "H" << InputHeight << "/"
+          << "W" << InputWidth << "/"
+          << "Pad" << PaddingTop << "," << PaddingLeft << "," << PaddingBottom << "," << PaddingRight << "/"
+          << "Beta" << Beta << " index " << i;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "Conv2dWinograd_Threaded" : "Conv2dWinograd_SingleThread");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    const int64_t Kernel3x3[] = {3, 3};
+    const int64_t Kernel5x5[] = {5, 5};
+    const int64_t Ones[] = {1, 1};
+    const int64_t Twos[] = {2, 2};
+
+    EXPECT_FALSE(MlasConvWinogradIsSupported(2, 1, 16, 64, Kernel3x3, Ones, Ones));
+    EXPECT_FALSE(MlasConvWinogradIsSupported(2, 2, 64, 64, Kernel3x3, Ones, Ones));
+    EXPECT_FALSE(MlasConvWinogradIsSupported(2, 1, 64, 64, Kernel5x5, Ones, Ones));
+    EXPECT_FALSE(MlasConvWinogradIsSupported(2, 1, 64, 64, Kernel3x3, Twos, Ones));
+    EXPECT_FALSE(MlasConvWinogradIsSupported(2, 1, 64, 64, Kernel3x3, Ones, Twos));
+
+    Test(1, 32, 8, 8, 32, 1, 1, 1, 1, MlasIdentityActivation, 0.0f);
+    Test(1, 32, 6, 6, 32, 0, 0, 0, 0, MlasIdentityActivation, 0.0f);
+    Test(2, 48, 13, 11, 40, 1, 1, 1, 1, MlasIdentityActivation, 0.0f);
+    Test(1, 64, 7, 9, 64, 0, 0, 0, 0, MlasReluActivation, 0.0f);
+    Test(1, 32, 17, 17, 33, 0, 1, 2, 1, MlasIdentityActivation, 0.0f);
+    Test(3, 33, 5, 6, 64, 1, 1, 1, 1, MlasReluActivation, 1.0f);
+    Test(1, 32, 40, 36, 32, 1, 1, 1, 1, MlasIdentityActivation, 1.0f);
+    Test(2, 64, 28, 28, 64, 1, 1, 1, 1, MlasReluActivation, 0.0f);
+  }
+};
+
 static size_t Conv2dRegistLongExecute() {
   size_t count = MlasLongExecuteTests<MlasConv2DTest<false>>::RegisterLongExecute();
   if (GetMlasThreadPool() != nullptr) {
@@ -20,6 +143,15 @@ static size_t Conv2dRegistShortExecute() {
   return count;
 }
 
+static size_t Conv2dWinogradRegistShortExecute() {
+  size_t count = MlasDirectShortExecuteTests<MlasConv2DWinogradTest<false>>::RegisterShortExecute();
+  if (GetMlasThreadPool() != nullptr) {
+    count += MlasDirectShortExecuteTests<MlasConv2DWinogradTest<true>>::RegisterShortExecute();
+  }
+  return count;
+}
+
 static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
-  return is_short_execute ? Conv2dRegistShortExecute() : Conv2dRegistLongExecute();
+  return is_short_execute ? Conv2dRegistShortExecute() + Conv2dWinogradRegistShortExecute()
+                          : Conv2dRegistLongExecute();
 });
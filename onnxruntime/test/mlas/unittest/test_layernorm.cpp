@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+#include "core/mlas/lib/mlasi.h"
+
+template <typename T>
+class MlasLayerNormTest : public MlasTestBase {
+ private:
+  static float ToFloat(T Value) { return static_cast<float>(Value); }
+
+  //
+  // The tolerance of an output element whose reference value is Expected.
+  // fp16 outputs are rounded to 11 significant bits.
+  //
+
+  static float Tolerance(float Expected) {
+    if constexpr (std::is_same_v<T, float>) {
+      return std::fabs(Expected) * 1e-5f + 1e-5f;
+    } else {
+      return std::fabs(Expected) * 2e-3f + 1e-3f;
+    }
+  }
+
+  void Test(size_t N, bool Simplified, bool UseSkip, bool UseSkipBias, bool UseBias, bool UseSkipOutput) {
+    std::vector<T> Input(N);
+    std::vector<T> Skip(N);
+    std::vector<float> SkipBias(N);
+    std::vector<float> Scale(N);
+    std::vector<float> Bias(N);
+    std::vector<T> Output(N);
+    std::vector<T> SkipOutput(N);
+
+    std::default_random_engine generator(static_cast<unsigned>(N * 17 + Simplified * 8 + UseSkip * 4 +
+                                                               UseSkipBias * 2 + UseBias));
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+
+    for (size_t h = 0; h < N; h++) {
+      // an offset so that the mean is not zero.
+      Input[h] = static_cast<T>(distribution(generator) + 0.5f);
+      Skip[h] = static_cast<T>(distribution(generator));
+      SkipBias[h] = distribution(generator);
+      Scale[h] = distribution(generator);
+      Bias[h] = distribution(generator);
+    }
+
+    const T* SkipData = UseSkip ? Skip.data() : nullptr;
+    const float* SkipBiasData = UseSkipBias ? SkipBias.data() : nullptr;
+    const float* BiasData = UseBias ? Bias.data() : nullptr;
+    T* SkipOutputData = UseSkipOutput ? SkipOutput.data() : nullptr;
+
+    constexpr float Epsilon = 1e-5f;
+    float Mean = 0.0f;
+    float InvStdDev = 0.0f;
+
+    if (Simplified) {
+      MlasRmsNorm<T>(Input.data(), SkipData, SkipBiasData, Scale.data(), Output.data(), SkipOutputData, N, Epsilon,
+                     &InvStdDev);
+    } else {
+      MlasLayerNorm<T>(Input.data(), SkipData, SkipBiasData, Scale.data(), BiasData, Output.data(), SkipOutputData,
+                       N, Epsilon, &Mean, &InvStdDev);
+    }
+
+    std::vector<double> X(N);
+    double Sum = 0.0;
+    double SumSquares = 0.0;
+    for (size_t h = 0; h < N; h++) {
+      X[h] = ToFloat(Input[h]);
+      if (UseSkip) {
+        X[h] += ToFloat(Skip[h]);
+      }
+      if (UseSkipBias) {
+        X[h] += SkipBias[h];
+      }
+      Sum += X[h];
+      SumSquares += X[h] * X[h];
+    }
+
+    const double ExpectedMean = Simplified ? 0.0 : Sum / N;
+    const double Variance = Simplified ? SumSquares / N : SumSquares / N - ExpectedMean * ExpectedMean;
+    const double ExpectedInvStdDev = 1.0 / std::sqrt(Variance + Epsilon);
+
+    if (!Simplified) {
+      ASSERT_NEAR(Mean, ExpectedMean, 1e-4) << "N=" << N;
+    }
+    ASSERT_NEAR(InvStdDev, ExpectedInvStdDev, ExpectedInvStdDev * 1e-4) << "N=" << N;
+
+    for (size_t h = 0; h < N; h++) {
+      double Expected = (X[h] - ExpectedMean) * ExpectedInvStdDev * Scale[h];
+      if (UseBias && !Simplified) {
+        Expected += Bias[h];
+      }
+
+      ASSERT_NEAR(ToFloat(Output[h]), Expected, Tolerance(static_cast<float>(Expected)))
+          << "Output[" << h << "], N=" << N << ", Simplified=" << Simplified << ", Skip=" << UseSkip
+          << ", SkipBias=" << UseSkipBias << ", Bias=" << UseBias;
+
+      if (UseSkipOutput) {
+        ASSERT_NEAR(ToFloat(SkipOutput[h]), X[h], Tolerance(static_cast<float>(X[h])))
+            << "SkipOutput[" << h << "], N=" << N;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(std::is_same_v<T, float> ? "LayerNorm_fp32" : "LayerNorm_fp16");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t N : {2, 3, 7, 8, 15, 16, 17, 33, 64, 768, 1023}) {
+      for (bool Simplified : {false, true}) {
+        Test(N, Simplified, false, false, false, false);
+        Test(N, Simplified, false, false, true, false);
+        Test(N, Simplified, true, false, true, true);
+        Test(N, Simplified, true, true, true, true);
+        Test(N, Simplified, true, true, false, false);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasLayerNormTest<float>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasLayerNormTest<MLAS_FP16>>::RegisterShortExecute();
+  }
+  return count;
+});
@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Checks a SGEMM with a block sparse packed matrix B against the SGEMM with
+// the dense matrix B. The matrices hold small integers so that both results
+// are exact regardless of how the K dimension is sliced.
+//
+
+template <bool Threaded>
+class MlasSgemmBlockSparseTest : public MlasTestBase {
+ private:
+  MLAS_THREADPOOL* threadpool_;
+
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+
+  //
+  // Builds matrix B stored as K x N, or N x K when transposed, where each
+  // block of 16 x 16 is zero with the given probability.
+  //
+
+  static std::vector<float> MakeBlockSparseB(bool TransB, size_t N, size_t K, float Sparsity, unsigned Seed) {
+    std::default_random_engine generator(Seed);
+    std::uniform_int_distribution<int> values(-3, 3);
+    std::uniform_real_distribution<float> keep(0.0f, 1.0f);
+
+    std::vector<float> B(N * K);
+    for (auto& b : B) b = static_cast<float>(values(generator));
+
+    for (size_t k0 = 0; k0 < K; k0 += 16) {
+      for (size_t n0 = 0; n0 < N; n0 += 16) {
+        if (keep(generator) >= Sparsity) {
+          continue;
+        }
+        for (size_t k = k0; k < std::min(K, k0 + 16); k++) {
+          for (size_t n = n0; n < std::min(N, n0 + 16); n++) {
+            B[TransB ? n * K + k : k * N + n] = 0.0f;
+          }
+        }
+      }
+    }
+
+    return B;
+  }
+
+  void Test(bool TransA, bool TransB, size_t BatchSize, size_t M, size_t N, size_t K, float Sparsity, float beta,
+            bool UseEpilogue) {
+    const unsigned Seed = static_cast<unsigned>(M * 1009 + N * 31 + K + size_t(Sparsity * 100));
+
+    std::default_random_engine generator(Seed);
+    std::uniform_int_distribution<int> values(-3, 3);
+
+    std::vector<float> A(M * K * BatchSize);
+    std::vector<float> Bias(N);
+    std::vector<float> C(M * N * BatchSize, -0.5f);
+    std::vector<float> CReference(M * N * BatchSize, -0.5f);
+
+    for (auto& a : A) a = static_cast<float>(values(generator));
+    for (auto& b : Bias) b = static_cast<float>(values(generator));
+
+    const std::vector<float> B = MakeBlockSparseB(TransB, N, K, Sparsity, Seed);
+    const size_t ldb = TransB ? K : N;
+
+    void* PackedB = BufferBPacked.GetBuffer(
+        MlasGemmBlockSparsePackBSize(TransB ? CblasTrans : CblasNoTrans, N, K, B.data(), ldb), true);
+    MlasGemmBlockSparsePackB(TransB ? CblasTrans : CblasNoTrans, N, K, B.data(), ldb, PackedB);
+
+    if (Sparsity == 0.0f) {
+      ASSERT_EQ(MlasGemmBlockSparsity(TransB ? CblasTrans : CblasNoTrans, N, K, B.data(), ldb), 0.0f);
+    } else if (Sparsity == 1.0f) {
+      ASSERT_EQ(MlasGemmBlockSparsity(TransB ? CblasTrans : CblasNoTrans, N, K, B.data(), ldb), 1.0f);
+    }
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasReluActivation;
+
+    MLAS_SGEMM_EPILOGUE Epilogue;
+    Epilogue.Bias = Bias.data();
+    Epilogue.Activation = &Activation;
+
+    std::vector<MLAS_SGEMM_DATA_PARAMS> Data(BatchSize);
+    for (size_t i = 0; i < BatchSize; i++) {
+      Data[i].A = A.data() + M * K * i;
+      Data[i].lda = TransA ? M : K;
+      Data[i].B = B.data();
+      Data[i].ldb = ldb;
+      Data[i].C = CReference.data() + M * N * i;
+      Data[i].ldc = N;
+      Data[i].beta = beta;
+      Data[i].Epilogue = UseEpilogue ? &Epilogue : nullptr;
+    }
+
+    const CBLAS_TRANSPOSE TransposeA = TransA ? CblasTrans : CblasNoTrans;
+    const CBLAS_TRANSPOSE TransposeB = TransB ? CblasTrans : CblasNoTrans;
+
+    MlasGemmBatch(TransposeA, TransposeB, M, N, K, Data.data(), BatchSize, threadpool_);
+
+    for (size_t i = 0; i < BatchSize; i++) {
+      Data[i].B = static_cast<const float*>(PackedB);
+      Data[i].ldb = 0;
+      Data[i].BIsBlockSparse = true;
+      Data[i].C = C.data() + M * N * i;
+    }
+
+    MlasGemmBatch(TransposeA, TransposeB, M, N, K, Data.data(), BatchSize, threadpool_);
+
+    for (size_t i = 0; i < M * N * BatchSize; i++) {
+      ASSERT_EQ(C[i], CReference[i])
+          << " Diff @" << i << ", " << (TransA ? "T" : "N") << (TransB ? "T" : "N") << "/"
+          << "Batch" << BatchSize << "/M" << M << "xN" << N << "xK" << K << "/"
+          << "Sparsity" << Sparsity << "/Beta" << beta << (UseEpilogue ? "/Epilogue" : "");
+    }
+
+    //
+    // Split the operation along both dimensions, so that each segment starts
+    // at an interior column panel and row.
+    //
+
+    std::fill(C.begin(), C.end(), -0.5f);
+
+    MLAS_SGEMM_THREADING Threading;
+    Threading.ThreadCountM = 3;
+    Threading.ThreadCountN = 2;
+    MlasGemmBatch(TransposeA, TransposeB, M, N, K, Data.data(), BatchSize, threadpool_, &Threading);
+
+    for (size_t i = 0; i < M * N * BatchSize; i++) {
+      ASSERT_EQ(C[i], CReference[i])
+          << " Diff @" << i << ", " << (TransA ? "T" : "N") << (TransB ? "T" : "N") << "/"
+          << "Batch" << BatchSize << "/M" << M << "xN" << N << "xK" << K << "/"
+          << "Sparsity" << Sparsity << "/Beta" << beta << (UseEpilogue ? "/Epilogue" : "") << "/Grid3x2";
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "SgemmBlockSparse_Threaded" : "SgemmBlockSparse_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasSgemmBlockSparseTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    static const size_t Shapes[][3] = {
+        {1, 1, 1}, {1, 64, 64}, {5, 17, 33}, {16, 48, 300}, {33, 130, 65}, {64, 96, 600},
+    };
+
+    static const float Sparsities[] = {0.0f, 0.5f, 0.8f, 1.0f};
+
+    for (const auto& Shape : Shapes) {
+      for (float Sparsity : Sparsities) {
+        for (int trans = 0; trans < 4; trans++) {
+          Test(trans & 1, trans & 2, 1, Shape[0], Shape[1], Shape[2], Sparsity, 0.0f, false);
+        }
+        Test(false, false, 3, Shape[0], Shape[1], Shape[2], Sparsity, 1.0f, false);
+        Test(false, true, 2, Shape[0], Shape[1], Shape[2], Sparsity, 0.5f, false);
+        Test(false, false, 1, Shape[0], Shape[1], Shape[2], Sparsity, 0.0f, true);
+        Test(true, false, 2, Shape[0], Shape[1], Shape[2], Sparsity, 1.0f, true);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSgemmBlockSparseTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSgemmBlockSparseTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
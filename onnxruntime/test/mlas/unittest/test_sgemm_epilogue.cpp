@@ -0,0 +1,177 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+template <bool Packed, bool Threaded>
+class MlasSgemmEpilogueTest : public MlasTestBase {
+ private:
+  MLAS_THREADPOOL* threadpool_;
+
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferResidual;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+
+  void Gemm(CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB, size_t M, size_t N, size_t K, float alpha,
+            const float* A, size_t lda, const float* B, size_t ldb, float beta, float* C, size_t ldc,
+            const MLAS_SGEMM_EPILOGUE* Epilogue) {
+    MLAS_SGEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = lda;
+    Data.C = C;
+    Data.ldc = ldc;
+    Data.alpha = alpha;
+    Data.beta = beta;
+    Data.Epilogue = Epilogue;
+
+    if (Packed) {
+      void* PackedB = BufferBPacked.GetBuffer(MlasGemmPackBSize(N, K), true);
+      MlasGemmPackB(TransB, N, K, B, ldb, PackedB);
+      Data.B = static_cast<const float*>(PackedB);
+      Data.BIsPacked = true;
+    } else {
+      Data.B = B;
+      Data.ldb = ldb;
+    }
+
+    MlasGemm(TransA, TransB, M, N, K, Data, threadpool_);
+  }
+
+  static float ReferenceActivation(const MLAS_ACTIVATION& Activation, float Value) {
+    switch (Activation.ActivationKind) {
+      case MlasReluActivation:
+        return std::max(Value, 0.0f);
+      case MlasLeakyReluActivation:
+        return Value >= 0.0f ? Value : Value * Activation.Parameters.LeakyRelu.alpha;
+      case MlasLogisticActivation:
+        return 1.0f / (1.0f + std::exp(-Value));
+      case MlasClipActivation:
+        return std::min(std::max(Value, Activation.Parameters.Clip.minimum), Activation.Parameters.Clip.maximum);
+      default:
+        return Value;
+    }
+  }
+
+  void Test(bool TransA, bool TransB, size_t M, size_t N, size_t K, float beta, bool UseBias, bool UseResidual,
+            const MLAS_ACTIVATION* Activation) {
+    const float* A = BufferA.GetBuffer(M * K);
+    const float* B = BufferB.GetBuffer(K * N);
+    const float* Bias = BufferBias.GetBuffer(N);
+    const float* Residual = BufferResidual.GetBuffer(M * N);
+    float* C = BufferC.GetBuffer(M * N);
+    float* CReference = BufferCReference.GetBuffer(M * N);
+
+    std::fill_n(C, M * N, -0.5f);
+    std::fill_n(CReference, M * N, -0.5f);
+
+    const size_t lda = TransA ? M : K;
+    const size_t ldb = TransB ? K : N;
+
+    MLAS_SGEMM_EPILOGUE Epilogue;
+    Epilogue.Bias = UseBias ? Bias : nullptr;
+    Epilogue.Residual = UseResidual ? Residual : nullptr;
+    Epilogue.ldr = N;
+    Epilogue.Activation = Activation;
+
+    Gemm(TransA ? CblasTrans : CblasNoTrans, TransB ? CblasTrans : CblasNoTrans, M, N, K, 1.0f,
+         A, lda, B, ldb, beta, C, N, &Epilogue);
+    Gemm(TransA ? CblasTrans : CblasNoTrans, TransB ? CblasTrans : CblasNoTrans, M, N, K, 1.0f,
+         A, lda, B, ldb, beta, CReference, N, nullptr);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        float Expected = CReference[m * N + n];
+        if (UseBias) {
+          Expected += Bias[n];
+        }
+        if (UseResidual) {
+          Expected += Residual[m * N + n];
+        }
+        if (Activation != nullptr) {
+          Expected = ReferenceActivation(*Activation, Expected);
+        }
+
+        ASSERT_NEAR(C[m * N + n], Expected, std::fabs(Expected) * 1e-5f + 1e-5f)
+            << " Diff @[" << m << ", " << n << "], "
+            << (Packed ? "Packed" : "NoPack") << "/"
+            << (TransA ? "TransA" : "A") << "/"
+            << (TransB ? "TransB" : "B") << "/"
+            << "M" << M << "xN" << N << "xK" << K << "/"
+            << "Beta" << beta << "/"
+            << (UseBias ? "Bias" : "") << (UseResidual ? "Residual" : "") << "/"
+            << "Activation" << (Activation != nullptr ? int(Activation->ActivationKind) : -1);
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name = std::string("SgemmEpilogue") +
+                                          (Packed ? "_Packed" : "_NoPack") +
+                                          (Threaded ? "_Threaded" : "_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasSgemmEpilogueTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    MLAS_ACTIVATION Relu;
+    Relu.ActivationKind = MlasReluActivation;
+
+    MLAS_ACTIVATION LeakyRelu;
+    LeakyRelu.ActivationKind = MlasLeakyReluActivation;
+    LeakyRelu.Parameters.LeakyRelu.alpha = 0.1f;
+
+    MLAS_ACTIVATION Logistic;
+    Logistic.ActivationKind = MlasLogisticActivation;
+
+    MLAS_ACTIVATION Clip;
+    Clip.ActivationKind = MlasClipActivation;
+    Clip.Parameters.Clip.minimum = -1.0f;
+    Clip.Parameters.Clip.maximum = 2.0f;
+
+    const MLAS_ACTIVATION* Activations[] = {nullptr, &Relu, &LeakyRelu, &Logistic, &Clip};
+
+    // M == 1 and N == 1 exercise the matrix/vector paths, the larger shapes span
+    // several slices along the N and K dimensions.
+    static const size_t Shapes[][3] = {
+        {1, 1, 1}, {1, 17, 7}, {1, 300, 64}, {5, 1, 33}, {7, 9, 3}, {16, 32, 16},
+        {33, 65, 130}, {64, 257, 300}, {128, 96, 600},
+    };
+
+    for (const auto& Shape : Shapes) {
+      const size_t M = Shape[0], N = Shape[1], K = Shape[2];
+      for (bool TransA : {false, true}) {
+        for (bool TransB : {false, true}) {
+          for (const MLAS_ACTIVATION* Activation : Activations) {
+            Test(TransA, TransB, M, N, K, 0.0f, true, false, Activation);
+            Test(TransA, TransB, M, N, K, 0.0f, true, true, Activation);
+          }
+          Test(TransA, TransB, M, N, K, 0.0f, false, true, nullptr);
+          Test(TransA, TransB, M, N, K, 1.0f, true, false, &Relu);
+          Test(TransA, TransB, M, N, K, 0.5f, false, false, &LeakyRelu);
+        }
+      }
+    }
+
+    if (!Packed) {
+      // K == 0 applies the epilogue to the scaled output.
+      Test(false, false, 4, 9, 0, 1.0f, true, true, &Relu);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSgemmEpilogueTest<false, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasSgemmEpilogueTest<false, true>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasSgemmEpilogueTest<true, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasSgemmEpilogueTest<true, true>>::RegisterShortExecute();
+  }
+  return count;
+});
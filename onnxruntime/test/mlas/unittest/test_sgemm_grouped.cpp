@@ -0,0 +1,169 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Checks a grouped SGEMM against a separate SGEMM for each multiplication of
+// the group. The matrices hold small integers so that both results are exact
+// regardless of how the multiplications are partitioned.
+//
+
+template <bool Threaded>
+class MlasSgemmGroupedTest : public MlasTestBase {
+ private:
+  MLAS_THREADPOOL* threadpool_;
+
+  struct Problem {
+    bool TransA;
+    bool TransB;
+    size_t M;
+    size_t N;
+    size_t K;
+    bool PackB;
+    bool UseEpilogue;
+  };
+
+  void Test(const std::vector<Problem>& Problems, float beta, unsigned Seed) {
+    std::default_random_engine generator(Seed);
+    std::uniform_int_distribution<int> values(-3, 3);
+
+    const size_t ProblemCount = Problems.size();
+
+    std::vector<std::vector<float>> A(ProblemCount), B(ProblemCount), Bias(ProblemCount);
+    std::vector<std::vector<float>> C(ProblemCount), CReference(ProblemCount);
+    std::vector<MatrixGuardBuffer<uint8_t>> BufferBPacked(ProblemCount);
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasReluActivation;
+
+    std::vector<MLAS_SGEMM_EPILOGUE> Epilogues(ProblemCount);
+    std::vector<MLAS_SGEMM_GROUPED_PARAMS> Params(ProblemCount);
+
+    for (size_t i = 0; i < ProblemCount; i++) {
+      const Problem& p = Problems[i];
+
+      A[i].resize(p.M * p.K);
+      B[i].resize(p.N * p.K);
+      Bias[i].resize(p.N);
+      C[i].assign(p.M * p.N, -0.5f);
+      CReference[i].assign(p.M * p.N, -0.5f);
+
+      for (auto& a : A[i]) a = static_cast<float>(values(generator));
+      for (auto& b : B[i]) b = static_cast<float>(values(generator));
+      for (auto& b : Bias[i]) b = static_cast<float>(values(generator));
+
+      Epilogues[i].Bias = Bias[i].data();
+      Epilogues[i].Activation = &Activation;
+
+      MLAS_SGEMM_GROUPED_PARAMS& Param = Params[i];
+      Param.TransA = p.TransA ? CblasTrans : CblasNoTrans;
+      Param.TransB = p.TransB ? CblasTrans : CblasNoTrans;
+      Param.M = p.M;
+      Param.N = p.N;
+      Param.K = p.K;
+      Param.Data.A = A[i].data();
+      Param.Data.lda = p.TransA ? p.M : p.K;
+      Param.Data.B = B[i].data();
+      Param.Data.ldb = p.TransB ? p.K : p.N;
+      Param.Data.C = CReference[i].data();
+      Param.Data.ldc = p.N;
+      Param.Data.beta = beta;
+      Param.Data.Epilogue = p.UseEpilogue ? &Epilogues[i] : nullptr;
+
+      MlasGemm(Param.TransA, Param.TransB, p.M, p.N, p.K, Param.Data, nullptr);
+
+      if (p.PackB) {
+        void* PackedB = BufferBPacked[i].GetBuffer(MlasGemmPackBSize(p.N, p.K), true);
+        MlasGemmPackB(Param.TransB, p.N, p.K, B[i].data(), Param.Data.ldb, PackedB);
+        Param.Data.B = static_cast<const float*>(PackedB);
+        Param.Data.ldb = 0;
+        Param.Data.BIsPacked = true;
+      }
+
+      Param.Data.C = C[i].data();
+    }
+
+    MlasGemmGrouped(Params.data(), ProblemCount, threadpool_);
+
+    for (size_t i = 0; i < ProblemCount; i++) {
+      const Problem& p = Problems[i];
+      for (size_t j = 0; j < p.M * p.N; j++) {
+        ASSERT_EQ(C[i][j], CReference[i][j])
+            << " Diff @" << j << " of problem " << i << ", " << (p.TransA ? "T" : "N") << (p.TransB ? "T" : "N")
+            << "/M" << p.M << "xN" << p.N << "xK" << p.K << (p.PackB ? "/PackB" : "")
+            << (p.UseEpilogue ? "/Epilogue" : "") << "/Beta" << beta;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "SgemmGrouped_Threaded" : "SgemmGrouped_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasSgemmGroupedTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    //
+    // A single multiplication, as with MlasGemm.
+    //
+
+    Test({{false, false, 33, 130, 65, false, false}}, 0.0f, 1);
+
+    //
+    // Experts of a mixture of experts layer with different token counts,
+    // including experts that receive no tokens.
+    //
+
+    Test({{false, false, 7, 96, 64, false, false},
+          {false, false, 0, 96, 64, false, false},
+          {false, false, 130, 96, 64, false, false},
+          {false, false, 1, 96, 64, false, false},
+          {false, false, 0, 96, 64, false, false},
+          {false, false, 45, 96, 64, false, false}},
+         0.0f, 2);
+
+    Test({{false, true, 7, 96, 64, false, true},
+          {false, true, 300, 96, 64, true, true},
+          {false, true, 1, 96, 64, true, false},
+          {false, true, 0, 96, 64, false, true}},
+         1.0f, 3);
+
+    //
+    // Unrelated shapes and transposes, with empty K and N dimensions and
+    // trailing empty multiplications.
+    //
+
+    std::vector<Problem> Mixed;
+    for (int trans = 0; trans < 4; trans++) {
+      Mixed.push_back({(trans & 1) != 0, (trans & 2) != 0, 5, 17, 33, false, false});
+      Mixed.push_back({(trans & 1) != 0, (trans & 2) != 0, 64, 300, 129, false, (trans & 1) != 0});
+      Mixed.push_back({(trans & 1) != 0, (trans & 2) != 0, 200, 24, 16, trans == 0, true});
+    }
+    Mixed.push_back({false, false, 16, 16, 0, false, true});
+    Mixed.push_back({false, false, 16, 0, 16, false, false});
+    Mixed.push_back({false, false, 0, 0, 0, false, false});
+
+    Test(Mixed, 0.0f, 4);
+    Test(Mixed, 0.5f, 5);
+
+    //
+    // An empty group.
+    //
+
+    Test({}, 0.0f, 6);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSgemmGroupedTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasSgemmGroupedTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+#include <cmath>
+#include <cstring>
+
+//
+// Checks the SGEMM of small matrices, which the platforms with small kernels
+// compute without packing matrix B, against a reference loop. The matrices
+// hold small integers so that the results are exact regardless of the order
+// of the additions.
+//
+
+class MlasSgemmSmallTest : public MlasTestBase {
+ private:
+  void Test(bool TransA, bool TransB, size_t M, size_t N, size_t K, float alpha, float beta) {
+    const unsigned Seed = static_cast<unsigned>(M * 1009 + N * 31 + K);
+
+    std::default_random_engine generator(Seed);
+    std::uniform_int_distribution<int> values(-3, 3);
+
+    //
+    // Use leading dimensions larger than the matrices to check the strides.
+    //
+
+    const size_t lda = (TransA ? M : K) + 3;
+    const size_t ldb = (TransB ? K : N) + 5;
+    const size_t ldc = N + 2;
+
+    std::vector<float> A((TransA ? K : M) * lda);
+    std::vector<float> B((TransB ? N : K) * ldb);
+    std::vector<float> C(M * ldc);
+    std::vector<float> CReference(M * ldc);
+
+    for (auto& a : A) a = static_cast<float>(values(generator));
+    for (auto& b : B) b = static_cast<float>(values(generator));
+    for (auto& c : C) c = static_cast<float>(values(generator));
+
+    //
+    // Matrix C must not be read when beta is zero.
+    //
+
+    if (beta == 0.0f) {
+      std::fill(C.begin(), C.end(), std::nanf(""));
+    }
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < ldc; n++) {
+        if (n >= N) {
+          CReference[m * ldc + n] = C[m * ldc + n];
+          continue;
+        }
+        float sum = 0.0f;
+        for (size_t k = 0; k < K; k++) {
+          const float a = TransA ? A[k * lda + m] : A[m * lda + k];
+          const float b = TransB ? B[n * ldb + k] : B[k * ldb + n];
+          sum += a * b;
+        }
+        CReference[m * ldc + n] = alpha * sum + ((beta == 0.0f) ? 0.0f : beta * C[m * ldc + n]);
+      }
+    }
+
+    MlasGemm(TransA ? CblasTrans : CblasNoTrans, TransB ? CblasTrans : CblasNoTrans, M, N, K, alpha,
+             A.data(), lda, B.data(), ldb, beta, C.data(), ldc, nullptr);
+
+    for (size_t i = 0; i < M * ldc; i++) {
+      if (i % ldc >= N) {
+        // The padding columns must be left alone. They hold NaN when beta is zero.
+        ASSERT_EQ(std::memcmp(&C[i], &CReference[i], sizeof(float)), 0)
+            << " Padding @" << i << ", " << (TransA ? "T" : "N") << (TransB ? "T" : "N") << "/"
+            << "M" << M << "xN" << N << "xK" << K;
+        continue;
+      }
+      ASSERT_EQ(C[i], CReference[i])
+          << " Diff @" << i << ", " << (TransA ? "T" : "N") << (TransB ? "T" : "N") << "/"
+          << "M" << M << "xN" << N << "xK" << K << "/"
+          << "Alpha" << alpha << "/Beta" << beta;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("SgemmSmall");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    static const size_t Ns[] = {1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 64, 255, 256};
+    static const size_t Ks[] = {1, 2, 7, 8, 9, 16, 31, 100, 256};
+    static const float Multipliers[][2] = {{1.0f, 0.0f}, {1.0f, 1.0f}, {0.5f, -2.0f}, {-1.0f, 0.0f}};
+
+    for (size_t M = 1; M <= 16; M++) {
+      for (size_t N : Ns) {
+        for (size_t K : Ks) {
+          for (int trans = 0; trans < 4; trans++) {
+            Test(trans & 1, trans & 2, M, N, K, 1.0f, 0.0f);
+          }
+        }
+      }
+    }
+
+    for (const auto& Multiplier : Multipliers) {
+      for (int trans = 0; trans < 4; trans++) {
+        Test(trans & 1, trans & 2, 5, 37, 19, Multiplier[0], Multiplier[1]);
+        Test(trans & 1, trans & 2, 16, 256, 256, Multiplier[0], Multiplier[1]);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSgemmSmallTest>::RegisterShortExecute();
+  }
+  return count;
+});
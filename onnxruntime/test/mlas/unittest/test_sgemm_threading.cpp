@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+//
+// Checks that a batched SGEMM split into a caller supplied thread partition
+// matches the SGEMM partitioned by MLAS.
+//
+
+template <bool Packed>
+class MlasSgemmThreadingTest : public MlasTestBase {
+ private:
+  MLAS_THREADPOOL* threadpool_;
+
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+
+  void Test(size_t BatchSize, size_t M, size_t N, size_t K, float beta, size_t ThreadCountM, size_t ThreadCountN) {
+    const float* A = BufferA.GetBuffer(M * K * BatchSize);
+    const float* B = BufferB.GetBuffer(K * N * BatchSize);
+    float* C = BufferC.GetBuffer(M * N * BatchSize);
+    float* CReference = BufferCReference.GetBuffer(M * N * BatchSize);
+
+    std::fill_n(C, M * N * BatchSize, -0.5f);
+    std::fill_n(CReference, M * N * BatchSize, -0.5f);
+
+    void* PackedB = nullptr;
+    if (Packed) {
+      PackedB = BufferBPacked.GetBuffer(MlasGemmPackBSize(N, K), true);
+      MlasGemmPackB(CblasNoTrans, N, K, B, N, PackedB);
+    }
+
+    std::vector<MLAS_SGEMM_DATA_PARAMS> Data(BatchSize);
+    for (size_t i = 0; i < BatchSize; i++) {
+      Data[i].A = A + M * K * i;
+      Data[i].lda = K;
+      if (Packed) {
+        Data[i].B = static_cast<const float*>(PackedB);
+        Data[i].BIsPacked = true;
+      } else {
+        Data[i].B = B + K * N * i;
+        Data[i].ldb = N;
+      }
+      Data[i].C = CReference + M * N * i;
+      Data[i].ldc = N;
+      Data[i].beta = beta;
+    }
+
+    MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, Data.data(), BatchSize, threadpool_);
+
+    for (size_t i = 0; i < BatchSize; i++) {
+      Data[i].C = C + M * N * i;
+    }
+
+    MLAS_SGEMM_THREADING Threading;
+    Threading.ThreadCountM = ThreadCountM;
+    Threading.ThreadCountN = ThreadCountN;
+    MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, Data.data(), BatchSize, threadpool_, &Threading);
+
+    for (size_t i = 0; i < M * N * BatchSize; i++) {
+      ASSERT_EQ(C[i], CReference[i])
+          << " Diff @" << i << ", " << (Packed ? "Packed" : "NoPack") << "/"
+          << "Batch" << BatchSize << "/M" << M << "xN" << N << "xK" << K << "/"
+          << "Beta" << beta << "/Grid" << ThreadCountM << "x" << ThreadCountN;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name = std::string("SgemmThreading") + (Packed ? "_Packed" : "_NoPack");
+    return suite_name.c_str();
+  }
+
+  MlasSgemmThreadingTest() : threadpool_(GetMlasThreadPool()) {}
+
+  void ExecuteShort(void) override {
+    // A zero count selects the default for that dimension, counts beyond the
+    // number of rows or 16 column blocks are clamped.
+    static const size_t Grids[][2] = {
+        {1, 1}, {2, 1}, {1, 3}, {3, 2}, {4, 4}, {7, 5}, {0, 2}, {3, 0}, {100, 100},
+    };
+
+    static const size_t Shapes[][3] = {
+        {1, 1, 1}, {1, 300, 64}, {5, 1, 33}, {16, 32, 16}, {33, 65, 130}, {64, 257, 300},
+    };
+
+    for (const auto& Shape : Shapes) {
+      for (const auto& Grid : Grids) {
+        Test(1, Shape[0], Shape[1], Shape[2], 0.0f, Grid[0], Grid[1]);
+        Test(3, Shape[0], Shape[1], Shape[2], 1.0f, Grid[0], Grid[1]);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasSgemmThreadingTest<false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasSgemmThreadingTest<true>>::RegisterShortExecute();
+  }
+  return count;
+});
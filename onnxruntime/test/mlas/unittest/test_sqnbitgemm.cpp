@@ -292,7 +292,11 @@ class MlasSQNBitGemmTest : public MlasTestBase {
     if (ComputeType == SQNBIT_CompFp32) {
       CallReferenceGemm_CompFp32(M, N, K, A, QuantBData, QuantBScale, QuantBZeroPoint, Bias, CReference);
     } else if (ComputeType == SQNBIT_CompInt8) {
-      CallReferenceGemm_CompInt8(M, N, K, A, QuantBData, QuantBScale, QuantBZeroPoint, Bias, CReference);
+      if constexpr (BlkBitWidth == 4) {
+        CallReferenceGemm_CompInt8(M, N, K, A, QuantBData, QuantBScale, QuantBZeroPoint, Bias, CReference);
+      } else {
+        FAIL() << "Int8 reference is only implemented for 4-bit quantized B";
+      }
     } else {
       FAIL() << "Test is not implemented for compute type "
              << ComputeType << " (" << ComputeTypeName(ComputeType) << ")";
@@ -429,6 +433,18 @@ static size_t SQNBitGemmRegisterAllShortExecuteTests() {
   count += SQNBitGemmShortExecuteTest<4, 128>::RegisterShortExecuteTests();
   count += SQNBitGemmShortExecuteTest<4, 256>::RegisterShortExecuteTests();
 
+  count += SQNBitGemmShortExecuteTest<2, 16>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<2, 32>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<2, 64>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<2, 128>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<2, 256>::RegisterShortExecuteTests();
+
+  count += SQNBitGemmShortExecuteTest<3, 16>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<3, 32>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<3, 64>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<3, 128>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<3, 256>::RegisterShortExecuteTests();
+
   return count;
 }
 
@@ -7,6 +7,7 @@
 #endif
 #include <new>
 #include <random>
+#include <string>
 
 #include "core/common/common.h"
 
@@ -49,3 +50,14 @@ T* GenerateArrayWithRandomValue(size_t batch_size, T low, T high) {
   }
   return data;
 }
+
+// Throws the error message of a failed C API call. The file that uses it declares g_ort.
+#define ORT_BENCH_THROW_ON_ERROR(expr)                       \
+  do {                                                       \
+    OrtStatus* onnx_status = (expr);                         \
+    if (onnx_status != nullptr) {                            \
+      std::string msg = g_ort->GetErrorMessage(onnx_status); \
+      g_ort->ReleaseStatus(onnx_status);                     \
+      ORT_THROW(msg);                                        \
+    }                                                        \
+  } while (false)
@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include <core/graph/constants.h>
+#include <core/graph/model.h>
+#include <core/session/onnxruntime_c_api.h>
+#include <core/session/onnxruntime_session_options_config_keys.h>
+#include <core/session/ort_env.h>
+
+using namespace onnxruntime;
+using namespace ONNX_NAMESPACE;
+
+extern OrtEnv* env;
+extern const OrtApi* g_ort;
+
+// Builds a model that computes y = activation(x + bias) * gate, with x and gate of shape {rows, cols} and bias of
+// shape {cols}. The activation is Swish, as Sigmoid and Mul nodes, or the Gelu contrib op.
+static std::string BuildGatedActivationModel(bool use_gelu, int64_t rows, int64_t cols) {
+  auto logger = env->GetLoggingManager()->CreateLogger("test");
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 17}, {kMSDomain, 1}};
+  Model model("gated_activation", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, {}, *logger);
+  Graph& graph = model.MainGraph();
+
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_float.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(rows);
+  tensor_float.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(cols);
+
+  TensorProto bias;
+  bias.set_name("bias");
+  bias.set_data_type(TensorProto_DataType_FLOAT);
+  bias.add_dims(cols);
+  for (int64_t i = 0; i < cols; i++) {
+    bias.add_float_data(static_cast<float>(i % 17 - 8) * 0.0625f);
+  }
+  graph.AddInitializedTensor(bias);
+
+  auto& x_arg = graph.GetOrCreateNodeArg("x", &tensor_float);
+  auto& gate_arg = graph.GetOrCreateNodeArg("gate", &tensor_float);
+  auto& bias_arg = graph.GetOrCreateNodeArg("bias", nullptr);
+  auto& biased_arg = graph.GetOrCreateNodeArg("biased", &tensor_float);
+  auto& activation_arg = graph.GetOrCreateNodeArg("activation", &tensor_float);
+  auto& y_arg = graph.GetOrCreateNodeArg("y", &tensor_float);
+
+  graph.AddNode("add", "Add", "", {&x_arg, &bias_arg}, {&biased_arg});
+  if (use_gelu) {
+    graph.AddNode("gelu", "Gelu", "", {&biased_arg}, {&activation_arg}, nullptr, kMSDomain);
+  } else {
+    auto& sigmoid_arg = graph.GetOrCreateNodeArg("sigmoid", &tensor_float);
+    graph.AddNode("sigmoid", "Sigmoid", "", {&biased_arg}, {&sigmoid_arg});
+    graph.AddNode("swish", "Mul", "", {&biased_arg, &sigmoid_arg}, {&activation_arg});
+  }
+  graph.AddNode("gate", "Mul", "", {&activation_arg, &gate_arg}, {&y_arg});
+  ORT_THROW_IF_ERROR(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  return model_data;
+}
+
+// Runs the model with or without the ElementwiseFusion transformer, so that the FusedElementwise kernel can be
+// compared with the separate elementwise kernels.
+static void RunGatedActivation(benchmark::State& state, bool use_gelu) {
+  const int64_t rows = state.range(0);
+  const int64_t cols = state.range(1);
+  const bool fuse = state.range(2) != 0;
+  const std::string model_data = BuildGatedActivationModel(use_gelu, rows, cols);
+
+  const size_t size = static_cast<size_t>(rows * cols);
+  float* x = GenerateArrayWithRandomValue<float>(size, -3.0f, 3.0f);
+  float* gate = GenerateArrayWithRandomValue<float>(size, -1.0f, 1.0f);
+
+  OrtSessionOptions* session_options = nullptr;
+  OrtSession* session = nullptr;
+  OrtMemoryInfo* memory_info = nullptr;
+  OrtValue* inputs[2] = {nullptr, nullptr};
+  const char* input_names[] = {"x", "gate"};
+  const char* output_names[] = {"y"};
+  const int64_t shape[] = {rows, cols};
+
+  const auto check = [&](OrtStatus* status) {
+    if (status == nullptr) {
+      return true;
+    }
+    state.SkipWithError(g_ort->GetErrorMessage(status));
+    g_ort->ReleaseStatus(status);
+    return false;
+  };
+
+  if (check(g_ort->CreateSessionOptions(&session_options)) &&
+      (!fuse || check(g_ort->AddSessionConfigEntry(session_options, kOrtSessionOptionsEnableElementwiseFusion, "1"))) &&
+      check(g_ort->CreateSessionFromArray(env, model_data.data(), model_data.size(), session_options, &session)) &&
+      check(g_ort->CreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &memory_info)) &&
+      check(g_ort->CreateTensorWithDataAsOrtValue(memory_info, x, size * sizeof(float), shape, 2,
+                                                  ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, &inputs[0])) &&
+      check(g_ort->CreateTensorWithDataAsOrtValue(memory_info, gate, size * sizeof(float), shape, 2,
+                                                  ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, &inputs[1]))) {
+    for (auto _ : state) {
+      OrtValue* output = nullptr;
+      if (!check(g_ort->Run(session, nullptr, input_names, inputs, 2, output_names, 1, &output))) {
+        break;
+      }
+      g_ort->ReleaseValue(output);
+    }
+  }
+
+  g_ort->ReleaseValue(inputs[1]);
+  g_ort->ReleaseValue(inputs[0]);
+  g_ort->ReleaseMemoryInfo(memory_info);
+  g_ort->ReleaseSession(session);
+  g_ort->ReleaseSessionOptions(session_options);
+  aligned_free(gate);
+  aligned_free(x);
+}
+
+static void GatedActivationArgs(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"Rows", "Cols", "Fused"});
+  for (int64_t rows : {16, 128, 512}) {
+    for (int64_t cols : {1024, 4096}) {
+      for (int64_t fuse : {0, 1}) {
+        b->Args({rows, cols, fuse});
+      }
+    }
+  }
+}
+
+static void BM_SwishGate(benchmark::State& state) {
+  RunGatedActivation(state, /*use_gelu*/ false);
+}
+
+BENCHMARK(BM_SwishGate)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(GatedActivationArgs);
+
+static void BM_GeluGate(benchmark::State& state) {
+  RunGatedActivation(state, /*use_gelu*/ true);
+}
+
+BENCHMARK(BM_GeluGate)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(GatedActivationArgs);
@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include "contrib_ops/cpu/bert/gqa_attention_base.h"
+#include "core/framework/allocator.h"
+#include "core/framework/config_options.h"
+#include "core/framework/data_transfer_manager.h"
+#include "core/framework/op_kernel_info.h"
+#include "core/framework/ort_value_name_idx_map.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/cpu_provider_factory_creator.h"
+#include "core/util/thread_utils.h"
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+using namespace onnxruntime;
+
+namespace {
+
+constexpr int64_t kHeadSize = 128;
+constexpr int kNumThreads = 8;
+
+// Runs the attention of GroupQueryAttention for one new token of a single sequence, with past and present sharing a
+// buffer of total_sequence_length tokens.
+class GqaDecodeAttention : public contrib::GQAAttentionBase {
+ public:
+  explicit GqaDecodeAttention(const OpKernelInfo& info) : GQAAttentionBase(info, false) {}
+
+  // Parallel over heads only: the scores of the whole sequence, then scores x V. This is how token generation was
+  // computed before the sequence was split, kept as the baseline.
+  void RunUnsplit(float* output, const float* q, const float* k, const float* v, const int32_t* seqlens_k,
+                  size_t total_sequence_length, float* present_key, float* present_value, float* attention_probs,
+                  concurrency::ThreadPool* tp, AllocatorPtr allocator) const {
+    ComputeAttentionProbs(attention_probs, q, k, seqlens_k, static_cast<const float*>(nullptr), 1, 1, {},
+                          total_sequence_length, total_sequence_length, kHeadSize, present_key, present_key, true,
+                          false, false, tp, allocator);
+    ComputeVxAttentionScore(output, attention_probs, v, seqlens_k, 1, 1, total_sequence_length,
+                            total_sequence_length, kHeadSize, static_cast<size_t>(num_heads_ * kHeadSize),
+                            present_value, present_value, true, false, false, tp, allocator);
+  }
+
+  // Returns false if DecodeSplitCount doesn't split the sequence.
+  bool RunSplitKV(float* output, const float* q, const float* k, const float* v, const int32_t* seqlens_k,
+                  size_t total_sequence_length, float* present_key, float* present_value,
+                  concurrency::ThreadPool* tp, AllocatorPtr allocator) const {
+    const size_t num_splits = DecodeSplitCount(1, total_sequence_length, tp);
+    if (num_splits <= 1) {
+      return false;
+    }
+    ComputeDecodeAttentionSplitKV(output, q, k, v, seqlens_k, static_cast<const float*>(nullptr), {}, 1, num_splits,
+                                  total_sequence_length, total_sequence_length, kHeadSize, present_key, present_key,
+                                  present_value, present_value, true, false, tp, allocator);
+    return true;
+  }
+};
+
+std::vector<float> MakeData(size_t size) {
+  std::mt19937 gen(5);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> data(size);
+  for (auto& v : data) {
+    v = dist(gen);
+  }
+  return data;
+}
+
+// state.range(0) heads of Q, state.range(1) heads of K and V and state.range(2) tokens in the sequence.
+void RunGqaDecodeAttention(benchmark::State& state, bool split_kv) {
+  const int64_t num_heads = state.range(0);
+  const int64_t kv_num_heads = state.range(1);
+  const auto total_sequence_length = static_cast<size_t>(state.range(2));
+
+  onnxruntime::Node node;
+  node.AddAttribute("num_heads", num_heads);
+  node.AddAttribute("kv_num_heads", kv_num_heads);
+
+  KernelDef kernel_def;
+  std::unique_ptr<IExecutionProvider> execution_provider = CPUProviderFactoryCreator::Create(true)->CreateProvider();
+  std::unordered_map<int, OrtValue> constant_initialized_tensors;
+  OrtValueNameIdxMap mlvalue_name_idx_map;
+  DataTransferManager data_transfer_mgr;
+  AllocatorMap allocators;
+  ConfigOptions config_options;
+  OpKernelInfo op_kernel_info(node, kernel_def, *execution_provider, constant_initialized_tensors, mlvalue_name_idx_map,
+                              data_transfer_mgr, allocators, config_options);
+  GqaDecodeAttention attention(op_kernel_info);
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = kNumThreads;
+  tpo.auto_set_affinity = true;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), tpo, concurrency::ThreadPoolType::INTRA_OP);
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+
+  const auto q = MakeData(static_cast<size_t>(num_heads * kHeadSize));
+  const auto k = MakeData(static_cast<size_t>(kv_num_heads * kHeadSize));
+  const auto v = MakeData(static_cast<size_t>(kv_num_heads * kHeadSize));
+  auto present_key = MakeData(static_cast<size_t>(kv_num_heads) * total_sequence_length * kHeadSize);
+  auto present_value = MakeData(static_cast<size_t>(kv_num_heads) * total_sequence_length * kHeadSize);
+  const std::vector<int32_t> seqlens_k{static_cast<int32_t>(total_sequence_length - 1)};
+  std::vector<float> attention_probs(static_cast<size_t>(num_heads) * total_sequence_length);
+  std::vector<float> output(static_cast<size_t>(num_heads * kHeadSize));
+
+  for (auto _ : state) {
+    if (split_kv) {
+      if (!attention.RunSplitKV(output.data(), q.data(), k.data(), v.data(), seqlens_k.data(), total_sequence_length,
+                                present_key.data(), present_value.data(), tp.get(), allocator)) {
+        state.SkipWithError("The sequence is not split.");
+        break;
+      }
+    } else {
+      attention.RunUnsplit(output.data(), q.data(), k.data(), v.data(), seqlens_k.data(), total_sequence_length,
+                           present_key.data(), present_value.data(), attention_probs.data(), tp.get(), allocator);
+    }
+    benchmark::DoNotOptimize(output.data());
+  }
+  state.SetItemsProcessed(state.iterations() * num_heads);
+}
+
+}  // namespace
+
+static void BM_GqaDecodeAttention_Unsplit(benchmark::State& state) {
+  RunGqaDecodeAttention(state, false);
+}
+
+static void BM_GqaDecodeAttention_SplitKV(benchmark::State& state) {
+  RunGqaDecodeAttention(state, true);
+}
+
+// Single sequence token generation with fewer heads than threads, for MQA and GQA models with long contexts.
+#define GQA_DECODE_BENCHMARK_ARGS(name)         \
+  BENCHMARK(name)                               \
+      ->UseRealTime()                           \
+      ->Unit(benchmark::TimeUnit::kMicrosecond) \
+      ->Args({1, 1, 2048})                      \
+      ->Args({2, 1, 8192})                      \
+      ->Args({4, 2, 8192})                      \
+      ->Args({4, 2, 32768})
+
+GQA_DECODE_BENCHMARK_ARGS(BM_GqaDecodeAttention_Unsplit);
+GQA_DECODE_BENCHMARK_ARGS(BM_GqaDecodeAttention_SplitKV);
@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/inlined_containers.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/ml/ml_common.h"
+#include "core/util/thread_utils.h"
+
+using namespace onnxruntime;
+
+namespace {
+
+std::vector<std::string> MakeVocabulary(size_t size) {
+  std::vector<std::string> vocabulary;
+  vocabulary.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    vocabulary.push_back("token_" + std::to_string(i * 2654435761u));
+  }
+  return vocabulary;
+}
+
+// Draws queries from the vocabulary with ~10% misses, matching what CategoryMapper / LabelEncoder see with a
+// default value configured.
+std::vector<std::string> MakeQueries(const std::vector<std::string>& vocabulary, size_t count) {
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<size_t> index_dist(0, vocabulary.size() - 1);
+  std::uniform_int_distribution<int> miss_dist(0, 9);
+  std::vector<std::string> queries;
+  queries.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    queries.push_back(miss_dist(gen) == 0 ? "missing_" + std::to_string(i) : vocabulary[index_dist(gen)]);
+  }
+  return queries;
+}
+
+template <typename TMap>
+void RunStringLookup(benchmark::State& state, concurrency::ThreadPool* tp) {
+  const auto vocabulary = MakeVocabulary(static_cast<size_t>(state.range(0)));
+  const auto queries = MakeQueries(vocabulary, 100000);
+
+  TMap map;
+  map.reserve(vocabulary.size());
+  for (size_t i = 0; i < vocabulary.size(); ++i) {
+    map[vocabulary[i]] = static_cast<int64_t>(i);
+  }
+
+  std::vector<int64_t> output(queries.size());
+  for (auto _ : state) {
+    ml::BatchLookup(tp, gsl::make_span(queries), gsl::make_span(output), [&map](const std::string& key) {
+      auto found = map.find(key);
+      return found == map.end() ? int64_t{-1} : found->second;
+    });
+    benchmark::DoNotOptimize(output.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(queries.size()));
+}
+
+std::unique_ptr<concurrency::ThreadPool> CreateThreadPool(int num_threads) {
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = num_threads;
+  tpo.auto_set_affinity = true;
+  return concurrency::CreateThreadPool(&onnxruntime::Env::Default(), tpo, concurrency::ThreadPoolType::INTRA_OP);
+}
+
+}  // namespace
+
+static void BM_StringLookup_UnorderedMap(benchmark::State& state) {
+  RunStringLookup<std::unordered_map<std::string, int64_t>>(state, nullptr);
+}
+
+static void BM_StringLookup_InlinedHashMap(benchmark::State& state) {
+  RunStringLookup<InlinedHashMap<std::string, int64_t>>(state, nullptr);
+}
+
+static void BM_StringLookup_InlinedHashMap_Parallel(benchmark::State& state) {
+  auto tp = CreateThreadPool(4);
+  RunStringLookup<InlinedHashMap<std::string, int64_t>>(state, tp.get());
+}
+
+BENCHMARK(BM_StringLookup_UnorderedMap)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(1000000);
+
+BENCHMARK(BM_StringLookup_InlinedHashMap)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(1000000);
+
+BENCHMARK(BM_StringLookup_InlinedHashMap_Parallel)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(1000000);
@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/graph/onnx_protobuf.h"
+#include "core/session/onnxruntime_c_api.h"
+
+extern OrtEnv* env;
+extern const OrtApi* g_ort;
+
+namespace {
+
+constexpr int64_t kSeqLength = 16;
+constexpr int kNumThreads = 4;
+
+void AddRandomInitializer(ONNX_NAMESPACE::GraphProto& graph, const std::string& name,
+                          std::initializer_list<int64_t> dims, std::mt19937& gen) {
+  auto* initializer = graph.add_initializer();
+  initializer->set_name(name);
+  initializer->set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  int64_t size = 1;
+  for (auto dim : dims) {
+    initializer->add_dims(dim);
+    size *= dim;
+  }
+
+  std::uniform_real_distribution<float> dist(-0.1f, 0.1f);
+  for (int64_t i = 0; i < size; ++i) {
+    initializer->add_float_data(dist(gen));
+  }
+}
+
+// Runs a single forward LSTM or GRU node over kSeqLength steps with hidden_size = input_size = state.range(0) and
+// batch_size = state.range(1). W and R are initializers so they are pre-packed when the session is created.
+void RunRnnModel(benchmark::State& state, const std::string& op_type, int64_t num_gates) {
+  const int64_t hidden_size = state.range(0);
+  const int64_t batch_size = state.range(1);
+  const int64_t input_size = hidden_size;
+
+  ONNX_NAMESPACE::ModelProto model;
+  model.set_ir_version(ONNX_NAMESPACE::IR_VERSION);
+  auto* opset = model.add_opset_import();
+  opset->set_domain("");
+  opset->set_version(14);
+  auto* graph = model.mutable_graph();
+  graph->set_name("rnn");
+
+  auto* node = graph->add_node();
+  node->set_op_type(op_type);
+  node->add_input("X");
+  node->add_input("W");
+  node->add_input("R");
+  node->add_input("B");
+  node->add_output("Y");
+  node->add_output("Y_h");
+  auto* hidden_size_attr = node->add_attribute();
+  hidden_size_attr->set_name("hidden_size");
+  hidden_size_attr->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_INT);
+  hidden_size_attr->set_i(hidden_size);
+
+  std::mt19937 gen(1234);
+  AddRandomInitializer(*graph, "W", {1, num_gates * hidden_size, input_size}, gen);
+  AddRandomInitializer(*graph, "R", {1, num_gates * hidden_size, hidden_size}, gen);
+  AddRandomInitializer(*graph, "B", {1, 2 * num_gates * hidden_size}, gen);
+
+  auto add_value_info = [](ONNX_NAMESPACE::ValueInfoProto* value_info, const std::string& name,
+                           std::initializer_list<int64_t> dims) {
+    value_info->set_name(name);
+    auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+    tensor_type->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    for (auto dim : dims) {
+      tensor_type->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+  };
+  add_value_info(graph->add_input(), "X", {kSeqLength, batch_size, input_size});
+  add_value_info(graph->add_output(), "Y", {kSeqLength, 1, batch_size, hidden_size});
+  add_value_info(graph->add_output(), "Y_h", {1, batch_size, hidden_size});
+  const std::string model_bytes = model.SerializeAsString();
+
+  OrtSessionOptions* session_options = nullptr;
+  ORT_BENCH_THROW_ON_ERROR(g_ort->CreateSessionOptions(&session_options));
+  ORT_BENCH_THROW_ON_ERROR(g_ort->SetIntraOpNumThreads(session_options, kNumThreads));
+  OrtSession* session = nullptr;
+  ORT_BENCH_THROW_ON_ERROR(g_ort->CreateSessionFromArray(env, model_bytes.data(), model_bytes.size(), session_options,
+                                                         &session));
+
+  const int64_t input_dims[] = {kSeqLength, batch_size, input_size};
+  std::vector<float> input_data(static_cast<size_t>(kSeqLength * batch_size * input_size));
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  for (auto& v : input_data) {
+    v = dist(gen);
+  }
+
+  OrtMemoryInfo* memory_info = nullptr;
+  ORT_BENCH_THROW_ON_ERROR(g_ort->CreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &memory_info));
+  OrtValue* input = nullptr;
+  ORT_BENCH_THROW_ON_ERROR(g_ort->CreateTensorWithDataAsOrtValue(memory_info, input_data.data(),
+                                                                 input_data.size() * sizeof(float), input_dims, 3,
+                                                                 ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, &input));
+
+  const char* input_name = "X";
+  const char* output_names[] = {"Y", "Y_h"};
+  OrtValue* outputs[] = {nullptr, nullptr};
+
+  for (auto _ : state) {
+    ORT_BENCH_THROW_ON_ERROR(g_ort->Run(session, nullptr, &input_name, &input, 1, output_names, 2, outputs));
+    for (auto*& output : outputs) {
+      g_ort->ReleaseValue(output);
+      output = nullptr;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kSeqLength * batch_size);
+
+  g_ort->ReleaseValue(input);
+  g_ort->ReleaseMemoryInfo(memory_info);
+  g_ort->ReleaseSession(session);
+  g_ort->ReleaseSessionOptions(session_options);
+}
+
+}  // namespace
+
+// hidden sizes 128 - 1024 with a single stream and a small batch of streams.
+#define RNN_BENCHMARK_ARGS(name)                \
+  BENCHMARK(name)                               \
+      ->UseRealTime()                           \
+      ->Unit(benchmark::TimeUnit::kMicrosecond) \
+      ->ArgsProduct({{128, 256, 512, 1024}, {1, 8}})
+
+static void BM_LSTM(benchmark::State& state) {
+  RunRnnModel(state, "LSTM", 4);
+}
+RNN_BENCHMARK_ARGS(BM_LSTM);
+
+static void BM_GRU(benchmark::State& state) {
+  RunRnnModel(state, "GRU", 3);
+}
+RNN_BENCHMARK_ARGS(BM_GRU);
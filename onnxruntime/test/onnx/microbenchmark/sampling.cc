@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "contrib_ops/cpu/transformers/sampling_top_p.h"
+#include "core/platform/threadpool.h"
+#include "core/util/thread_utils.h"
+
+using namespace onnxruntime;
+
+namespace {
+
+constexpr float kTopP = 0.9f;
+constexpr float kFilterValue = -std::numeric_limits<float>::infinity();
+
+// Normally distributed logits. A standard deviation of 3 is flatter than most language models and leaves thousands of
+// tokens in the top 0.9 of the probability mass, so the candidate set has to grow a few times.
+std::vector<float> MakeLogits(size_t batch_size, size_t vocab_size) {
+  std::mt19937 gen(11);
+  std::normal_distribution<float> dist(0.0f, 3.0f);
+  std::vector<float> logits(batch_size * vocab_size);
+  for (auto& v : logits) {
+    v = dist(gen);
+  }
+  return logits;
+}
+
+std::unique_ptr<concurrency::ThreadPool> CreateThreadPool(int num_threads) {
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = num_threads;
+  tpo.auto_set_affinity = true;
+  return concurrency::CreateThreadPool(&onnxruntime::Env::Default(), tpo, concurrency::ThreadPoolType::INTRA_OP);
+}
+
+void RunTopPFilter(benchmark::State& state, concurrency::ThreadPool* tp) {
+  const auto vocab_size = static_cast<size_t>(state.range(0));
+  const auto batch_size = static_cast<size_t>(state.range(1));
+  const auto logits = MakeLogits(batch_size, vocab_size);
+
+  std::vector<float> scores(logits.size());
+  std::vector<float> probs(logits.size());
+  std::vector<int32_t> indices(logits.size());
+  for (auto _ : state) {
+    std::copy(logits.begin(), logits.end(), scores.begin());
+    contrib::SamplingCpuHelper::TopPFilter(gsl::make_span(scores), batch_size, kTopP, kFilterValue, 1, false,
+                                           gsl::make_span(probs), gsl::make_span(indices), tp);
+    benchmark::DoNotOptimize(scores.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch_size));
+}
+
+}  // namespace
+
+// Sorts the whole vocabulary of every row before computing the cumulative probabilities. This is how top-p was done
+// before the partial selection, kept as the baseline.
+static void BM_TopPFilter_FullSort(benchmark::State& state) {
+  const auto vocab_size = static_cast<size_t>(state.range(0));
+  const auto batch_size = static_cast<size_t>(state.range(1));
+  const auto logits = MakeLogits(batch_size, vocab_size);
+
+  std::vector<float> scores(logits.size());
+  std::vector<float> sorted_scores(logits.size());
+  std::vector<float> cumulative_probs(logits.size());
+  std::vector<size_t> sorted_indices(logits.size());
+  for (auto _ : state) {
+    std::copy(logits.begin(), logits.end(), scores.begin());
+    for (size_t i = 0; i < batch_size; ++i) {
+      const size_t offset = i * vocab_size;
+      auto indices_begin = sorted_indices.begin() + offset;
+      std::iota(indices_begin, indices_begin + vocab_size, size_t{0});
+      std::sort(indices_begin, indices_begin + vocab_size,
+                [&](size_t a, size_t b) { return scores[offset + a] < scores[offset + b]; });
+      std::copy(scores.begin() + offset, scores.begin() + offset + vocab_size, sorted_scores.begin() + offset);
+      std::sort(sorted_scores.begin() + offset, sorted_scores.begin() + offset + vocab_size);
+      MlasComputeSoftmax(sorted_scores.data() + offset, cumulative_probs.data() + offset, 1, vocab_size, false, false,
+                         nullptr);
+      for (size_t j = 0; j < vocab_size - 1; ++j) {
+        if (j > 0) {
+          cumulative_probs[offset + j] += cumulative_probs[offset + j - 1];
+        }
+        if (cumulative_probs[offset + j] <= 1 - kTopP) {
+          scores[offset + sorted_indices[offset + j]] = kFilterValue;
+        }
+      }
+    }
+    benchmark::DoNotOptimize(scores.data());
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch_size));
+}
+
+static void BM_TopPFilter(benchmark::State& state) {
+  RunTopPFilter(state, nullptr);
+}
+
+static void BM_TopPFilter_Parallel(benchmark::State& state) {
+  auto tp = CreateThreadPool(4);
+  RunTopPFilter(state, tp.get());
+}
+
+// vocabularies of 32k (llama 2) to 256k (gemma) tokens, with a single sequence and a batch of sequences.
+#define TOP_P_BENCHMARK_ARGS(name)              \
+  BENCHMARK(name)                               \
+      ->UseRealTime()                           \
+      ->Unit(benchmark::TimeUnit::kMicrosecond) \
+      ->ArgsProduct({{32000, 128256, 151936, 256000}, {1, 8}})
+
+TOP_P_BENCHMARK_ARGS(BM_TopPFilter_FullSort);
+TOP_P_BENCHMARK_ARGS(BM_TopPFilter);
+TOP_P_BENCHMARK_ARGS(BM_TopPFilter_Parallel);
@@ -0,0 +1,160 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/graph/onnx_protobuf.h"
+#include "core/session/onnxruntime_c_api.h"
+
+extern OrtEnv* env;
+extern const OrtApi* g_ort;
+
+namespace {
+
+// Generates `count` strings of `words_per_string` space separated words. Word lengths mix SSO-sized and heap-sized
+// strings, as seen in tokenization inputs.
+std::vector<std::string> GenerateSentences(size_t count, int words_per_string) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> length_dist(2, 40);
+  std::uniform_int_distribution<int> char_dist('a', 'z');
+  std::vector<std::string> sentences(count);
+  for (auto& s : sentences) {
+    for (int w = 0; w < words_per_string; ++w) {
+      if (w != 0) {
+        s.push_back(' ');
+      }
+      const int length = length_dist(gen);
+      for (int c = 0; c < length; ++c) {
+        s.push_back(static_cast<char>(char_dist(gen)));
+      }
+    }
+  }
+  return sentences;
+}
+
+// Runs a single-node model with a 1-D string input of state.range(0) rows using state.range(1) intra-op threads.
+void RunStringOpModel(benchmark::State& state, const ONNX_NAMESPACE::NodeProto& node,
+                      ONNX_NAMESPACE::TensorProto_DataType output_type, int words_per_string) {
+  const auto num_rows = static_cast<int64_t>(state.range(0));
+
+  ONNX_NAMESPACE::ModelProto model;
+  model.set_ir_version(ONNX_NAMESPACE::IR_VERSION);
+  auto* opset = model.add_opset_import();
+  opset->set_domain("");
+  opset->set_version(20);
+  auto* graph = model.mutable_graph();
+  graph->set_name("string_op");
+  *graph->add_node() = node;
+
+  auto add_value_info = [num_rows](ONNX_NAMESPACE::ValueInfoProto* value_info, const std::string& name,
+                                   ONNX_NAMESPACE::TensorProto_DataType type, bool known_shape) {
+    value_info->set_name(name);
+    auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+    tensor_type->set_elem_type(type);
+    if (known_shape) {
+      tensor_type->mutable_shape()->add_dim()->set_dim_value(num_rows);
+    }
+  };
+  add_value_info(graph->add_input(), node.input(0), ONNX_NAMESPACE::TensorProto_DataType_STRING, true);
+  add_value_info(graph->add_output(), node.output(0), output_type, false);
+  for (int i = 1; i < node.output_size(); ++i) {
+    add_value_info(graph->add_output(), node.output(i), ONNX_NAMESPACE::TensorProto_DataType_INT64, false);
+  }
+  const std::string model_bytes = model.SerializeAsString();
+
+  OrtSessionOptions* session_options = nullptr;
+  ORT_BENCH_THROW_ON_ERROR(g_ort->CreateSessionOptions(&session_options));
+  ORT_BENCH_THROW_ON_ERROR(g_ort->SetIntraOpNumThreads(session_options, static_cast<int>(state.range(1))));
+  OrtSession* session = nullptr;
+  ORT_BENCH_THROW_ON_ERROR(g_ort->CreateSessionFromArray(env, model_bytes.data(), model_bytes.size(), session_options,
+                                                         &session));
+
+  const auto sentences = GenerateSentences(static_cast<size_t>(num_rows), words_per_string);
+  std::vector<const char*> sentence_ptrs;
+  for (const auto& s : sentences) {
+    sentence_ptrs.push_back(s.c_str());
+  }
+
+  OrtAllocator* allocator = nullptr;
+  ORT_BENCH_THROW_ON_ERROR(g_ort->GetAllocatorWithDefaultOptions(&allocator));
+  OrtValue* input = nullptr;
+  ORT_BENCH_THROW_ON_ERROR(g_ort->CreateTensorAsOrtValue(allocator, &num_rows, 1,
+                                                         ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING, &input));
+  ORT_BENCH_THROW_ON_ERROR(g_ort->FillStringTensor(input, sentence_ptrs.data(), sentence_ptrs.size()));
+
+  const char* input_name = node.input(0).c_str();
+  std::vector<const char*> output_names;
+  for (const auto& name : node.output()) {
+    output_names.push_back(name.c_str());
+  }
+  std::vector<OrtValue*> outputs(output_names.size(), nullptr);
+
+  for (auto _ : state) {
+    ORT_BENCH_THROW_ON_ERROR(g_ort->Run(session, nullptr, &input_name, &input, 1, output_names.data(),
+                                        output_names.size(), outputs.data()));
+    for (auto*& output : outputs) {
+      g_ort->ReleaseValue(output);
+      output = nullptr;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_rows);
+
+  g_ort->ReleaseValue(input);
+  g_ort->ReleaseSession(session);
+  g_ort->ReleaseSessionOptions(session_options);
+}
+
+ONNX_NAMESPACE::NodeProto MakeNode(const std::string& op_type, std::initializer_list<std::string> outputs) {
+  ONNX_NAMESPACE::NodeProto node;
+  node.set_op_type(op_type);
+  node.add_input("X");
+  for (const auto& output : outputs) {
+    node.add_output(output);
+  }
+  return node;
+}
+
+}  // namespace
+
+// 100k-row batches, run with 1 and 4 intra-op threads.
+#define STRING_OP_BENCHMARK_ARGS(name)          \
+  BENCHMARK(name)                               \
+      ->UseRealTime()                           \
+      ->Unit(benchmark::TimeUnit::kMillisecond) \
+      ->Args({100000, 1})                       \
+      ->Args({100000, 4})
+
+static void BM_StringSplit(benchmark::State& state) {
+  RunStringOpModel(state, MakeNode("StringSplit", {"Y", "Z"}), ONNX_NAMESPACE::TensorProto_DataType_STRING, 8);
+}
+STRING_OP_BENCHMARK_ARGS(BM_StringSplit);
+
+static void BM_RegexFullMatch(benchmark::State& state) {
+  auto node = MakeNode("RegexFullMatch", {"Y"});
+  auto* pattern = node.add_attribute();
+  pattern->set_name("pattern");
+  pattern->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_STRING);
+  pattern->set_s("([a-z]+ )*[a-m]+");
+  RunStringOpModel(state, node, ONNX_NAMESPACE::TensorProto_DataType_BOOL, 8);
+}
+STRING_OP_BENCHMARK_ARGS(BM_RegexFullMatch);
+
+static void BM_StringNormalizer(benchmark::State& state) {
+  auto node = MakeNode("StringNormalizer", {"Y"});
+  auto* case_change_action = node.add_attribute();
+  case_change_action->set_name("case_change_action");
+  case_change_action->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_STRING);
+  case_change_action->set_s("UPPER");
+  auto* is_case_sensitive = node.add_attribute();
+  is_case_sensitive->set_name("is_case_sensitive");
+  is_case_sensitive->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_INT);
+  is_case_sensitive->set_i(1);
+  RunStringOpModel(state, node, ONNX_NAMESPACE::TensorProto_DataType_STRING, 1);
+}
+STRING_OP_BENCHMARK_ARGS(BM_StringNormalizer);
@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/ml/svmclassifier.h"
+#include "core/util/thread_utils.h"
+
+using namespace onnxruntime;
+
+namespace {
+
+std::vector<float> MakeData(size_t size) {
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> data(size);
+  for (auto& v : data) {
+    v = dist(gen);
+  }
+  return data;
+}
+
+// state.range(0) batch rows, state.range(1) support vectors and state.range(2) features.
+void RunRbfKernel(benchmark::State& state, concurrency::ThreadPool* tp) {
+  const int64_t num_batches = state.range(0);
+  const int64_t num_support_vectors = state.range(1);
+  const int64_t num_features = state.range(2);
+  const auto x = MakeData(static_cast<size_t>(num_batches * num_features));
+  const auto support_vectors = MakeData(static_cast<size_t>(num_support_vectors * num_features));
+  const float gamma = 1.0f / static_cast<float>(num_features);
+
+  std::vector<float> out(static_cast<size_t>(num_batches * num_support_vectors));
+  for (auto _ : state) {
+    ml::ComputeRbfKernel<float>(x, support_vectors, num_batches, num_support_vectors, num_features, gamma, out, tp);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * num_batches * num_support_vectors);
+}
+
+}  // namespace
+
+// Computes the kernel of every batch row and support vector one at a time. This is how the RBF kernel was computed
+// before the support vectors were blocked, kept as the baseline.
+static void BM_SvmRbfKernel_Scalar(benchmark::State& state) {
+  const int64_t num_batches = state.range(0);
+  const int64_t num_support_vectors = state.range(1);
+  const int64_t num_features = state.range(2);
+  const auto x = MakeData(static_cast<size_t>(num_batches * num_features));
+  const auto support_vectors = MakeData(static_cast<size_t>(num_support_vectors * num_features));
+  const float gamma = 1.0f / static_cast<float>(num_features);
+
+  std::vector<float> out(static_cast<size_t>(num_batches * num_support_vectors));
+  for (auto _ : state) {
+    float* cur_out = out.data();
+    const float* cur_batch = x.data();
+    for (int64_t batch = 0; batch < num_batches; ++batch) {
+      const float* cur_support_vector = support_vectors.data();
+      for (int64_t support_vector = 0; support_vector < num_support_vectors; ++support_vector) {
+        float sum = 0.f;
+        const float* cur_input = cur_batch;
+        for (int64_t feature = 0; feature < num_features; ++feature) {
+          float val = *cur_input++ - *cur_support_vector++;
+          sum += val * val;
+        }
+        *cur_out++ = std::exp(-gamma * sum);
+      }
+      cur_batch += num_features;
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * num_batches * num_support_vectors);
+}
+
+static void BM_SvmRbfKernel(benchmark::State& state) {
+  RunRbfKernel(state, nullptr);
+}
+
+static void BM_SvmRbfKernel_Parallel(benchmark::State& state) {
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 4;
+  tpo.auto_set_affinity = true;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), tpo, concurrency::ThreadPoolType::INTRA_OP);
+  RunRbfKernel(state, tp.get());
+}
+
+// Few to many features, with support vector counts of small and large scikit-learn SVC models.
+#define SVM_RBF_BENCHMARK_ARGS(name)            \
+  BENCHMARK(name)                               \
+      ->UseRealTime()                           \
+      ->Unit(benchmark::TimeUnit::kMicrosecond) \
+      ->Args({10000, 100, 10})                  \
+      ->Args({1000, 500, 20})                   \
+      ->Args({1000, 1000, 100})                 \
+      ->Args({100, 2000, 500})
+
+SVM_RBF_BENCHMARK_ARGS(BM_SvmRbfKernel_Scalar);
+SVM_RBF_BENCHMARK_ARGS(BM_SvmRbfKernel);
+SVM_RBF_BENCHMARK_ARGS(BM_SvmRbfKernel_Parallel);
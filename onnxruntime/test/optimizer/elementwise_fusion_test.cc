@@ -0,0 +1,228 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "graph_transform_test_builder.h"
+
+#include "core/graph/graph.h"
+#include "core/optimizer/elementwise_fusion.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+#ifndef DISABLE_CONTRIB_OPS
+
+namespace {
+
+// ElementwiseFusion only runs when it is enabled in the session options.
+void EnableElementwiseFusion(SessionOptions& session_options) {
+  ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(kOrtSessionOptionsEnableElementwiseFusion, "1"));
+}
+
+}  // namespace
+
+// Swish of a biased input, scaled by a constant: Mul(Mul(y, Sigmoid(y)), 0.5) with y = Add(x, bias).
+TEST(ElementwiseFusionTests, SwishWithBroadcastBias) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 3, 64}, -4.f, 4.f);
+    auto* bias_arg = builder.MakeInitializer<float>({64}, -1.f, 1.f);
+    auto* scale_arg = builder.MakeScalarInitializer<float>(0.5f);
+    auto* add_out_arg = builder.MakeIntermediate();
+    auto* sigmoid_out_arg = builder.MakeIntermediate();
+    auto* swish_out_arg = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Add", {input_arg, bias_arg}, {add_out_arg});
+    builder.AddNode("Sigmoid", {add_out_arg}, {sigmoid_out_arg});
+    builder.AddNode("Mul", {add_out_arg, sigmoid_out_arg}, {swish_out_arg});
+    builder.AddNode("Mul", {swish_out_arg, scale_arg}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(op_to_count["Add"], 0);
+    EXPECT_EQ(op_to_count["Sigmoid"], 0);
+    EXPECT_EQ(op_to_count["Mul"], 0);
+    EXPECT_EQ(op_to_count["com.microsoft.QuickGelu"], 0);
+  };
+
+  TransformerTester(build_test_case,
+                    check_graph,
+                    TransformerLevel::Level2,
+                    TransformerLevel::Level3, 13, 0.0001, 0.000001, nullptr, EnableElementwiseFusion);
+}
+
+// Gelu of a biased input multiplied by a second input that is broadcast along the leading dimension.
+TEST(ElementwiseFusionTests, GeluMulBroadcastInputs) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({4, 8, 32}, -3.f, 3.f);
+    auto* gate_arg = builder.MakeInput<float>({8, 32}, -1.f, 1.f);
+    auto* bias_arg = builder.MakeInitializer<float>({32}, -1.f, 1.f);
+    auto* add_out_arg = builder.MakeIntermediate();
+    auto* gelu_out_arg = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Add", {input_arg, bias_arg}, {add_out_arg});
+    builder.AddNode("Gelu", {add_out_arg}, {gelu_out_arg}, kMSDomain);
+    builder.AddNode("Mul", {gelu_out_arg, gate_arg}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(op_to_count["com.microsoft.BiasGelu"], 0);
+    EXPECT_EQ(op_to_count["com.microsoft.Gelu"], 0);
+    EXPECT_EQ(op_to_count["Mul"], 0);
+  };
+
+  TransformerTester(build_test_case,
+                    check_graph,
+                    TransformerLevel::Level2,
+                    TransformerLevel::Level3, 13, 0.0001, 0.000001, nullptr, EnableElementwiseFusion);
+}
+
+// The result of the Add is a graph output, so only the Tanh and the Mul are fused.
+TEST(ElementwiseFusionTests, IntermediateIsGraphOutput) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input1_arg = builder.MakeInput<float>({3, 16}, -2.f, 2.f);
+    auto* input2_arg = builder.MakeInput<float>({3, 16}, -2.f, 2.f);
+    auto* add_out_arg = builder.MakeOutput();
+    auto* tanh_out_arg = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Add", {input1_arg, input2_arg}, {add_out_arg});
+    builder.AddNode("Tanh", {add_out_arg}, {tanh_out_arg});
+    builder.AddNode("Mul", {tanh_out_arg, input2_arg}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(op_to_count["Add"], 1);
+    EXPECT_EQ(op_to_count["Tanh"], 0);
+    EXPECT_EQ(op_to_count["Mul"], 0);
+  };
+
+  TransformerTester(build_test_case,
+                    check_graph,
+                    TransformerLevel::Level2,
+                    TransformerLevel::Level3, 13, 0.0001, 0.000001, nullptr, EnableElementwiseFusion);
+}
+
+// The Add is also consumed by a Transpose, so it cannot be fused with the Relu.
+TEST(ElementwiseFusionTests, IntermediateHasOtherConsumer) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input1_arg = builder.MakeInput<float>({3, 16}, -2.f, 2.f);
+    auto* input2_arg = builder.MakeInput<float>({3, 16}, -2.f, 2.f);
+    auto* add_out_arg = builder.MakeIntermediate();
+    auto* relu_out_arg = builder.MakeOutput();
+    auto* transpose_out_arg = builder.MakeOutput();
+
+    builder.AddNode("Add", {input1_arg, input2_arg}, {add_out_arg});
+    builder.AddNode("Relu", {add_out_arg}, {relu_out_arg});
+    builder.AddNode("Transpose", {add_out_arg}, {transpose_out_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 0);
+    EXPECT_EQ(op_to_count["Add"], 1);
+    EXPECT_EQ(op_to_count["Relu"], 1);
+  };
+
+  TransformerTester(build_test_case,
+                    check_graph,
+                    TransformerLevel::Level2,
+                    TransformerLevel::Level3, 13, 0.0, 0.0, nullptr, EnableElementwiseFusion);
+}
+
+// Without the session option, the nodes are not fused.
+TEST(ElementwiseFusionTests, DisabledByDefault) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input1_arg = builder.MakeInput<float>({3, 16}, -2.f, 2.f);
+    auto* input2_arg = builder.MakeInput<float>({3, 16}, -2.f, 2.f);
+    auto* add_out_arg = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Add", {input1_arg, input2_arg}, {add_out_arg});
+    builder.AddNode("Tanh", {add_out_arg}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 0);
+    EXPECT_EQ(op_to_count["Add"], 1);
+    EXPECT_EQ(op_to_count["Tanh"], 1);
+  };
+
+  TransformerTester(build_test_case,
+                    check_graph,
+                    TransformerLevel::Level2,
+                    TransformerLevel::Level3, 13);
+}
+
+// The fused Exp computes the same values as the Exp kernel, including the Exp of the broadcast bias, which the
+// FusedElementwise kernel evaluates before broadcasting it.
+TEST(ElementwiseFusionTests, ExpMatchesUnfusedGraph) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({8, 300}, -4.f, 4.f);
+    auto* bias_arg = builder.MakeInput<float>({300}, -2.f, 2.f);
+    auto* neg_out_arg = builder.MakeIntermediate();
+    auto* exp_out_arg = builder.MakeIntermediate();
+    auto* bias_exp_out_arg = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Neg", {input_arg}, {neg_out_arg});
+    builder.AddNode("Exp", {neg_out_arg}, {exp_out_arg});
+    builder.AddNode("Exp", {bias_arg}, {bias_exp_out_arg});
+    builder.AddNode("Mul", {exp_out_arg, bias_exp_out_arg}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+    EXPECT_EQ(op_to_count["Exp"], 0);
+  };
+
+  TransformerTester(build_test_case,
+                    check_graph,
+                    TransformerLevel::Level2,
+                    TransformerLevel::Level3, 13, 0.000001, 0.000001, nullptr, EnableElementwiseFusion);
+}
+
+// A group that only reads constants is not fused, as the FusedElementwise node would have no inputs.
+TEST(ElementwiseFusionTests, ConstantsOnly) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* constant1_arg = builder.MakeScalarInitializer<float>(0.5f);
+    auto* constant2_arg = builder.MakeScalarInitializer<float>(2.0f);
+    auto* add_out_arg = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Add", {constant1_arg, constant2_arg}, {add_out_arg});
+    builder.AddNode("Neg", {add_out_arg}, {output_arg});
+  };
+
+  auto check_graph = [&](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.FusedElementwise"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Neg"] == 1);
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, DefaultLoggingManager().DefaultLogger(),
+                                        std::make_unique<ElementwiseFusion>(), TransformerLevel::Level3, 1,
+                                        nullptr, check_graph));
+}
+
+#endif  // DISABLE_CONTRIB_OPS
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -35,9 +35,20 @@ namespace perftest {
       "Options:\n"
       "\t-m [test_mode]: Specifies the test mode. Value could be 'duration' or 'times'.\n"
       "\t\tProvide 'duration' to run the test for a fix duration, and 'times' to repeated for a certain times. \n"
+      "\t-Q [requests_per_second]: Run in open loop mode. Requests arrive at this rate for the duration given by -t\n"
+      "\t\tregardless of how fast earlier requests complete, and are served by the number of workers given by -c.\n"
+      "\t\tReports latency, queueing delay and service time percentiles.\n"
+      "\t-a [fixed|poisson]: Open loop mode arrival process. Default:'fixed'.\n"
+      "\t-w [warmup_seconds]: Open loop mode warmup. Requests arriving during warmup are not recorded. Default:0.\n"
+      "\t-j [latency_report_file]: Open loop mode. Writes the latency report to the file, as JSON if the file has a\n"
+      "\t\t'.json' extension and as CSV otherwise.\n"
       "\t-M: Disable memory pattern.\n"
       "\t-A: Disable memory arena\n"
       "\t-I: Generate tensor input binding. Free dimensions are treated as 1 unless overridden using -f.\n"
+      "\t-k [shape_distribution_file]: Generate inputs for each shape in the file and pick one per run, weighted by the\n"
+      "\t\tshape's weight. Each line is '<weight> <dim_name>=<value> ...' where <value> can be a range\n"
+      "\t\t'<first>:<last>[:<step>]' to sweep it. Reports latency and arena growth per shape. Implies -I.\n"
+      "\t\tArena growth is only attributed to the right shape when -c is 1.\n"
       "\t-c [parallel runs]: Specifies the (max) number of runs to invoke simultaneously. Default:1.\n"
       "\t-e [cpu|cuda|dnnl|tensorrt|openvino|dml|acl|nnapi|coreml|qnn|snpe|rocm|migraphx|xnnpack|vitisai|webgpu]: Specifies the provider 'cpu','cuda','dnnl','tensorrt', "
       "'nvtensorrtrtx', 'openvino', 'dml', 'acl', 'nnapi', 'coreml', 'qnn', 'snpe', 'rocm', 'migraphx', 'xnnpack', 'vitisai' or 'webgpu'. "
@@ -193,7 +204,7 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
 
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:AMPIDZvhsqznlgR:X"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:Q:a:w:j:k:AMPIDZvhsqznlgR:X"))) != -1) {
     switch (ch) {
       case 'f': {
         std::basic_string<ORTCHAR_T> dim_name;
@@ -288,6 +299,31 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
         }
         test_config.run_config.test_mode = TestMode::kFixDurationMode;
         break;
+      case 'Q':
+        test_config.run_config.requests_per_second = OrtStrtod<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (test_config.run_config.requests_per_second <= 0) {
+          return false;
+        }
+        break;
+      case 'a':
+        if (!CompareCString(optarg, ORT_TSTR("fixed"))) {
+          test_config.run_config.arrival_distribution = ArrivalDistribution::kFixed;
+        } else if (!CompareCString(optarg, ORT_TSTR("poisson"))) {
+          test_config.run_config.arrival_distribution = ArrivalDistribution::kPoisson;
+        } else {
+          return false;
+        }
+        break;
+      case 'w':
+        test_config.run_config.warmup_in_seconds = static_cast<size_t>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
+        break;
+      case 'j':
+        test_config.run_config.latency_report_file = optarg;
+        break;
+      case 'k':
+        test_config.run_config.shape_distribution_file = optarg;
+        test_config.run_config.generate_model_input_binding = true;
+        break;
       case 's':
         test_config.run_config.f_dump_statistics = true;
         break;
@@ -409,6 +445,11 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
     }
   }
 
+  // -t only sets the duration of an open loop run, so apply -Q after all the options have been seen
+  if (test_config.run_config.requests_per_second > 0) {
+    test_config.run_config.test_mode = TestMode::kOpenLoopMode;
+  }
+
   // parse model_path and result_file_path
   argc -= optind;
   argv += optind;
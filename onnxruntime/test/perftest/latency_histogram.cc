@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace onnxruntime {
+namespace perftest {
+
+namespace {
+
+int MostSignificantBit(uint64_t value) {
+  int bit = 0;
+  while (value >>= 1) {
+    ++bit;
+  }
+  return bit;
+}
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram()
+    // values [0, kSubBucketCount) map 1:1, then kSubBucketHalfCount buckets for each of the remaining powers of two
+    : counts_(static_cast<size_t>(kSubBucketCount + (63 - (kSubBucketBits - 1)) * kSubBucketHalfCount), 0) {
+}
+
+size_t LatencyHistogram::IndexOf(int64_t value) {
+  if (value < kSubBucketCount) {
+    return static_cast<size_t>(value);
+  }
+
+  // keep the kSubBucketBits most significant bits of the value
+  const int shift = MostSignificantBit(static_cast<uint64_t>(value)) - (kSubBucketBits - 1);
+  const int64_t sub_bucket = value >> shift;  // in [kSubBucketHalfCount, kSubBucketCount)
+  return static_cast<size_t>(kSubBucketCount + (shift - 1) * kSubBucketHalfCount + (sub_bucket - kSubBucketHalfCount));
+}
+
+int64_t LatencyHistogram::HighestEquivalentValue(size_t index) {
+  if (index < static_cast<size_t>(kSubBucketCount)) {
+    return static_cast<int64_t>(index);
+  }
+
+  const int64_t offset = static_cast<int64_t>(index) - kSubBucketCount;
+  const int shift = static_cast<int>(offset / kSubBucketHalfCount) + 1;
+  const int64_t sub_bucket = offset % kSubBucketHalfCount + kSubBucketHalfCount;
+  return ((sub_bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(int64_t value) {
+  value = std::max<int64_t>(value, 0);
+  ++counts_[IndexOf(value)];
+  ++total_count_;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+  sum_ += value;
+}
+
+void LatencyHistogram::Add(const LatencyHistogram& other) {
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  total_count_ += other.total_count_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+  sum_ += other.sum_;
+}
+
+int64_t LatencyHistogram::ValueAtPercentile(double percentile) const {
+  if (total_count_ == 0) {
+    return 0;
+  }
+
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  const auto target = std::max<uint64_t>(
+      static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(total_count_))), 1);
+
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    cumulative += counts_[i];
+    if (cumulative >= target) {
+      return std::min(HighestEquivalentValue(i), max_);
+    }
+  }
+
+  return max_;
+}
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace onnxruntime {
+namespace perftest {
+
+// Log-linear histogram of non-negative integer values (latencies in microseconds), in the style of HdrHistogram.
+// Values below kSubBucketCount are counted exactly. Above that, every power of two is split into kSubBucketCount / 2
+// linear sub-buckets, so percentiles are reported with a relative error below 1/64 regardless of the range of
+// values, using a fixed amount of memory. Record is not thread safe; use one histogram per thread and Add them.
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  void Record(int64_t value);
+
+  // Adds the counts of `other` to this histogram.
+  void Add(const LatencyHistogram& other);
+
+  // Returns the largest value equivalent to the value at `percentile` (0 - 100), or 0 if nothing was recorded.
+  int64_t ValueAtPercentile(double percentile) const;
+
+  uint64_t Count() const { return total_count_; }
+  int64_t Min() const { return total_count_ == 0 ? 0 : min_; }
+  int64_t Max() const { return max_; }
+  double Mean() const {
+    return total_count_ == 0 ? 0.0 : static_cast<double>(sum_) / static_cast<double>(total_count_);
+  }
+
+ private:
+  static constexpr int kSubBucketBits = 7;
+  static constexpr int64_t kSubBucketCount = int64_t{1} << kSubBucketBits;
+  static constexpr int64_t kSubBucketHalfCount = kSubBucketCount / 2;
+
+  static size_t IndexOf(int64_t value);
+  static int64_t HighestEquivalentValue(size_t index);
+
+  std::vector<uint64_t> counts_;
+  uint64_t total_count_{0};
+  int64_t min_{std::numeric_limits<int64_t>::max()};
+  int64_t max_{0};
+  int64_t sum_{0};
+};
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -40,12 +40,22 @@ extern const OrtApi* g_ort;
 namespace onnxruntime {
 namespace perftest {
 
-std::chrono::duration<double> OnnxRuntimeTestSession::Run() {
+size_t OnnxRuntimeTestSession::NextTestDataId() {
   // Randomly pick one OrtValueArray from test_inputs_. (NOT ThreadSafe)
+  if (!test_data_weights_.empty()) {
+    return test_data_dist_(rand_engine_);
+  }
+
   const std::uniform_int_distribution<int>::param_type p(0, static_cast<int>(test_inputs_.size() - 1));
-  const size_t id = static_cast<size_t>(dist_(rand_engine_, p));
+  return static_cast<size_t>(dist_(rand_engine_, p));
+}
+
+std::chrono::duration<double> OnnxRuntimeTestSession::Run() {
+  return Run(NextTestDataId());
+}
 
-  auto& input = test_inputs_.at(id);
+std::chrono::duration<double> OnnxRuntimeTestSession::Run(size_t test_data_id) {
+  auto& input = test_inputs_.at(test_data_id);
   auto start = std::chrono::high_resolution_clock::now();
 
   session_.Run(Ort::RunOptions{nullptr}, input_names_.data(), input.data(), input_names_.size(),
@@ -978,6 +988,30 @@ static void InitializeTensorWithSeed(int32_t seed, Ort::Value& tensor) {
 }
 
 bool OnnxRuntimeTestSession::PopulateGeneratedInputTestData(int32_t seed) {
+  return PopulateGeneratedInputTestData(seed, {InputShapeSpec{}});
+}
+
+bool OnnxRuntimeTestSession::PopulateGeneratedInputTestData(int32_t seed, const std::vector<InputShapeSpec>& shapes) {
+  for (size_t test_data_id = 0; test_data_id < shapes.size(); ++test_data_id) {
+    if (!PopulateGeneratedInputTestData(seed, test_data_id, shapes[test_data_id])) {
+      return false;
+    }
+  }
+
+  // weight the choice of test data by the shape distribution. a single shape doesn't need it.
+  if (shapes.size() > 1) {
+    test_data_weights_.clear();
+    for (const auto& shape : shapes) {
+      test_data_weights_.push_back(shape.weight);
+    }
+    test_data_dist_ = std::discrete_distribution<size_t>(test_data_weights_.begin(), test_data_weights_.end());
+  }
+
+  return true;
+}
+
+bool OnnxRuntimeTestSession::PopulateGeneratedInputTestData(int32_t seed, size_t test_data_id,
+                                                            const InputShapeSpec& shape) {
   Ort::AllocatorWithDefaultOptions default_allocator;
   // iterate over all input nodes
   for (size_t i = 0; i < static_cast<size_t>(input_length_); i++) {
@@ -985,16 +1019,21 @@ bool OnnxRuntimeTestSession::PopulateGeneratedInputTestData(int32_t seed) {
     if (type_info.GetONNXType() == ONNX_TYPE_TENSOR) {
       auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
       std::vector<int64_t> input_node_dim = tensor_info.GetShape();
+      const std::vector<const char*> symbolic_dims = tensor_info.GetSymbolicDimensions();
 
-      // free dimensions are treated as 1 if not overridden
-      auto transform_fcn = [](int64_t input) { return (input == -1) ? -input : input; };
-      std::transform(input_node_dim.begin(), input_node_dim.end(), input_node_dim.begin(), transform_fcn);
+      // free dimensions are set from the shape if it names them and treated as 1 otherwise
+      for (size_t d = 0; d < input_node_dim.size(); ++d) {
+        if (input_node_dim[d] == -1) {
+          auto dim_value = symbolic_dims[d] != nullptr ? shape.dims.find(symbolic_dims[d]) : shape.dims.end();
+          input_node_dim[d] = dim_value != shape.dims.end() ? dim_value->second : 1;
+        }
+      }
 
       if (device_memory_name_ != CUDA) {
         Ort::Value input_tensor = Ort::Value::CreateTensor(allocator_, (const int64_t*)input_node_dim.data(),
                                                            input_node_dim.size(), tensor_info.GetElementType());
         InitializeTensorWithSeed(seed, input_tensor);
-        PreLoadTestData(0, i, std::move(input_tensor));
+        PreLoadTestData(test_data_id, i, std::move(input_tensor));
       }
 // Create tensor on CPU, initialize and copy to CUDA tensor
 #if defined(USE_CUDA) || defined(USE_TENSORRT) || defined(USE_NV)
@@ -1018,7 +1057,7 @@ bool OnnxRuntimeTestSession::PopulateGeneratedInputTestData(int32_t seed) {
         if (cuda_err != cudaSuccess) {
           ORT_THROW("Failed to copy tensor data from CPU to CUDA device. CUDA Error: ", cudaGetErrorString(cuda_err));
         }
-        PreLoadTestData(0, i, std::move(cuda_tensor));
+        PreLoadTestData(test_data_id, i, std::move(cuda_tensor));
       }
 #endif
     }
@@ -1026,5 +1065,15 @@ bool OnnxRuntimeTestSession::PopulateGeneratedInputTestData(int32_t seed) {
   return true;
 }
 
+std::unordered_map<std::string, std::string> OnnxRuntimeTestSession::GetCpuAllocatorStats() {
+  // Concurrent runs read the stats, so the allocator is only created once.
+  std::call_once(cpu_allocator_created_, [this]() {
+    Ort::MemoryInfo memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    cpu_allocator_ = Ort::Allocator(session_, memory_info);
+  });
+
+  return cpu_allocator_.GetStats().GetKeyValuePairs();
+}
+
 }  // namespace perftest
 }  // namespace onnxruntime
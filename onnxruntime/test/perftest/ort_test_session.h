@@ -3,7 +3,12 @@
 
 #pragma once
 #include <core/session/onnxruntime_cxx_api.h>
+#include <mutex>
 #include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "shape_distribution.h"
 #include "test_configuration.h"
 #include "test_session.h"
 class TestModelInfo;
@@ -27,19 +32,35 @@ class OnnxRuntimeTestSession : public TestSession {
 
   bool PopulateGeneratedInputTestData(int32_t seed);
 
+  // Generates one set of test data per shape, and weights the choice of test data for each run by shape.weight.
+  bool PopulateGeneratedInputTestData(int32_t seed, const std::vector<InputShapeSpec>& shapes);
+
   ~OnnxRuntimeTestSession() = default;
 
   std::chrono::duration<double> Run() override;
 
+  // Picks the test data to use for the next run. (NOT ThreadSafe)
+  size_t NextTestDataId();
+  std::chrono::duration<double> Run(size_t test_data_id);
+
+  // Statistics of the session's CPU allocator, e.g. "NumArenaExtensions". Empty if the allocator doesn't track them.
+  std::unordered_map<std::string, std::string> GetCpuAllocatorStats();
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OnnxRuntimeTestSession);
 
  private:
+  bool PopulateGeneratedInputTestData(int32_t seed, size_t test_data_id, const InputShapeSpec& shape);
+
   Ort::Session session_{nullptr};
   std::mt19937 rand_engine_;
   std::uniform_int_distribution<int> dist_;
+  std::vector<double> test_data_weights_;
+  std::discrete_distribution<size_t> test_data_dist_;
   OrtAllocator* allocator_ = Ort::AllocatorWithDefaultOptions();
   // Note: custom_allocator_, if used, must outlive the `Ort::Value`s allocated with it in test_inputs_ and outputs_.
   Ort::Allocator custom_allocator_{nullptr};
+  Ort::Allocator cpu_allocator_{nullptr};
+  std::once_flag cpu_allocator_created_;
   std::vector<std::vector<Ort::Value>> test_inputs_;
   std::vector<Ort::Value> outputs_;
   std::vector<std::string> output_names_;
@@ -7,7 +7,13 @@
 #endif
 
 #include "performance_runner.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
 #include <iostream>
+#include <map>
+#include <thread>
 
 #include "TestCase.h"
 #include "utils.h"
@@ -111,6 +117,94 @@ void PerformanceResult::DumpToFile(const std::basic_string<ORTCHAR_T>& path, boo
   }
 }
 
+namespace {
+
+constexpr double kReportPercentiles[] = {50.0, 90.0, 99.0, 99.9};
+
+double ToMilliseconds(int64_t microseconds) {
+  return static_cast<double>(microseconds) / 1000.0;
+}
+
+const char* ArrivalDistributionName(ArrivalDistribution distribution) {
+  return distribution == ArrivalDistribution::kPoisson ? "poisson" : "fixed";
+}
+
+}  // namespace
+
+void OpenLoopResult::Print(const RunConfig& run_config) const {
+  const auto completed = static_cast<double>(latency.Count());
+  std::cout << "Open loop arrival rate: " << run_config.requests_per_second << " requests/s ("
+            << ArrivalDistributionName(run_config.arrival_distribution) << ")\n"
+            << "Completed requests: " << latency.Count() << " (failed: " << num_failed << ")\n"
+            << "Achieved throughput: " << (measured_seconds > 0 ? completed / measured_seconds : 0.0)
+            << " requests/s\n";
+
+  auto print_row = [](const char* name, const LatencyHistogram& histogram) {
+    std::cout << std::left << std::setw(10) << name << std::right;
+    for (double percentile : kReportPercentiles) {
+      std::cout << std::setw(12) << ToMilliseconds(histogram.ValueAtPercentile(percentile));
+    }
+    std::cout << std::setw(12) << ToMilliseconds(histogram.Max())
+              << std::setw(12) << histogram.Mean() / 1000.0 << "\n";
+  };
+
+  std::cout << std::left << std::setw(10) << "(ms)" << std::right
+            << std::setw(12) << "P50" << std::setw(12) << "P90" << std::setw(12) << "P99"
+            << std::setw(12) << "P999" << std::setw(12) << "Max" << std::setw(12) << "Mean" << "\n";
+  print_row("latency", latency);
+  print_row("queueing", queueing);
+  print_row("service", service);
+  std::cout << std::flush;
+}
+
+void OpenLoopResult::DumpToFile(const std::basic_string<ORTCHAR_T>& path, const RunConfig& run_config) const {
+  std::ofstream outfile(path, std::ofstream::out | std::ofstream::trunc);
+  if (!outfile.good()) {
+    std::cerr << "failed to open latency report file '" << ToUTF8String(path.c_str()) << "'.\n";
+    return;
+  }
+
+  const std::pair<const char*, const LatencyHistogram*> metrics[] = {
+      {"latency", &latency}, {"queueing", &queueing}, {"service", &service}};
+
+  if (HasExtensionOf(path, ORT_TSTR("json"))) {
+    outfile << "{\n"
+            << "  \"requests_per_second\": " << run_config.requests_per_second << ",\n"
+            << "  \"arrival_distribution\": \"" << ArrivalDistributionName(run_config.arrival_distribution) << "\",\n"
+            << "  \"completed\": " << latency.Count() << ",\n"
+            << "  \"failed\": " << num_failed << ",\n"
+            << "  \"measured_seconds\": " << measured_seconds << ",\n"
+            << "  \"unit\": \"ms\"";
+    for (const auto& metric : metrics) {
+      const auto& histogram = *metric.second;
+      outfile << ",\n  \"" << metric.first << "\": {"
+              << "\"min\": " << ToMilliseconds(histogram.Min())
+              << ", \"mean\": " << histogram.Mean() / 1000.0
+              << ", \"p50\": " << ToMilliseconds(histogram.ValueAtPercentile(50.0))
+              << ", \"p90\": " << ToMilliseconds(histogram.ValueAtPercentile(90.0))
+              << ", \"p99\": " << ToMilliseconds(histogram.ValueAtPercentile(99.0))
+              << ", \"p999\": " << ToMilliseconds(histogram.ValueAtPercentile(99.9))
+              << ", \"max\": " << ToMilliseconds(histogram.Max()) << "}";
+    }
+    outfile << "\n}\n";
+  } else {
+    outfile << "metric,requests_per_second,arrival_distribution,completed,failed,"
+            << "min_ms,mean_ms,p50_ms,p90_ms,p99_ms,p999_ms,max_ms\n";
+    for (const auto& metric : metrics) {
+      const auto& histogram = *metric.second;
+      outfile << metric.first << "," << run_config.requests_per_second << ","
+              << ArrivalDistributionName(run_config.arrival_distribution) << ","
+              << histogram.Count() << "," << num_failed << ","
+              << ToMilliseconds(histogram.Min()) << "," << histogram.Mean() / 1000.0 << ","
+              << ToMilliseconds(histogram.ValueAtPercentile(50.0)) << ","
+              << ToMilliseconds(histogram.ValueAtPercentile(90.0)) << ","
+              << ToMilliseconds(histogram.ValueAtPercentile(99.0)) << ","
+              << ToMilliseconds(histogram.ValueAtPercentile(99.9)) << ","
+              << ToMilliseconds(histogram.Max()) << "\n";
+    }
+  }
+}
+
 void PerformanceRunner::LogSessionCreationTime() {
   std::chrono::duration<double> session_create_duration = session_create_end_ - session_create_start_;
   std::cout << "\nSession creation time cost: " << session_create_duration.count() << " s\n";
@@ -138,6 +232,9 @@ Status PerformanceRunner::Run() {
     case TestMode::KFixRepeatedTimesMode:
       ORT_RETURN_IF_ERROR(RepeatedTimesTest());
       break;
+    case TestMode::kOpenLoopMode:
+      ORT_RETURN_IF_ERROR(RunOpenLoop());
+      break;
     default:
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
   }
@@ -165,6 +262,18 @@ Status PerformanceRunner::Run() {
             << "Peak working set size: " << performance_result_.peak_workingset_size << " bytes"
             << std::endl;
 
+  if (!input_shapes_.empty()) {
+    PrintShapeResults();
+  }
+
+  if (performance_test_config_.run_config.test_mode == TestMode::kOpenLoopMode) {
+    const auto& run_config = performance_test_config_.run_config;
+    open_loop_result_.Print(run_config);
+    if (!run_config.latency_report_file.empty()) {
+      open_loop_result_.DumpToFile(run_config.latency_report_file, run_config);
+    }
+  }
+
   return Status::OK();
 }
 
@@ -255,6 +364,203 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
+Status PerformanceRunner::RunOpenLoop() {
+  using clock = std::chrono::steady_clock;
+  const auto& run_config = performance_test_config_.run_config;
+
+  struct Request {
+    clock::time_point arrival;
+    bool warmup;
+  };
+
+  // each worker records into its own histograms so completing requests do not contend on a lock
+  struct WorkerResult {
+    LatencyHistogram latency;
+    LatencyHistogram queueing;
+    LatencyHistogram service;
+    size_t num_failed{0};
+  };
+
+  std::deque<Request> queue;
+  std::mutex queue_mutex;
+  std::condition_variable queue_cv;
+  bool arrivals_done = false;
+
+  const size_t num_workers = std::max<size_t>(run_config.concurrent_session_runs, 1);
+  std::vector<WorkerResult> worker_results(num_workers);
+  std::vector<std::thread> workers;
+  workers.reserve(num_workers);
+
+  auto to_microseconds = [](clock::duration duration) {
+    return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+  };
+
+  for (size_t w = 0; w < num_workers; ++w) {
+    workers.emplace_back([&, w]() {
+      auto& result = worker_results[w];
+      for (;;) {
+        Request request;
+        {
+          std::unique_lock<std::mutex> lock(queue_mutex);
+          queue_cv.wait(lock, [&]() { return arrivals_done || !queue.empty(); });
+          if (queue.empty()) {
+            return;
+          }
+          request = queue.front();
+          queue.pop_front();
+        }
+
+        const auto service_start = clock::now();
+        auto status = request.warmup ? RunOneIteration<true>() : RunOneIteration<false>();
+        const auto service_end = clock::now();
+
+        if (!status.IsOK()) {
+          std::cerr << status.ErrorMessage() << "\n";
+          ++result.num_failed;
+        } else if (!request.warmup) {
+          result.latency.Record(to_microseconds(service_end - request.arrival));
+          result.queueing.Record(to_microseconds(service_start - request.arrival));
+          result.service.Record(to_microseconds(service_end - service_start));
+        }
+      }
+    });
+  }
+
+  // Generate arrivals on this thread. Each request is timestamped with its scheduled arrival time, so if the
+  // generator or the workers fall behind the delay shows up in the reported latency instead of silently lowering
+  // the offered load.
+  const unsigned int seed = run_config.random_seed_for_input_data >= 0
+                                ? static_cast<unsigned int>(run_config.random_seed_for_input_data)
+                                : std::random_device{}();
+  std::mt19937_64 generator(seed);
+  std::exponential_distribution<double> exponential_interval(run_config.requests_per_second);
+  const std::chrono::duration<double> fixed_interval(1.0 / run_config.requests_per_second);
+
+  const auto start = clock::now();
+  const auto measure_start = start + std::chrono::seconds(run_config.warmup_in_seconds);
+  const auto end = measure_start + std::chrono::seconds(run_config.duration_in_seconds);
+
+  for (auto arrival = start; arrival < end;) {
+    std::this_thread::sleep_until(arrival);
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex);
+      queue.push_back({arrival, arrival < measure_start});
+    }
+    queue_cv.notify_one();
+
+    const std::chrono::duration<double> interval =
+        run_config.arrival_distribution == ArrivalDistribution::kPoisson
+            ? std::chrono::duration<double>(exponential_interval(generator))
+            : fixed_interval;
+    arrival += std::chrono::duration_cast<clock::duration>(interval);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    arrivals_done = true;
+  }
+  queue_cv.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  open_loop_result_.measured_seconds = std::chrono::duration<double>(end - measure_start).count();
+  for (const auto& result : worker_results) {
+    open_loop_result_.latency.Add(result.latency);
+    open_loop_result_.queueing.Add(result.queueing);
+    open_loop_result_.service.Add(result.service);
+    open_loop_result_.num_failed += result.num_failed;
+  }
+
+  return Status::OK();
+}
+
+namespace {
+
+struct ArenaCounters {
+  int64_t arena_extensions{0};
+  int64_t allocated_bytes{0};
+};
+
+ArenaCounters ReadArenaCounters(OnnxRuntimeTestSession& session) {
+  const auto stats = session.GetCpuAllocatorStats();
+  auto get = [&stats](const char* key) -> int64_t {
+    auto entry = stats.find(key);
+    return entry != stats.end() ? std::stoll(entry->second) : 0;
+  };
+  return {get("NumArenaExtensions"), get("TotalAllocated")};
+}
+
+}  // namespace
+
+std::chrono::duration<double> PerformanceRunner::RunInputShape(bool is_warmup) {
+  auto& session = *static_cast<OnnxRuntimeTestSession*>(session_.get());
+
+  size_t test_data_id = 0;
+  {
+    std::lock_guard<std::mutex> guard(test_data_mutex_);
+    test_data_id = session.NextTestDataId();
+  }
+
+  // the counters are read outside of the timed region. they are cumulative for the session so with concurrent runs
+  // growth caused by one shape may be attributed to another.
+  const auto before = ReadArenaCounters(session);
+  const auto duration_seconds = session.Run(test_data_id);
+  if (!is_warmup) {
+    const auto after = ReadArenaCounters(session);
+    std::lock_guard<std::mutex> guard(results_mutex_);
+    auto& result = shape_results_[test_data_id];
+    result.latency.Record(std::chrono::duration_cast<std::chrono::microseconds>(duration_seconds).count());
+    result.arena_extensions += after.arena_extensions - before.arena_extensions;
+    result.allocated_bytes += after.allocated_bytes - before.allocated_bytes;
+  }
+
+  return duration_seconds;
+}
+
+void PerformanceRunner::PrintShapeResults() {
+  size_t name_width = 5;
+  for (const auto& shape : input_shapes_) {
+    name_width = std::max(name_width, shape.name.size());
+  }
+
+  std::cout << "\nPer shape results (latency in ms):\n"
+            << std::left << std::setw(static_cast<int>(name_width + 2)) << "Shape" << std::right
+            << std::setw(8) << "Weight" << std::setw(10) << "Runs" << std::setw(10) << "Mean"
+            << std::setw(10) << "P50" << std::setw(10) << "P90" << std::setw(10) << "P99" << std::setw(10) << "Max"
+            << std::setw(18) << "ArenaExtensions" << std::setw(18) << "AllocatedBytes" << "\n";
+
+  double total_weight = 0;
+  for (const auto& shape : input_shapes_) {
+    total_weight += shape.weight;
+  }
+
+  for (size_t i = 0; i < input_shapes_.size(); ++i) {
+    const auto& latency = shape_results_[i].latency;
+    std::cout << std::left << std::setw(static_cast<int>(name_width + 2))
+              << (input_shapes_[i].name.empty() ? "(default)" : input_shapes_[i].name) << std::right
+              << std::setw(8) << std::setprecision(3) << input_shapes_[i].weight / total_weight
+              << std::setprecision(6) << std::setw(10) << latency.Count()
+              << std::setw(10) << latency.Mean() / 1000.0
+              << std::setw(10) << latency.ValueAtPercentile(50.0) / 1000.0
+              << std::setw(10) << latency.ValueAtPercentile(90.0) / 1000.0
+              << std::setw(10) << latency.ValueAtPercentile(99.0) / 1000.0
+              << std::setw(10) << latency.Max() / 1000.0
+              << std::setw(18) << shape_results_[i].arena_extensions
+              << std::setw(18) << shape_results_[i].allocated_bytes << "\n";
+  }
+
+  const auto stats = static_cast<OnnxRuntimeTestSession*>(session_.get())->GetCpuAllocatorStats();
+  if (!stats.empty()) {
+    std::cout << "\nCPU allocator stats:\n";
+    const std::map<std::string, std::string> sorted_stats(stats.begin(), stats.end());
+    for (const auto& entry : sorted_stats) {
+      std::cout << "  " << entry.first << ": " << entry.second << "\n";
+    }
+  }
+  std::cout << std::flush;
+}
+
 static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   const auto& file_path = performance_test_config_.model_info.model_file_path;
 #if !defined(ORT_MINIMAL_BUILD)
@@ -299,10 +605,27 @@ bool PerformanceRunner::Initialize() {
   TestModelInfo* test_model_info = test_model_info_.get();
   test_case_ = CreateOnnxTestCase(narrow_model_name, std::move(test_model_info_), 0.0, 0.0);
 
-  if (performance_test_config_.run_config.generate_model_input_binding) {
+  const auto& run_config = performance_test_config_.run_config;
+  if (!run_config.shape_distribution_file.empty()) {
+    st = LoadShapeDistribution(run_config.shape_distribution_file, input_shapes_);
+    if (!st.IsOK()) {
+      std::cout << st.ErrorMessage() << std::endl;
+      return false;
+    }
+    if (run_config.enable_cuda_io_binding) {
+      // outputs are pre-allocated with a fixed shape when binding them on device
+      std::cout << "a shape distribution can't be used with -g" << std::endl;
+      return false;
+    }
+    shape_results_.resize(input_shapes_.size());
+    return static_cast<OnnxRuntimeTestSession*>(session_.get())
+        ->PopulateGeneratedInputTestData(run_config.random_seed_for_input_data, input_shapes_);
+  }
+
+  if (run_config.generate_model_input_binding) {
     return static_cast<OnnxRuntimeTestSession*>(
                session_.get())
-        ->PopulateGeneratedInputTestData(performance_test_config_.run_config.random_seed_for_input_data);
+        ->PopulateGeneratedInputTestData(run_config.random_seed_for_input_data);
   }
 
   // TODO: Place input tensor on cpu memory if dnnl provider type to avoid CopyTensor logic in CopyInputAcrossDevices
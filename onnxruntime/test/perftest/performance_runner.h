@@ -17,6 +17,8 @@
 #include <mutex>
 #include <core/session/onnxruntime_cxx_api.h>
 #include "test_configuration.h"
+#include "latency_histogram.h"
+#include "shape_distribution.h"
 #include "heap_buffer.h"
 #include "test_session.h"
 #include "OrtValueList.h"
@@ -39,6 +41,19 @@ struct PerformanceResult {
   void DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics = false) const;
 };
 
+// Results of an open loop run. Latency is measured from the scheduled arrival of a request, not from when a worker
+// picked it up, so it includes the time spent queued behind earlier requests. All values are in microseconds.
+struct OpenLoopResult {
+  LatencyHistogram latency;   // scheduled arrival to completion
+  LatencyHistogram queueing;  // scheduled arrival to start of Run
+  LatencyHistogram service;   // duration of Run
+  size_t num_failed{0};
+  double measured_seconds{0};
+
+  void Print(const RunConfig& run_config) const;
+  void DumpToFile(const std::basic_string<ORTCHAR_T>& path, const RunConfig& run_config) const;
+};
+
 class PerformanceRunner {
  public:
   PerformanceRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd);
@@ -65,7 +80,7 @@ class PerformanceRunner {
 
     auto status = Status::OK();
     ORT_TRY {
-      duration_seconds = session_->Run();
+      duration_seconds = input_shapes_.empty() ? session_->Run() : RunInputShape(isWarmup);
     }
     ORT_CATCH(const std::exception& ex) {
       ORT_HANDLE_EXCEPTION([&]() {
@@ -90,6 +105,11 @@ class PerformanceRunner {
   Status RepeatedTimesTest();
   Status ForkJoinRepeat();
   Status RunParallelDuration();
+  Status RunOpenLoop();
+
+  // Runs with test data picked from the shape distribution and records the latency and arena growth for the shape.
+  std::chrono::duration<double> RunInputShape(bool is_warmup);
+  void PrintShapeResults();
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
@@ -110,6 +130,7 @@ class PerformanceRunner {
   std::chrono::time_point<std::chrono::high_resolution_clock> session_create_end_;
   PerformanceResult initial_inference_result_;
   PerformanceResult performance_result_;
+  OpenLoopResult open_loop_result_;
   PerformanceTestConfig performance_test_config_;
   std::unique_ptr<TestModelInfo> test_model_info_;
   std::unique_ptr<TestSession> session_;
@@ -117,6 +138,16 @@ class PerformanceRunner {
   std::unique_ptr<ITestCase> test_case_;
 
   std::mutex results_mutex_;
+
+  struct ShapeResult {
+    LatencyHistogram latency;  // microseconds
+    int64_t arena_extensions{0};
+    int64_t allocated_bytes{0};
+  };
+
+  std::vector<InputShapeSpec> input_shapes_;
+  std::vector<ShapeResult> shape_results_;
+  std::mutex test_data_mutex_;
 };
 }  // namespace perftest
 }  // namespace onnxruntime
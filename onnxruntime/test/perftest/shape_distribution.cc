@@ -0,0 +1,124 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "shape_distribution.h"
+
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include <core/common/common.h>
+
+namespace onnxruntime {
+namespace perftest {
+
+namespace {
+
+bool ParseInt64(const std::string& str, int64_t& value) {
+  size_t pos = 0;
+  ORT_TRY {
+    value = std::stoll(str, &pos);
+  }
+  ORT_CATCH(...) {
+    return false;
+  }
+  return pos == str.size();
+}
+
+// Parses '<value>' or '<first>:<last>[:<step>]' into the list of values it covers.
+bool ParseDimValues(const std::string& spec, std::vector<int64_t>& values) {
+  std::vector<int64_t> parts;
+  std::istringstream ss(spec);
+  std::string part;
+  while (std::getline(ss, part, ':')) {
+    int64_t value = 0;
+    if (!ParseInt64(part, value)) {
+      return false;
+    }
+    parts.push_back(value);
+  }
+
+  if (parts.size() == 1) {
+    values = {parts[0]};
+  } else if (parts.size() == 2 || parts.size() == 3) {
+    const int64_t step = parts.size() == 3 ? parts[2] : 1;
+    if (step <= 0 || parts[1] < parts[0]) {
+      return false;
+    }
+    values.clear();
+    for (int64_t value = parts[0]; value <= parts[1]; value += step) {
+      values.push_back(value);
+    }
+  } else {
+    return false;
+  }
+
+  for (auto value : values) {
+    if (value <= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+Status LoadShapeDistribution(const std::basic_string<ORTCHAR_T>& path, std::vector<InputShapeSpec>& shapes) {
+  std::ifstream infile(path);
+  ORT_RETURN_IF_NOT(infile.good(), "failed to open shape distribution file '", ToUTF8String(path), "'");
+
+  shapes.clear();
+  std::string line;
+  for (size_t line_number = 1; std::getline(infile, line); ++line_number) {
+    std::istringstream tokens(line);
+    std::string weight_str;
+    if (!(tokens >> weight_str) || weight_str[0] == '#') {
+      continue;
+    }
+
+    double weight = 0.0;
+    ORT_TRY {
+      weight = std::stod(weight_str);
+    }
+    ORT_CATCH(...) {
+      weight = -1.0;
+    }
+    ORT_RETURN_IF_NOT(weight > 0.0, "line ", line_number, ": invalid weight '", weight_str, "'");
+
+    // expand the ranges on this line into every combination of values
+    std::vector<InputShapeSpec> expanded{InputShapeSpec{}};
+    std::string dim_spec;
+    while (tokens >> dim_spec) {
+      const auto delimiter = dim_spec.find('=');
+      std::vector<int64_t> values;
+      ORT_RETURN_IF_NOT(delimiter != std::string::npos && delimiter != 0 &&
+                            ParseDimValues(dim_spec.substr(delimiter + 1), values),
+                        "line ", line_number, ": invalid dimension '", dim_spec,
+                        "'. expected <dim_name>=<value> or <dim_name>=<first>:<last>[:<step>]");
+
+      const std::string dim_name = dim_spec.substr(0, delimiter);
+      std::vector<InputShapeSpec> next;
+      next.reserve(expanded.size() * values.size());
+      for (const auto& shape : expanded) {
+        for (auto value : values) {
+          InputShapeSpec combined = shape;
+          combined.dims[dim_name] = value;
+          combined.name += (combined.name.empty() ? "" : " ") + dim_name + "=" + std::to_string(value);
+          next.push_back(std::move(combined));
+        }
+      }
+      expanded = std::move(next);
+    }
+
+    for (auto& shape : expanded) {
+      shape.weight = weight / static_cast<double>(expanded.size());
+      shapes.push_back(std::move(shape));
+    }
+  }
+
+  ORT_RETURN_IF(shapes.empty(), "no shapes in shape distribution file '", ToUTF8String(path), "'");
+  return Status::OK();
+}
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <core/common/status.h>
+#include <core/session/onnxruntime_c_api.h>
+
+namespace onnxruntime {
+namespace perftest {
+
+// Values for the symbolic dimensions of the model inputs, and how often inputs of this shape are run.
+struct InputShapeSpec {
+  std::string name;  // e.g. "batch=1 sequence=128", used to label the results
+  double weight{1.0};
+  std::unordered_map<std::string, int64_t> dims;
+};
+
+// Loads a shape distribution file. Each non-empty line not starting with '#' has the form
+//
+//   <weight> <dim_name>=<value> [<dim_name>=<value> ...]
+//
+// where <value> is either a single value or a range 'first:last[:step]' (inclusive, step defaults to 1). A line with
+// ranges is expanded to every combination of the values, with the line's weight split evenly between them.
+// Symbolic dimensions of the model inputs that are not listed are set to 1.
+Status LoadShapeDistribution(const std::basic_string<ORTCHAR_T>& path, std::vector<InputShapeSpec>& shapes);
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -16,7 +16,13 @@ namespace perftest {
 
 enum class TestMode : std::uint8_t {
   kFixDurationMode = 0,
-  KFixRepeatedTimesMode
+  KFixRepeatedTimesMode,
+  kOpenLoopMode
+};
+
+enum class ArrivalDistribution : std::uint8_t {
+  kFixed = 0,
+  kPoisson
 };
 
 enum class Platform : std::uint8_t {
@@ -43,6 +49,13 @@ struct RunConfig {
   size_t repeated_times{1000};
   size_t duration_in_seconds{600};
   size_t concurrent_session_runs{1};
+  // open loop mode: requests arrive at this rate independently of completions, for warmup_in_seconds followed by
+  // duration_in_seconds, and are served by concurrent_session_runs workers.
+  double requests_per_second{0.0};
+  ArrivalDistribution arrival_distribution{ArrivalDistribution::kFixed};
+  size_t warmup_in_seconds{0};
+  std::basic_string<ORTCHAR_T> latency_report_file;
+  std::basic_string<ORTCHAR_T> shape_distribution_file;
   bool f_dump_statistics{false};
   int random_seed_for_input_data{-1};
   bool f_verbose{false};
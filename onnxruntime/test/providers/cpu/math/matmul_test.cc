@@ -522,6 +522,47 @@ TEST(MathOpTest, MatMul_bfloat16) {
 }
 #endif
 
+// B is a constant where most 16x16 blocks are zero, so the CPU EP packs it in the
+// block sparse format.
+TEST(MathOpTest, MatMulBlockSparseConstantB) {
+  constexpr int64_t M = 3, K = 40, N = 48;
+
+  std::vector<float> a_vals(M * K);
+  for (int64_t i = 0; i < M * K; i++) {
+    a_vals[i] = static_cast<float>(i % 7) - 3.0f;
+  }
+
+  // Keep only the blocks on the block diagonal.
+  std::vector<float> b_vals(K * N, 0.0f);
+  for (int64_t k = 0; k < K; k++) {
+    for (int64_t n = 0; n < N; n++) {
+      if (k / 16 == n / 16) {
+        b_vals[k * N + n] = static_cast<float>((k + 2 * n) % 5) - 2.0f;
+      }
+    }
+  }
+
+  std::vector<float> y_vals(M * N, 0.0f);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      for (int64_t k = 0; k < K; k++) {
+        y_vals[m * N + n] += a_vals[m * K + k] * b_vals[k * N + n];
+      }
+    }
+  }
+
+  OpTester test("MatMul");
+  test.AddInput<float>("A", {M, K}, a_vals);
+  test.AddInput<float>("B", {K, N}, b_vals, true);
+  test.AddOutput<float>("Y", {M, N}, y_vals);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.ConfigEps(std::move(execution_providers))
+      .Config(run_with_tunable_op)
+      .RunWithConfig();
+}
+
 #ifndef ENABLE_TRAINING
 // Prepacking is disabled in full training build so no need to test the feature in a training build.
 TEST(MathOpTest, MatMulSharedPrepackedWeights) {
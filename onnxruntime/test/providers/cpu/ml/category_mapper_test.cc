@@ -43,5 +43,21 @@ TEST(CategoryMapper, IntToString) {
 
   RunTest(dims, input, output);
 }
+
+// Large enough for the lookups to be split across the thread pool.
+TEST(CategoryMapper, StringToIntLargeBatch) {
+  static const std::vector<std::string> words = {"One", "Two", "Three", "Four"};
+  static const std::vector<int64_t> mapped = {1, 2, 3, 99};
+
+  constexpr int64_t num_elements = 50000;
+  std::vector<std::string> input;
+  std::vector<int64_t> output;
+  for (int64_t i = 0; i < num_elements; ++i) {
+    input.push_back(words[static_cast<size_t>(i) % words.size()]);
+    output.push_back(mapped[static_cast<size_t>(i) % mapped.size()]);
+  }
+
+  RunTest({num_elements}, input, output);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,12 +1,86 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
+#include <memory>
+#include <vector>
+
 #include "gtest/gtest.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/ml/svmclassifier.h"
+#include "core/util/thread_utils.h"
+#include "test/common/tensor_op_test_utils.h"
 #include "test/providers/provider_test_utils.h"
 
 namespace onnxruntime {
 namespace test {
 
+namespace {
+
+// Computes the RBF kernel of every batch row and support vector one at a time, as SVMCommon did before the support
+// vectors were blocked.
+std::vector<float> ComputeRbfKernelReference(const std::vector<float>& x, const std::vector<float>& support_vectors,
+                                             int64_t num_batches, int64_t num_support_vectors, int64_t num_features,
+                                             float gamma) {
+  std::vector<float> out;
+  out.reserve(static_cast<size_t>(num_batches * num_support_vectors));
+  for (int64_t batch = 0; batch < num_batches; ++batch) {
+    for (int64_t support_vector = 0; support_vector < num_support_vectors; ++support_vector) {
+      float sum = 0.f;
+      for (int64_t feature = 0; feature < num_features; ++feature) {
+        const float val = x[batch * num_features + feature] - support_vectors[support_vector * num_features + feature];
+        sum += val * val;
+      }
+      out.push_back(std::exp(-gamma * sum));
+    }
+  }
+  return out;
+}
+
+void RunRbfKernel(int64_t num_batches, int64_t num_support_vectors, int64_t num_features,
+                  concurrency::ThreadPool* thread_pool) {
+  RandomValueGenerator random{};
+  const std::vector<float> x = random.Uniform<float>(std::vector<int64_t>{num_batches, num_features}, -1.f, 1.f);
+  const std::vector<float> support_vectors =
+      random.Uniform<float>(std::vector<int64_t>{num_support_vectors, num_features}, -1.f, 1.f);
+  // ||x - sv||^2 is about 2/3 of the feature count, keep the kernel values away from 0.
+  const float gamma = 1.f / static_cast<float>(num_features);
+
+  const std::vector<float> expected =
+      ComputeRbfKernelReference(x, support_vectors, num_batches, num_support_vectors, num_features, gamma);
+  std::vector<float> out(expected.size());
+  ml::ComputeRbfKernel<float>(x, support_vectors, num_batches, num_support_vectors, num_features, gamma, out,
+                              thread_pool);
+
+  for (size_t i = 0; i < out.size(); ++i) {
+    ASSERT_NEAR(out[i], expected[i], 1e-5f) << "batches " << num_batches << ", support vectors "
+                                            << num_support_vectors << ", features " << num_features << ", index " << i;
+  }
+}
+
+}  // namespace
+
+// The RBF kernel visits the support vectors in blocks of kRbfSupportVectorBlockBytes, i.e. 4096 / num_features
+// vectors for float. The sizes cover a single partial block, exact multiples of the block, a partial last block and
+// blocks of a single vector, with batches that are split across threads or not.
+TEST(MLOpTest, SVMRbfKernelBlocked) {
+  OrtThreadPoolParams options;
+  options.thread_pool_size = 4;
+  auto thread_pool = concurrency::CreateThreadPool(&Env::Default(), options, concurrency::ThreadPoolType::INTRA_OP);
+
+  for (concurrency::ThreadPool* tp : {static_cast<concurrency::ThreadPool*>(nullptr), thread_pool.get()}) {
+    for (int64_t num_batches : {1, 5, 37}) {
+      RunRbfKernel(num_batches, 5, 7, tp);      // 1 block of 5
+      RunRbfKernel(num_batches, 8, 1024, tp);   // 2 blocks of 4
+      RunRbfKernel(num_batches, 9, 1000, tp);   // blocks of 4, 4 and 1
+      RunRbfKernel(num_batches, 13, 600, tp);   // blocks of 6, 6 and 1
+      RunRbfKernel(num_batches, 3, 5000, tp);   // blocks of 1
+      RunRbfKernel(num_batches, 700, 3, tp);    // 1 block of 700
+      RunRbfKernel(num_batches, 1500, 3, tp);   // blocks of 1365 and 135
+    }
+  }
+}
+
 TEST(MLOpTest, SVMClassifierMulticlassSVC) {
   OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
 
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #include "core/graph/constants.h"
 #include "gtest/gtest.h"
+#include "test/common/random_generator.h"
 #include "test/providers/provider_test_utils.h"
 
 using namespace std;
@@ -1046,5 +1047,56 @@ TEST(ConvTest, Conv_AutoPad_with_non_default_strides) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, true);
 }
 
+// A 3x3 stride 1 convolution with enough channels and a constant filter runs with the MLAS Winograd algorithm on CPU.
+TEST(ConvTest, Conv2D_Winograd) {
+  constexpr int64_t N = 2, C = 32, H = 9, W = 11, M = 40;
+  constexpr int64_t OH = H, OW = W;
+
+  const vector<int64_t> X_shape = {N, C, H, W};
+  const vector<int64_t> W_shape = {M, C, 3, 3};
+  const vector<int64_t> B_shape = {M};
+  const vector<int64_t> Y_shape = {N, M, OH, OW};
+
+  RandomValueGenerator random{1234};
+  const vector<float> X = random.Uniform<float>(X_shape, -1.0f, 1.0f);
+  const vector<float> Wt = random.Uniform<float>(W_shape, -1.0f, 1.0f);
+  const vector<float> B = random.Uniform<float>(B_shape, -1.0f, 1.0f);
+
+  vector<float> Y(N * M * OH * OW);
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t oh = 0; oh < OH; oh++) {
+        for (int64_t ow = 0; ow < OW; ow++) {
+          double sum = B[m];
+          for (int64_t c = 0; c < C; c++) {
+            for (int64_t kh = 0; kh < 3; kh++) {
+              for (int64_t kw = 0; kw < 3; kw++) {
+                const int64_t ih = oh + kh - 1;
+                const int64_t iw = ow + kw - 1;
+                if (ih >= 0 && ih < H && iw >= 0 && iw < W) {
+                  sum += double(X[((n * C + c) * H + ih) * W + iw]) * Wt[((m * C + c) * 3 + kh) * 3 + kw];
+                }
+              }
+            }
+          }
+          Y[((n * M + m) * OH + oh) * OW + ow] = static_cast<float>(sum);
+        }
+      }
+    }
+  }
+
+  for (bool weight_is_initializer : {false, true}) {
+    OpTester test("Conv", 11);
+    test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+    test.AddAttribute("pads", vector<int64_t>{1, 1, 1, 1});
+    test.AddInput<float>("X", X_shape, X);
+    test.AddInput<float>("W", W_shape, Wt, weight_is_initializer);
+    test.AddInput<float>("B", B_shape, B, weight_is_initializer);
+    test.AddOutput<float>("Y", Y_shape, Y);
+    test.SetOutputTolerance(1e-3f, 1e-4f);
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kQnnExecutionProvider});
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
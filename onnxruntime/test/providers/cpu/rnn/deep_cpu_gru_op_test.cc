@@ -331,6 +331,63 @@ TEST(GRUTest, ReverseDefaultActivationsSimpleWeightsWithBiasBatchParallelLinearB
   DefaultActivationsSimpleWeightsWithBias("reverse", Y_data, linear_before_reset);
 }
 
+// batch of 6 made from 3 copies of the 2 rows above so the batch is split into blocks of rows across threads.
+// one row has a shorter sequence length so the blocks do not all finish on the same step.
+TEST(GRUTest, ForwardDefaultActivationsSimpleWeightsWithBiasLargeBatchParallelLinearBeforeReset) {
+  constexpr int batch_size = 6;
+  constexpr int64_t seq_length = 2;
+  constexpr int64_t input_size = 1;
+  constexpr int64_t hidden_size = 3;
+
+  const std::vector<float> X_pair{-0.1f, 0.2f, -0.3f, 0.4f};
+  const std::vector<float> Y_pair{
+      0.15024948f, -0.11097029f, -0.02121867f,
+      0.18887489f, -0.09747667f, 0.02093463f,
+
+      0.19538902f, -0.19016478f, -0.05644283f,
+      0.30856851f, -0.15190377f, 0.05999807f};
+  const std::vector<int> sequence_lengths{2, 2, 2, 1, 2, 2};
+
+  std::vector<float> X_data;
+  std::vector<float> Y_data;
+  std::vector<float> Y_h_data;
+  for (int64_t step = 0; step < seq_length; ++step) {
+    for (int b = 0; b < batch_size; ++b) {
+      const auto pair_row = static_cast<size_t>(step * 2 + b % 2);
+      X_data.push_back(X_pair[pair_row]);
+      for (int64_t h = 0; h < hidden_size; ++h) {
+        Y_data.push_back(step < sequence_lengths[b] ? Y_pair[pair_row * hidden_size + h] : 0.f);
+      }
+    }
+  }
+
+  for (int b = 0; b < batch_size; ++b) {
+    const auto pair_row = static_cast<size_t>((sequence_lengths[b] - 1) * 2 + b % 2);
+    for (int64_t h = 0; h < hidden_size; ++h) {
+      Y_h_data.push_back(Y_pair[pair_row * hidden_size + h]);
+    }
+  }
+
+  std::vector<float> W_data{0.1f, 0.2f, 0.3f,   // wz
+                            0.2f, 0.3f, 0.1f,   // wr
+                            0.3f, 0.1f, 0.2f};  // wh
+
+  std::vector<float> B_data{
+      -0.01f, 0.1f, 0.01f,  // Wb[zrh]
+      -0.2f, -0.02f, 0.02f,
+      0.3f, -0.3f, -0.3f,
+
+      -0.03f, 0.5f, -0.7f,  // Rb[zrh]
+      0.05f, -0.7f, 0.3f,
+      0.07f, -0.03f, 0.5f};
+
+  std::vector<float> R_data(3 * hidden_size * hidden_size, 0.1f);
+
+  RunGruTest(X_data, W_data, R_data, Y_data, Y_h_data, input_size, batch_size, hidden_size, seq_length,
+             &B_data, nullptr, &sequence_lengths, "forward", 999.f, /* output_sequence*/ true,
+             /* linear_before_reset*/ true);
+}
+
 // test forward !batch_parallel_ path with linear_before_reset
 TEST(GRUTest, ForwardDefaultActivationsSimpleWeightsWithBiasLinearBeforeReset) {
   std::vector<float> Y_data{
@@ -211,6 +211,30 @@ TEST(ContribOpTest, StringNormalizerSensitiveFilterOutUpperEmptyCase) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+TEST(ContribOpTest, StringNormalizerInsensitiveFilterOutUpperLargeBatch) {
+  // Enough strings for the input to be split into several partitions when a thread pool is available.
+  // - case insensitive approach
+  // - filter out monday
+  // - UPPER
+  OpTester test("StringNormalizer", opset_ver, domain);
+  InitTestAttr(test, "UPPER", false, {"monday"}, test_locale);
+  const std::vector<std::string> days = {"Monday", "tuesday", "Wednesday", "thursday", "MONDAY", "friday"};
+  const std::vector<std::string> upper_days = {"", "TUESDAY", "WEDNESDAY", "THURSDAY", "", "FRIDAY"};
+  constexpr int64_t num_strings = 30000;
+  std::vector<std::string> input;
+  std::vector<std::string> output;
+  for (int64_t i = 0; i < num_strings; ++i) {
+    const size_t day = static_cast<size_t>(i) % days.size();
+    input.push_back(days[day]);
+    if (!upper_days[day].empty()) {
+      output.push_back(upper_days[day]);
+    }
+  }
+  test.AddInput<std::string>("T", {num_strings}, input);
+  test.AddOutput<std::string>("Y", {static_cast<int64_t>(output.size())}, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 // Fails on iOS because necessary locales are not installed
 // MacOS runs fine.
 #ifndef ORT_IOS
@@ -122,5 +122,28 @@ TEST(StringSplit, NoInputTest) {
   test.Run();
 }
 
+// Enough rows for the input to be split into several partitions when a thread pool is available.
+TEST(StringSplit, LargeBatchTest) {
+  constexpr int64_t num_rows = 20000;
+  std::vector<std::string> input;
+  std::vector<std::string> splits;
+  std::vector<int64_t> num_tokens;
+  for (int64_t i = 0; i < num_rows; ++i) {
+    const bool two_tokens = i % 3 != 0;
+    const std::string first = "row" + std::to_string(i);
+    input.push_back(two_tokens ? first + ",tail" : first);
+    splits.push_back(first);
+    splits.push_back(two_tokens ? "tail" : "");
+    num_tokens.push_back(two_tokens ? 2 : 1);
+  }
+
+  OpTester test("StringSplit", 20);
+  test.AddInput<std::string>("X", {num_rows}, input);
+  test.AddAttribute<std::string>("delimiter", ",");
+  test.AddOutput<std::string>("Y", {num_rows, 2}, splits);
+  test.AddOutput<int64_t>("Z", {num_rows}, num_tokens);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
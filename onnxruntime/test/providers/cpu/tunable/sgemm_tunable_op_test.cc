@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "core/providers/cpu/tunable/sgemm.h"
+#include "core/util/thread_utils.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+std::unique_ptr<concurrency::ThreadPool> CreateIntraOpThreadPool(int size) {
+  OrtThreadPoolParams options;
+  options.thread_pool_size = size;
+  return concurrency::CreateThreadPool(&Env::Default(), options, concurrency::ThreadPoolType::INTRA_OP);
+}
+
+std::vector<float> MakeData(size_t size, int seed) {
+  std::vector<float> data(size);
+  for (size_t i = 0; i < size; i++) {
+    data[i] = static_cast<float>(static_cast<int>((i * 7 + seed) % 13) - 6) * 0.125f;
+  }
+  return data;
+}
+
+// Runs C := A * B + beta * C for A {M, K} and B {K, N} with the tunable sgemm and checks it against MlasGemm.
+void RunSgemm(cpu::tunable::CpuTuningContext* tuning_ctx, concurrency::ThreadPool* thread_pool,
+              size_t M, size_t N, size_t K, float beta) {
+  const auto a = MakeData(M * K, 1);
+  const auto b = MakeData(K * N, 2);
+  std::vector<float> c = MakeData(M * N, 3);
+  std::vector<float> expected = c;
+
+  MLAS_SGEMM_DATA_PARAMS data;
+  data.A = a.data();
+  data.lda = K;
+  data.B = b.data();
+  data.ldb = N;
+  data.C = c.data();
+  data.ldc = N;
+  data.beta = beta;
+  ASSERT_STATUS_OK(cpu::tunable::SgemmBatch(tuning_ctx, CblasNoTrans, CblasNoTrans, M, N, K, &data, 1, thread_pool));
+
+  data.C = expected.data();
+  MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, data, nullptr);
+
+  for (size_t i = 0; i < c.size(); i++) {
+    ASSERT_NEAR(c[i], expected[i], 1e-4f) << "i=" << i << ", M=" << M << ", N=" << N << ", K=" << K;
+  }
+}
+
+}  // namespace
+
+TEST(CpuTunableOpTest, SgemmTuning) {
+#ifdef ORT_NO_RTTI
+  GTEST_SKIP() << "TunableOp needs RTTI to work correctly";
+#else
+  auto thread_pool = CreateIntraOpThreadPool(4);
+  CPUExecutionProvider ep{CPUExecutionProviderInfo{}};
+  auto* tuning_ctx = static_cast<cpu::tunable::CpuTuningContext*>(ep.GetTuningContext());
+  ASSERT_NE(tuning_ctx, nullptr);
+  tuning_ctx->EnableTunableOpAndTuning();
+  tuning_ctx->SetMaxTuningDurationMs(10);
+
+  // beta != 0 tunes on a copy of C, the result must only accumulate C once.
+  RunSgemm(tuning_ctx, thread_pool.get(), 1, 1, 1, 0.0f);
+  RunSgemm(tuning_ctx, thread_pool.get(), 3, 100, 17, 1.0f);
+  RunSgemm(tuning_ctx, thread_pool.get(), 64, 64, 64, 0.5f);
+  RunSgemm(tuning_ctx, thread_pool.get(), 130, 40, 96, 0.0f);
+
+  auto trs = tuning_ctx->GetTuningResults();
+  ASSERT_EQ(trs.ep, kCpuExecutionProvider);
+  ASSERT_THAT(trs.validators, ::testing::Contains(::testing::Key("CPU_MODEL")));
+  ASSERT_EQ(trs.results.size(), 1u);
+  ASSERT_EQ(trs.results.begin()->second.size(), 4u);
+#endif
+}
+
+TEST(CpuTunableOpTest, SgemmReplayTuningResults) {
+#ifdef ORT_NO_RTTI
+  GTEST_SKIP() << "TunableOp needs RTTI to work correctly";
+#else
+  auto thread_pool = CreateIntraOpThreadPool(4);
+
+  TuningResults trs;
+  {
+    CPUExecutionProvider ep{CPUExecutionProviderInfo{}};
+    auto* tuning_ctx = static_cast<cpu::tunable::CpuTuningContext*>(ep.GetTuningContext());
+    tuning_ctx->EnableTunableOpAndTuning();
+    RunSgemm(tuning_ctx, thread_pool.get(), 96, 200, 48, 1.0f);
+    trs = tuning_ctx->GetTuningResults();
+  }
+
+  // A new provider replays the loaded results without tuning.
+  CPUExecutionProvider ep{CPUExecutionProviderInfo{}};
+  auto* tuning_ctx = static_cast<cpu::tunable::CpuTuningContext*>(ep.GetTuningContext());
+  ASSERT_STATUS_OK(tuning_ctx->LoadTuningResults(trs));
+  tuning_ctx->EnableTunableOp();
+  ASSERT_FALSE(tuning_ctx->IsTuningEnabled());
+
+  RunSgemm(tuning_ctx, thread_pool.get(), 96, 200, 48, 1.0f);
+  RunSgemm(tuning_ctx, thread_pool.get(), 20, 30, 40, 0.0f);
+
+  // The shape without a result runs with the default partition and is not recorded.
+  auto replayed = tuning_ctx->GetTuningResults();
+  ASSERT_EQ(replayed.results, trs.results);
+
+  // Results from another CPU are rejected.
+  trs.validators["CPU_MODEL"] = "SomeOtherVendor";
+  ASSERT_FALSE(tuning_ctx->LoadTuningResults(trs).IsOK());
+#endif
+}
+
+}  // namespace test
+}  // namespace onnxruntime
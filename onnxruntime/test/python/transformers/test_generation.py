@@ -136,6 +136,20 @@ class TestBeamSearchGpt(unittest.TestCase):
         if self.enable_cuda:
             self.run_beam_search("--past_present_share_buffer --use_gpu", is_greedy=True)
 
+    @pytest.mark.slow
+    def test_greedy_search_past_present_share_buffer_cpu(self):
+        # On CPU, Attention appends to the shared past/present buffer in place and only the past_sequence_length feed
+        # is updated between steps, which shall not change the generated sequences.
+        arguments = " ".join([*self.default_arguments, "--num_beams 1 --num_return_sequences 1"]).split()
+        expected = run(arguments, sentences=self.sentences)
+        self.assertTrue(expected["parity"], f"ORT and PyTorch result is different on CPU for arguments {arguments}")
+
+        arguments.append("--past_present_share_buffer")
+        result = run(arguments, sentences=self.sentences)
+        self.assertTrue(result["parity"], f"ORT and PyTorch result is different on CPU for arguments {arguments}")
+        self.assertEqual(result["decoded_sequences"], expected["decoded_sequences"])
+        os.remove(self.beam_search_onnx_path)
+
     @pytest.mark.slow
     def test_greedy_search_past_present_share_buffer_fp16(self):
         if self.enable_cuda:
@@ -429,6 +443,67 @@ class TestBeamSearchT5Fp16(unittest.TestCase):
         self.check_decoder_fusion()
 
 
+class TestBeamSearchT5DecoderMaskedAttention(unittest.TestCase):
+    """Test BeamSearch for T5 model with DecoderMaskedMultiHeadAttention and fp32 in CPU"""
+
+    @classmethod
+    def setUpClass(cls):
+        tiny_model_dir = get_tiny_t5_model_dir()
+        cls.model_name = "tiny_t5" if use_tiny_model and os.path.exists(tiny_model_dir) else "t5-small"
+        cls.model_id = tiny_model_dir if cls.model_name == "tiny_t5" else "t5-small"
+        cls.beam_search_onnx_path = os.path.join(".", "onnx_models", f"{cls.model_name}_beam_search_dmmha.onnx")
+        cls.default_arguments = [
+            f"-m {cls.model_id}",
+            "--model_type t5",
+            f"--output {cls.beam_search_onnx_path}",
+            "--min_length 2",
+            "--max_length 16",
+            "--output_sequences_score",
+            "--repetition_penalty 2.0",
+        ]
+
+        cls.remove_onnx_files()
+
+    @classmethod
+    def remove_onnx_files(cls):
+        model_name = cls.model_name
+        for file in [
+            f"{model_name}_beam_search_dmmha.onnx",
+            f"{model_name}_encoder.onnx",
+            f"{model_name}_decoder.onnx",
+        ]:
+            if os.path.exists(os.path.join(".", "onnx_models", file)):
+                os.remove(os.path.join(".", "onnx_models", file))
+            if os.path.exists(os.path.join(".", "onnx_models", file + ".data")):
+                os.remove(os.path.join(".", "onnx_models", file + ".data"))
+
+    def tearDown(self):
+        self.remove_onnx_files()
+
+    def run_beam_search(self, extra_arguments: str):
+        # With a shared past/present buffer, DecoderMaskedMultiHeadAttention reads the past state of each beam through
+        # the cache indirection instead of a copy reordered by beam, which shall not change the generated sequences.
+        arguments = " ".join([*self.default_arguments, extra_arguments]).split()
+        expected = run(arguments)
+        self.assertTrue(expected["parity"], f"ORT and PyTorch result is different on CPU for arguments {arguments}")
+
+        arguments.extend(["--past_present_share_buffer", "--use_decoder_masked_attention"])
+        result = run(arguments)
+        self.assertTrue(result["parity"], f"ORT and PyTorch result is different on CPU for arguments {arguments}")
+        self.assertEqual(result["decoded_sequences"], expected["decoded_sequences"])
+
+    def test_return_sequences(self):
+        for return_sequences in [1, 2]:
+            self.run_beam_search(f"--num_return_sequences {return_sequences}")
+
+    def test_num_beams(self):
+        for num_beams in [2, 4]:
+            self.run_beam_search(f"--num_beams {num_beams}")
+
+    def test_no_repeat_ngram(self):
+        self.run_beam_search("--no_repeat_ngram_size 2")
+
+
 class TestBeamSearchWhisper(unittest.TestCase):
     """Test BeamSearch for Whisper"""
 
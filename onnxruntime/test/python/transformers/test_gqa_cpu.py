@@ -360,7 +360,13 @@ def create_group_query_attention_graph_past(
     packed=False,
     softcap=0.0,
     use_smooth_softmax=False,
+    kv_cache_type=None,
+    kv_scale_size=0,
 ):
+    # kv_cache_type is the type of past and present key/value, ort_type by default. An int8 cache takes k_scale and
+    # v_scale inputs of shape [kv_scale_size].
+    if kv_cache_type is None:
+        kv_cache_type = ort_type
     past_kv_seqlen = config.kv_sequence_length
     present_kv_seqlen = (
         config.kv_sequence_length if share_buffer else config.kv_sequence_length + config.sequence_length
@@ -380,6 +386,8 @@ def create_group_query_attention_graph_past(
                 "sin_cache" if rotary else "",
                 "position_ids" if config.has_position_ids else "",
                 "attention_bias" if config.has_attention_bias else "",
+                "k_scale" if kv_scale_size > 0 else "",
+                "v_scale" if kv_scale_size > 0 else "",
             ],
             ["output", "present_key", "present_value"],
             "GroupQueryAttention_0",
@@ -412,7 +420,7 @@ def create_group_query_attention_graph_past(
         ),
         helper.make_tensor_value_info(
             "past_key",
-            ort_type,
+            kv_cache_type,
             [
                 config.batch_size,
                 past_kv_seqlen if past_kv_format == Formats.BSNH else config.kv_num_heads,
@@ -422,7 +430,7 @@ def create_group_query_attention_graph_past(
         ),
         helper.make_tensor_value_info(
             "past_value",
-            ort_type,
+            kv_cache_type,
             [
                 config.batch_size,
                 past_kv_seqlen if past_kv_format == Formats.BSNH else config.kv_num_heads,
@@ -498,6 +506,12 @@ def create_group_query_attention_graph_past(
             ),
         ]
 
+    if kv_scale_size > 0:
+        graph_input += [
+            helper.make_tensor_value_info("k_scale", TensorProto.FLOAT, [kv_scale_size]),
+            helper.make_tensor_value_info("v_scale", TensorProto.FLOAT, [kv_scale_size]),
+        ]
+
     graph_output = [
         helper.make_tensor_value_info(
             "output",
@@ -506,7 +520,7 @@ def create_group_query_attention_graph_past(
         ),
         helper.make_tensor_value_info(
             "present_key",
-            ort_type,
+            kv_cache_type,
             [
                 config.batch_size,
                 present_kv_seqlen if past_kv_format == Formats.BSNH else config.kv_num_heads,
@@ -516,7 +530,7 @@ def create_group_query_attention_graph_past(
         ),
         helper.make_tensor_value_info(
             "present_value",
-            ort_type,
+            kv_cache_type,
             [
                 config.batch_size,
                 present_kv_seqlen if past_kv_format == Formats.BSNH else config.kv_num_heads,
@@ -863,8 +877,13 @@ def gqa_past_func(
     use_smooth_softmax=False,
     ort_type=TensorProto.FLOAT16,
     numpy_type=numpy.float16,
+    intra_op_num_threads=0,
+    k_scale=None,
+    v_scale=None,
 ):
     assert seqlens_k is not None
+    # The kv cache is int8 when k_scale and v_scale are given.
+    kv_cache_int8 = k_scale is not None
     onnx_model_str = create_group_query_attention_graph_past(
         config,
         ort_type,
@@ -876,6 +895,8 @@ def gqa_past_func(
         packed=new_k is None,
         softcap=softcap,
         use_smooth_softmax=use_smooth_softmax,
+        kv_cache_type=TensorProto.INT8 if kv_cache_int8 else ort_type,
+        kv_scale_size=k_scale.numel() if kv_cache_int8 else 0,
     )
     q = torch.reshape(q, (config.batch_size, config.sequence_length, -1))
     past_k = k.clone()
@@ -902,6 +923,7 @@ def gqa_past_func(
             .numpy(),
         }
         sess_options = SessionOptions()
+        sess_options.intra_op_num_threads = intra_op_num_threads
         ort_session = InferenceSession(onnx_model_str, sess_options, providers=["CPUExecutionProvider"])
         io_binding = ort_session.io_binding()
         if new_k is not None and new_v is not None:
@@ -923,15 +945,26 @@ def gqa_past_func(
             ort_inputs["attention_bias"] = attention_bias.detach().cpu().numpy()
             io_binding.bind_cpu_input("attention_bias", ort_inputs["attention_bias"])
 
+        if kv_cache_int8:
+            ort_inputs["k_scale"] = k_scale.detach().cpu().numpy()
+            ort_inputs["v_scale"] = v_scale.detach().cpu().numpy()
+            io_binding.bind_cpu_input("k_scale", ort_inputs["k_scale"])
+            io_binding.bind_cpu_input("v_scale", ort_inputs["v_scale"])
+
         io_binding.bind_cpu_input("query", ort_inputs["query"])
         io_binding.bind_input(
-            "past_key", "cpu", 0, numpy_type, ort_inputs["past_key"].shape(), ort_inputs["past_key"].data_ptr()
+            "past_key",
+            "cpu",
+            0,
+            numpy.int8 if kv_cache_int8 else numpy_type,
+            ort_inputs["past_key"].shape(),
+            ort_inputs["past_key"].data_ptr(),
         )
         io_binding.bind_input(
             "past_value",
             "cpu",
             0,
-            numpy_type,
+            numpy.int8 if kv_cache_int8 else numpy_type,
             ort_inputs["past_value"].shape(),
             ort_inputs["past_value"].data_ptr(),
         )
@@ -959,6 +992,7 @@ def gqa_past_func(
             .numpy(),
         }
         sess_options = SessionOptions()
+        sess_options.intra_op_num_threads = intra_op_num_threads
         ort_session = InferenceSession(onnx_model_str, sess_options, providers=["CPUExecutionProvider"])
         io_binding = ort_session.io_binding()
         if new_k is not None and new_v is not None:
@@ -980,6 +1014,12 @@ def gqa_past_func(
             ort_inputs["attention_bias"] = attention_bias.detach().cpu().numpy()
             io_binding.bind_cpu_input("attention_bias", ort_inputs["attention_bias"])
 
+        if kv_cache_int8:
+            ort_inputs["k_scale"] = k_scale.detach().cpu().numpy()
+            ort_inputs["v_scale"] = v_scale.detach().cpu().numpy()
+            io_binding.bind_cpu_input("k_scale", ort_inputs["k_scale"])
+            io_binding.bind_cpu_input("v_scale", ort_inputs["v_scale"])
+
         io_binding.bind_cpu_input("query", ort_inputs["query"])
         io_binding.bind_cpu_input("past_key", ort_inputs["past_key"])
         io_binding.bind_cpu_input("past_value", ort_inputs["past_value"])
@@ -1186,6 +1226,26 @@ def get_custom_position_ids(batch_size, sequence_length, seqlens_k=None, past=Fa
     return position_ids
 
 
+def get_kv_cache_scale(cache, per_head=True):
+    """Returns the scale of an int8 kv cache of shape (batch_size, seqlen, kv_num_heads, head_size), for each kv head
+    or for the whole cache, such that the largest magnitude is stored as 127."""
+    amax = cache.float().abs().amax(dim=(0, 1, 3)) if per_head else cache.float().abs().amax().reshape(1)
+    return torch.clamp(amax, min=1e-6) / 127.0
+
+
+def get_kv_cache_scale_shape(kv_format):
+    return [1, 1, -1, 1] if kv_format == Formats.BSNH else [1, -1, 1, 1]
+
+
+def quantize_kv_cache(cache, scale, kv_format=Formats.BSNH):
+    scale = scale.reshape(get_kv_cache_scale_shape(kv_format))
+    return torch.clamp(torch.round(cache.float() / scale), -128, 127).to(torch.int8)
+
+
+def dequantize_kv_cache(cache, scale, kv_format=Formats.BSNH):
+    return cache.float() * scale.reshape(get_kv_cache_scale_shape(kv_format))
+
+
 def parity_check_gqa_prompt(
     config,
     torch_type,
@@ -1668,6 +1728,9 @@ def parity_check_gqa_past(
     use_smooth_softmax=False,
     rtol=RTOL,
     atol=ATOL,
+    intra_op_num_threads=0,
+    kv_cache_int8=False,
+    per_head_kv_scale=True,
 ):
     q = torch.randn(
         config.batch_size,
@@ -1766,8 +1829,21 @@ def parity_check_gqa_past(
     )
     k_cache_ref[update_mask] = rearrange(k_ro, "b s ... -> (b s) ...").to(dtype=torch_type)
     v_cache_ref[update_mask] = rearrange(new_v, "b s ... -> (b s) ...").to(dtype=torch_type)
-    k_cache_rep = repeat(k_cache_ref, "b s h d -> b s (h g) d", g=config.num_heads // config.kv_num_heads)
-    v_cache_rep = repeat(v_cache_ref, "b s h d -> b s (h g) d", g=config.num_heads // config.kv_num_heads)
+    k_scale, v_scale = None, None
+    k_cache_attn, v_cache_attn = k_cache_ref, v_cache_ref
+    if kv_cache_int8:
+        # The past is quantized as input, the new rows are quantized by the op, and the reference attention runs on
+        # the dequantized cache.
+        k_scale = get_kv_cache_scale(k_cache_ref, per_head_kv_scale)
+        v_scale = get_kv_cache_scale(v_cache_ref, per_head_kv_scale)
+        k_cache_ref = quantize_kv_cache(k_cache_ref, k_scale)
+        v_cache_ref = quantize_kv_cache(v_cache_ref, v_scale)
+        k_cache_attn = dequantize_kv_cache(k_cache_ref, k_scale)
+        v_cache_attn = dequantize_kv_cache(v_cache_ref, v_scale)
+        k = quantize_kv_cache(k, k_scale, past_format)
+        v = quantize_kv_cache(v, v_scale, past_format)
+    k_cache_rep = repeat(k_cache_attn, "b s h d -> b s (h g) d", g=config.num_heads // config.kv_num_heads)
+    v_cache_rep = repeat(v_cache_attn, "b s h d -> b s (h g) d", g=config.num_heads // config.kv_num_heads)
     key_padding_mask = arange < cache_seqlens_expanded + config.sequence_length
     out_ref, _ = attention_ref(
         q_ro,
@@ -1830,6 +1906,9 @@ def parity_check_gqa_past(
             use_smooth_softmax=use_smooth_softmax,
             ort_type=ort_type,
             numpy_type=numpy_type,
+            intra_op_num_threads=intra_op_num_threads,
+            k_scale=k_scale,
+            v_scale=v_scale,
         )
     else:
         out, present_k, present_v = gqa_past_func(
@@ -1852,14 +1931,25 @@ def parity_check_gqa_past(
             use_smooth_softmax=use_smooth_softmax,
             ort_type=ort_type,
             numpy_type=numpy_type,
+            intra_op_num_threads=intra_op_num_threads,
+            k_scale=k_scale,
+            v_scale=v_scale,
         )
     out = torch.squeeze(out, 0)
     out = torch.reshape(out, (config.batch_size, config.sequence_length, config.num_heads, config.head_size))
     out = out.detach().cpu().numpy()
 
     # Make sure past-present buffer updating correctly
-    assert numpy.allclose(present_k, k_cache_ref.detach().cpu().numpy(), rtol=rtol, atol=atol, equal_nan=True)
-    assert numpy.allclose(present_v, v_cache_ref.detach().cpu().numpy(), rtol=rtol, atol=atol, equal_nan=True)
+    if kv_cache_int8:
+        # Allow one quantization step for values halfway between two steps.
+        present_k_ref = k_cache_ref.detach().cpu().numpy().astype(numpy.int32)
+        present_v_ref = v_cache_ref.detach().cpu().numpy().astype(numpy.int32)
+        assert present_k.dtype == numpy.int8 and present_v.dtype == numpy.int8
+        assert numpy.abs(present_k.astype(numpy.int32) - present_k_ref).max() <= 1
+        assert numpy.abs(present_v.astype(numpy.int32) - present_v_ref).max() <= 1
+    else:
+        assert numpy.allclose(present_k, k_cache_ref.detach().cpu().numpy(), rtol=rtol, atol=atol, equal_nan=True)
+        assert numpy.allclose(present_v, v_cache_ref.detach().cpu().numpy(), rtol=rtol, atol=atol, equal_nan=True)
 
     # Compare results
     all_close = numpy.allclose(out, out_ref, rtol=rtol, atol=atol, equal_nan=True)
@@ -1882,6 +1972,8 @@ def parity_check_gqa_past(
         softcap,
         " smooth_softmax:",
         use_smooth_softmax,
+        " int8 kv cache:",
+        kv_cache_int8,
         " B:",
         config.batch_size,
         " S:",
@@ -1920,6 +2012,9 @@ def parity_check_gqa_past_no_buff(
     use_smooth_softmax=False,
     rtol=RTOL,
     atol=ATOL,
+    intra_op_num_threads=0,
+    kv_cache_int8=False,
+    per_head_kv_scale=True,
 ):
     torch.manual_seed(69)
     q = torch.randn(
@@ -2024,8 +2119,21 @@ def parity_check_gqa_past_no_buff(
     )
     k_cache_ref[update_mask] = rearrange(k_ro, "b s ... -> (b s) ...").to(dtype=torch_type)
     v_cache_ref[update_mask] = rearrange(new_v, "b s ... -> (b s) ...").to(dtype=torch_type)
-    k_cache_rep = repeat(k_cache_ref, "b s h d -> b s (h g) d", g=config.num_heads // config.kv_num_heads)
-    v_cache_rep = repeat(v_cache_ref, "b s h d -> b s (h g) d", g=config.num_heads // config.kv_num_heads)
+    k_scale, v_scale = None, None
+    k_cache_attn, v_cache_attn = k_cache_ref, v_cache_ref
+    if kv_cache_int8:
+        # The past is quantized as input, the new rows are quantized by the op, and the reference attention runs on
+        # the dequantized cache.
+        k_scale = get_kv_cache_scale(k_cache_ref, per_head_kv_scale)
+        v_scale = get_kv_cache_scale(v_cache_ref, per_head_kv_scale)
+        k_cache_ref = quantize_kv_cache(k_cache_ref, k_scale)
+        v_cache_ref = quantize_kv_cache(v_cache_ref, v_scale)
+        k_cache_attn = dequantize_kv_cache(k_cache_ref, k_scale)
+        v_cache_attn = dequantize_kv_cache(v_cache_ref, v_scale)
+        k = quantize_kv_cache(k, k_scale, past_format)
+        v = quantize_kv_cache(v, v_scale, past_format)
+    k_cache_rep = repeat(k_cache_attn, "b s h d -> b s (h g) d", g=config.num_heads // config.kv_num_heads)
+    v_cache_rep = repeat(v_cache_attn, "b s h d -> b s (h g) d", g=config.num_heads // config.kv_num_heads)
     key_padding_mask = arange < cache_seqlens_expanded + config.sequence_length
     out_ref, _ = attention_ref(
         q_ro,
@@ -2088,6 +2196,9 @@ def parity_check_gqa_past_no_buff(
             use_smooth_softmax=use_smooth_softmax,
             ort_type=ort_type,
             numpy_type=numpy_type,
+            intra_op_num_threads=intra_op_num_threads,
+            k_scale=k_scale,
+            v_scale=v_scale,
         )
     else:
         out, present_k, present_v = gqa_past_func(
@@ -2110,6 +2221,9 @@ def parity_check_gqa_past_no_buff(
             use_smooth_softmax=use_smooth_softmax,
             ort_type=ort_type,
             numpy_type=numpy_type,
+            intra_op_num_threads=intra_op_num_threads,
+            k_scale=k_scale,
+            v_scale=v_scale,
         )
     out = torch.squeeze(out, 0)
     out = torch.reshape(out, (config.batch_size, config.sequence_length, config.num_heads, config.head_size))
@@ -2134,6 +2248,8 @@ def parity_check_gqa_past_no_buff(
         softcap,
         " smooth_softmax:",
         use_smooth_softmax,
+        " int8 kv cache:",
+        kv_cache_int8,
         "past kv format:",
         "BSNH" if past_format == Formats.BSNH else "BNSH",
         " B:",
@@ -2256,8 +2372,9 @@ class TestGQA(unittest.TestCase):
     def test_gqa_past(self):
         print("-------- TEST GQA PAST (TOKEN GEN) ---------")
         batches = [1] if pipeline_mode else [1, 3, 5]
+        # long past sequences are split across threads when there are fewer heads than threads
         seqs = (
-            [(1, 128)]
+            [(1, 128), (1, 1024)]
             if pipeline_mode
             else [(1, 128), (1, 339), (1, 1024), (1, 5000), (1, 800), (1, 256), (1, 799), (1, 2048)]
         )
@@ -2274,6 +2391,95 @@ class TestGQA(unittest.TestCase):
         # Test without buffer
         self.run_test_config(parity_check_gqa_past_no_buff, Config, batches, seqs, num_h, h_sizes, pos_ids_attn_bias)
 
+    def test_gqa_past_split_kv(self):
+        print("-------- TEST GQA PAST SPLIT KV (TOKEN GEN) ---------")
+        # One batch with fewer heads than threads and at least two splits of 256 tokens, so the decoding attention
+        # of each head is split across the threads.
+        batches = [1]
+        seqs = [(1, 1024)] if pipeline_mode else [(1, 512), (1, 1024), (1, 2048), (1, 5000)]
+        pos_ids_attn_bias = [(False, False)] if pipeline_mode else [(False, False), (True, True)]
+        num_h = [(2, 1), (6, 3)] if pipeline_mode else [(1, 1), (2, 1), (4, 4), (6, 3), (9, 3)]
+        h_sizes = [64] if pipeline_mode else [32, 64, 128]
+        additional_params = {"intra_op_num_threads": 16}
+
+        # Test with buffer
+        self.run_test_config(
+            parity_check_gqa_past,
+            Config,
+            batches,
+            seqs,
+            num_h,
+            h_sizes,
+            pos_ids_attn_bias,
+            additional_params=additional_params,
+        )
+        # Test without buffer
+        self.run_test_config(
+            parity_check_gqa_past_no_buff,
+            Config,
+            batches,
+            seqs,
+            num_h,
+            h_sizes,
+            pos_ids_attn_bias,
+            additional_params=additional_params,
+        )
+
+    def test_gqa_past_int8_kv_cache(self):
+        print("-------- TEST GQA PAST INT8 KV CACHE (TOKEN GEN) ---------")
+        batches = [1, 3] if pipeline_mode else [1, 3, 5]
+        seqs = [(1, 128), (1, 1024)] if pipeline_mode else [(1, 128), (1, 339), (1, 1024), (1, 2048)]
+        pos_ids_attn_bias = (
+            [(False, False), (True, True)]
+            if pipeline_mode
+            else [(False, False), (True, True), (False, True), (True, False)]
+        )
+        num_h = [(9, 3)] if pipeline_mode else [(6, 6), (6, 3), (9, 9), (9, 3)]
+        h_sizes = [64] if pipeline_mode else [32, 40, 64, 80, 96, 128, 256]
+
+        for per_head_kv_scale in [True, False]:
+            additional_params = {"kv_cache_int8": True, "per_head_kv_scale": per_head_kv_scale}
+            # Test with buffer
+            self.run_test_config(
+                parity_check_gqa_past,
+                Config,
+                batches,
+                seqs,
+                num_h,
+                h_sizes,
+                pos_ids_attn_bias,
+                additional_params=additional_params,
+            )
+            # Test without buffer
+            self.run_test_config(
+                parity_check_gqa_past_no_buff,
+                Config,
+                batches,
+                seqs,
+                num_h,
+                h_sizes,
+                pos_ids_attn_bias,
+                additional_params=additional_params,
+            )
+
+    def test_gqa_int8_kv_cache_requires_scales(self):
+        config = Config(1, 1, 16, 0, 4, 2, 32, False, False)
+        onnx_model_str = create_group_query_attention_graph_past(
+            config, TensorProto.FLOAT, Formats.BNSH, kv_cache_type=TensorProto.INT8
+        )
+        ort_session = InferenceSession(onnx_model_str, SessionOptions(), providers=["CPUExecutionProvider"])
+        ort_inputs = {
+            "query": numpy.random.randn(1, 1, 4 * 32).astype(numpy.float32),
+            "key": numpy.random.randn(1, 1, 2 * 32).astype(numpy.float32),
+            "value": numpy.random.randn(1, 1, 2 * 32).astype(numpy.float32),
+            "past_key": numpy.zeros((1, 2, 16, 32), dtype=numpy.int8),
+            "past_value": numpy.zeros((1, 2, 16, 32), dtype=numpy.int8),
+            "seqlens_k": numpy.array([8], dtype=numpy.int32),
+            "total_sequence_length": numpy.array([16], dtype=numpy.int32),
+        }
+        with self.assertRaisesRegex(Exception, "k_scale"):
+            ort_session.run(None, ort_inputs)
+
     def test_gqa_interactive_one_batch(self):
         print("-------- TEST GQA INTERACTIVE ---------")
         batches = [1]
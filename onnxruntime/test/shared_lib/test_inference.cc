@@ -2171,6 +2171,72 @@ TEST(CApiTest, io_binding) {
   binding.ClearBoundOutputs();
 }
 
+TEST(CApiTest, io_binding_output_to_input) {
+  Ort::SessionOptions session_options;
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  Ort::MemoryInfo info_cpu = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemTypeDefault);
+
+  // Y = X * W with W = {1, 2, 3, 4, 5, 6}. Feeding Y back as X computes X0 * W^n after n runs.
+  const std::array<int64_t, 2> shape = {3, 2};
+  std::array<float, 3 * 2> x_values = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+  const std::array<float, 3 * 2> initial_x = x_values;
+  Ort::Value bound_x = Ort::Value::CreateTensor(info_cpu, x_values.data(), x_values.size(),
+                                                shape.data(), shape.size());
+
+  Ort::IoBinding binding(session);
+  binding.BindInput("X", bound_x);
+  binding.BindOutput("Y", info_cpu);
+  binding.BindOutputToInput("Y", "X");
+
+  std::array<float, 3 * 2> expected_y = initial_x;
+  for (int run = 0; run < 4; ++run) {
+    session.Run(Ort::RunOptions(), binding);
+    for (size_t i = 0; i < expected_y.size(); ++i) {
+      expected_y[i] *= static_cast<float>(i + 1);
+    }
+
+    std::vector<Ort::Value> output_values = binding.GetOutputValues();
+    ASSERT_EQ(output_values.size(), 1U);
+    const Ort::Value& Y_value = output_values[0];
+    ASSERT_EQ(expected_y.size(), Y_value.GetTensorTypeAndShapeInfo().GetElementCount());
+    const float* values = Y_value.GetTensorData<float>();
+    ASSERT_TRUE(std::equal(values, values + expected_y.size(), std::begin(expected_y)));
+  }
+
+  // the initial state is never written to
+  ASSERT_TRUE(std::equal(std::begin(x_values), std::end(x_values), std::begin(initial_x)));
+
+  // binding the initial state again resets the state, so the next runs start over from it. The output of the last run
+  // is not written by the next one.
+  std::vector<Ort::Value> last_output_values = binding.GetOutputValues();
+  const std::array<float, 3 * 2> last_y = expected_y;
+  binding.BindInput("X", bound_x);
+  expected_y = initial_x;
+  for (int run = 0; run < 3; ++run) {
+    session.Run(Ort::RunOptions(), binding);
+    for (size_t i = 0; i < expected_y.size(); ++i) {
+      expected_y[i] *= static_cast<float>(i + 1);
+    }
+
+    std::vector<Ort::Value> output_values = binding.GetOutputValues();
+    ASSERT_EQ(output_values.size(), 1U);
+    const float* values = output_values[0].GetTensorData<float>();
+    ASSERT_TRUE(std::equal(values, values + expected_y.size(), std::begin(expected_y)));
+    if (run == 0) {
+      const float* last_values = last_output_values[0].GetTensorData<float>();
+      ASSERT_TRUE(std::equal(last_values, last_values + last_y.size(), std::begin(last_y)));
+    }
+  }
+  ASSERT_TRUE(std::equal(std::begin(x_values), std::end(x_values), std::begin(initial_x)));
+
+  // binding an input twice fails
+  ASSERT_THROW(binding.BindOutputToInput("Y", "X"), Ort::Exception);
+
+  binding.ClearBoundInputs();
+  binding.ClearBoundOutputs();
+}
+
 #if defined(USE_CUDA) || defined(USE_TENSORRT)
 TEST(CApiTest, io_binding_cuda) {
   Ort::SessionOptions session_options;